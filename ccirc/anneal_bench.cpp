@@ -0,0 +1,245 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+//
+// Compares the ways of finding the Wirelength-approx.
+//
+//	anneal_bench [--seed N] [--threads N] [--partitions N] 
+//				 [--wirelength_time_budget S] circuit.blif [circuit.blif ...]
+//
+// Each circuit is read, levelled and partitioned once (one cluster unless
+// --partitions is given), then placed from the same start by each method:
+//	fixed		annealing with the fixed schedule
+//	adaptive	annealing with the adaptive schedule
+//	analytic	the analytic placement alone
+//	seeded		the analytic placement, then annealing with the adaptive schedule
+//
+// For each it reports the annealing moves tried and their rate, the seconds
+// taken in all and the Wirelength-approx reached, with its change from the
+// fixed schedule.  The seed defaults to 1 so that runs can be compared.
+//
+
+#include "circ.h"
+#include "blif_parser.h"
+#include "cycle_breaker.h"
+#include "delay_leveler.h"
+#include "node_partitioner.h"
+#include "wirelength_character.h"
+#include "util.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+//
+// RETURNS: a new OPTIONS of the arguments plus the schedule and the mode
+//
+static OPTIONS * make_options
+(
+	const vector<string> & arguments,
+	const string & schedule,
+	const string & mode
+)
+{
+	vector<string> option_arguments(arguments);
+	vector<char *> option_argv;
+	OPTIONS * options = new OPTIONS;
+	unsigned index;
+
+	option_arguments.push_back("--wirelength_schedule");
+	option_arguments.push_back(schedule);
+	option_arguments.push_back("--wirelength_mode");
+	option_arguments.push_back(mode);
+
+	for (index = 0; index < option_arguments.size(); index++)
+	{
+		option_argv.push_back(const_cast<char *>(option_arguments[index].c_str()));
+	}
+
+	options->process_options(static_cast<int>(option_argv.size()), &option_argv[0]);
+
+	return options;
+}
+
+typedef chrono::steady_clock BENCH_CLOCK;
+
+const int nMETHODS = 4;
+const char * METHOD_NAMES[nMETHODS] = { "fixed", "adaptive", "analytic", "seeded" };
+
+static void bench_circuit
+(
+	const string & file_name,
+	OPTIONS * method_options[nMETHODS]
+)
+{
+	COST_TYPE wirelength[nMETHODS];
+	ostringstream log;
+	streambuf * table_buffer;
+	BENCH_CLOCK::time_point start;
+	double seconds;
+	FILE * input_file = fopen(file_name.c_str(), "r");
+	int method;
+
+	if (! input_file)
+	{
+		cerr << "Could not read " << file_name << endl;
+		return;
+	}
+
+	// keep what the passes log out of the table
+	table_buffer = cout.rdbuf(log.rdbuf());
+
+	g_options = method_options[0];
+
+	BLIF_PARSER parser(g_options);
+	CIRCUIT * circuit = parser.parse(input_file);
+	fclose(input_file);
+
+	CYCLE_BREAKER cycle_breaker;
+	cycle_breaker.break_cycles(circuit);
+	circuit->freeze();
+
+	DELAY_LEVELER delay_leveler;
+	delay_leveler.calculate_and_label_combinational_delay_levels(circuit);
+
+	NODE_PARTITIONER node_partitioner;
+	node_partitioner.partition_circuit(circuit);
+
+	for (method = 0; method < nMETHODS; method++)
+	{
+		WIRELENGTH_CHARACTER wirelength_characterizer;
+
+		g_options = method_options[method];
+		cout.rdbuf(log.rdbuf());
+		start = BENCH_CLOCK::now();
+		wirelength[method] = wirelength_characterizer.get_circuit_wirelength_approx(circuit);
+		seconds = chrono::duration<double>(BENCH_CLOCK::now() - start).count();
+		cout.rdbuf(table_buffer);
+
+		cout << setw(24) << left << util_strip_directory_name(file_name) 
+			<< setw(10) << METHOD_NAMES[method] << right
+			<< setw(14) << wirelength_characterizer.get_nMoves();
+
+		if (wirelength_characterizer.get_nMoves() > 0)
+		{
+			cout << setw(14) << fixed << setprecision(0) 
+				<< wirelength_characterizer.get_nMoves() / wirelength_characterizer.get_seconds();
+		}
+		else
+		{
+			cout << setw(14) << "-";
+		}
+
+		cout << setw(10) << fixed << setprecision(2) << seconds
+			<< setw(16) << setprecision(0) << wirelength[method];
+
+		if (method > 0 && wirelength[0] > 0)
+		{
+			cout << setw(10) << setprecision(1) << showpos 
+				<< 100.0 * (wirelength[method] - wirelength[0]) / wirelength[0] << "%" << noshowpos;
+		}
+		cout << endl;
+	}
+
+	g_options = method_options[0];
+	delete circuit;
+}
+
+int main(int argc, char ** argv)
+{
+	vector<string> arguments;
+	string seed = "1";
+	int argnum = 1;
+	int method;
+
+	arguments.push_back("anneal_bench");
+	arguments.push_back("");			// the circuit, for the circuit name only
+	arguments.push_back("--nowarn");
+	arguments.push_back("--wirelength_approx");
+
+	while (argnum + 1 < argc && argv[argnum][0] == '-')
+	{
+		if (string(argv[argnum]) == "--seed")
+		{
+			seed = argv[argnum + 1];
+		}
+		else if (string(argv[argnum]) == "--threads" || string(argv[argnum]) == "--partitions" ||
+				 string(argv[argnum]) == "--wirelength_time_budget")
+		{
+			arguments.push_back(argv[argnum]);
+			arguments.push_back(argv[argnum + 1]);
+		}
+		else
+		{
+			break;
+		}
+		argnum += 2;
+	}
+
+	if (argnum >= argc || argv[argnum][0] == '-')
+	{
+		cerr << "Usage:  anneal_bench [--seed N] [--threads N] [--partitions N] "
+			<< "[--wirelength_time_budget S] circuit.blif [circuit.blif ...]" << endl;
+		return 1;
+	}
+
+	arguments[1] = argv[argnum];
+	arguments.push_back("--seed");
+	arguments.push_back(seed);
+
+	// the options echo themselves as they are read
+	ostringstream log;
+	streambuf * table_buffer = cout.rdbuf(log.rdbuf());
+	OPTIONS * method_options[nMETHODS] = { 
+		make_options(arguments, "fixed", "anneal"),
+		make_options(arguments, "adaptive", "anneal"),
+		make_options(arguments, "adaptive", "analytic"),
+		make_options(arguments, "adaptive", "analytic_anneal") };
+	cout.rdbuf(table_buffer);
+
+	cout << setw(24) << left << "circuit" << setw(10) << "method" << right 
+		<< setw(14) << "moves" << setw(14) << "moves/s" 
+		<< setw(10) << "seconds" << setw(16) << "wirelength" 
+		<< setw(11) << "change" << endl;
+
+	try
+	{
+		for (; argnum < argc; argnum++)
+		{
+			bench_circuit(argv[argnum], method_options);
+		}
+	}
+	catch (const CIRC_FAILURE & failure)
+	{
+		cout.rdbuf(table_buffer);
+		cerr << "Error: " << failure.what() << endl;
+		return 1;
+	}
+
+	g_options = 0;
+	for (method = 0; method < nMETHODS; method++)
+	{
+		delete method_options[method];
+	}
+
+	return 0;
+}
@@ -0,0 +1,441 @@
+# Copyright (c) 2021, Programmable digital systems group, University of Toronto
+# All rights reserved.
+
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""Throughput benchmark of ccirc, run by `make bench`.
+
+Runs ccirc over the circuits bundled here, the circuits behind the checked-in
+.stats files and the netlists of submodules/benchmarks.  For each circuit it
+records the parse time, the analysis time, the peak RSS and the nodes per
+second in a CSV, taken from the PROFILE section of `--profile --format json`.
+
+With a baseline CSV (`make bench_baseline` stores one) a circuit whose nodes
+per second fell, or whose peak RSS grew, by more than --tolerance is a
+regression.  A circuit with a .stats golden file must still report the same
+circuit-wide numbers.  The runs that once broke ccirc, a generated chain of
+LUTs deeper than a short and bisections of adder.blif that left parts empty,
+must finish in time with the right numbers.  Any failure makes the exit
+status 1.
+
+With --synthetic the circuits are instead synthetic netlists of the sizes
+given, made by netlist_gen (`make scaling`, whose baseline `make
+scaling_baseline` stores).  The time of each stage is then fitted as
+nodes^exponent by least squares over all the sizes, and a total exponent above
+1 + --tolerance fails as the analysis no longer scales linearly.  The fit
+needs SCALING_MINIMUM_SIZES sizes slow enough to time; two sizes are too
+noisy to judge.
+"""
+
+import argparse
+import csv
+import glob
+import json
+import math
+import os
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+CSV_FIELDS = ["circuit", "nodes", "parse_s", "analysis_s", "peak_rss_kb", "nodes_per_s"]
+
+# the golden values are written with 6 significant digits
+GOLDEN_TOLERANCE = 1e-5
+
+# a generated regression circuit that runs longer than this hangs
+REGRESSION_TIMEOUT_SECONDS = 60
+
+# deeper than the 32767 levels a short delay holds
+DEEP_CHAIN_LENGTH = 40000
+
+# stages quicker than this at a size are too noisy to fit there
+SCALING_MINIMUM_SECONDS = 0.1
+
+# the fewest sizes the total is fitted over to judge it
+SCALING_MINIMUM_SIZES = 3
+
+
+def read_golden(stats_file):
+    """The circuit-wide numbers of a text .stats file, by name.
+
+    Averages give <name> and <name>_std_dev, shapes and distributions a list.
+    The cluster summary and the clusters are left out, their layout changed
+    over the versions of ccirc.
+    """
+    golden = {}
+    in_cluster_summary = False
+
+    with open(stats_file) as stats:
+        for line in stats:
+            line = line.strip()
+            if line.startswith("#################### Cluster"):
+                break
+            if line.startswith("===") or line.startswith("###"):
+                in_cluster_summary = "Cluster_Summary" in line
+                continue
+            if in_cluster_summary or ":" not in line:
+                continue
+
+            name, value = line.split(":", 1)
+            tokens = value.split()
+            if name in ("Circuit_Name", "clock") or not tokens:
+                golden[name] = value.strip()
+            elif tokens[0] == "(":
+                golden[name] = [float(token) for token in tokens[1:-1]]
+            elif len(tokens) == 2 and tokens[1].startswith("("):
+                golden[name] = float(tokens[0])
+                golden[name + "_std_dev"] = float(tokens[1].strip("()"))
+            else:
+                golden[name] = float(tokens[0])
+    return golden
+
+
+def golden_arguments(golden):
+    """The options that made the golden file, as far as it tells."""
+    arguments = []
+    if golden.get("Number_of_Clusters", 1) > 1:
+        arguments += ["--partitions", str(int(golden["Number_of_Clusters"]))]
+    return arguments
+
+
+def is_close(value, golden_value):
+    return abs(value - golden_value) <= GOLDEN_TOLERANCE * max(1.0, abs(golden_value))
+
+
+def compare_to_golden(stats, golden):
+    """The names whose values differ from the golden ones."""
+    differences = []
+    for name, golden_value in golden.items():
+        if name == "Circuit_Name":
+            continue
+        value = stats.get(name)
+        if isinstance(golden_value, str):
+            same = (value == golden_value)
+        elif isinstance(golden_value, list):
+            same = (isinstance(value, list) and len(value) == len(golden_value) and
+                    all(is_close(v, g) for v, g in zip(value, golden_value)))
+        else:
+            same = (isinstance(value, (int, float)) and is_close(value, golden_value))
+        if not same:
+            differences.append(name)
+    return differences
+
+
+def find_circuits(ccirc_dir, benchmarks_dir):
+    """(name, netlist or None, golden file or None, extra options, None) of each circuit."""
+    circuits = []
+    names = set()
+
+    netlists = {}
+    for netlist in sorted(glob.glob(os.path.join(benchmarks_dir, "**", "*.blif"), recursive=True)):
+        netlists.setdefault(os.path.splitext(os.path.basename(netlist))[0], netlist)
+
+    for stats_file in sorted(glob.glob(os.path.join(ccirc_dir, "*.stats"))):
+        golden = read_golden(stats_file)
+        name = golden.get("Circuit_Name", os.path.splitext(os.path.basename(stats_file))[0])
+        netlist = os.path.join(ccirc_dir, name + ".blif")
+        if not os.path.exists(netlist):
+            netlist = netlists.get(name)
+        circuits.append((name, netlist, stats_file, golden_arguments(golden), None))
+        names.add(name)
+
+    for netlist in sorted(glob.glob(os.path.join(ccirc_dir, "*.blif"))) + sorted(netlists.values()):
+        name = os.path.splitext(os.path.basename(netlist))[0]
+        if name not in names:
+            circuits.append((name, netlist, None, [], None))
+            names.add(name)
+
+    return circuits
+
+
+def write_lut_chain(netlist, name, length):
+    """A chain of length 2-input LUTs, each the AND of the one before and input b."""
+    with open(netlist, "w") as blif:
+        blif.write(".model %s\n.inputs a b\n.outputs z\n" % name)
+        previous = "a"
+        for index in range(length):
+            output = "z" if index == length - 1 else "n%d" % index
+            blif.write(".names %s b %s\n11 1\n" % (previous, output))
+            previous = output
+        blif.write(".end\n")
+
+
+def expect_stats(expected):
+    """A check that the stats have these values, giving the names that differ."""
+    def check(stats):
+        return ["%s %s not %s" % (name, stats.get(name), value)
+                for name, value in expected.items() if stats.get(name) != value]
+    return check
+
+
+def is_finite(value):
+    """Whether every number in value, however deep, is finite."""
+    if isinstance(value, dict):
+        return all(is_finite(item) for item in value.values())
+    if isinstance(value, list):
+        return all(is_finite(item) for item in value)
+    return not isinstance(value, float) or math.isfinite(value)
+
+
+def check_clusters(stats):
+    """The clusters left empty and the numbers that are not finite."""
+    problems = ["cluster %s is empty" % cluster["Cluster_number"]
+                for cluster in stats.get("Clusters", []) if cluster["Number_of_Nodes"] == 0]
+    problems += ["%s is not finite" % name for name, value in stats.items() if not is_finite(value)]
+    return problems
+
+
+def make_regression_circuits(ccirc_dir, directory):
+    """(name, netlist, None, extra options, check) of each circuit that once broke ccirc.
+
+    check(stats) gives what is wrong with the stats of the run.
+    """
+    circuits = []
+
+    netlist = os.path.join(directory, "deep_chain.blif")
+    write_lut_chain(netlist, "deep_chain", DEEP_CHAIN_LENGTH)
+    circuits.append(("deep_chain", netlist, None, [], expect_stats({"Maximum_Delay": DEEP_CHAIN_LENGTH})))
+
+    # recursive bisection once left parts empty when a side could take all the weight
+    netlist = os.path.join(ccirc_dir, "adder.blif")
+    for nParts, ubfactor in ((3, 30), (9, 40)):
+        circuits.append(("adder_bi_%d_%d" % (nParts, ubfactor), netlist, None,
+                         ["--partition_type", "bi", "--partitions", str(nParts), "--ubfactor", str(ubfactor)],
+                         check_clusters))
+
+    return circuits
+
+
+def make_synthetic_circuits(netlist_gen, sizes, directory, generator_options):
+    """(name, netlist, None, [], None) of a netlist_gen netlist of each size."""
+    circuits = []
+    for size in sizes:
+        name = "synthetic_%d" % size
+        netlist = os.path.join(directory, name + ".blif")
+        command = [netlist_gen, "--nodes", str(size), "--name", name, "--blif", netlist] + generator_options
+        subprocess.run(command, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=True)
+        circuits.append((name, netlist, None, [], None))
+    return circuits
+
+
+def stage_seconds(stats):
+    """The wall seconds of each stage of the PROFILE section, and their total."""
+    seconds = {name[:-len("_wall_s")]: value for name, value in stats["Profile"].items()
+               if is_outer_stage_time(name)}
+    seconds["total"] = total_seconds(stats)
+    return seconds
+
+
+def fit_exponent(points):
+    """The least squares slope of log(seconds) over log(nodes) of (nodes, seconds) points."""
+    xs = [math.log(nodes) for nodes, _ in points]
+    ys = [math.log(seconds) for _, seconds in points]
+    x_mean = sum(xs) / len(xs)
+    y_mean = sum(ys) / len(ys)
+    return (sum((x - x_mean) * (y - y_mean) for x, y in zip(xs, ys)) /
+            sum((x - x_mean) ** 2 for x in xs))
+
+
+def check_scaling(runs, tolerance):
+    """Prints how each stage grows over the sizes, fitted over those it took long enough at.
+
+    RETURNS: 1 if the total grows faster than linearly, else 0
+    """
+    stages = []
+    for _, seconds in runs:
+        stages += [stage for stage in seconds if stage not in stages and stage != "total"]
+    stages.append("total")
+
+    exponents = []
+    nTotal_sizes = 0
+    for stage in stages:
+        points = [(nodes, seconds[stage]) for nodes, seconds in runs
+                  if seconds.get(stage, 0.0) >= SCALING_MINIMUM_SECONDS]
+        if len(set(nodes for nodes, _ in points)) >= 2:
+            exponents.append((stage, fit_exponent(points)))
+        if stage == "total":
+            nTotal_sizes = len(points)
+
+    total_exponent = dict(exponents).get("total")
+    is_judged = total_exponent is not None and nTotal_sizes >= SCALING_MINIMUM_SIZES
+    is_superlinear = is_judged and total_exponent > 1.0 + tolerance
+    notes = ["%s %.2f" % exponent for exponent in exponents]
+    if is_superlinear:
+        notes.append("SUPERLINEAR")
+    elif not is_judged:
+        notes.append("not judged: %d sizes took %.2f s or more, %d are needed" %
+                     (nTotal_sizes, SCALING_MINIMUM_SECONDS, SCALING_MINIMUM_SIZES))
+    print("scaling %s nodes: %s" % (" -> ".join(str(nodes) for nodes, _ in runs), "  ".join(notes)))
+    return 1 if is_superlinear else 0
+
+
+def run_ccirc(ccirc, netlist, arguments, repeat, timeout=None):
+    """The stats of the fastest of repeat runs, with their PROFILE section."""
+    best = None
+    for _ in range(repeat):
+        command = [ccirc, netlist, "--profile", "--format", "json", "--out", "-"] + arguments
+        try:
+            result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                                    universal_newlines=True, timeout=timeout)
+        except subprocess.TimeoutExpired:
+            raise RuntimeError("ccirc did not finish in %d s" % timeout)
+        if result.returncode != 0 or not result.stdout.strip():
+            raise RuntimeError(result.stderr.strip().splitlines()[-1] if result.stderr.strip()
+                               else "ccirc exited with %d" % result.returncode)
+        stats = json.loads(result.stdout.splitlines()[0])
+        if best is None or total_seconds(stats) < total_seconds(best):
+            best = stats
+    return best
+
+
+def is_outer_stage_time(name):
+    """Whether name is the wall time of a stage not inside another, as parse.graph_medic is."""
+    return name.endswith("_wall_s") and "." not in name
+
+
+def total_seconds(stats):
+    profile = stats["Profile"]
+    return sum(value for name, value in profile.items() if is_outer_stage_time(name))
+
+
+def measure(name, stats):
+    profile = stats["Profile"]
+    parse_seconds = profile.get("parse_wall_s", 0.0)
+    analysis_seconds = total_seconds(stats) - parse_seconds
+    nodes = stats["Number_of_Nodes"]
+    return {
+        "circuit": name,
+        "nodes": nodes,
+        "parse_s": "%.6f" % parse_seconds,
+        "analysis_s": "%.6f" % analysis_seconds,
+        "peak_rss_kb": profile["peak_rss_kb"],
+        "nodes_per_s": "%.1f" % (nodes / max(parse_seconds + analysis_seconds, 1e-9)),
+    }
+
+
+def read_csv(file_name):
+    with open(file_name) as csv_file:
+        return {row["circuit"]: row for row in csv.DictReader(csv_file)}
+
+
+def write_csv(file_name, rows):
+    with open(file_name, "w", newline="") as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames=CSV_FIELDS)
+        writer.writeheader()
+        writer.writerows(rows)
+
+
+def compare_to_baseline(row, baseline_row, tolerance):
+    """The ways row is worse than its baseline by more than tolerance."""
+    regressions = []
+    speed = float(row["nodes_per_s"])
+    baseline_speed = float(baseline_row["nodes_per_s"])
+    if speed < baseline_speed * (1.0 - tolerance):
+        regressions.append("nodes/s %.0f was %.0f" % (speed, baseline_speed))
+    rss = float(row["peak_rss_kb"])
+    baseline_rss = float(baseline_row["peak_rss_kb"])
+    if rss > baseline_rss * (1.0 + tolerance):
+        regressions.append("peak RSS %.0f kB was %.0f kB" % (rss, baseline_rss))
+    return regressions
+
+
+def main():
+    ccirc_dir = os.path.dirname(os.path.abspath(__file__))
+
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--ccirc", default=os.path.join(ccirc_dir, "ccirc"))
+    parser.add_argument("--benchmarks", default=os.path.join(ccirc_dir, "..", "submodules", "benchmarks"),
+                        help="the directory searched for .blif netlists")
+    parser.add_argument("--csv", default="bench.csv", help="where the results go")
+    parser.add_argument("--baseline", default="bench_baseline.csv")
+    parser.add_argument("--tolerance", type=float, default=0.25,
+                        help="the fraction the speed or the memory may get worse (default 0.25)")
+    parser.add_argument("--repeat", type=int, default=1, help="keep the fastest of this many runs")
+    parser.add_argument("--only", nargs="*", help="bench only these circuits")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="store the results as the baseline instead of comparing")
+    parser.add_argument("--synthetic", help="bench synthetic netlists of these sizes, e.g. 10000,100000")
+    parser.add_argument("--netlist-gen", default=os.path.join(ccirc_dir, "netlist_gen"))
+    parser.add_argument("--generator-options", default="",
+                        help="options for netlist_gen, e.g. \"--k 6 --dff_ratio 0.1\"")
+    parser.add_argument("ccirc_options", nargs=argparse.REMAINDER,
+                        help="after --, options for every run of ccirc")
+    arguments = parser.parse_args()
+    ccirc_options = [option for option in arguments.ccirc_options if option != "--"]
+
+    baseline = {}
+    if not arguments.update_baseline and os.path.exists(arguments.baseline):
+        baseline = read_csv(arguments.baseline)
+
+    generated_directory = tempfile.mkdtemp(prefix="ccirc_bench_")
+    if arguments.synthetic:
+        circuits = make_synthetic_circuits(arguments.netlist_gen,
+                                           [int(size) for size in arguments.synthetic.split(",")],
+                                           generated_directory, shlex.split(arguments.generator_options))
+    else:
+        circuits = find_circuits(ccirc_dir, arguments.benchmarks) + make_regression_circuits(ccirc_dir, generated_directory)
+
+    rows = []
+    scaling_runs = []
+    nFailures = 0
+    for name, netlist, golden_file, golden_options, check in circuits:
+        if arguments.only and name not in arguments.only:
+            continue
+        if netlist is None:
+            print("%-16s skipped: no netlist for %s" % (name, os.path.basename(golden_file)))
+            continue
+
+        try:
+            stats = run_ccirc(arguments.ccirc, netlist, golden_options + ccirc_options, arguments.repeat,
+                              REGRESSION_TIMEOUT_SECONDS if check else None)
+        except RuntimeError as error:
+            print("%-16s FAILED: %s" % (name, error))
+            nFailures += 1
+            continue
+
+        row = measure(name, stats)
+        rows.append(row)
+        scaling_runs.append((row["nodes"], stage_seconds(stats)))
+
+        notes = []
+        if golden_file:
+            differences = compare_to_golden(stats, read_golden(golden_file))
+            if differences:
+                notes.append("differs from %s in %s" % (os.path.basename(golden_file), ", ".join(differences)))
+            else:
+                notes.append("matches %s" % os.path.basename(golden_file))
+            nFailures += bool(differences)
+        if check:
+            problems = check(stats)
+            notes += ["WRONG " + problem for problem in problems]
+            nFailures += bool(problems)
+        if name in baseline:
+            regressions = compare_to_baseline(row, baseline[name], arguments.tolerance)
+            notes += ["REGRESSION " + regression for regression in regressions]
+            nFailures += bool(regressions)
+
+        print("%-16s %8d nodes  parse %8.4f s  analysis %8.4f s  %8d kB  %10.0f nodes/s  %s" %
+              (name, row["nodes"], float(row["parse_s"]), float(row["analysis_s"]), row["peak_rss_kb"],
+               float(row["nodes_per_s"]), "; ".join(notes)))
+
+    shutil.rmtree(generated_directory)
+    if arguments.synthetic:
+        nFailures += check_scaling(scaling_runs, arguments.tolerance)
+
+    write_csv(arguments.baseline if arguments.update_baseline else arguments.csv, rows)
+    if arguments.update_baseline:
+        print("bench: stored %d circuits as the baseline in %s" % (len(rows), arguments.baseline))
+    else:
+        if not baseline:
+            print("bench: no baseline in %s to compare with. `make %s` stores one" %
+                  (arguments.baseline, "scaling_baseline" if arguments.synthetic else "bench_baseline"))
+        print("bench: %d circuits, %d failures. results in %s" % (len(rows), nFailures, arguments.csv))
+
+    return 1 if nFailures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,374 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+#include "blif_parser.h"
+
+#ifndef VISUAL_C
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+BLIF_PARSER::BLIF_PARSER
+(
+	OPTIONS * options
+)
+{
+	assert(options);
+
+	m_options			= options;
+	m_tokenizer			= 0;
+	m_graph_constructor	= 0;
+	m_have_line			= false;
+	m_current_lut		= 0;
+}
+
+BLIF_PARSER::~BLIF_PARSER()
+{
+	delete_graph_constructor();
+}
+
+//
+// Parse the circuit in an open file. 
+// A regular file is mapped into memory and parsed in place. Anything 
+// else (a pipe, a memory stream) is read into a buffer first.
+//
+// PRE: input_file is open
+// POST: input_file has been read to its end
+// RETURNS: the graph of the circuit. it belongs to the caller
+//
+CIRCUIT * BLIF_PARSER::parse
+(
+	FILE * input_file
+)
+{
+	assert(input_file);
+
+	CIRCUIT * graph = 0;
+	string text;
+	char buffer[BUFSIZ];
+	size_t nRead;
+
+#ifndef VISUAL_C
+	struct stat file_status;
+	int file_descriptor = fileno(input_file);
+	long offset = ftell(input_file);
+	void * mapped_file = MAP_FAILED;
+	size_t file_size = 0;
+
+	if (file_descriptor >= 0 && offset >= 0 && 
+		fstat(file_descriptor, &file_status) == 0 && S_ISREG(file_status.st_mode) &&
+		file_status.st_size > offset)
+	{
+		file_size = static_cast<size_t>(file_status.st_size);
+		mapped_file = mmap(0, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	}
+
+	if (mapped_file != MAP_FAILED)
+	{
+		madvise(mapped_file, file_size, MADV_SEQUENTIAL);
+
+		try
+		{
+			graph = parse(static_cast<const char *>(mapped_file) + offset, file_size - offset);
+		}
+		catch (const CIRC_FAILURE &)
+		{
+			munmap(mapped_file, file_size);
+			throw;
+		}
+
+		munmap(mapped_file, file_size);
+		fseek(input_file, 0, SEEK_END);
+
+		return graph;
+	}
+#endif
+
+	while ((nRead = fread(buffer, 1, sizeof(buffer), input_file)) > 0)
+	{
+		text.append(buffer, nRead);
+	}
+
+	graph = parse(text.data(), text.size());
+
+	return graph;
+}
+
+//
+// Parse the circuit in text
+//
+// PRE: text holds length characters of BLIF
+// POST: the parse is complete or we have failed. if we failed nothing
+//       built during the parse is left behind
+// RETURNS: the graph of the circuit. it belongs to the caller
+//
+CIRCUIT * BLIF_PARSER::parse
+(
+	const char * text, 
+	size_t length
+)
+{
+	BLIF_TOKENIZER tokenizer(text, length);
+	CIRCUIT * graph = 0;
+	long line_number = 0;
+
+	m_tokenizer = &tokenizer;
+	m_have_line = false;
+
+	try
+	{
+		parse_model();
+
+		debugif(DCODE, "Parse completed.  Calling cleanup");
+		m_variable_name_stack.clear();
+		m_graph_constructor->delete_unusable_nodes();
+		graph = m_graph_constructor->get_constructed_graph();
+	}
+	catch (const CIRC_FAILURE & failure)
+	{
+		line_number = tokenizer.get_line_number();
+		m_tokenizer = 0;
+		m_variable_name_stack.clear();
+
+		if (m_graph_constructor)
+		{
+			delete m_graph_constructor->get_constructed_graph();
+		}
+		delete_graph_constructor();
+
+		Fail("Parse error, line " << line_number << " of input: " << failure.what());
+	}
+
+	m_tokenizer = 0;
+	delete_graph_constructor();
+
+	return graph;
+}
+
+//
+// .model <name>, the preamble, the logic and then .end
+//
+// PRE: nothing has been read
+// POST: the whole model has been read and its graph built
+//
+void BLIF_PARSER::parse_model()
+{
+	if (! read_line() || ! is_keyword(".model"))
+	{
+		Fail("Expected .model");
+	}
+	if (m_tokens.size() < 2)
+	{
+		Fail("The .model has no name");
+	}
+	m_have_line = false;
+
+	m_graph_constructor = new GRAPH_CONSTRUCTOR(m_options);
+	assert(m_graph_constructor);
+
+	// all the inputs and outputs come before the logic
+	while (read_line() && (is_keyword(".inputs") || is_keyword(".outputs")))
+	{
+		parse_external_ports(is_keyword(".inputs") ? PORT::PI : PORT::PO);
+	}
+
+	while (read_line() && ! is_keyword(".end"))
+	{
+		m_graph_constructor->set_line_number(m_tokenizer->get_line_number());
+
+		if (is_keyword(".names"))
+		{
+			parse_names();
+		}
+		else if (is_keyword(".latch"))
+		{
+			parse_latch();
+		}
+		else if (is_keyword(".clock"))
+		{
+			Warning("Ignoring .clocks stmt.  Assigning global clock.");
+			m_have_line = false;
+		}
+		else if (is_keyword(".gate") || is_keyword(".subckt"))
+		{
+			Warning("Unsupported construct, will try to ignore it.");
+			m_have_line = false;
+		}
+		else if (is_keyword(".inputs") || is_keyword(".outputs"))
+		{
+			Fail(m_tokens[0] << " must come before the logic");
+		}
+		else
+		{
+			Fail("Unexpected '" << m_tokens[0] << "'");
+		}
+	}
+
+	if (! m_have_line)
+	{
+		Fail("Missing .end");
+	}
+	m_have_line = false;
+}
+
+//
+// .inputs or .outputs followed by the names of the ports
+//
+void BLIF_PARSER::parse_external_ports
+(
+	const PORT::EXTERNAL_TYPE & external_type
+)
+{
+	BLIF_TOKENS::size_type token_index;
+
+	for (token_index = 1; token_index < m_tokens.size(); token_index++)
+	{
+		m_graph_constructor->new_external_port(intern(m_tokens[token_index]), external_type);
+	}
+	m_have_line = false;
+}
+
+//
+// To parse a logic element, we stack the arguments because we don't know
+// which one is the output until we get the last one. Then we parse the 
+// table entries and finally add the node to the graph.
+//
+void BLIF_PARSER::parse_names()
+{
+	BLIF_TOKENS::size_type token_index;
+
+	for (token_index = 1; token_index < m_tokens.size(); token_index++)
+	{
+		debugif(DBLIF, "Got symbol '" << m_tokens[token_index] << "' in logic");
+		m_variable_name_stack.push_back(intern(m_tokens[token_index]));
+	}
+	m_have_line = false;
+
+	parse_truth_table();
+
+	m_graph_constructor->new_combination_block(&m_variable_name_stack, m_current_lut);
+}
+
+//
+// Lines of <cube> <value> up to the next keyword. 
+// A line with only a value is a constant function.
+//
+void BLIF_PARSER::parse_truth_table()
+{
+	VALUE_TYPE value;
+	short number_input_variables = static_cast<short>(m_variable_name_stack.size()) - 1;
+
+	// m_entry and m_name keep their storage from line to line
+	while (read_line() && m_tokens[0][0] != '.')
+	{
+		m_tokens[0].assign_to(m_entry);
+
+		if (m_tokens.size() == 2)
+		{
+			m_tokens[1].assign_to(m_name);
+			value = m_graph_constructor->new_value(m_name, m_current_lut);
+			debugif(DBLIF, "got table entry '" << m_entry << "' value '" << value << "'");
+		}
+		else if (m_tokens.size() == 1)
+		{
+			debugif(DBLIF, "Function is a constant '" <<  m_entry << "'");
+			value = m_graph_constructor->new_value(m_entry, m_current_lut);
+			m_entry.clear();
+		}
+		else
+		{
+			Fail("Too many entries in this table line");
+		}
+
+		// add the new cube and value to the current list.
+		m_graph_constructor->new_truth_table_entry(m_entry, value, 
+									number_input_variables, m_current_lut);
+		m_have_line = false;
+	}
+}
+
+//
+// .latch <input> <output> <type> <clock> [<initial value>]
+// the type and the initial value are ignored
+//
+void BLIF_PARSER::parse_latch()
+{
+	if (m_tokens.size() != 5 && m_tokens.size() != 6)
+	{
+		Fail("Expected .latch <input> <output> <type> <clock> [<initial value>]");
+	}
+
+	m_graph_constructor->new_flip_flop(intern(m_tokens[1]), intern(m_tokens[2]), 
+										intern(m_tokens[4]));
+	m_have_line = false;
+}
+
+//
+// PRE: nothing
+// POST: m_tokens holds the next line unless we are at the end
+// RETURNS: true if there is a line to parse, false otherwise
+//
+bool BLIF_PARSER::read_line()
+{
+	if (! m_have_line)
+	{
+		m_have_line = m_tokenizer->read_line(m_tokens);
+	}
+
+	return m_have_line;
+}
+
+//
+// RETURNS: true if the current line starts with keyword, false otherwise
+//
+bool BLIF_PARSER::is_keyword
+(
+	const char * keyword
+) const
+{
+	assert(m_have_line && ! m_tokens.empty());
+
+	return (m_tokens[0] == keyword);
+}
+
+//
+// PRE: nothing
+// POST: the graph constructor and its symbol table have been deleted.
+//       the graph it built has not
+//
+void BLIF_PARSER::delete_graph_constructor()
+{
+	delete m_graph_constructor;
+	m_graph_constructor = 0;
+}
+
+//
+// RETURNS: the name of the token interned in the graph being built
+//
+NET_NAME BLIF_PARSER::intern
+(
+	const BLIF_TOKEN & token
+)
+{
+	assert(m_graph_constructor);
+
+	return m_graph_constructor->intern_name(token.get_text(), token.get_length());
+}
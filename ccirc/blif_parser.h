@@ -0,0 +1,88 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+#ifndef blif_parser_H
+#define blif_parser_H
+
+#include "circ.h"
+#include "circuit.h"
+#include "graph_constructor.h"
+#include "blif_tokenizer.h"
+#include "lut.h"
+#include <cstdio>
+
+//
+// Class_name BLIF_PARSER
+//
+// Description
+//
+//	Parses a BLIF circuit and builds its graph with a GRAPH_CONSTRUCTOR.
+//
+//	  .model <name>
+//	  .inputs <input names>
+//	  .outputs <output names>
+//	  .names <input names> <output name>
+//	  <cube> <value>
+//	  .latch <input> <output> <type> <clock> [<initial value>]
+//	  .end
+//
+//	.clock statements are ignored and every latch is connected to the 
+//	global clock. .gate and .subckt are not supported and are skipped.
+//
+//	Each parser owns its tokenizer, graph constructor and symbol table,
+//	so circuits can be parsed on several threads at the same time as 
+//	long as each thread uses its own parser.
+//
+
+class BLIF_PARSER
+{
+public:
+	BLIF_PARSER(OPTIONS * options);
+	~BLIF_PARSER();
+
+	CIRCUIT *	parse(FILE * input_file);
+	CIRCUIT *	parse(const char * text, size_t length);
+private:
+	OPTIONS *				m_options;
+	BLIF_TOKENIZER *		m_tokenizer;
+	GRAPH_CONSTRUCTOR *		m_graph_constructor;
+	BLIF_TOKENS				m_tokens;			// the current line
+	string					m_name;				// the text of a value token, reused
+	string					m_entry;			// the cube of a table line, reused
+	bool					m_have_line;		// m_tokens holds a line not yet parsed
+	VARIABLE_STACK_TYPE		m_variable_name_stack;
+	LUT *					m_current_lut;
+
+	void	parse_model();
+	void	parse_external_ports(const PORT::EXTERNAL_TYPE & external_type);
+	void	parse_names();
+	void	parse_truth_table();
+	void	parse_latch();
+
+	bool	read_line();
+	bool	is_keyword(const char * keyword) const;
+	NET_NAME	intern(const BLIF_TOKEN & token);
+	void	delete_graph_constructor();
+
+	BLIF_PARSER(const BLIF_PARSER & another_parser);
+	BLIF_PARSER & operator=(const BLIF_PARSER & another_parser);
+};
+
+#endif
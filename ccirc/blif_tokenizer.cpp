@@ -0,0 +1,215 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+#include "blif_tokenizer.h"
+#include <cctype>
+#include <cstring>
+
+BLIF_TOKENIZER::BLIF_TOKENIZER
+(
+	const char * text, 
+	size_t length
+)
+{
+	assert(text || length == 0);
+
+	m_next				= text;
+	m_end				= text + length;
+	m_line_number		= 0;
+	m_next_line_number	= 1;
+}
+
+BLIF_TOKENIZER::BLIF_TOKENIZER(const BLIF_TOKENIZER & another_tokenizer)
+{
+	m_next				= another_tokenizer.m_next;
+	m_end				= another_tokenizer.m_end;
+	m_line_number		= another_tokenizer.m_line_number;
+	m_next_line_number	= another_tokenizer.m_next_line_number;
+}
+
+BLIF_TOKENIZER & BLIF_TOKENIZER::operator=(const BLIF_TOKENIZER & another_tokenizer)
+{
+	m_next				= another_tokenizer.m_next;
+	m_end				= another_tokenizer.m_end;
+	m_line_number		= another_tokenizer.m_line_number;
+	m_next_line_number	= another_tokenizer.m_next_line_number;
+
+	return (*this);
+}
+
+BLIF_TOKENIZER::~BLIF_TOKENIZER()
+{
+}
+
+//
+// Read the next logical line
+//
+// PRE: nothing
+// POST: tokens holds the tokens of the next line that has any
+//       m_line_number is the line of input that line started on
+// RETURNS: false if there are no more lines, true otherwise
+//
+bool BLIF_TOKENIZER::read_line
+(
+	BLIF_TOKENS & tokens
+)
+{
+	const char * token_start = 0;
+	char character;
+
+	tokens.clear();
+
+	while (m_next < m_end)
+	{
+		m_line_number = m_next_line_number;
+
+		while (m_next < m_end && *m_next != '\n')
+		{
+			character = *m_next;
+
+			if (character == ' ' || character == '\t' || character == '\r')
+			{
+				m_next++;
+			}
+			else if (is_name_character(character) || character == '.')
+			{
+				// a '.' can only start a keyword
+				token_start = m_next;
+				m_next++;
+				while (m_next < m_end && is_name_character(*m_next))
+				{
+					m_next++;
+				}
+
+				if (token_start[0] == '.' && m_next - token_start == 1)
+				{
+					Fail("'.' not allowed. Find and delete any illegal periods");
+				}
+
+				tokens.push_back(BLIF_TOKEN(token_start, m_next - token_start));
+			}
+			else if (character == '\\' && is_at_line_continuation())
+			{
+				// skip the fake newline put in by sis or other tools
+				m_next = skip_to_end_of_line(m_next) + 1;
+				m_next_line_number++;
+			}
+			else if (character == '#')
+			{
+				m_next = skip_to_end_of_line(m_next);
+			}
+			else if (character == ':')
+			{
+				Fail("':' not allowed. Find and delete any illegal :");
+			}
+			else
+			{
+				Fail("Illegal character '" << character << "'");
+			}
+		}
+
+		if (m_next < m_end)
+		{
+			// step over the newline
+			m_next++;
+			m_next_line_number++;
+		}
+
+		if (! tokens.empty())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//
+// The characters that can be part of a name.
+// [\[\]a-zA-Z0-9,=!@$%^&*_-]
+//
+class NAME_CHARACTERS
+{
+public:
+	NAME_CHARACTERS()
+	{
+		int character;
+
+		for (character = 0; character < 256; character++)
+		{
+			m_is_name_character[character] = (isalnum(character) != 0);
+		}
+		for (const char * other = "[],=!@$%^&*_-"; *other; other++)
+		{
+			m_is_name_character[static_cast<unsigned char>(*other)] = true;
+		}
+	}
+
+	bool operator[](const char & character) const
+	{
+		return m_is_name_character[static_cast<unsigned char>(character)];
+	}
+private:
+	bool m_is_name_character[256];
+};
+
+static const NAME_CHARACTERS g_name_characters;
+
+//
+// RETURNS: true if character can be part of a name, false otherwise
+//
+bool BLIF_TOKENIZER::is_name_character
+(
+	const char & character
+) const
+{
+	return g_name_characters[character];
+}
+
+//
+// RETURNS: the newline that ends the line next is on or m_end
+//
+const char * BLIF_TOKENIZER::skip_to_end_of_line
+(
+	const char * next
+) const
+{
+	const char * end_of_line = 
+		static_cast<const char *>(memchr(next, '\n', m_end - next));
+
+	return (end_of_line ? end_of_line : m_end);
+}
+
+//
+// PRE: m_next points to a '\'
+// RETURNS: true if only white space follows it on its line
+//
+bool BLIF_TOKENIZER::is_at_line_continuation() const
+{
+	const char * next = m_next + 1;
+
+	while (next < m_end && (*next == ' ' || *next == '\t' || *next == '\r'))
+	{
+		next++;
+	}
+
+	return (next < m_end && *next == '\n');
+}
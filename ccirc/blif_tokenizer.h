@@ -0,0 +1,101 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+#ifndef blif_tokenizer_H
+#define blif_tokenizer_H
+
+#include "circ.h"
+#include <cstddef>
+#include <cstring>
+
+//
+// Class_name BLIF_TOKEN
+//
+// Description
+//
+//	A view of the text of a token in the input. It does not own or copy
+//	the text, so it is only valid while the input is.
+//
+
+class BLIF_TOKEN
+{
+public:
+	BLIF_TOKEN() : m_text(0), m_length(0) {}
+	BLIF_TOKEN(const char * text, size_t length) : m_text(text), m_length(length) {}
+
+	const char *	get_text() const { return m_text; }
+	size_t			get_length() const { return m_length; }
+	char			operator[](size_t index) const { return m_text[index]; }
+
+	bool	operator==(const char * keyword) const
+			{ return strncmp(m_text, keyword, m_length) == 0 && keyword[m_length] == '\0'; }
+
+	// copy the text out of the input
+	void	assign_to(string & text) const { text.assign(m_text, m_length); }
+	string	to_string() const { return string(m_text, m_length); }
+private:
+	const char *	m_text;
+	size_t			m_length;
+};
+
+inline ostream & operator<<(ostream & output_stream, const BLIF_TOKEN & token)
+{
+	return output_stream.write(token.get_text(), token.get_length());
+}
+
+typedef vector<BLIF_TOKEN> BLIF_TOKENS;
+
+//
+// Class_name BLIF_TOKENIZER
+//
+// Description
+//
+//	Splits BLIF text into logical lines of tokens. A '\' at the end of
+//	a line joins it to the next one, '#' starts a comment that runs to 
+//	the end of the line, and lines with no tokens are skipped.
+//
+//	The tokens point into the text, nothing is copied. All of its state
+//	is its own so any number of tokenizers can run at the same time.
+//
+
+class BLIF_TOKENIZER
+{
+public:
+	BLIF_TOKENIZER(const char * text, size_t length);
+	BLIF_TOKENIZER(const BLIF_TOKENIZER & another_tokenizer);
+	BLIF_TOKENIZER & operator=(const BLIF_TOKENIZER & another_tokenizer);
+	~BLIF_TOKENIZER();
+
+	bool	read_line(BLIF_TOKENS & tokens);
+
+	// the line of input the last logical line started on
+	long	get_line_number() const { return m_line_number; }
+private:
+	const char *	m_next;					// the next character to scan
+	const char *	m_end;
+	long			m_line_number;
+	long			m_next_line_number;
+
+	bool	is_name_character(const char & character) const;
+	const char *	skip_to_end_of_line(const char * next) const;
+	bool	is_at_line_continuation() const;
+};
+
+#endif
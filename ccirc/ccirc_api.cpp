@@ -0,0 +1,241 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+#include "ccirc_api.h"
+#include "circ.h"
+#include "circ_control.h"
+#include "statistic_reporter.h"
+#include <sstream>
+
+struct CCIRC_METRICS
+{
+	string			circuit_name;
+	vector<string>	names;
+	DOUBLE_VECTOR	values;
+};
+
+static string g_last_error;
+
+//
+// Set up the options for one call as if they were given on the command line
+//
+// PRE: file_name names the input, options is NULL or a string of options
+// POST: call_options holds the options
+//
+static void set_call_options
+(
+	OPTIONS & call_options,
+	const char * file_name,
+	const char * options
+)
+{
+	istringstream option_stream(options ? options : "");
+	vector<string> arguments;
+	vector<char *> argv;
+	string argument;
+	unsigned int argument_index;
+
+	arguments.push_back("ccirc");
+	arguments.push_back(file_name);
+	while (option_stream >> argument)
+	{
+		arguments.push_back(argument);
+	}
+
+	for (argument_index = 0; argument_index < arguments.size(); argument_index++)
+	{
+		argv.push_back(const_cast<char *>(arguments[argument_index].c_str()));
+	}
+
+	call_options.process_options(static_cast<int>(argv.size()), &argv[0]);
+}
+
+//
+// Read, analyze and collect the stats of one circuit
+//
+// PRE: blif_text holds length characters of BLIF or is NULL to read file_name
+// RETURNS: the metrics or NULL with g_last_error set
+//
+static CCIRC_METRICS * analyze
+(
+	const char * blif_text,
+	size_t length,
+	const char * file_name,
+	const char * options
+)
+{
+	OPTIONS call_options;
+	OPTIONS * caller_options = g_options;
+	CIRC_CONTROL circ_control;
+	METRICS metrics;
+	METRICS::const_iterator metric_iter;
+	CCIRC_METRICS * result = 0;
+
+	// the host owns stdout
+	streambuf * cout_buffer = cout.rdbuf(cerr.rdbuf());
+
+	g_last_error.clear();
+	g_options = &call_options;
+
+	try
+	{
+		set_call_options(call_options, file_name, options);
+
+		if (blif_text)
+		{
+			circ_control.read_circuit(blif_text, length);
+		}
+		else
+		{
+			circ_control.read_circuits();
+		}
+
+		circ_control.collect_stats(metrics);
+
+		result = new CCIRC_METRICS;
+		result->circuit_name = call_options.get_circuit_name();
+		for (metric_iter = metrics.begin(); metric_iter != metrics.end(); metric_iter++)
+		{
+			result->names.push_back(metric_iter->first);
+			result->values.push_back(metric_iter->second);
+		}
+	}
+	catch (const exception & failure)
+	{
+		g_last_error = failure.what();
+		delete result;
+		result = 0;
+	}
+
+	g_options = caller_options;
+	cout.rdbuf(cout_buffer);
+
+	return result;
+}
+
+CCIRC_METRICS * ccirc_analyze_file
+(
+	const char * file_name,
+	const char * options
+)
+{
+	if (! file_name || ! *file_name)
+	{
+		g_last_error = "No input file was given";
+		return 0;
+	}
+
+	return analyze(0, 0, file_name, options);
+}
+
+CCIRC_METRICS * ccirc_analyze_buffer
+(
+	const char * blif_text,
+	size_t length,
+	const char * options
+)
+{
+	if (! blif_text)
+	{
+		g_last_error = "No circuit was given";
+		return 0;
+	}
+
+	// the circuit is parsed in place
+	return analyze(blif_text, length, "-", options);
+}
+
+const char * ccirc_last_error(void)
+{
+	return g_last_error.c_str();
+}
+
+int ccirc_get_nMetrics
+(
+	const CCIRC_METRICS * metrics
+)
+{
+	assert(metrics);
+	return static_cast<int>(metrics->values.size());
+}
+
+const char * ccirc_get_metric_name
+(
+	const CCIRC_METRICS * metrics,
+	int index
+)
+{
+	assert(metrics);
+	assert(index >= 0 && index < ccirc_get_nMetrics(metrics));
+	return metrics->names[index].c_str();
+}
+
+const double * ccirc_get_metric_values
+(
+	const CCIRC_METRICS * metrics
+)
+{
+	assert(metrics);
+	return (metrics->values.empty() ? 0 : &metrics->values[0]);
+}
+
+//
+// RETURNS: 1 and the value of the metric called name if there is one
+//          else 0
+//
+int ccirc_find_metric
+(
+	const CCIRC_METRICS * metrics,
+	const char * name,
+	double * value
+)
+{
+	assert(metrics && name && value);
+	unsigned int index;
+
+	for (index = 0; index < metrics->names.size(); index++)
+	{
+		if (metrics->names[index] == name)
+		{
+			*value = metrics->values[index];
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+const char * ccirc_get_circuit_name
+(
+	const CCIRC_METRICS * metrics
+)
+{
+	assert(metrics);
+	return metrics->circuit_name.c_str();
+}
+
+void ccirc_free_metrics
+(
+	CCIRC_METRICS * metrics
+)
+{
+	delete metrics;
+}
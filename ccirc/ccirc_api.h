@@ -0,0 +1,69 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+#ifndef ccirc_api_H
+#define ccirc_api_H
+
+#include <stddef.h>
+
+/*
+ * C interface to the ccirc analysis.
+ *
+ * A circuit is read from a file or from a buffer holding BLIF text, 
+ * analyzed, and every number the .stats file would contain is returned 
+ * in memory as a flat array of (name, value) pairs. Nothing is written 
+ * to disk. Shapes and distributions give one metric per element named
+ * <name>[<index>], averages give <name> and <name>_std_dev.
+ *
+ * options is a string of ccirc command line options, e.g. "--nowarn", 
+ * and may be NULL. 
+ *
+ * Errors do not end the process. The analyze functions return NULL and
+ * ccirc_last_error() says why. Diagnostics go to stderr.
+ *
+ * The analysis uses global state so only one call may run at a time.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct CCIRC_METRICS CCIRC_METRICS;
+
+CCIRC_METRICS * ccirc_analyze_file(const char * file_name, const char * options);
+CCIRC_METRICS * ccirc_analyze_buffer(const char * blif_text, size_t length, 
+									const char * options);
+
+const char * 	ccirc_last_error(void);
+
+int 			ccirc_get_nMetrics(const CCIRC_METRICS * metrics);
+const char * 	ccirc_get_metric_name(const CCIRC_METRICS * metrics, int index);
+const double * 	ccirc_get_metric_values(const CCIRC_METRICS * metrics);
+int 			ccirc_find_metric(const CCIRC_METRICS * metrics, const char * name, 
+									double * value);
+const char * 	ccirc_get_circuit_name(const CCIRC_METRICS * metrics);
+
+void 			ccirc_free_metrics(CCIRC_METRICS * metrics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
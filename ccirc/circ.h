@@ -60,7 +60,7 @@ const bool Dsingle_seq_level = true;
 #include <iostream>
 using namespace std;
 
-extern OPTIONS * g_options;
+extern thread_local OPTIONS * g_options;
 
 #include "output.h"
 
@@ -20,6 +20,7 @@
 
 #include "circ_control.h"
 #include <fstream>
+#include <sstream>
 #include "graph_medic.h"
 #include "cycle_breaker.h"
 #include "delay_leveler.h"
@@ -27,29 +28,62 @@
 #include "drawer.h"
 #include "wirelength_character.h"
 #include "node_partitioner.h"
+#include "blif_parser.h"
+#include "incremental_analyzer.h"
+#include "stats_plan.h"
+#include "profiler.h"
+#include "thread_pool.h"
+#include "util.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#ifndef VISUAL_C
+#include <glob.h>
+#endif
 
-extern		OPTIONS * g_options;
-extern 		int yyparse();
-extern 		FILE *yyin;
+extern		thread_local OPTIONS * g_options;
 
-CIRCUIT *	g_parsed_graph;
+// the line that ends each reply in server mode
+const string SERVER_REPLY_END = ".done";
+
+typedef chrono::steady_clock BATCH_CLOCK;
+
+// a stream buffer that drops everything written to it
+class DISCARD_BUFFER : public streambuf
+{
+protected:
+	int overflow(int character) { return traits_type::not_eof(character); }
+};
 
 CIRC_CONTROL::CIRC_CONTROL()
 {
 	m_circuit = 0;
+	m_previous_circuit = 0;
 	m_input_file = 0;
+	m_stats_stream = 0;
+	m_metrics = 0;
 }
 
 CIRC_CONTROL::CIRC_CONTROL(const CIRC_CONTROL & another_circ_control)
 {
 	m_circuit		=	another_circ_control.m_circuit; 
+	m_previous_circuit	=	another_circ_control.m_previous_circuit;
 	m_input_file	= 	another_circ_control.m_input_file;
+	m_stats_stream	=	another_circ_control.m_stats_stream;
+	m_metrics		=	another_circ_control.m_metrics;
+	m_profiler		=	another_circ_control.m_profiler;
 }
 	
 CIRC_CONTROL & CIRC_CONTROL::operator=(const CIRC_CONTROL & another_circ_control)
 {
 	m_circuit		=	another_circ_control.m_circuit; 
+	m_previous_circuit	=	another_circ_control.m_previous_circuit;
 	m_input_file	= 	another_circ_control.m_input_file;
+	m_stats_stream	=	another_circ_control.m_stats_stream;
+	m_metrics		=	another_circ_control.m_metrics;
+	m_profiler		=	another_circ_control.m_profiler;
 
 	return (*this);
 }
@@ -57,6 +91,7 @@ CIRC_CONTROL & CIRC_CONTROL::operator=(const CIRC_CONTROL & another_circ_control
 CIRC_CONTROL::~CIRC_CONTROL()
 {
 	delete m_circuit;
+	delete m_previous_circuit;
 }
 void CIRC_CONTROL::help()
 {
@@ -73,24 +108,115 @@ void CIRC_CONTROL::help()
 void CIRC_CONTROL::read_circuits()
 {
 	open_circuit_input_file();
-	yyin = m_input_file;
+	parse_input_file();
+}
 
-	yyparse();
+//
+// Read in the circuit from a file the caller has opened
+//
+// PRE: input_file is open and positioned at the start of a blif circuit
+// POST: input_file has been closed
+//       we have read in the graph or failed
+//
+void CIRC_CONTROL::read_circuit
+(
+	FILE * input_file
+)
+{
+	assert(input_file);
 
-	close_circuit_input_file();
+	m_input_file = input_file;
+	parse_input_file();
+}
+
+//
+// Read in the circuit from BLIF text in memory
+//
+// PRE: blif_text holds length characters of BLIF
+// POST: we have read in the graph or failed
+//
+void CIRC_CONTROL::read_circuit
+(
+	const char * blif_text,
+	size_t length
+)
+{
+	assert(blif_text);
+	assert(! m_circuit);
 
-	// Check to see if we have a parsed the circuit and have a graph
-	if (g_parsed_graph)
+	BLIF_PARSER parser(g_options);
+
+	m_profiler.clear();
+	begin_profiling();
+
+	try
 	{
-		// yes we do
-		m_circuit = g_parsed_graph;
-		g_parsed_graph = 0;
+		PROFILE_STAGE stage("parse");
+		m_circuit = parser.parse(blif_text, length);
 	}
-	else
+	catch (const CIRC_FAILURE &)
 	{
-		Fail("Could not parse the graph");
+		g_profiler = 0;
+		throw;
 	}
 
+	g_profiler = 0;
+	assert(m_circuit);
+}
+
+//
+// Take a circuit built in memory instead of reading one, e.g. a synthetic
+// netlist from NETLIST_GENERATOR
+//
+// PRE: circuit is a complete graph that has not been frozen
+// POST: the circuit is ours to analyze and delete
+//
+void CIRC_CONTROL::use_circuit
+(
+	CIRCUIT * circuit
+)
+{
+	assert(circuit);
+	assert(! m_circuit);
+
+	m_profiler.clear();
+	m_circuit = circuit;
+}
+
+//
+// Parse the circuit in m_input_file
+//
+// PRE: m_input_file is open
+// POST: m_input_file is closed
+//       m_circuit is the parsed graph or we have failed and exited
+//
+void CIRC_CONTROL::parse_input_file()
+{
+	assert(m_input_file);
+	assert(! m_circuit);
+
+	BLIF_PARSER parser(g_options);
+
+	m_profiler.clear();
+	begin_profiling();
+
+	try
+	{
+		PROFILE_STAGE stage("parse");
+		m_circuit = parser.parse(m_input_file);
+	}
+	catch (const CIRC_FAILURE &)
+	{
+		g_profiler = 0;
+		close_circuit_input_file();
+		throw;
+	}
+
+	g_profiler = 0;
+	close_circuit_input_file();
+
+	assert(m_circuit);
+
 
 	Log("Finished reading in the circuits");
 	Verbose("Circuit Stats: size=" << m_circuit->get_size() <<
@@ -101,6 +227,46 @@ void CIRC_CONTROL::read_circuits()
 }
 
 
+//
+// PRE: g_options are the options of the circuit
+// POST: the stages run on this thread are recorded in m_profiler if we are 
+//       profiling, and not at all if we are not
+//
+void CIRC_CONTROL::begin_profiling()
+{
+	bool is_profiling = g_options->is_profile() || ! g_options->get_trace_file_name().empty();
+
+	g_profiler = is_profiling ? &m_profiler : 0;
+}
+
+//
+// Analyze the circuit and collect its stats instead of writing them
+//
+// PRE: we have read in the circuit
+// POST: metrics holds every number the stats report would contain
+//
+void CIRC_CONTROL::collect_stats
+(
+	METRICS & metrics
+)
+{
+	assert(m_circuit);
+
+	m_metrics = &metrics;
+
+	try
+	{
+		analyze_graphs();
+	}
+	catch (const CIRC_FAILURE &)
+	{
+		m_metrics = 0;
+		throw;
+	}
+
+	m_metrics = 0;
+}
+
 // 
 // This function controls the execution of ccirc
 // 
@@ -113,6 +279,7 @@ void CIRC_CONTROL::analyze_graphs()
 
 	NUM_ELEMENTS size;
 	bool should_log = true;
+	bool is_incremental = false;
 
 	GRAPH_MEDIC medic(m_circuit);
 	CYCLE_BREAKER cycle_breaker;
@@ -121,48 +288,609 @@ void CIRC_CONTROL::analyze_graphs()
 	STATISTIC_REPORTER statistic_reporter;
 	DRAWER drawer;
 	WIRELENGTH_CHARACTER wirelength_characterizer;
+	INCREMENTAL_ANALYZER incremental_analyzer;
+	STATS_PLAN stats_plan;
 
 	size = m_circuit->get_size();
 	should_log = DEBUG || (size>1000);
 
-	Logif(should_log,"Status: Looking to break combinational cycles");
-	cycle_breaker.break_cycles(m_circuit);
+	begin_profiling();
+
+	{
+		PROFILE_STAGE stage("cycle_breaking");
+		Logif(should_log,"Status: Looking to break combinational cycles");
+		cycle_breaker.break_cycles(m_circuit);
+	}
+
+	{
+		PROFILE_STAGE stage("freeze");
+		Logif(should_log,"Status: Freezing the graph");
+		m_circuit->freeze();
+	}
+
+	is_incremental = (m_previous_circuit && g_options->is_incremental());
+	if (is_incremental)
+	{
+		PROFILE_STAGE stage("incremental_matching");
+		Logif(should_log,"Status: Matching the graph to the previous circuit");
+		incremental_analyzer.match_circuits(m_previous_circuit, m_circuit);
+	}
 	
-	Logif(should_log,"Status: Calculating combinational delay");
-	delay_leveler.calculate_and_label_combinational_delay_levels(m_circuit);
+	// only the passes needed for the --stats are run
+	if (stats_plan.is_needed(STATS_PLAN::DELAY_PASS))
+	{
+		PROFILE_STAGE stage("delay_leveling");
+		Logif(should_log,"Status: Calculating combinational delay");
+		stats_plan.start_pass(STATS_PLAN::DELAY_PASS);
+		delay_leveler.calculate_and_label_combinational_delay_levels(m_circuit, 
+													incremental_analyzer.get_known_levels());
+		stats_plan.finish_pass(STATS_PLAN::DELAY_PASS);
+	}
 
-	Logif(should_log,"Status: Doing sanity checks on the graph");
-	medic.check_sanity();
+	if (stats_plan.is_needed(STATS_PLAN::SANITY_PASS))
+	{
+		PROFILE_STAGE stage("sanity_check");
+		Logif(should_log,"Status: Doing sanity checks on the graph");
+		stats_plan.start_pass(STATS_PLAN::SANITY_PASS);
+		medic.check_sanity();
+		stats_plan.finish_pass(STATS_PLAN::SANITY_PASS);
+	}
 
-	// Logif(should_log,"Status: Partitioning");
-	// node_partitioner.partition_circuit(m_circuit);
+	if (stats_plan.is_needed(STATS_PLAN::PARTITION_PASS))
+	{
+		PROFILE_STAGE stage("partition");
+		Logif(should_log,"Status: Partitioning");
+		stats_plan.start_pass(STATS_PLAN::PARTITION_PASS);
+		node_partitioner.partition_circuit(m_circuit);
+		stats_plan.finish_pass(STATS_PLAN::PARTITION_PASS);
+	}
 
-	Logif(should_log, "Status: Calculating degree (fanin/fanout) stats");
-	m_circuit->calculate_degree_information();
+	if (stats_plan.is_needed(STATS_PLAN::DEGREE_PASS))
+	{
+		PROFILE_STAGE stage("degree_info");
+		Logif(should_log, "Status: Calculating degree (fanin/fanout) stats");
+		stats_plan.start_pass(STATS_PLAN::DEGREE_PASS);
+		m_circuit->calculate_degree_information();
+		stats_plan.finish_pass(STATS_PLAN::DEGREE_PASS);
+	}
 
 	// Logif(should_log, "Status: Final sanity check");
 	// m_circuit->final_sanity_check();
 
-	if (g_options->is_determine_wirelength_approx())
+	if (stats_plan.is_needed(STATS_PLAN::WIRELENGTH_PASS))
 	{
+		PROFILE_STAGE stage("wirelength");
 		Logif(should_log, "Status: Determining lowest wirelength_approx");
+		stats_plan.start_pass(STATS_PLAN::WIRELENGTH_PASS);
 		wirelength_characterizer.get_circuit_wirelength_approx(m_circuit);
+		stats_plan.finish_pass(STATS_PLAN::WIRELENGTH_PASS);
 	}
 
-	Logif(should_log, "Status: Analysis is complete");
+	if (is_incremental && g_options->is_verify_incremental())
+	{
+		Logif(should_log, "Status: Verifying the incremental analysis");
+		incremental_analyzer.verify();
+	}
 
-	Logif(should_log,"Status: Reporting Statistics");
-	statistic_reporter.report_stats(m_circuit);
+	Logif(should_log, "Status: Analysis is complete");
 
+	// drawn before the stats so that the profile in them has the drawing
 	if (g_options->is_draw_circuit())
 	{
+		PROFILE_STAGE stage("drawing");
 		Logif(should_log,"Status: Drawing Circuits");
 		drawer.draw_full_graph(m_circuit);
 	}
 
+	Logif(should_log,"Status: Reporting Statistics");
+	statistic_reporter.set_stats_plan(&stats_plan);
+	if (m_metrics)
+	{
+		statistic_reporter.collect_stats(m_circuit, *m_metrics);
+	}
+	else if (m_stats_stream)
+	{
+		statistic_reporter.report_stats(m_circuit, *m_stats_stream);
+	}
+	else
+	{
+		statistic_reporter.report_stats(m_circuit);
+	}
+
+	stats_plan.report_pass_times(m_circuit->get_nEdges());
+
+	if (g_profiler && ! g_options->get_trace_file_name().empty())
+	{
+		m_profiler.write_trace(g_options->get_trace_file_name());
+	}
+	g_profiler = 0;
+
 	Logif(should_log,"Status: Done");
 }
 
+//
+// Server mode. Keeps running and analyzes one circuit per request so that
+// callers do not pay for a new process for every circuit.
+//
+// With --incremental the circuit of each request is kept until the next 
+// one, so that only what has changed between the two is analyzed again.
+//
+// Each request is a single line on stdin:
+//		circuit.blif [Options...]
+// or, to send the circuit inline, 
+//		- [Options...]
+// followed by the BLIF text up to and including its .end line.
+//
+// The options of each request are applied on top of the options ccirc was
+// started with. The stats are written to stdout followed by a line
+// containing only SERVER_REPLY_END. All other output goes to stderr.
+//
+// PRE: g_options holds the server's options
+// POST: stdin has been exhausted or a 'quit' request was received
+//
+void CIRC_CONTROL::serve()
+{
+	assert(g_options);
+
+	const OPTIONS server_options(*g_options);
+	string request_line;
+
+	// keep stdout for the replies alone
+	ostream reply_stream(cout.rdbuf());
+	streambuf * cout_buffer = cout.rdbuf(cerr.rdbuf());
+
+	Log("ccirc: serving requests on stdin");
+
+	while (getline(cin, request_line))
+	{
+		if (! serve_request(request_line, server_options, reply_stream))
+		{
+			break;
+		}
+	}
+
+	*g_options = server_options;
+	cout.rdbuf(cout_buffer);
+}
+
+//
+// Analyze the circuit of a single request and write the reply
+//
+// PRE: request_line is the text of one request
+// POST: if the request named a circuit it has been analyzed, the reply 
+//       has been written and the circuit has been deleted, or kept as 
+//       the previous circuit in incremental mode
+// RETURNS: false if the server should stop, true otherwise
+//
+bool CIRC_CONTROL::serve_request
+(
+	const string & request_line,
+	const OPTIONS & server_options,
+	ostream & reply_stream
+)
+{
+	istringstream request(request_line);
+	vector<string> arguments;
+	vector<char *> argv;
+	string argument;
+	unsigned int argument_index;
+	bool is_analyzed = false;
+
+	arguments.push_back("ccirc");
+	while (request >> argument)
+	{
+		arguments.push_back(argument);
+	}
+
+	// skip blank lines and comments
+	if (arguments.size() == 1 || arguments[1][0] == '#')
+	{
+		return true;
+	}
+
+	if (arguments[1] == "quit" || arguments[1] == "exit")
+	{
+		return false;
+	}
+
+	for (argument_index = 0; argument_index < arguments.size(); argument_index++)
+	{
+		argv.push_back(const_cast<char *>(arguments[argument_index].c_str()));
+	}
+
+	// a failed request gets an error reply. it does not stop the server
+	try
+	{
+		// every request starts from the options the server was started with
+		*g_options = server_options;
+		g_options->process_options(static_cast<int>(argv.size()), &argv[0]);
+
+		string file_name = g_options->get_input_file_name();
+
+		if (file_name == "-")
+		{
+			m_input_file = read_inline_circuit();
+			if (! m_input_file)
+			{
+				Fail("Could not buffer the inline circuit");
+			}
+		}
+		else if (! file_name.empty())
+		{
+			m_input_file = try_to_open_file(file_name);
+		}
+
+		if (! m_input_file)
+		{
+			Fail("Cannot open input file '" << file_name << "'");
+		}
+
+		parse_input_file();
+
+		m_stats_stream = &reply_stream;
+		analyze_graphs();
+		is_analyzed = true;
+	}
+	catch (const CIRC_FAILURE & failure)
+	{
+		reply_stream << "error: " << failure.what() << endl;
+	}
+
+	m_stats_stream = 0;
+	reply_stream << SERVER_REPLY_END << endl;
+
+	// in incremental mode the circuit is kept to compare the next one to
+	if (is_analyzed && g_options->is_incremental())
+	{
+		delete m_previous_circuit;
+		m_previous_circuit = m_circuit;
+		m_circuit = 0;
+	}
+	else
+	{
+		delete_circuit();
+	}
+
+	if (! g_options->is_incremental())
+	{
+		delete m_previous_circuit;
+		m_previous_circuit = 0;
+	}
+
+	return true;
+}
+
+//
+// Read an inline circuit from stdin up to and including its .end line
+//
+// RETURNS: a rewound temporary file holding the circuit or NULL if the 
+//          temporary file could not be created
+//
+FILE * CIRC_CONTROL::read_inline_circuit()
+{
+	FILE * circuit_file = tmpfile();
+	string line;
+	string first_word;
+
+	if (! circuit_file)
+	{
+		return 0;
+	}
+
+	while (getline(cin, line))
+	{
+		fputs(line.c_str(), circuit_file);
+		fputc('\n', circuit_file);
+
+		istringstream line_stream(line);
+		if ((line_stream >> first_word) && first_word == ".end")
+		{
+			break;
+		}
+	}
+
+	rewind(circuit_file);
+
+	return circuit_file;
+}
+
+//
+// Batch mode. Analyzes many circuits in one run, up to -j of them at once.
+//
+// The batch is a file with one request per line, 'circuit.blif [Options...]'
+// as in server mode, or a quoted glob of circuit files.  Each circuit is 
+// read and analyzed by a task of its own with its own CIRC_CONTROL and its 
+// own copy of the options: the batch's with the line's on top.  A circuit 
+// is deleted as soon as its stats are out, so no more than -j circuits are
+// held at once.  The stats go to each circuit's .stats file or, with 
+// --batch_table, into one table with a row per circuit.
+//
+// What the passes log is dropped; a line on stdout says how each circuit 
+// went as it finishes.
+//
+// PRE: g_options holds the batch's options
+// RETURNS: the number of circuits that could not be analyzed
+//
+int CIRC_CONTROL::run_batch()
+{
+	assert(g_options);
+
+	const OPTIONS batch_options(*g_options);
+	const bool is_table = ! batch_options.get_batch_table_name().empty();
+	vector<vector<string> > requests;
+	vector<string> circuit_names,
+				   errors;
+	vector<METRICS> batch_metrics;
+	NUM_ELEMENTS nRequests = 0,
+				 request_index = 0,
+				 nFinished = 0,
+				 nFailed = 0;
+	mutex progress_mutex;
+	BATCH_CLOCK::time_point start = BATCH_CLOCK::now();
+
+	read_batch(batch_options.get_batch_name(), requests);
+
+	nRequests = static_cast<NUM_ELEMENTS>(requests.size());
+	if (nRequests == 0)
+	{
+		Fail("The batch '" << batch_options.get_batch_name() << "' names no circuits");
+	}
+
+	circuit_names.resize(nRequests);
+	errors.resize(nRequests);
+	batch_metrics.resize(is_table ? nRequests : 0);
+
+	// keep stdout for the progress alone, or for the stats with --out -
+	DISCARD_BUFFER discard_buffer;
+	ostream progress_stream(m_stats_stream ? cerr.rdbuf() : cout.rdbuf());
+	streambuf * cout_buffer = cout.rdbuf(&discard_buffer);
+
+	THREAD_POOL thread_pool(batch_options.get_nJobs());
+
+	thread_pool.run(nRequests, [&](NUM_ELEMENTS task_index, int)
+	{
+		OPTIONS circuit_options(batch_options);
+		OPTIONS * thread_options = g_options;
+		CIRC_CONTROL circ_control;
+		ostringstream circuit_stats;
+		vector<char *> argv;
+		unsigned int argument_index;
+		BATCH_CLOCK::time_point circuit_start = BATCH_CLOCK::now();
+
+		for (argument_index = 0; argument_index < requests[task_index].size(); argument_index++)
+		{
+			argv.push_back(const_cast<char *>(requests[task_index][argument_index].c_str()));
+		}
+
+		// the passes and the pools they start see this circuit's options
+		g_options = &circuit_options;
+
+		try
+		{
+			circuit_options.process_options(static_cast<int>(argv.size()), &argv[0]);
+			circuit_names[task_index] = circuit_options.get_circuit_name();
+
+			circ_control.read_circuits();
+
+			if (m_stats_stream)
+			{
+				circ_control.write_stats_to(&circuit_stats);
+			}
+
+			if (is_table)
+			{
+				circ_control.collect_stats(batch_metrics[task_index]);
+			}
+			else
+			{
+				circ_control.analyze_graphs();
+			}
+		}
+		catch (const CIRC_FAILURE & failure)
+		{
+			errors[task_index] = failure.what();
+		}
+
+		circ_control.delete_circuit();
+		g_options = thread_options;
+		g_profiler = 0;
+
+		{
+			unique_lock<mutex> lock(progress_mutex);
+
+			if (m_stats_stream)
+			{
+				// whole records, in the order the circuits finish
+				*m_stats_stream << circuit_stats.str() << flush;
+			}
+
+			progress_stream << "batch: [" << ++nFinished << "/" << nRequests << "] " << 
+				requests[task_index][1];
+			if (errors[task_index].empty())
+			{
+				progress_stream << " analyzed in " << 
+					chrono::duration<double>(BATCH_CLOCK::now() - circuit_start).count() << " s" << endl;
+			}
+			else
+			{
+				progress_stream << " failed: " << errors[task_index] << endl;
+			}
+		}
+	});
+
+	cout.rdbuf(cout_buffer);
+
+	for (request_index = 0; request_index < nRequests; request_index++)
+	{
+		nFailed += ! errors[request_index].empty();
+	}
+
+	if (is_table)
+	{
+		write_batch_table(batch_options.get_batch_table_name(), circuit_names, batch_metrics, errors);
+	}
+
+	Log("batch: " << nRequests - nFailed << " of " << nRequests << " circuits analyzed in " << 
+		chrono::duration<double>(BATCH_CLOCK::now() - start).count() << " s");
+
+	return static_cast<int>(nFailed);
+}
+
+//
+// PRE: batch_name is a file of requests or a glob of circuit files
+// POST: requests holds the arguments of each request, as if ccirc had 
+//       been run on it: the program name, the circuit and its options
+//
+void CIRC_CONTROL::read_batch
+(
+	const string & batch_name,
+	vector<vector<string> > & requests
+) const
+{
+	vector<string> arguments;
+	string line,
+		   argument;
+
+	requests.clear();
+
+#ifndef VISUAL_C
+	if (batch_name.find_first_of("*?[") != string::npos)
+	{
+		glob_t matches;
+		size_t match_index;
+
+		if (glob(batch_name.c_str(), 0, 0, &matches) == 0)
+		{
+			for (match_index = 0; match_index < matches.gl_pathc; match_index++)
+			{
+				arguments.clear();
+				arguments.push_back("ccirc");
+				arguments.push_back(matches.gl_pathv[match_index]);
+				requests.push_back(arguments);
+			}
+		}
+		globfree(&matches);
+		return;
+	}
+#endif
+
+	ifstream batch_file(batch_name.c_str());
+
+	if (! batch_file.is_open())
+	{
+		Fail("Cannot open the batch '" << batch_name << "'");
+	}
+
+	while (getline(batch_file, line))
+	{
+		istringstream request(line);
+
+		arguments.clear();
+		arguments.push_back("ccirc");
+		while (request >> argument)
+		{
+			arguments.push_back(argument);
+		}
+
+		// skip blank lines and comments
+		if (arguments.size() > 1 && arguments[1][0] != '#')
+		{
+			requests.push_back(arguments);
+		}
+	}
+}
+
+//
+// Write the stats of a batch as one tab separated table: a row for each 
+// circuit analyzed, a column for each stat.  A stat reported more than once
+// for a circuit gets a column for each time, numbered from the second.
+//
+// PRE: batch_metrics holds the stats of each circuit without an error
+// POST: the table has been written to table_name
+//
+void CIRC_CONTROL::write_batch_table
+(
+	const string & table_name,
+	const vector<string> & circuit_names,
+	const vector<METRICS> & batch_metrics,
+	const vector<string> & errors
+) const
+{
+	vector<string> column_names;
+	vector<map<string, double> > rows(batch_metrics.size());
+	map<string, int> nSeen;
+	map<string, double>::const_iterator value_iter;
+	METRICS::const_iterator metric_iter;
+	string column_name;
+	unsigned int row_index,
+				 column_index;
+
+	for (row_index = 0; row_index < batch_metrics.size(); row_index++)
+	{
+		nSeen.clear();
+		for (metric_iter = batch_metrics[row_index].begin(); metric_iter != batch_metrics[row_index].end(); 
+				metric_iter++)
+		{
+			column_name = metric_iter->first;
+			if (++nSeen[column_name] > 1)
+			{
+				column_name += "_" + util_long_to_string(nSeen[column_name]);
+			}
+
+			if (find(column_names.begin(), column_names.end(), column_name) == column_names.end())
+			{
+				column_names.push_back(column_name);
+			}
+			rows[row_index][column_name] = metric_iter->second;
+		}
+	}
+
+	ofstream table_file(table_name.c_str());
+
+	if (! table_file.is_open())
+	{
+		Fail("Could not open the batch table '" << table_name << "'");
+	}
+
+	table_file << "circuit";
+	for (column_index = 0; column_index < column_names.size(); column_index++)
+	{
+		table_file << "\t" << column_names[column_index];
+	}
+	table_file << "\n";
+
+	table_file << setprecision(10);
+	for (row_index = 0; row_index < rows.size(); row_index++)
+	{
+		if (! errors[row_index].empty())
+		{
+			continue;
+		}
+
+		table_file << circuit_names[row_index];
+		for (column_index = 0; column_index < column_names.size(); column_index++)
+		{
+			table_file << "\t";
+			value_iter = rows[row_index].find(column_names[column_index]);
+			if (value_iter != rows[row_index].end())
+			{
+				table_file << value_iter->second;
+			}
+		}
+		table_file << "\n";
+	}
+}
+
+//
+// PRE: nothing
+// POST: m_circuit and everything it owns has been deleted
+//
+void CIRC_CONTROL::delete_circuit()
+{
+	delete m_circuit;
+	m_circuit = 0;
+}
+
 
 
 // 
@@ -176,7 +904,7 @@ void CIRC_CONTROL::open_circuit_input_file()
 
 	if (file_name.empty()) 
 	{
-		exit(1);
+		Fail("No input file was given");
 	}
 	else
 	{
@@ -303,4 +1031,5 @@ FILE * CIRC_CONTROL::open_file
 void CIRC_CONTROL::close_circuit_input_file()
 {
 	fclose(m_input_file);
+	m_input_file = 0;
 }
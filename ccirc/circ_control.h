@@ -22,6 +22,8 @@
 
 #include "circ.h"
 #include "circuit.h"
+#include "statistic_reporter.h"
+#include "profiler.h"
 #include <cstdio>
 
 //
@@ -40,14 +42,37 @@ public:
 	CIRC_CONTROL & operator=(const CIRC_CONTROL & another_circ_control);
 	~CIRC_CONTROL();
 	void read_circuits();
+	void read_circuit(FILE * input_file);
+	void read_circuit(const char * blif_text, size_t length);
+	void use_circuit(CIRCUIT * circuit);
 	void analyze_graphs();
+	void collect_stats(METRICS & metrics);
+	void write_stats_to(ostream * stats_stream) { m_stats_stream = stats_stream; }
+	void delete_circuit();
+	void serve();
+	int run_batch();
 
 	void print_report_on_circuits();
 	void help();
 
 private:
 	CIRCUIT	*			m_circuit; 
+	CIRCUIT *			m_previous_circuit;	// kept after serving it in incremental mode
 	FILE * 				m_input_file;
+	ostream *			m_stats_stream;		// if set, stats go here instead of a file
+	METRICS *			m_metrics;			// if set, stats are collected here instead
+	PROFILER			m_profiler;			// the cost of the stages of the circuit
+
+	void parse_input_file();
+	void begin_profiling();
+
+	bool serve_request(const string & request_line, const OPTIONS & server_options,
+						ostream & reply_stream);
+	FILE * read_inline_circuit();
+
+	void read_batch(const string & batch_name, vector<vector<string> > & requests) const;
+	void write_batch_table(const string & table_name, const vector<string> & circuit_names,
+						const vector<METRICS> & batch_metrics, const vector<string> & errors) const;
 
 	void open_circuit_input_file();
 	FILE * try_to_open_file(const string & file_name);
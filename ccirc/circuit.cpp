@@ -22,6 +22,8 @@
 #include "circuit.h"
 #include "graph_medic.h"
 #include "drawer.h"
+#include "frozen_circuit.h"
+#include "traversal.h"
 #include <algorithm>
 using namespace std;
 
@@ -29,6 +31,14 @@ CIRCUIT::CIRCUIT()
 {
 	m_name				= "";
 
+	m_name_pool			= new NAME_POOL;
+	assert(m_name_pool);
+
+	m_arena				= new GRAPH_ARENA;
+	assert(m_arena);
+
+	m_frozen_circuit	= 0;
+
 	m_global_clock		= 0;
 
 	m_max_fan_in		= 0;
@@ -48,6 +58,9 @@ CIRCUIT::CIRCUIT(const CIRCUIT & another_circuit)
 {
 	assert(false);
 	m_name				= another_circuit.m_name;
+	m_name_pool			= another_circuit.m_name_pool;
+	m_arena				= another_circuit.m_arena;
+	m_frozen_circuit	= another_circuit.m_frozen_circuit;
 	m_max_fan_in		= another_circuit.m_max_fan_in;
 	m_PI				= another_circuit.m_PI;
 	m_PO				= another_circuit.m_PO;
@@ -67,6 +80,9 @@ CIRCUIT & CIRCUIT::operator=(const CIRCUIT & another_circuit)
 {
 	assert(false);
 	m_name				= another_circuit.m_name;
+	m_name_pool			= another_circuit.m_name_pool;
+	m_arena				= another_circuit.m_arena;
+	m_frozen_circuit	= another_circuit.m_frozen_circuit;
 	m_max_fan_in		= another_circuit.m_max_fan_in;
 	m_PI				= another_circuit.m_PI;
 	m_PO				= another_circuit.m_PO;
@@ -91,6 +107,7 @@ CIRCUIT::~CIRCUIT()
 	NODE * node;
 	CLUSTERS::iterator cluster_iter;
 	CLUSTER * cluster;
+	PORTS::iterator port_iter;
 
 	for (node_iter = m_nodes.begin(); node_iter != m_nodes.end(); node_iter++)
 	{
@@ -101,6 +118,9 @@ CIRCUIT::~CIRCUIT()
 
 	delete m_degree_info;
 	m_degree_info = 0;
+
+	delete m_frozen_circuit;
+	m_frozen_circuit = 0;
 	
 	delete m_sequential_level;
 	m_sequential_level = 0;
@@ -112,6 +132,61 @@ CIRCUIT::~CIRCUIT()
 
 		delete cluster;
 	}
+
+	// the primary inputs and the clock do not belong to any node
+	for (port_iter = m_PI.begin(); port_iter != m_PI.end(); port_iter++)
+	{
+		assert(*port_iter);
+		if (! (*port_iter)->get_my_node())
+		{
+			delete *port_iter;
+		}
+	}
+
+	if (m_global_clock && ! m_global_clock->get_my_node())
+	{
+		delete m_global_clock;
+	}
+	m_global_clock = 0;
+
+	// the nodes, ports and edges have been destroyed. 
+	// free their memory all at once
+	delete m_arena;
+	m_arena = 0;
+
+	// the ports and nodes refer to their names here so it goes last
+	delete m_name_pool;
+	m_name_pool = 0;
+}
+
+//
+// Builds the frozen (CSR) view of the graph that the analysis passes use.
+//
+// PRE: the graph will not change again (the medic and the cycle breaker are done)
+// POST: the circuit is frozen
+//
+void CIRCUIT::freeze()
+{
+	assert(! m_frozen_circuit);
+
+	m_frozen_circuit = new FROZEN_CIRCUIT(this);
+	assert(m_frozen_circuit);
+}
+
+//
+// PRE: name points to length characters
+// POST: the name is in the name pool
+// RETURNS: the interned name
+//
+NET_NAME CIRCUIT::intern_name
+(
+	const char * name,
+	const size_t & length
+)
+{
+	assert(m_name_pool);
+
+	return NET_NAME(m_name_pool, m_name_pool->intern(name, length));
 }
 
 //
@@ -141,7 +216,7 @@ PORTS CIRCUIT::get_PI_with_clock()
 //
 PORT *	CIRCUIT::create_and_add_external_port
 (
-	const string & port_name,
+	const NET_NAME & port_name,
 	const PORT::EXTERNAL_TYPE & external_type
 )
 {
@@ -152,7 +227,7 @@ PORT *	CIRCUIT::create_and_add_external_port
 	// making them outputs allows them to glue easily to the 
 	// PI of other graphs
 	
-	PORT * port = new PORT(port_name, PORT::EXTERNAL, PORT::OUTPUT, external_type);
+	PORT * port = new (m_arena) PORT(port_name, PORT::EXTERNAL, PORT::OUTPUT, external_type);
 	assert(port);
 
 	if (external_type == PORT::PI || external_type == PORT::GI)
@@ -319,88 +394,29 @@ void CIRCUIT::colour_graph
 (
 	const NODE::COLOUR_TYPE & colour
 )
-{
-
-	debugif(DCOLOUR, "Reseting the graph to colour " << static_cast<short>(colour));
-
-	// first colour the nodes to NONE to allow all the nodes to be coloured
-	// in the second part
-	colour_nodes(NODE::NONE);
-	
-	// Now colour the nodes the colour the user wants
-	colour_nodes(colour);
-}
-
-
-//
-// Do a DFS from the primary outputs, marking all nodes with the colour.  
-// 
-// PRE: all paths can be reach from the POs
-// POST: the graph has been coloured
-//
-void CIRCUIT::colour_nodes
-(
-	const NODE::COLOUR_TYPE & colour
-)
 {
 	PORTS::iterator port_iter;
 	PORT * output_port;
 	NODE * node;
 	NUM_ELEMENTS number_nodes = get_nNodes();
-	
+
+	// a new traversal sees every node as uncoloured so there is no need 
+	// to colour the graph NONE first
+	NODE_VISITS visits(colour == NODE::NONE ? NODE::UNMARKED : NODE::NONE);
+
+	debugif(DCOLOUR, "Colouring the graph " << static_cast<short>(colour));
+
 	for (port_iter = m_PO.begin(); port_iter != m_PO.end(); port_iter++)
 	{
 		output_port = *port_iter;
 		assert(output_port);
 
 		node = output_port->get_my_node();
-	
-		if (node->get_colour() != colour)
-		{
-			colour_up_from_node(node, colour, number_nodes);
-		}
+		number_nodes -= visits.colour_up_from_node(node, colour);
 	}
 	assert(number_nodes == 0);
 }
 
-// colour up from this node
-//
-// PRE: node is valid,
-//      number_nodes contains the number of nodes still to colour
-//      all paths can be reach from the POs
-// POST: all nodes up from this node have been coloured
-//
-void CIRCUIT::colour_up_from_node
-(
-	NODE * node,
-	const NODE::COLOUR_TYPE & colour,
-	NUM_ELEMENTS & number_nodes
-)
-{
-	PORTS	input_ports;
-	NODE *			output_node;
-	PORTS::iterator port_iter;
-
-	assert(node);
-	node->set_colour(colour);
-	number_nodes--;
-
-	debugif(DCOLOUR, node->get_name() << " = marked " << static_cast<short>(colour) );
-
-	input_ports = node->get_input_ports();
-
-	for (port_iter = input_ports.begin(); port_iter != input_ports.end(); port_iter++) 
-	{
-		assert(*port_iter);
-		output_node = (*port_iter)->get_node_that_fanout_to_me();
-
-		if (output_node && output_node->get_colour() != colour)
-		{
-			colour_up_from_node(output_node, colour, number_nodes);
-		}
-	}
-}
-
 // create a dff 
 // only to be used once the graph is complete
 //
@@ -418,6 +434,7 @@ NODE * CIRCUIT::create_dff
 	NODE * node = 0;
 	PORT * input_port = 0;
 	PORT * clock_port = 0;
+	NET_NAME dff_name = intern_name(new_dff_name);
 
 	debug("Creating a sequential node with node name : " << new_dff_name << " and input name " << input_port_name);
 
@@ -426,15 +443,17 @@ NODE * CIRCUIT::create_dff
 		Fail("Trying to create dff.  No global clock exists.  Please create one.");
 	}
 
-	node = create_node(new_dff_name, NODE::SEQ);
+	node = create_node(dff_name, NODE::SEQ);
 
-	node->create_and_add_port(new_dff_name, PORT::INTERNAL, PORT::OUTPUT, PORT::NONE);
+	node->create_and_add_port(dff_name, PORT::INTERNAL, PORT::OUTPUT, PORT::NONE);
 
-	input_port = node->create_and_add_port(new_dff_name, PORT::INTERNAL, PORT::INPUT, PORT::NONE);
-
-	clock_port = node->create_and_add_port(m_global_clock->get_name(), 
+	// the clock port goes first, as in flip-flops read from the netlist,
+	// so that get_clock_port and get_D_port find them
+	clock_port = node->create_and_add_port(m_global_clock->get_net_name(), 
 											PORT::INTERNAL, PORT::CLOCK, PORT::NONE);
 
+	input_port = node->create_and_add_port(dff_name, PORT::INTERNAL, PORT::INPUT, PORT::NONE);
+
 	// connect the global clock to the clock port
 	create_edge(m_global_clock, clock_port, 1);
 
@@ -460,7 +479,7 @@ EDGE * CIRCUIT::create_edge
 {
 	assert(source_port && sink_port);
 
-	EDGE * new_edge = new EDGE(source_port, sink_port, length);
+	EDGE * new_edge = new (m_arena) EDGE(source_port, sink_port, length);
 	assert(new_edge);
 
 	source_port->add_edge(new_edge);
@@ -516,14 +535,14 @@ void CIRCUIT::remove_and_delete_edge
 //
 NODE * CIRCUIT::create_node
 (
-	const string & node_name,
+	const NET_NAME & node_name,
 	const NODE::NODE_TYPE & node_type
 )
 {
 	NODE * node;
 	debugif(DCODE, "Creating a node with name = " << node_name);
 
-	node = new NODE(node_name, node_type);
+	node = new (m_arena) NODE(node_name, node_type, m_arena);
 	assert(node);
 
 	increment_node_count(node);
@@ -21,6 +21,7 @@
 #define circuit_H
 
 class CIRCUIT;
+class FROZEN_CIRCUIT;
 
 #include "circ.h"
 #include "sequential_level.h"
@@ -51,12 +52,12 @@ public:
 	// circuit creation methods
 	void	set_name(const string & new_name) { m_name = new_name;}
 	PORT *	add_external_port(PORT * port, const PORT::EXTERNAL_TYPE & external_type);
-	PORT *	create_and_add_external_port(const string & port_name, const PORT::EXTERNAL_TYPE & external_type);
+	PORT *	create_and_add_external_port(const NET_NAME & port_name, const PORT::EXTERNAL_TYPE & external_type);
 	void 	remove_external_port(PORT * port_to_remove);
 	void 	set_external_ports(PORTS & new_ports, PORT::IO_DIRECTION io_direction);
 
 	NODE *	create_dff(const string & new_dff_name, const string & input_port_name);
-	NODE * 	create_node(const string & node_name, const NODE::NODE_TYPE & node_type);
+	NODE * 	create_node(const NET_NAME & node_name, const NODE::NODE_TYPE & node_type);
 	EDGE * 	create_edge(PORT * source_port,PORT * sink_port,const LENGTH_TYPE & length);
 	void 	remove_and_delete_edge(PORT * source_port, PORT * sink_port,
 									EDGE * edge_to_delete);
@@ -64,6 +65,17 @@ public:
 	void	set_global_clock(PORT * new_global_clock);
 	void	erase_global_clock() { m_global_clock = 0; }
 
+	// the names of the ports and nodes are interned in the circuit's name pool
+	NET_NAME	intern_name(const char * name, const size_t & length);
+	NET_NAME	intern_name(const string & name) { return intern_name(name.data(), name.size()); }
+	NAME_POOL *	get_name_pool() { return m_name_pool; }
+	GRAPH_ARENA *	get_arena() { return m_arena; }
+
+	// once the graph is final the analysis passes work on a frozen view of it
+	void	freeze();
+	bool	is_frozen() const { return (m_frozen_circuit != 0); }
+	FROZEN_CIRCUIT *	get_frozen_circuit() { return m_frozen_circuit; }
+
 
 	// cluster methods
 	void 	construct_clusters(const NUM_ELEMENTS & number_of_partitions);
@@ -121,6 +133,9 @@ public:
 	void	final_sanity_check();
 private:
 	string 				m_name;			// the name of the circuit	
+	NAME_POOL *			m_name_pool;	// the names of the ports and nodes
+	GRAPH_ARENA *		m_arena;		// the memory of the nodes, ports and edges
+	FROZEN_CIRCUIT *	m_frozen_circuit;	// the CSR view, once the graph is final
 	PORTS				m_PI;			// the collection of primary inputs
 	PORTS				m_PO;			// the collection of primary ouputs
 	PORT *				m_global_clock;	// in addition to being in the PO	
@@ -143,8 +158,6 @@ private:
 	double				m_scaled_cost;
 	COST_TYPE			m_wirelength_approx;
 
-	void	colour_nodes(const NODE::COLOUR_TYPE & colour);
-	void 	colour_up_from_node(NODE * node, const NODE::COLOUR_TYPE & colour, NUM_ELEMENTS & number_nodes);
 	void	decrement_node_count(NODE * node);
 	void	increment_node_count(NODE * node);
 
@@ -52,6 +52,13 @@ CYCLE_BREAKER::~CYCLE_BREAKER()
 
 //
 // Detects and breaks any combinational cycles that may exist in the graph
+//
+// A PI whose search finds no cycle leaves the nodes it explored black.
+// Nothing down from a black node is on a cycle, so they stay black for 
+// the search from the next PI rather than being explored again.  
+// Breaking a cycle changes the graph, so the search then starts over 
+// with every node white.
+//
 // PRE: circuit is valid
 // POST: all combinational cycles have been broken
 //
@@ -67,6 +74,9 @@ void CYCLE_BREAKER::break_cycles
 	NODE_PTR_LIST next_nodes;
 	PORTS PI;
 
+	// all the nodes start unexplored
+	NODE_VISITS visits(NODE::WHITE);
+
 	m_number_new_dff = 0;
 	m_number_moved_edges = 0;
 	m_circuit = circuit;
@@ -81,11 +91,8 @@ void CYCLE_BREAKER::break_cycles
 		debugsepif(DCYCLE);
 		debugif(DCYCLE,"Looking for a cycle in the graph");
 		
-		// colour all the nodes as unexplored
-		m_circuit->colour_graph(NODE::WHITE);
-
 		// find and break cycles in the graph
-		found_cycle = find_and_break_cycles(*port_iter, next_nodes, 0);
+		found_cycle = find_and_break_cycles(visits, *port_iter, next_nodes);
 
 		// if we didn't find a cycle look to the next PI, 
 		if (! found_cycle)
@@ -96,8 +103,9 @@ void CYCLE_BREAKER::break_cycles
 		}
 		else
 		{
-			// we didn't find a cycle. don't look to the next PI.
+			// we found a cycle. don't look to the next PI.
 			// see if we have further cycles
+			visits.restart();
 			show_breaking_cycles_warning();
 		}
 	}
@@ -108,7 +116,7 @@ void CYCLE_BREAKER::break_cycles
 }
 
 /*
- **  Search the graph, looking for a cycle, from specified node.
+ **  Search the graph, looking for a cycle, from specified port.
  **
  **  Variation on the white/grey/black algorithm (see CLR book).  Do
  **  a DFS, with unexplored nodes white, active nodes grey and explored
@@ -119,35 +127,79 @@ void CYCLE_BREAKER::break_cycles
 
 bool CYCLE_BREAKER::find_and_break_cycles
 (
+	NODE_VISITS & visits,
+	PORT * output_port,
+	NODE_PTR_LIST & next_nodes
+)
+{
+	bool found_cycle = false;
+
+	found_cycle = find_cycle_down_from_port(visits, output_port, next_nodes);
+
+	if (! found_cycle)
+	{
+		found_cycle = find_cycle_in_path_from_seq_nodes(visits, next_nodes);
+	}
+
+	return found_cycle;
+}
+
+//
+// The DFS through the combinational fanout of the port.  Each port on 
+// the stack is a grey node, or the start, and resumes at its next edge
+// when the nodes below it are done.
+//
+// PRE: the nodes are coloured for this search
+// POST: if a cycle was found it was broken, otherwise the combinational 
+//       fanout is black and the dffs found are in next_nodes
+// RETURNS: whether a cycle was found
+//
+bool CYCLE_BREAKER::find_cycle_down_from_port
+(
+	NODE_VISITS & visits,
 	PORT * output_port,
-	NODE_PTR_LIST & next_nodes,
-	DEPTH_TYPE depth
+	NODE_PTR_LIST & next_nodes
 )
 {
-	EDGES output_edges;
-	EDGES::iterator edge_iter;
+	FANOUT_STACK stack;
+	NUM_ELEMENTS edge_index;
 	EDGE * output_edge;
 	NODE * node_in_fanout;
-	PORT * node_in_fanout_output_port;
 	NODE::COLOUR_TYPE colour;
-	bool found_cycle = false;
 
-	// get the edges that fanout from the output port
 	assert(output_port);
-	output_edges = output_port->get_edges();
-
-	debugif(DCYCLE,"Looking at fanout from port " << output_port->get_name()); 
+	stack.push_back(FANOUT_FRAME(output_port, 0));
 
-	// explore all these edges 
-	for (edge_iter = output_edges.begin(); edge_iter != output_edges.end(); edge_iter++)
+	while (! stack.empty())
 	{
-		output_edge = (*edge_iter);
+		output_port = stack.back().first;
+		edge_index = stack.back().second;
+
+		if (edge_index == output_port->get_nEdges())
+		{
+			// all the fanout of this node has been explored
+			stack.pop_back();
+			if (! stack.empty())
+			{
+				debugif(DCYCLE,"Marking " << output_port->get_my_node()->get_name() << " as black");
+				visits.set_colour(output_port->get_my_node(), NODE::BLACK);
+			}
+			continue;
+		}
+		stack.back().second++;
+
+		if (edge_index == 0)
+		{
+			debugif(DCYCLE,"Looking at fanout from port " << output_port->get_name()); 
+		}
+
+		output_edge = output_port->get_edge(edge_index);
 		assert(output_edge);
 
 		node_in_fanout = output_edge->get_sink_node();
 		assert(node_in_fanout);
 
-		colour = node_in_fanout->get_colour();
+		colour = visits.get_colour(node_in_fanout);
 
 		// what colour is the node that we fanout too?
 	
@@ -170,19 +222,10 @@ bool CYCLE_BREAKER::find_and_break_cycles
 			}
 			else
 			{
-				debugif(DCYCLE,"...marking " << node_in_fanout->get_name() << " as grey");
-				node_in_fanout->set_colour(NODE::GREY);
-				node_in_fanout_output_port = node_in_fanout->get_output_port();
-
 				// look for cycles that fanout from this node
-				found_cycle = find_and_break_cycles(node_in_fanout_output_port, next_nodes,depth+1);
-				if (found_cycle)
-				{
-					debugif(DCYCLE,"returning...");
-					return true;
-				}
-				debugif(DCYCLE,"Marking " << node_in_fanout->get_name() << " as black");
-				node_in_fanout->set_colour(NODE::BLACK);
+				debugif(DCYCLE,"...marking " << node_in_fanout->get_name() << " as grey");
+				visits.set_colour(node_in_fanout, NODE::GREY);
+				stack.push_back(FANOUT_FRAME(node_in_fanout->get_output_port(), 0));
 			}
 		}
 		else if (colour == NODE::GREY)
@@ -201,27 +244,26 @@ bool CYCLE_BREAKER::find_and_break_cycles
 		}
 	}
 
-	// we only get here if a cycle wasn't found above
-	assert(! found_cycle);
-
-	found_cycle = find_cycle_in_path_from_seq_nodes(next_nodes, depth);
-
-	return found_cycle;
+	return false;
 }
 
 //
 // look for cycles that exists in the fanout from the flip-flops
+//
+// The dffs are searched in the order they were found.  Searching a dff
+// can queue more of them.
+//
 bool CYCLE_BREAKER::find_cycle_in_path_from_seq_nodes
 (
-	NODE_PTR_LIST & next_nodes,
-	DEPTH_TYPE depth
+	NODE_VISITS & visits,
+	NODE_PTR_LIST & next_nodes
 )
 {
 	PORT * seq_node_output_port;
 	NODE * seq_node;
 	bool found_cycle = false;
 
-	while (depth == 0 && ! next_nodes.empty())
+	while (! next_nodes.empty())
 	{
 		seq_node = next_nodes.front();
 		next_nodes.pop_front();
@@ -230,10 +272,10 @@ bool CYCLE_BREAKER::find_cycle_in_path_from_seq_nodes
 		debugsepif(DCYCLE);
 		debugif(DCYCLE,"Working from sequential node " << seq_node->get_name());
 		debugif(DCYCLE,"...marking " << seq_node->get_name() << " as black");
-		seq_node->set_colour(NODE::BLACK);
+		visits.set_colour(seq_node, NODE::BLACK);
 
 		seq_node_output_port = seq_node->get_output_port();
-		found_cycle = find_and_break_cycles(seq_node_output_port, next_nodes, 0);
+		found_cycle = find_cycle_down_from_port(visits, seq_node_output_port, next_nodes);
 
 		if (found_cycle)
 		{
@@ -304,7 +346,7 @@ void CYCLE_BREAKER::break_cycle_by_adding_dff
 		m_number_new_dff++;
 	}
 	// rename the destination input port with the name of the output node
-	destination_input_port->set_name(dff_to_insert->get_name());
+	destination_input_port->set_name(dff_to_insert->get_net_name());
 
 	show_added_dff_warning();
 }
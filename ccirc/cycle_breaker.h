@@ -22,6 +22,7 @@
 
 #include "circuit.h"
 #include "circ.h"
+#include "traversal.h"
 
 //
 // Class_name CYCLE_BREAKER
@@ -46,8 +47,9 @@ private:
 
 	bool			m_shown_breaking_cycles_warning;
 
-	bool 	find_and_break_cycles(PORT * output_port, NODE_PTR_LIST & next_nodes, DEPTH_TYPE depth);
-	bool	find_cycle_in_path_from_seq_nodes(NODE_PTR_LIST & next_nodes, DEPTH_TYPE depth);
+	bool 	find_and_break_cycles(NODE_VISITS & visits, PORT * output_port, NODE_PTR_LIST & next_nodes);
+	bool	find_cycle_down_from_port(NODE_VISITS & visits, PORT * output_port, NODE_PTR_LIST & next_nodes);
+	bool	find_cycle_in_path_from_seq_nodes(NODE_VISITS & visits, NODE_PTR_LIST & next_nodes);
 	NODE *  find_latch_in_fanout(PORT * output_port);
 	void 	break_cycle_by_adding_dff(PORT * source_port, EDGE * edge_to_break);
 
@@ -21,6 +21,11 @@
 
 #include "degree_info.h"
 #include <math.h>
+#include <numeric>
+
+static NUM_ELEMENTS _sum_of_degrees(const NUM_ELEMENTS_VECTOR & histogram);
+static NUM_ELEMENTS _maximum_degree(const NUM_ELEMENTS_VECTOR & histogram);
+static NUM_ELEMENTS _count_at_least(const NUM_ELEMENTS_VECTOR & histogram, const double & degree);
 
 DEGREE_INFO::DEGREE_INFO()
 {
@@ -112,7 +117,7 @@ DEGREE_INFO::~DEGREE_INFO()
 // Calcuate the degree information for the total circuit 
 // that will be put into a .stats file 
 //
-// PRE: circuit is valid
+// PRE: circuit is valid and frozen
 // POST: info has been calculated 
 //
 void DEGREE_INFO::calculate_degree_information_for_circuit
@@ -120,19 +125,27 @@ void DEGREE_INFO::calculate_degree_information_for_circuit
 	CIRCUIT * circuit
 )
 {
-	assert(circuit);
+	assert(circuit && circuit->is_frozen());
+
+	FROZEN_CIRCUIT * frozen_circuit = circuit->get_frozen_circuit();
+	NUM_ELEMENTS nPI = 0;
+
+	// the histograms come out of the same pass as the shapes
+	frozen_circuit->calculate_statistics();
 
-	NODES & nodes = circuit->get_nodes();
-	PORTS pi = circuit->get_PI();
+	const DEGREE_HISTOGRAMS & histograms = frozen_circuit->get_statistics().get_degree_histograms();
+	const NUM_ELEMENTS_VECTOR & pi_fanout = histograms.get_pi_fanout();
 
-	m_number_of_pi		= static_cast<double>(pi.size());
+	nPI = accumulate(pi_fanout.begin(), pi_fanout.end(), nPI);
+
+	m_number_of_pi		= static_cast<double>(nPI);
 	m_number_of_nodes	= static_cast<double>(circuit->get_nNodes());
 	m_number_of_comb	= static_cast<double>(circuit->get_nComb());
 	m_number_of_dff		= static_cast<double>(circuit->get_nDFF());
 
 	m_dff_exist = (circuit->get_nDFF() > 0);
 
-	calculate_degree_information(nodes, pi);
+	calculate_degree_information(histograms);
 }
 
 //
@@ -151,6 +164,39 @@ void DEGREE_INFO::calculate_degree_information_for_cluster
 
 	NODES & nodes 	= cluster->get_nodes();
 	PORTS pi		  		= cluster->get_PI();
+	DEGREE_HISTOGRAMS histograms;
+	NODES::const_iterator node_iter;
+	NODE * node = 0;
+	PORTS::const_iterator port_iter;
+	PORT * port = 0;
+
+	for (node_iter = nodes.begin(); node_iter != nodes.end(); node_iter++)
+	{
+		node = *node_iter;
+		assert(node);
+
+		if (node->get_type() == NODE::COMB)
+		{
+			histograms.add_comb(node->get_fanout_degree(), node->get_fanin_degree());
+		}
+		else
+		{
+			assert(node->get_type() == NODE::SEQ);
+
+			histograms.add_dff(node->get_fanout_degree());
+		}
+	}
+
+	for (port_iter = pi.begin(); port_iter != pi.end(); port_iter++)
+	{
+		port = *port_iter;
+		assert(port);
+
+		if (port->get_io_direction() != PORT::CLOCK)
+		{
+			histograms.add_pi(port->get_fanout_degree());
+		}
+	}
 
 	m_number_of_pi		= static_cast<double>(cluster->get_nPI());
 	m_number_of_nodes	= static_cast<double>(cluster->get_nNodes());
@@ -159,18 +205,18 @@ void DEGREE_INFO::calculate_degree_information_for_cluster
 
 	m_dff_exist			= (cluster->get_nDFF() > 0);
 
-	calculate_degree_information(nodes, pi);
+	calculate_degree_information(histograms);
 }
 //
 // Calculates the degree information for nodes and pi 
 //
-// PRE: nodes and pi parameters contain the things we want to calculate for
+// PRE: histograms count the nodes and the non-clock pi we want to 
+//      calculate for at each degree
 // POST: inform has been calculated
 //  
 void DEGREE_INFO::calculate_degree_information
 (
-	NODES & nodes,
-	PORTS & pi
+	const DEGREE_HISTOGRAMS & histograms
 )
 {
 	NUM_ELEMENTS total_comb_fanin	= 0;
@@ -178,87 +224,52 @@ void DEGREE_INFO::calculate_degree_information
 	NUM_ELEMENTS total_dff_fanout	= 0;
 	NUM_ELEMENTS total_pi_fanout	= 0;
 
-	sum_node_totals(nodes, total_comb_fanout, total_dff_fanout, total_comb_fanin);
-	sum_pi_totals(pi, total_pi_fanout); 
+	sum_node_totals(histograms, total_comb_fanout, total_dff_fanout, total_comb_fanin);
+	sum_pi_totals(histograms.get_pi_fanout(), total_pi_fanout); 
 
 	calculate_averages(total_comb_fanout, total_dff_fanout, total_pi_fanout, total_comb_fanin);
 
-	calculate_std_deviations(nodes, pi);
-	find_high_degree_fanout_nodes(nodes);
-	find_high_degree_fanout_pi(pi);
+	calculate_std_deviations(histograms);
+	find_high_degree_fanout_nodes(histograms);
+	find_high_degree_fanout_pi(histograms.get_pi_fanout());
 }
 
 
 // Finds fanin and fanout sums
 // 
-// PRE: nodes contains the nodes that we want to calculate for.
+// PRE: histograms count the nodes that we want to calculate for.
 // POST: total_comb_fanout,total_dff_fanout,total_comb_fanin have been calculated
 //
 void DEGREE_INFO::sum_node_totals
 (
-	const NODES & nodes,
+	const DEGREE_HISTOGRAMS & histograms,
 	NUM_ELEMENTS & total_comb_fanout,
 	NUM_ELEMENTS & total_dff_fanout,
 	NUM_ELEMENTS & total_comb_fanin
 )
 {
-	NODES::const_iterator node_iter;
-	NODE * node = 0;
-
-
-	NUM_ELEMENTS fanout_degree = 0;
-
-	for (node_iter = nodes.begin(); node_iter != nodes.end(); node_iter++)
-	{
-		node = *node_iter;
-		assert(node);
-
-		fanout_degree = node->get_fanout_degree();
-
-		m_maximum_fanout = MAX(m_maximum_fanout, fanout_degree);
+	total_comb_fanout	+= _sum_of_degrees(histograms.get_comb_fanout());
+	total_comb_fanin	+= _sum_of_degrees(histograms.get_comb_fanin());
+	total_dff_fanout	+= _sum_of_degrees(histograms.get_dff_fanout());
 
-		if (node->get_type() == NODE::COMB)
-		{
-			total_comb_fanout += fanout_degree;
-			total_comb_fanin  += node->get_fanin_degree();
-		}
-		else
-		{
-			assert(node->get_type() == NODE::SEQ);
-
-			total_dff_fanout += fanout_degree;
-		}
-	}
+	m_maximum_fanout = MAX(m_maximum_fanout, _maximum_degree(histograms.get_comb_fanout()));
+	m_maximum_fanout = MAX(m_maximum_fanout, _maximum_degree(histograms.get_dff_fanout()));
 }
 
 // Finds the total pi fanout
 // 
-// PRE: pi contains the PIs that we want to calculate for.
+// PRE: pi_fanout counts the PIs that we want to calculate for at each fanout.
 // POST: total_pi_fanout has been calculated
 //
 void DEGREE_INFO::sum_pi_totals
 (
-	const PORTS & pi,
+	const NUM_ELEMENTS_VECTOR & pi_fanout,
 	NUM_ELEMENTS & total_pi_fanout
 )
 {
-	PORTS::const_iterator port_iter;
-	PORT * port = 0;
-	NUM_ELEMENTS pi_fanout = 0;
-
-	for (port_iter = pi.begin(); port_iter != pi.end(); port_iter++)
-	{
-		port = *port_iter;
-		assert(port);
+	total_pi_fanout += _sum_of_degrees(pi_fanout);
 
-		if (port->get_io_direction() != PORT::CLOCK)
-		{
-			pi_fanout = port->get_fanout_degree();
-			total_pi_fanout += pi_fanout;
-
-			m_maximum_fanout = MAX(m_maximum_fanout, pi_fanout);
-		}
-	}
+	m_maximum_fanout = MAX(m_maximum_fanout, _maximum_degree(pi_fanout));
 }
 
 
@@ -295,65 +306,24 @@ void DEGREE_INFO::calculate_averages
 //
 // Calculates the std. deviations of the fanin/fanout
 //
-// PRE: nodes and pi parameters contains the things we want to calculate for
+// The squares are summed once per degree, times the number of things 
+// with that degree.
+//
+// PRE: histograms count the things we want to calculate for
 // POST: std. dev. have been calculated
 //
 void DEGREE_INFO::calculate_std_deviations
 (
-	const NODES & nodes,
-	const PORTS & pi
+	const DEGREE_HISTOGRAMS & histograms
 )
 {
-
-	NODES::const_iterator node_iter;
-	NODE * node = 0;
-	PORTS::const_iterator port_iter;
-	PORT * port = 0;
-
-	// decided to make the totals a double because i think it might be better to have 
-	// avg - data_point to be in double instead of long
-	double fanout_degree = 0.0;
-	double total_sq_comb_fanout = 0.0;
-	double total_sq_dff_fanout = 0.0;
-	double total_sq_pi_fanout = 0.0;
-	double total_sq_fanout = 0.0;
-	double total_sq_fanin = 0.0;
-
-	
-	for (node_iter = nodes.begin(); node_iter != nodes.end(); node_iter++)
-	{
-		node = *node_iter;
-		assert(node);
-
-		fanout_degree = node->get_fanout_degree();
-
-		if (node->get_type() == NODE::COMB)
-		{
-			total_sq_comb_fanout += square(m_avg_fanout_for_comb - fanout_degree);
-			total_sq_fanin  += square(m_avg_fanin_for_comb - node->get_fanin_degree());
-		}
-		else
-		{
-			assert(node->get_type() == NODE::SEQ);
-			total_sq_dff_fanout += square(m_avg_fanout_for_dff - fanout_degree);
-		}
-		
-		total_sq_fanout += square(m_avg_fanout -  fanout_degree);
-
-	}
-
-	for (port_iter = pi.begin(); port_iter != pi.end(); port_iter++)
-	{
-		port = *port_iter;
-		assert(port);
-
-		if (port->get_io_direction() != PORT::CLOCK)
-		{
-			fanout_degree = port->get_fanout_degree();
-			total_sq_pi_fanout += square(m_avg_fanout_for_pi -  fanout_degree);
-			total_sq_fanout += square(m_avg_fanout - fanout_degree);
-		}
-	}
+	double total_sq_comb_fanout = sum_of_squares(histograms.get_comb_fanout(), m_avg_fanout_for_comb);
+	double total_sq_dff_fanout	= sum_of_squares(histograms.get_dff_fanout(), m_avg_fanout_for_dff);
+	double total_sq_pi_fanout	= sum_of_squares(histograms.get_pi_fanout(), m_avg_fanout_for_pi);
+	double total_sq_fanin		= sum_of_squares(histograms.get_comb_fanin(), m_avg_fanin_for_comb);
+	double total_sq_fanout		= sum_of_squares(histograms.get_comb_fanout(), m_avg_fanout) +
+								  sum_of_squares(histograms.get_dff_fanout(), m_avg_fanout) +
+								  sum_of_squares(histograms.get_pi_fanout(), m_avg_fanout);
 
 	if (m_dff_exist)
 	{
@@ -374,53 +344,19 @@ void DEGREE_INFO::calculate_std_deviations
 // a) Above 10
 // b) One std. deviation above the average
 //
-// PRE: nodes contains the nodes we want to calculate for
+// PRE: histograms count the nodes we want to calculate for
 // POST: m_10plus_degree_comb and m_high_degree_comb have been calculated
 //
 void DEGREE_INFO::find_high_degree_fanout_nodes
 (
-	const NODES & nodes
+	const DEGREE_HISTOGRAMS & histograms
 )
 {
-	NODES::const_iterator node_iter;
-	NODE * node = 0;
+	m_10plus_degree_comb	+= _count_at_least(histograms.get_comb_fanout(), 10);
+	m_high_degree_comb		+= _count_at_least(histograms.get_comb_fanout(), m_avg_fanout + m_std_dev_fanout);
 
-	NUM_ELEMENTS fanout_degree = 0;
-
-	for (node_iter = nodes.begin(); node_iter != nodes.end(); node_iter++)
-	{
-		node = *node_iter;
-		assert(node);
-
-		fanout_degree = node->get_fanout_degree();
-
-		if (node->get_type() == NODE::COMB)
-		{
-			if (fanout_degree >= 10)
-			{
-				m_10plus_degree_comb++;
-			}
-			if (fanout_degree >= m_avg_fanout + m_std_dev_fanout)
-			{
-				m_high_degree_comb++;
-			}
-
-		}
-		else
-		{
-			assert(node->get_type() == NODE::SEQ);
-
-			if (fanout_degree >= 10)
-			{
-				m_10plus_degree_dff++;
-			}
-			if (fanout_degree >= m_avg_fanout + m_std_dev_fanout)
-			{
-				m_high_degree_dff++;
-			}
-		}
-
-	}
+	m_10plus_degree_dff		+= _count_at_least(histograms.get_dff_fanout(), 10);
+	m_high_degree_dff		+= _count_at_least(histograms.get_dff_fanout(), m_avg_fanout + m_std_dev_fanout);
 }
 
 // 
@@ -428,39 +364,41 @@ void DEGREE_INFO::find_high_degree_fanout_nodes
 // a) Above 10
 // b) One std. deviation above the average
 //
-// PRE: pi contains the primary inputs we want to calculate for
+// PRE: pi_fanout counts the primary inputs we want to calculate for at each fanout
 // POST: m_10plus_degree_pi and m_high_degree_pi have been calculated
 //
 void DEGREE_INFO::find_high_degree_fanout_pi
 (
-	const PORTS & pi
+	const NUM_ELEMENTS_VECTOR & pi_fanout
 )
 {
-	PORTS::const_iterator port_iter;
-	PORT * port = 0;
-	NUM_ELEMENTS pi_fanout = 0;
+	m_10plus_degree_pi	+= _count_at_least(pi_fanout, 10);
+	m_high_degree_pi	+= _count_at_least(pi_fanout, m_avg_fanout + m_std_dev_fanout);
+}
 
-	for (port_iter = pi.begin(); port_iter != pi.end(); port_iter++)
-	{
-		port = *port_iter;
-		assert(port);
+//
+// RETURNS: the sum of the squared differences from average of the degrees 
+//          counted in histogram
+//
+double DEGREE_INFO::sum_of_squares
+(
+	const NUM_ELEMENTS_VECTOR & histogram,
+	const double & average
+)
+{
+	NUM_ELEMENTS_VECTOR::size_type degree;
+	double total_sq = 0.0;
 
-		if (port->get_io_direction() != PORT::CLOCK)
+	for (degree = 0; degree < histogram.size(); degree++)
+	{
+		if (histogram[degree] > 0)
 		{
-			pi_fanout = port->get_fanout_degree();
-
-			if (pi_fanout >= 10)
-			{
-				m_10plus_degree_pi++;
-			}
-			if (pi_fanout >= m_avg_fanout + m_std_dev_fanout)
-			{
-				m_high_degree_pi++;
-			}
+			total_sq += histogram[degree] * square(average - static_cast<double>(degree));
 		}
 	}
-}
 
+	return total_sq;
+}
 
 
 // returns arg*arg
@@ -472,3 +410,57 @@ double DEGREE_INFO::square
 	return arg*arg;
 }
 
+
+// RETURNS: the sum of the degrees counted in histogram
+static NUM_ELEMENTS _sum_of_degrees
+(
+	const NUM_ELEMENTS_VECTOR & histogram
+)
+{
+	NUM_ELEMENTS_VECTOR::size_type degree;
+	NUM_ELEMENTS total = 0;
+
+	for (degree = 0; degree < histogram.size(); degree++)
+	{
+		total += static_cast<NUM_ELEMENTS>(degree) * histogram[degree];
+	}
+
+	return total;
+}
+
+// RETURNS: the largest degree counted in histogram, 0 if there are none
+static NUM_ELEMENTS _maximum_degree
+(
+	const NUM_ELEMENTS_VECTOR & histogram
+)
+{
+	NUM_ELEMENTS degree = static_cast<NUM_ELEMENTS>(histogram.size()) - 1;
+
+	while (degree > 0 && histogram[degree] == 0)
+	{
+		degree--;
+	}
+
+	return MAX(degree, 0);
+}
+
+// RETURNS: the number counted in histogram with a degree >= degree
+static NUM_ELEMENTS _count_at_least
+(
+	const NUM_ELEMENTS_VECTOR & histogram,
+	const double & degree
+)
+{
+	NUM_ELEMENTS_VECTOR::size_type index;
+	NUM_ELEMENTS count = 0;
+
+	for (index = 0; index < histogram.size(); index++)
+	{
+		if (static_cast<double>(index) >= degree)
+		{
+			count += histogram[index];
+		}
+	}
+
+	return count;
+}
@@ -25,6 +25,7 @@ class DEGREE_INFO;
 #include "circ.h"
 #include "circuit.h"
 #include "cluster.h"
+#include "frozen_circuit.h"
 
 //
 // Class_name DEGREE_INFO
@@ -33,6 +34,11 @@ class DEGREE_INFO;
 //
 //		Calculates the fanin/fanout degree for circuits and clusters.
 //		Also serves as the repository of such information
+//
+//		The nodes are counted by degree into DEGREE_HISTOGRAMS (by the 
+//		statistics pass of the frozen circuit, or from the nodes of a 
+//		cluster) and the statistics are found from the histograms, so the 
+//		nodes are only looked at once.
 //		
 
 
@@ -106,21 +112,21 @@ private:
 	DISTRIBUTION	m_fanin_distribution;
 
 
-	void calculate_degree_information(NODES & list_of_nodes, PORTS & pi);
+	void calculate_degree_information(const DEGREE_HISTOGRAMS & histograms);
 
-	void sum_node_totals(const NODES & list_of_nodes, NUM_ELEMENTS & total_comb_fanout, 
+	void sum_node_totals(const DEGREE_HISTOGRAMS & histograms, NUM_ELEMENTS & total_comb_fanout, 
 						NUM_ELEMENTS & total_dff_fanout, NUM_ELEMENTS & total_comb_fanin);
-	void sum_pi_totals(const PORTS & pi, NUM_ELEMENTS & total_pi_fanout);
+	void sum_pi_totals(const NUM_ELEMENTS_VECTOR & pi_fanout, NUM_ELEMENTS & total_pi_fanout);
 	void calculate_averages(const NUM_ELEMENTS & total_comb_fanin,
 							const NUM_ELEMENTS & total_comb_fanout,
 							const NUM_ELEMENTS & total_dff_fanout,
 							const NUM_ELEMENTS & total_pi_fanout);
-	void calculate_std_deviations(const NODES & list_of_nodes, const PORTS & pi);
+	void calculate_std_deviations(const DEGREE_HISTOGRAMS & histograms);
 
-	void find_high_degree_fanout_nodes(const NODES & list_of_nodes);
-	void find_high_degree_fanout_pi(const PORTS & pi);
+	void find_high_degree_fanout_nodes(const DEGREE_HISTOGRAMS & histograms);
+	void find_high_degree_fanout_pi(const NUM_ELEMENTS_VECTOR & pi_fanout);
 
-	
+	double sum_of_squares(const NUM_ELEMENTS_VECTOR & histogram, const double & average);
 	double square(const double & arg);
 };
 
@@ -18,20 +18,25 @@
 
 
 
-
 #include "delay_leveler.h"
+#include "thread_pool.h"
+
+// the nodes labelled by one task of the sweep
+const NUM_ELEMENTS LEVEL_SWEEP_CHUNK = 4096;
 
 DELAY_LEVELER::DELAY_LEVELER()
 {
 	m_max_combinational_delay = -1;
 
 	m_circuit = 0;
+	m_frozen_circuit = 0;
 }
 DELAY_LEVELER::DELAY_LEVELER(const DELAY_LEVELER & another_delay_leveler)
 {
 	assert(false);
 	m_max_combinational_delay	= another_delay_leveler.m_max_combinational_delay;
 	m_circuit					= another_delay_leveler.m_circuit;
+	m_frozen_circuit			= another_delay_leveler.m_frozen_circuit;
 }
 
 DELAY_LEVELER & DELAY_LEVELER::operator=(const DELAY_LEVELER & another_delay_leveler)
@@ -40,6 +45,7 @@ DELAY_LEVELER & DELAY_LEVELER::operator=(const DELAY_LEVELER & another_delay_lev
 
 	m_max_combinational_delay	= another_delay_leveler.m_max_combinational_delay;
 	m_circuit					= another_delay_leveler.m_circuit;
+	m_frozen_circuit			= another_delay_leveler.m_frozen_circuit;
 
 	return (*this);
 }
@@ -51,7 +57,7 @@ DELAY_LEVELER::~DELAY_LEVELER()
 //
 // Calculate and label the nodes in the graph with their delay level
 //
-// PRE:  circuit is valid
+// PRE:  circuit is valid and frozen
 // POST: Each node has its delay level labelled
 //       Edge edge has its length labelled
 //       The maximum combinational delay of the circuit has been found
@@ -62,314 +68,200 @@ void DELAY_LEVELER::calculate_and_label_combinational_delay_levels
 	CIRCUIT * circuit
 )
 {
-	assert(circuit);
-	m_circuit = circuit;
-
-	SEQUENTIAL_LEVEL * sequential_level = m_circuit->get_sequential_level();
-	assert(sequential_level);
-
-	debug("Status: Beginning combinational delay analysis.");
-
-	m_circuit->colour_graph(NODE::UNMARKED);
-
-	calculate_and_label_combinational_delay_for_sequential_level(sequential_level);
-
-	// add the primary inputs and nodes to the sequential level datastructure
-	add_primary_inputs_to_0th_sequential_level(sequential_level);
-	add_nodes_to_sequential_level(sequential_level);
-
-	label_edges_with_length();
-
-	check_sanity();
-
-	debug("Status: Combinational delay analysis is complete.");
+	calculate_and_label_combinational_delay_levels(circuit, DELAYS());
 }
 
-
-
 //
-// 	
-// 	Calculate and label each node in the graph with its delay level.
+// As above but the levels of some nodes are already known
 //
-//	PRE: sequential_level is valid
-//	POST: all nodes have their delay level labelled
-//	      the max_combinational_delay of the sequential level has been found and set
-
-void DELAY_LEVELER::calculate_and_label_combinational_delay_for_sequential_level
+// The levels are found in one pass over the topological order of the frozen 
+// circuit.  Everything else is done in a single sweep over the nodes grouped 
+// by level, the wavefronts of that order: labelling the nodes and the edges 
+// into them, checking the levels and placing the nodes in the delay levels 
+// of the sequential level.
+//
+// PRE:  circuit is valid and frozen
+//       known_levels is empty or holds the level of each node in frozen 
+//       order, UNKNOWN_DELAY_LEVEL if it is not known
+// POST: as above
+//
+void DELAY_LEVELER::calculate_and_label_combinational_delay_levels
 (
-	SEQUENTIAL_LEVEL * sequential_level
+	CIRCUIT * circuit,
+	const DELAYS & known_levels
 )
 {
-	NODES::iterator node_iter;
-	NODE * top_node = 0;
-	NODE_PTR_DEQUE nodes_to_find_delay_for;
-	NODE * node = 0;
-	NODES top_nodes = m_circuit->get_top_nodes();
-	m_max_combinational_delay = 0;
+	assert(circuit && circuit->is_frozen());
+	m_circuit = circuit;
+	m_frozen_circuit = circuit->get_frozen_circuit();
+
+	SEQUENTIAL_LEVEL * sequential_level = m_circuit->get_sequential_level();
+	DELAYS levels;
+	DELAY_LEVELS delay_levels;
 
 	assert(sequential_level);
 
-	label_all_dff_with_0_delay();
+	debug("Status: Beginning combinational delay analysis.");
 
-	for (node_iter = top_nodes.begin(); node_iter != top_nodes.end(); node_iter++)
-	{
-		top_node = *node_iter;
-		assert(top_node);
+	find_levels(m_frozen_circuit, known_levels, levels, m_max_combinational_delay);
 
-		if (top_node->get_type() == NODE::SEQ)
-		{
-			// if the node is connected to a SEQ 
-			// it should already have its delay and colour set
-			assert(	top_node->get_colour() == NODE::MARKED &&
-					top_node->get_max_comb_delay_level() == 0);
-		}
-		else
-		{
-			// the node is combinational
-	
-			// put the node on the queue of nodes we need to find delay for
-			nodes_to_find_delay_for.push_back(top_node);
+	// this also groups the nodes by level
+	m_frozen_circuit->set_levels(levels, m_max_combinational_delay);
+	sequential_level->set_max_combinational_delay(m_max_combinational_delay);
 
-			// continue to find the delay level of nodes until the queue of nodes is empty
-			while (! nodes_to_find_delay_for.empty())
-			{
-				// pop a node off the stack
-				node = nodes_to_find_delay_for.front();
-				nodes_to_find_delay_for.pop_front();
-
-				// if it is unmarked look for its delay level
-				if (node->get_colour() == NODE::UNMARKED)
-				{
-					find_comb_delay_of_node(node, nodes_to_find_delay_for);
-				}
-			}
-		}
-	}
+	sweep_levels(delay_levels);
 
-	// set the maximum combinational delay we saw during labelling
-	sequential_level->set_max_combinational_delay(m_max_combinational_delay);
+	// add the primary inputs and nodes to the sequential level datastructure
+	sequential_level->add_frozen_circuit(m_frozen_circuit, delay_levels);
+
+	debug("Status: Combinational delay analysis is complete.");
 }
 
 //
-// Find and set the delay level of the node
-// 
-// PRE: node is valid
-// POST: the delay level of this nodes has been set and the delay level of all nodes in the fanin
-//       of this node has been set
+// Find the delay level of each node without labelling anything
 //
-void DELAY_LEVELER::find_comb_delay_of_node
+// PRE: the nodes of frozen_circuit are in topological order
+//      known_levels is empty or holds a level or UNKNOWN_DELAY_LEVEL 
+//      for each node
+// POST: levels holds the delay level of each node in frozen order
+//       max_level is the largest of them
+//
+void DELAY_LEVELER::find_levels
 (
-	NODE * node,
-	NODE_PTR_DEQUE & nodes_to_find_delay_for
+	FROZEN_CIRCUIT * frozen_circuit,
+	const DELAYS & known_levels,
+	DELAYS & levels,
+	DELAY_TYPE & max_level
 )
 {
-	assert(node && node->get_colour() == NODE::UNMARKED);
-
-	PORTS input_ports = node->get_input_ports();
-	PORTS::iterator port_iter;
-	PORT * port = 0;
-	DELAY_TYPE max_comb_delay_of_fanin = 0;
-	NODE * fanin_node = 0;
+	assert(frozen_circuit);
 
-	// push the unmarked fanout onto the queue
-	get_unmarked_fanout(node, nodes_to_find_delay_for);
+	NODE_INDEX nNodes = frozen_circuit->get_nNodes();
+	NODE_INDEX node = 0;
+	bool is_any_known = ! known_levels.empty();
 
-	// look for the maximum combinational delay of the fanin 
-	for (port_iter = input_ports.begin(); port_iter != input_ports.end(); port_iter++)
-	{
-		port = *port_iter;
+	assert(! is_any_known || static_cast<NODE_INDEX>(known_levels.size()) == nNodes);
 
-		fanin_node = port->get_node_that_fanout_to_me();
+	m_frozen_circuit = frozen_circuit;
+	levels.assign(nNodes, 0);
+	max_level = 0;
 
-		// note: if the fanin node is NULL it is a PI 
-		// We don't care about PI because their combinational delay is 0 
-		// and we are looking for the maximum combinational delay
-		if (fanin_node)
+	for (node = 0; node < nNodes; node++)
+	{
+		if (m_frozen_circuit->is_comb(node))
 		{
-			// if the node is combinational then it might have combinal delay 
-			// else the node is a dff and does not have combinational delay
-			if (fanin_node->get_type() == NODE::COMB)
+			if (is_any_known && known_levels[node] != UNKNOWN_DELAY_LEVEL)
 			{
-
-				// if this node has not had its delay level calculated. calculate it.
-				if (fanin_node->get_colour() == NODE::UNMARKED)
-				{
-					find_comb_delay_of_node(fanin_node, nodes_to_find_delay_for);
-				}
-			
-				// the fanin node should now have its max combinational delay determined
-				assert(fanin_node->get_colour() == NODE::MARKED && fanin_node->get_max_comb_delay_level() >= 0);
-				
-				max_comb_delay_of_fanin = MAX(max_comb_delay_of_fanin, fanin_node->get_max_comb_delay_level());
+				levels[node] = known_levels[node];
 			}
-				
+			else
+			{
+				levels[node] = 1 + get_max_comb_delay_level_of_fanin(levels, node);
+			}
+
+			max_level = MAX(max_level, levels[node]);
 		}
 	}
-
-	node->set_max_comb_delay_level(max_comb_delay_of_fanin+1);
-	node->set_colour(NODE::MARKED);
-
-	m_max_combinational_delay = MAX(m_max_combinational_delay, max_comb_delay_of_fanin+1);
 }
 
 //
-// gets all unmarked nodes in the fanout of this node and 
+// Label the nodes and edges with their levels, wavefront by wavefront, in 
+// chunks spread over the threads.  The levels are all known so no wavefront 
+// waits for the one before.
 //
-// PRE: node is valid
-// POST: all unmarked combinational nodes in the fanin of this node are 
-//       enqueued in nodes_to_find_delay_for
+// PRE: the frozen circuit has its levels and its nodes grouped by level
+// POST: each node has its delay level and is coloured as marked
+//       each edge is labelled with the number of delay levels it crosses
+//       delay_levels holds the nodes of each level in the order of the circuit
+//       the levels have been checked against the fanin
 //
-void DELAY_LEVELER::get_unmarked_fanout
+void DELAY_LEVELER::sweep_levels
 (
-	NODE * node, 
-	NODE_PTR_DEQUE & nodes_to_find_delay_for
+	DELAY_LEVELS & delay_levels
 )
 {
+	assert(m_frozen_circuit);
 
-	assert(node);
-
-	EDGES output_edges = node->get_output_edges();
-	EDGES::iterator edge_iter;
-	EDGE * edge = 0;
-	NODE * fanout_node = 0;
+	NUM_ELEMENTS nNodes = m_frozen_circuit->get_nNodes();
+	NUM_ELEMENTS nTasks = (nNodes + LEVEL_SWEEP_CHUNK - 1) / LEVEL_SWEEP_CHUNK;
+	DELAY_TYPE level = 0;
 
-	for (edge_iter = output_edges.begin(); edge_iter != output_edges.end(); edge_iter++)
+	delay_levels.resize(m_max_combinational_delay + 1);
+	for (level = 0; level <= m_max_combinational_delay; level++)
 	{
-		edge = *edge_iter;
-		assert(edge);
-
-		fanout_node = edge->get_sink_node();
-		assert(fanout_node);
-
-		if (fanout_node->get_colour() == NODE::UNMARKED  && fanout_node->get_type() == NODE::COMB)
-		{
-			nodes_to_find_delay_for.push_back(fanout_node);
-		}
-		else
-		{
-			// the node should either be a dff or MARKED
-			assert( fanout_node->get_type() == NODE::SEQ || fanout_node->get_colour() == NODE::UNMARKED);
-		}
+		delay_levels[level].resize(m_frozen_circuit->get_level_size(level));
 	}
-}
 
-//
-// sanity check on the circuit to make sure everything is ok
-//
-// PRE: circuit is valid
-// POST: all nodes have their delay level checked
-//
-void DELAY_LEVELER::check_sanity() const
-{
-	assert(m_circuit);
+	THREAD_POOL thread_pool(static_cast<int>(MAX(1, MIN(g_options->get_nThreads(), nTasks))));
 
-	NODES & nodes = m_circuit->get_nodes();
-	NODES::const_iterator node_iter;
-	NODE * node = 0;
-	DELAY_TYPE node_comb_delay = -1;
-
-	for (node_iter = nodes.begin(); node_iter != nodes.end(); node_iter++)
+	thread_pool.run(nTasks, [&](NUM_ELEMENTS task, int)
 	{
-		node = *node_iter;
-		assert(node);
-
-		node_comb_delay = node->get_max_comb_delay_level();
+		label_nodes_by_level(task * LEVEL_SWEEP_CHUNK, MIN(nNodes, (task + 1) * LEVEL_SWEEP_CHUNK), 
+							delay_levels);
+	});
 
-
-		if (node->get_type() == NODE::SEQ)
-		{
-			assert(node_comb_delay == 0);
-		}
-		else
-		{
-			assert(node->get_colour() == NODE::MARKED);
-			assert(node_comb_delay == 1 + get_max_comb_delay_level_of_fanin(node));
-		}
-	}
-
-
-    debug("Sanity checks on delay levels done (successful) ...");
-}	
+	debug("Sanity checks on delay levels done (successful) ...");
+}
 
 //
-// Find the max combinational delay of the fanin to this node
+// Label the nodes from first to last in the order by level, and the edges 
+// into them.  For edges that connect to the input of a flip-flop label that 
+// edge of length 0, the edges of the pi (and the clock) are as long as the 
+// delay level of their sink.
 //
-// PRE: node is valid
-// Returns: the maximum combinational delay of the fanin
+// PRE: the frozen circuit has its levels and its nodes grouped by level
+//      delay_levels has room for the nodes of each level
+// POST: the nodes, the edges into them and their places in delay_levels 
+//       have been labelled
 //
-LEVEL_TYPE DELAY_LEVELER::get_max_comb_delay_level_of_fanin
+void DELAY_LEVELER::label_nodes_by_level
 (
-	const NODE * node
+	const NUM_ELEMENTS & first,
+	const NUM_ELEMENTS & last,
+	DELAY_LEVELS & delay_levels
 ) const
 {
+	const NODE_INDEXES & nodes_by_level = m_frozen_circuit->get_nodes_by_level();
+	const DELAYS & levels = m_frozen_circuit->get_levels();
+	const NODE_INDEX * source_iter;
+	NUM_ELEMENTS position = 0;
+	NUM_ELEMENTS fanin_position = 0;
+	NODE_INDEX node = 0;
+	NODE_INDEX source = NO_NODE_INDEX;
+	NODE * circuit_node = 0;
+	DELAY_TYPE level = 0;
+	DELAY_TYPE source_level = 0;
+	DELAY_TYPE max_fanin_level = 0;
+	LENGTH_TYPE edge_length = 0;
+	bool is_comb = false;
 
-	assert(node);
-
-	PORTS input_ports = node->get_input_ports();
-	PORTS::const_iterator port_iter;
-	PORT * port = 0;
-	DELAY_TYPE max_comb_delay = 0;
-	NODE * fanin_node = 0;
-
-
-	// look at the combinational delay of the fanin
-	for (port_iter = input_ports.begin(); port_iter != input_ports.end(); port_iter++)
+	for (position = first; position < last; position++)
 	{
-		port = *port_iter;
+		node = nodes_by_level[position];
+		level = levels[node];
+		is_comb = m_frozen_circuit->is_comb(node);
 
-		fanin_node = port->get_node_that_fanout_to_me();
+		circuit_node = m_frozen_circuit->get_node(node);
+		assert(circuit_node);
 
-		if (fanin_node)
-		{
-			if (fanin_node->get_type() == NODE::COMB)
-			{
-				max_comb_delay = MAX(max_comb_delay, fanin_node->get_max_comb_delay_level());
-			}
-		}
-	}
-
-	return max_comb_delay;
-}
+		circuit_node->set_max_comb_delay_level(level);
+		circuit_node->set_colour(NODE::MARKED);
+		delay_levels[level][position - m_frozen_circuit->get_level_position(level)] = circuit_node;
 
+		// a source of NO_NODE_INDEX is a PI and, like a dff, has no combinational delay
+		max_fanin_level = 0;
+		fanin_position = m_frozen_circuit->get_fanin_position(node);
 
-
-//
-// Label each edge in the graph with the number of delay levels it crosses
-// For edges that connect to the input of a flip-flop label that edge of length 0.
-//
-// PRE: circuit is valid
-//      nodes have their delay level labelled
-// POST: all edges in the circuit have their length labelled
-//
-void DELAY_LEVELER::label_edges_with_length()
-{
-	assert(m_circuit);
-	EDGES & edges =  m_circuit->get_edges();
-	EDGES::const_iterator edge_iter;
-	EDGE * edge = 0;
-	NODE * source_node = 0;
-	NODE * sink_node = 0;
-	LENGTH_TYPE edge_length = 0;
-	DELAY_TYPE source_delay = 0;
-	DELAY_TYPE sink_delay = 0;
-
-
-	for (edge_iter = edges.begin(); edge_iter != edges.end(); edge_iter++)
-	{
-		edge = *edge_iter;
-		assert(edge);
-
-		source_node = edge->get_source_node();
-		sink_node = edge->get_sink_node();
-
-		if (source_node)
+		for (source_iter = m_frozen_circuit->fanin_begin(node); 
+			 source_iter != m_frozen_circuit->fanin_end(node); source_iter++, fanin_position++)
 		{
-			if (sink_node->get_type() == NODE::COMB)
-			{
-				source_delay = source_node->get_max_comb_delay_level();
-				sink_delay = sink_node->get_max_comb_delay_level();
+			source = *source_iter;
+			source_level = (source != NO_NODE_INDEX && m_frozen_circuit->is_comb(source)) ? levels[source] : 0;
 
-				edge_length = sink_delay - source_delay;
+			if (is_comb)
+			{
+				max_fanin_level = MAX(max_fanin_level, source_level);
+				edge_length = level - source_level;
 			}
 			else
 			{
@@ -377,94 +269,50 @@ void DELAY_LEVELER::label_edges_with_length()
 				// the length of this edge is 0
 				edge_length = 0;
 			}
-		}
-		else
-		{
-			// we have a pi
 
-			sink_delay = sink_node->get_max_comb_delay_level();
+			assert(edge_length >= 0);
 
-			edge_length = sink_delay;
+			m_frozen_circuit->get_fanin_edge(fanin_position)->set_length(edge_length);
 		}
 
-		assert(edge_length >= 0);
-
-		edge->set_length(edge_length);
+		// sanity check of the level
+		assert(is_comb ? (level == 1 + max_fanin_level) : (level == 0));
 	}
 }
 
 //
-// Label all the dff with a combinational delay of 0
-//
-// PRE: circuit is valid
-// POST: all dff have a combinational delay of 0 and have been coloured as 
-//       marked
-void DELAY_LEVELER::label_all_dff_with_0_delay()
-{
-	assert(m_circuit);
-	NODES dff_list = m_circuit->get_dffs();
-	NODES::iterator node_iter;
-	NODE * node = 0;
-
-	for (node_iter = dff_list.begin(); node_iter != dff_list.end(); node_iter++)
-	{
-		node = *node_iter;
-		assert(node);
-		assert(node->get_type() == NODE::SEQ);
-		node->set_max_comb_delay_level(0);
-		node->set_colour(NODE::MARKED);
-	}
-}
-
+// Find the max combinational delay of the fanin to this node
 //
-// add the nodes to the sequential level datastructure
-// which organizes the nodes by delay level
+// PRE: node is valid
+//      levels holds the delay level of the fanin of the node
+// Returns: the maximum combinational delay of the fanin
 //
-// PRE: each node has its delay level defined
-// POST: sequential_level has all the nodes in the circuit organized by delay level
-// 
-void DELAY_LEVELER::add_nodes_to_sequential_level
+LEVEL_TYPE DELAY_LEVELER::get_max_comb_delay_level_of_fanin
 (
-	SEQUENTIAL_LEVEL*  sequential_level
-)
+	const DELAYS & levels,
+	const NODE_INDEX & node
+) const
 {
-	assert(m_circuit);
+	assert(m_frozen_circuit);
 
-	NODES & nodes = m_circuit->get_nodes();
-	NODES::iterator node_iter;
-	NODE * node = 0;
+	const NODE_INDEX * source_iter;
+	NODE_INDEX source = NO_NODE_INDEX;
+	DELAY_TYPE max_comb_delay = 0;
 
-	for (node_iter = nodes.begin(); node_iter != nodes.end(); node_iter++)
+	// look at the combinational delay of the fanin
+	// note: a source of NO_NODE_INDEX is a PI and has no combinational delay
+	for (source_iter = m_frozen_circuit->fanin_begin(node); 
+		 source_iter != m_frozen_circuit->fanin_end(node); source_iter++)
 	{
-		node = *node_iter;
-		assert(node);
+		source = *source_iter;
 
-		sequential_level->add_node(node);
+		if (source != NO_NODE_INDEX && m_frozen_circuit->is_comb(source))
+		{
+			// the topological order puts the fanin first
+			assert(source < node);
+			max_comb_delay = MAX(max_comb_delay, levels[source]);
+		}
 	}
 
-}
-
-// 
-// add the primary inputs to the sequential level datastructure
-//
-// PRE: seq_level_0 is valid
-// POST: PIs have been added to seq_level_0
-//
-void DELAY_LEVELER::add_primary_inputs_to_0th_sequential_level
-(
-	SEQUENTIAL_LEVEL * seq_level_0
-)
-{
-
-	PORTS primary_inputs = m_circuit->get_PI();
-	PORTS::iterator port_iter;
-	PORT * port = 0;
-
-	for (port_iter = primary_inputs.begin(); port_iter != primary_inputs.end(); port_iter++)
-	{
-		port = *port_iter;
-		assert(port);
-
-		seq_level_0->add_primary_input(port);
-	}
+	return max_comb_delay;
 }
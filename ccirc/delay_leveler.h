@@ -22,6 +22,7 @@
 
 #include "circ.h"
 #include "circuit.h"
+#include "frozen_circuit.h"
 
 //
 // Class_name DELAY_LEVELER
@@ -30,7 +31,18 @@
 //
 // 		Calculates the combinational delay levels for all nodes in the circuit
 //
+//		The levels are found in one pass over the frozen circuit: its nodes 
+//		are in topological order so the fanin of a node always has its level
+//		before the node is reached.  The nodes, the edges and the delay 
+//		levels of the sequential level are then labelled in one sweep over 
+//		the wavefronts of that order, on --threads threads.
 //
+//		The level of a node can be given in known_levels (in frozen order) 
+//		when it is already known, e.g. from the previous circuit in 
+//		incremental mode; UNKNOWN_DELAY_LEVEL marks the ones to calculate.
+//
+
+const DELAY_TYPE UNKNOWN_DELAY_LEVEL = -1;
 
 
 class DELAY_LEVELER
@@ -42,22 +54,21 @@ public:
 	~DELAY_LEVELER();
 
 	void calculate_and_label_combinational_delay_levels(CIRCUIT * circuit);
+	void calculate_and_label_combinational_delay_levels(CIRCUIT * circuit, const DELAYS & known_levels);
+
+	void find_levels(FROZEN_CIRCUIT * frozen_circuit, const DELAYS & known_levels, 
+					DELAYS & levels, DELAY_TYPE & max_level);
 
 private:
 	CIRCUIT * 	m_circuit;
+	FROZEN_CIRCUIT * m_frozen_circuit;
 	DELAY_TYPE 	m_max_combinational_delay;
 
-	void calculate_and_label_combinational_delay_for_sequential_level(SEQUENTIAL_LEVEL * sequential_level);
-	void get_unmarked_fanout(NODE * node, NODE_PTR_DEQUE & nodes_to_find_delay_for);
-												
-	void label_all_dff_with_0_delay();
-	void label_edges_with_length();
-	void find_comb_delay_of_node(NODE * node, NODE_PTR_DEQUE & nodes_to_find_delay_for);
+	void sweep_levels(DELAY_LEVELS & delay_levels);
+	void label_nodes_by_level(const NUM_ELEMENTS & first, const NUM_ELEMENTS & last,
+							DELAY_LEVELS & delay_levels) const;
 
-	void add_nodes_to_sequential_level(SEQUENTIAL_LEVEL* sequential_level);
-	void add_primary_inputs_to_0th_sequential_level(SEQUENTIAL_LEVEL * seq_level_0);
-	LEVEL_TYPE get_max_comb_delay_level_of_fanin(const NODE * node) const;
-	void check_sanity() const;
+	LEVEL_TYPE get_max_comb_delay_level_of_fanin(const DELAYS & levels, const NODE_INDEX & node) const;
 };
 
 
@@ -39,7 +39,6 @@ EDGE::EDGE (const EDGE & another_edge)
 	m_source 		= another_edge.m_source;
 	m_destination 	= another_edge.m_destination;
 	m_length 		= another_edge.m_length;
-	m_name			= another_edge.m_name;
 }
 
 EDGE & EDGE::operator=(const EDGE & another_edge)
@@ -47,24 +46,9 @@ EDGE & EDGE::operator=(const EDGE & another_edge)
 	m_source 		= another_edge.m_source;
 	m_destination 	= another_edge.m_destination;
 	m_length 		= another_edge.m_length;
-	m_name			= another_edge.m_name;
 
 	return (*this);
 }
-EDGE::EDGE
-(
-	PORT * source_port, 
-	PORT * sink_port, 
-	const string & edge_name, 
-	const LENGTH_TYPE& length
-)
-{
-	m_source 		= source_port;
-	m_destination 	= sink_port;
-	m_name 			= edge_name;
-	m_length		= length;
-}
-
 EDGE::EDGE
 (
 	PORT * source_port, 
@@ -72,17 +56,12 @@ EDGE::EDGE
 	const LENGTH_TYPE&  length
 )
 {
-	NODE * sink_node;
-
 	m_source 		= source_port;
 	m_destination 	= sink_port;
 	m_length		= length;
 
 	assert(m_destination);
-	sink_node = m_destination->get_my_node();
-	assert(sink_node);
-	
-	m_name 	= get_edge_name(sink_node->get_name(), source_port->get_name());
+	assert(m_destination->get_my_node());
 }
 
 EDGE::~EDGE()
@@ -105,6 +84,19 @@ NODE * EDGE::get_source_node() const
 	return (m_source->get_my_node());
 }
 
+//
+// The name is only needed for messages so it is built on demand
+//
+// RETURNS: the name of the edge
+//
+string EDGE::get_name() const
+{
+	NODE * sink_node = get_sink_node();
+	assert(sink_node && m_source);
+
+	return get_edge_name(sink_node->get_name(), m_source->get_name());
+}
+
 //
 // RETURNS: a name for the edge
 //
@@ -342,69 +334,88 @@ LENGTH_TYPE EDGE::get_inter_cluster_distance() const
 
 NODE::NODE()
 {
+	m_arena			=	0;
 	m_type			=	NODE::COMB;
-	m_name			= 	"";
 	m_output_port	=	0;
 
 	m_delay_level	=	-1;
 	m_colour_mark	=	NODE::UNMARKED;
+	m_visit_epoch	=	0;
 
 	m_lut			=	0;
 
 	m_horizontal_position = 0;
+	m_frozen_index	= NO_NODE_INDEX;
 }
 
 
-NODE::NODE(const string & node_name)
+NODE::NODE(const NET_NAME & node_name)
 {
+	m_arena			=	0;
 	m_name			= 	node_name;
 	m_type			=	NODE::COMB;
 	m_output_port	=	0;
 	m_delay_level	=	-1;
 	m_lut			=	0;
 	m_colour_mark	=	NODE::UNMARKED;
+	m_visit_epoch	=	0;
 	
 	m_horizontal_position = 0;
+	m_frozen_index	= NO_NODE_INDEX;
 }
 
-NODE::NODE(const string & node_name, const NODE::NODE_TYPE & node_type)
+NODE::NODE
+(
+	const NET_NAME & node_name, 
+	const NODE::NODE_TYPE & node_type,
+	GRAPH_ARENA * arena
+)
 {
+	m_arena			=	arena;
 	m_name			= 	node_name;
 	m_type			=	node_type;
 	m_output_port	=	0;
 	m_delay_level	=	-1;
 	m_lut			=	0;
 	m_colour_mark	=	NODE::UNMARKED;
+	m_visit_epoch	=	0;
 
 	m_horizontal_position = 0;
+	m_frozen_index	= NO_NODE_INDEX;
 }
 
 NODE::NODE(const NODE  & another_node)
 {
+	m_arena				= another_node.m_arena;
 	m_type				= another_node.m_type;
 	m_name				= another_node.m_name;
 	m_input_ports		= another_node.m_input_ports;
 	m_output_port		= another_node.m_output_port;
 	m_delay_level		= another_node.m_delay_level;
 	m_colour_mark		= another_node.m_colour_mark;
+	m_visit_epoch		= another_node.m_visit_epoch;
 	m_lut				= another_node.m_lut;
 	m_cluster_number	= another_node.m_cluster_number;
 	m_sub_cluster_numbers	= another_node.m_sub_cluster_numbers;
 	m_horizontal_position = another_node.m_horizontal_position;
+	m_frozen_index		= another_node.m_frozen_index;
 }
 
 NODE& NODE::operator=(const NODE  & another_node)
 {
+	m_arena				= another_node.m_arena;
 	m_type				= another_node.m_type;
 	m_name				= another_node.m_name;
 	m_input_ports		= another_node.m_input_ports;
 	m_output_port		= another_node.m_output_port;
 	m_delay_level		= another_node.m_delay_level;
 	m_colour_mark		= another_node.m_colour_mark;
+	m_visit_epoch		= another_node.m_visit_epoch;
 	m_lut				= another_node.m_lut;
 	m_cluster_number	= another_node.m_cluster_number;
 	m_sub_cluster_numbers	= another_node.m_sub_cluster_numbers;
 	m_horizontal_position = another_node.m_horizontal_position;
+	m_frozen_index		= another_node.m_frozen_index;
 
 	return (*this);
 }
@@ -412,7 +423,7 @@ NODE& NODE::operator=(const NODE  & another_node)
 NODE::~NODE()
 {
 	// delete all the input ports
-	PORTS::iterator port_iter;
+	FANIN_PORTS::iterator port_iter;
 	for (port_iter = m_input_ports.begin(); port_iter != m_input_ports.end(); port_iter++)
 	{
 		// if we have an input port we should be the one to delete it
@@ -441,13 +452,14 @@ NODE::~NODE()
 // POST: an input or output port has been created and added to the node
 PORT * NODE::create_and_add_port
 (
-	const string & port_name,
+	const NET_NAME & port_name,
 	const PORT::PORT_TYPE & port_type,
 	const PORT::IO_DIRECTION & io_direction,
 	const PORT::EXTERNAL_TYPE & external_type
 )
 {
-	PORT * port = new PORT(port_name, port_type, io_direction, external_type, this);
+	assert(m_arena);
+	PORT * port = new (m_arena) PORT(port_name, port_type, io_direction, external_type, this);
 	assert(port);
 
 	if (io_direction == PORT::INPUT || io_direction == PORT::CLOCK)
@@ -529,7 +541,7 @@ void NODE::remove_input_port
 	PORT * port_to_remove
 )
 {
-	PORTS::iterator input_port_iter;
+	FANIN_PORTS::iterator input_port_iter;
 
 	input_port_iter = find(m_input_ports.begin(), m_input_ports.end(), port_to_remove);
 	assert((*input_port_iter) == port_to_remove );
@@ -564,7 +576,7 @@ void NODE::set_lut
 //
 string NODE::get_info() const
 {
-	string info_string = m_name;
+	string info_string = m_name.to_string();
 
 	assert(m_type == NODE::COMB || m_type == NODE::SEQ);
 	if (m_type == NODE::COMB)
@@ -594,7 +606,7 @@ void NODE::add_sub_cluster_number(const CLUSTER_NUMBER_TYPE & cluster_number)
 //
 void NODE::print_out_information() const
 {
-	PORTS::const_iterator port_iter;
+	FANIN_PORTS::const_iterator port_iter;
 	PORT * port;
 
 	Log("name " << m_name);
@@ -621,7 +633,7 @@ EDGES NODE::get_output_edges() const
 EDGES NODE::get_input_edges() const
 {
 	EDGES input_edges;
-	PORTS::const_iterator port_iter;
+	FANIN_PORTS::const_iterator port_iter;
 	PORT * port  = 0;
 	EDGE * edge  = 0;
 
@@ -640,7 +652,7 @@ EDGES NODE::get_input_edges() const
 EDGES NODE::get_input_edges_without_clock_edges() const
 {
 	EDGES input_edges;
-	PORTS::const_iterator port_iter;
+	FANIN_PORTS::const_iterator port_iter;
 	PORT * port  = 0;
 	EDGE * edge  = 0;
 
@@ -747,7 +759,7 @@ PORT::PORT()
 }
 PORT::PORT
 (
-	const string & port_name, 
+	const NET_NAME & port_name, 
 	const PORT::PORT_TYPE & port_type, 
 	const PORT::IO_DIRECTION & io_direction,
 	const PORT::EXTERNAL_TYPE & external_type
@@ -762,7 +774,7 @@ PORT::PORT
 }
 PORT::PORT
 (
-	const string & port_name, 
+	const NET_NAME & port_name, 
 	const PORT::PORT_TYPE & port_type, 
 	const PORT::IO_DIRECTION & io_direction,
 	const PORT::EXTERNAL_TYPE & external_type,
@@ -836,7 +848,7 @@ EDGE * PORT::get_edge() const
 // 
 EDGES PORT::get_edges() const
 {
-	return m_edges;
+	return m_edges.to_vector();
 }
 
 //
@@ -876,7 +888,7 @@ void PORT::remove_edge
 	EDGE * edge_to_remove
 )
 {
-	EDGES::iterator ports_edge_reference;
+	PORT_EDGES::iterator ports_edge_reference;
 
 	ports_edge_reference = find(m_edges.begin(), m_edges.end(), edge_to_remove);
 	assert((*ports_edge_reference) == edge_to_remove );
@@ -949,7 +961,7 @@ NUM_ELEMENTS PORT::get_fanout_degree_to_combinational_nodes() const
 	assert(m_io_direction == PORT::OUTPUT);
 
 	NUM_ELEMENTS fanout = 0;
-	EDGES::const_iterator edge_iter;	
+	PORT_EDGES::const_iterator edge_iter;	
 	EDGE * edge = 0;
 	NODE * sink_node = 0;
 
@@ -975,7 +987,7 @@ NUM_ELEMENTS PORT::get_fanout_degree_to_combinational_nodes() const
 NODE *  PORT::find_dff_in_fanout() const
 {
 	NODE * dff_found = 0;
-	EDGES::const_iterator edge_iter;
+	PORT_EDGES::const_iterator edge_iter;
 	NODE * node_in_fanout;
 
 	edge_iter = m_edges.begin();
@@ -27,6 +27,9 @@
 #include <string>
 using namespace std;
 #include "types.h"
+#include "name_pool.h"
+#include "graph_arena.h"
+#include "small_vector.h"
 
 class EDGE;
 class PORT;
@@ -49,6 +52,23 @@ typedef list<EDGE *> EDGE_PTR_LIST;
 typedef set<CLUSTER_NUMBER_TYPE> CLUSTER_NUMBER_SET;
 typedef vector<CLUSTER_NUMBER_TYPE> CLUSTER_NUMBERS;
 typedef deque<NODE *> NODE_PTR_DEQUE;
+
+// the fanin of a node and the edges of a port, inline while they are small
+typedef SMALL_VECTOR<PORT *, 6> FANIN_PORTS;
+typedef SMALL_VECTOR<EDGE *, 1> PORT_EDGES;
+
+//
+// Nodes, ports and edges are created in the GRAPH_ARENA of their circuit
+// with new (arena) and deleting them does not free memory, the arena does
+// that when the circuit goes away.
+//
+#define GRAPH_ARENA_OBJECT \
+public: \
+	static void *	operator new(size_t size, GRAPH_ARENA * arena) { assert(arena); return arena->allocate(size); } \
+	static void		operator delete(void *, GRAPH_ARENA *) {} \
+	static void		operator delete(void *) {} \
+private: \
+	static void *	operator new(size_t size);
 //
 // Class_name EDGE
 //
@@ -63,13 +83,12 @@ class EDGE
 public:
 	EDGE();
 	EDGE(const EDGE & another_edge);
-	EDGE(PORT * source_port, PORT * sink_port, const string& edge_name, const LENGTH_TYPE& length);
 	EDGE(PORT * source_port, PORT * sink_port, const LENGTH_TYPE& length);
 	EDGE & operator=(const EDGE & another_edge);
 	~EDGE();
 	PORT *		get_source() const { return m_source;}
 	PORT *		get_sink() const { return m_destination;}
-	string		get_name() const { return m_name;}
+	string		get_name() const;
 	NODE *		get_sink_node() const;
 	NODE *		get_source_node() const;
 	string		get_edge_name(const string & input_node_name, const string & output_port_name) const;
@@ -89,11 +108,11 @@ public:
 	bool		is_sink_a_dff() const;
 	bool		is_clock_edge() const;
 
+	GRAPH_ARENA_OBJECT
 private:
 	PORT * 		m_source;
 	PORT * 		m_destination;
 	LENGTH_TYPE m_length;
-	string		m_name;
 
 };
 
@@ -115,16 +134,18 @@ public:
 	enum IO_DIRECTION {INPUT, OUTPUT, CLOCK, UNKNOWN};
 	enum EXTERNAL_TYPE {PO, PI, GI, GO, NONE};
 	PORT();
-	PORT(const string & port_name, const PORT_TYPE & port_type, 
+	PORT(const NET_NAME & port_name, const PORT_TYPE & port_type, 
 		const IO_DIRECTION & io_direction, const EXTERNAL_TYPE & external_type);
-	PORT(const string & port_name, const PORT_TYPE & port_type, 
+	PORT(const NET_NAME & port_name, const PORT_TYPE & port_type, 
 		const IO_DIRECTION & io_direction, const EXTERNAL_TYPE & external_type,
 		NODE * node_connected_to);
 	PORT(const PORT & another_port);
 	PORT & operator=(const PORT & another_port);
 	~PORT();
 
-	string				get_name() const {return m_name;}
+	string				get_name() const {return m_name.to_string();}
+	NET_NAME			get_net_name() const {return m_name;}
+	NAME_ID				get_name_id() const {return m_name.get_id();}
 	PORT_TYPE			get_type() const {return m_port_type;}
 	IO_DIRECTION		get_io_direction() const {return m_io_direction;}
 	NODE *				get_my_node() const {return m_my_node;}
@@ -137,7 +158,7 @@ public:
 
 
 	void set_my_node(NODE * new_node) { m_my_node = new_node;}
-	void set_name(const string & new_name) { m_name = new_name;}
+	void set_name(const NET_NAME & new_name) { m_name = new_name;}
 	void set_direction(const IO_DIRECTION & new_direction) {m_io_direction = new_direction;}
 	void set_type(const PORT_TYPE new_port_type) { m_port_type = new_port_type;}
 	void set_external_type(const EXTERNAL_TYPE & new_external_type) {m_external_type = new_external_type;}
@@ -150,6 +171,8 @@ public:
 	// used for output ports as they can have multiple edges
 	void			add_edge(EDGE * edge_to_add);
 	EDGES get_edges() const;
+	NUM_ELEMENTS	get_nEdges() const { return static_cast<NUM_ELEMENTS>(m_edges.size()); }
+	EDGE *			get_edge(const NUM_ELEMENTS & index) const { return m_edges[index]; }
 	NUM_ELEMENTS	get_fanout_degree() const;
 	NUM_ELEMENTS	get_fanout_degree_to_combinational_nodes() const;
 	NUM_ELEMENTS 	get_horizontal_position() const { return m_horizontal_position; }
@@ -164,13 +187,15 @@ public:
 
 	bool	is_clock_port() const { return (m_io_direction == PORT::CLOCK); }
 	bool	is_connected_to_PI() const;
+
+	GRAPH_ARENA_OBJECT
 private:
-	string				m_name;
+	NET_NAME			m_name;
 	PORT_TYPE			m_port_type;
 	EXTERNAL_TYPE		m_external_type;
 	IO_DIRECTION		m_io_direction;
 	NODE *				m_my_node;
-	EDGES				m_edges;
+	PORT_EDGES			m_edges;
 	CLUSTER_NUMBER_TYPE m_cluster_number;	// ports need cluster numbers because the pi
 											// are sometimes seen as nodes for the purpose 
 											// of shape
@@ -196,13 +221,13 @@ public:
 					   	WHITE, GREY, BLACK,
 						IN_PROGRESS, CLUSTER_DONE,MARKED_OUTCONE};
 	NODE();
-	NODE(const string & node_name);
-	NODE(const string & node_name, const NODE_TYPE & node_type);
+	NODE(const NET_NAME & node_name);
+	NODE(const NET_NAME & node_name, const NODE_TYPE & node_type, GRAPH_ARENA * arena);
 	NODE(const NODE & another_node);
 	NODE& operator=(const NODE  & another_node);
 	~NODE();
 
-	PORT * 	create_and_add_port(const string & port_name, const PORT::PORT_TYPE & port_type,
+	PORT * 	create_and_add_port(const NET_NAME & port_name, const PORT::PORT_TYPE & port_type,
 								const PORT::IO_DIRECTION & io_direction, 
 								const PORT::EXTERNAL_TYPE & external_type);
 	void 	add_port(PORT * port_to_add);
@@ -211,16 +236,22 @@ public:
 	void set_lut(LUT *	new_lut);
 	void set_type(const NODE_TYPE & new_type) {m_type = new_type;}
 	void set_colour(const COLOUR_TYPE & new_colour_mark) {m_colour_mark = new_colour_mark;}
+	void set_visit(const VISIT_EPOCH & epoch, const COLOUR_TYPE & new_colour_mark) 
+								{ m_visit_epoch = epoch; m_colour_mark = new_colour_mark; }
 	void set_max_comb_delay_level(const DELAY_TYPE new_delay_level) { m_delay_level = new_delay_level;}
 	void set_cluster_number(const CLUSTER_NUMBER_TYPE & new_cluster_number) 
 								{ m_cluster_number = new_cluster_number; }
 	void remove_input_port(PORT * port_to_remove); 	// doesn't delete the port
 	void set_horizontal_position(const NUM_ELEMENTS& horizontal_pos) { m_horizontal_position = horizontal_pos; }
+	void set_frozen_index(const NODE_INDEX & new_index) { m_frozen_index = new_index; }
 
 
-	string 			get_name() const { return m_name;}
+	string 			get_name() const { return m_name.to_string();}
+	NET_NAME		get_net_name() const { return m_name;}
+	NAME_ID			get_name_id() const { return m_name.get_id();}
 	NODE_TYPE 		get_type() const { return m_type;}
 	COLOUR_TYPE		get_colour() const { return m_colour_mark;}
+	VISIT_EPOCH		get_visit_epoch() const { return m_visit_epoch;}
 	DELAY_TYPE		get_max_comb_delay_level() const { return m_delay_level;}
 
 	CLUSTER_NUMBER_TYPE 	get_cluster_number() const { return m_cluster_number; }
@@ -234,25 +265,31 @@ public:
 	NUM_ELEMENTS	get_fanin_degree() const;
 	NUM_ELEMENTS	get_horizontal_position() const { return m_horizontal_position; }
 	NUM_ELEMENTS 	get_wirelength_approx_cost() const;
+	NODE_INDEX		get_frozen_index() const { return m_frozen_index; }
 
 	string			get_info() const ;
 	PORT *			get_output_port() const { return m_output_port;}
-	PORTS			get_input_ports() const { return m_input_ports;}
+	PORTS			get_input_ports() const { return m_input_ports.to_vector();}
+	PORT *			get_input_port(const NUM_ELEMENTS & index) const { return m_input_ports[index];}
 	
 	// for sequential nodes
 	PORT *			get_D_port() const;
 	PORT *			get_clock_port() const;
 
 	void print_out_information() const;
+
+	GRAPH_ARENA_OBJECT
 private:
 	NODE_TYPE		m_type;
-	string			m_name;
+	NET_NAME		m_name;
+	GRAPH_ARENA *	m_arena;		// where the ports of the node are created
 
-	PORTS 			m_input_ports;
+	FANIN_PORTS		m_input_ports;
 	PORT * 			m_output_port;
 
 	DELAY_TYPE 		m_delay_level;
 	COLOUR_TYPE		m_colour_mark;
+	VISIT_EPOCH		m_visit_epoch;	// the NODE_VISITS that set the colour
 
 	LUT * 			m_lut;
 
@@ -260,6 +297,7 @@ private:
 	CLUSTER_NUMBERS		m_sub_cluster_numbers;	
 
 	NUM_ELEMENTS		m_horizontal_position;
+	NODE_INDEX			m_frozen_index;		// position in the FROZEN_CIRCUIT
 };
 
 #endif
@@ -0,0 +1,444 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+#include "frozen_circuit.h"
+#include "circuit.h"
+
+//
+// Builds the frozen view of the circuit
+//
+// PRE: circuit is valid and its graph will not change again
+//      the combinational graph has no cycles
+// POST: the nodes have been renumbered in topological order and the 
+//       CSR arrays have been built
+//       each node knows its frozen index
+//
+FROZEN_CIRCUIT::FROZEN_CIRCUIT
+(
+	CIRCUIT * circuit
+)
+{
+	PORTS output_ports;
+
+	assert(circuit);
+
+	m_max_level = -1;
+
+	order_nodes_topologically(circuit);
+	build_node_arrays(output_ports);
+	build_fanout(output_ports, m_fanout_offsets, m_fanout_sinks, m_fanout_edges);
+	build_fanin();
+	build_PI_arrays(circuit);
+}
+
+FROZEN_CIRCUIT::FROZEN_CIRCUIT(const FROZEN_CIRCUIT & another_frozen_circuit)
+{
+	m_nodes				= another_frozen_circuit.m_nodes;
+	m_types				= another_frozen_circuit.m_types;
+	m_is_PO				= another_frozen_circuit.m_is_PO;
+	m_levels			= another_frozen_circuit.m_levels;
+	m_max_level			= another_frozen_circuit.m_max_level;
+	m_original_order	= another_frozen_circuit.m_original_order;
+	m_original_position	= another_frozen_circuit.m_original_position;
+	m_fanout_offsets	= another_frozen_circuit.m_fanout_offsets;
+	m_fanout_sinks		= another_frozen_circuit.m_fanout_sinks;
+	m_fanout_edges		= another_frozen_circuit.m_fanout_edges;
+	m_fanin_offsets		= another_frozen_circuit.m_fanin_offsets;
+	m_fanin_sources		= another_frozen_circuit.m_fanin_sources;
+	m_fanin_edges		= another_frozen_circuit.m_fanin_edges;
+	m_level_offsets		= another_frozen_circuit.m_level_offsets;
+	m_level_nodes		= another_frozen_circuit.m_level_nodes;
+	m_PI				= another_frozen_circuit.m_PI;
+	m_is_clock_PI		= another_frozen_circuit.m_is_clock_PI;
+	m_PI_fanout_offsets	= another_frozen_circuit.m_PI_fanout_offsets;
+	m_PI_fanout_sinks	= another_frozen_circuit.m_PI_fanout_sinks;
+	m_PI_fanout_edges	= another_frozen_circuit.m_PI_fanout_edges;
+	m_rnum_contributions = another_frozen_circuit.m_rnum_contributions;
+	m_statistics		= another_frozen_circuit.m_statistics;
+}
+
+FROZEN_CIRCUIT & FROZEN_CIRCUIT::operator=(const FROZEN_CIRCUIT & another_frozen_circuit)
+{
+	m_nodes				= another_frozen_circuit.m_nodes;
+	m_types				= another_frozen_circuit.m_types;
+	m_is_PO				= another_frozen_circuit.m_is_PO;
+	m_levels			= another_frozen_circuit.m_levels;
+	m_max_level			= another_frozen_circuit.m_max_level;
+	m_original_order	= another_frozen_circuit.m_original_order;
+	m_original_position	= another_frozen_circuit.m_original_position;
+	m_fanout_offsets	= another_frozen_circuit.m_fanout_offsets;
+	m_fanout_sinks		= another_frozen_circuit.m_fanout_sinks;
+	m_fanout_edges		= another_frozen_circuit.m_fanout_edges;
+	m_fanin_offsets		= another_frozen_circuit.m_fanin_offsets;
+	m_fanin_sources		= another_frozen_circuit.m_fanin_sources;
+	m_fanin_edges		= another_frozen_circuit.m_fanin_edges;
+	m_level_offsets		= another_frozen_circuit.m_level_offsets;
+	m_level_nodes		= another_frozen_circuit.m_level_nodes;
+	m_PI				= another_frozen_circuit.m_PI;
+	m_is_clock_PI		= another_frozen_circuit.m_is_clock_PI;
+	m_PI_fanout_offsets	= another_frozen_circuit.m_PI_fanout_offsets;
+	m_PI_fanout_sinks	= another_frozen_circuit.m_PI_fanout_sinks;
+	m_PI_fanout_edges	= another_frozen_circuit.m_PI_fanout_edges;
+	m_rnum_contributions = another_frozen_circuit.m_rnum_contributions;
+	m_statistics		= another_frozen_circuit.m_statistics;
+
+	return (*this);
+}
+
+FROZEN_CIRCUIT::~FROZEN_CIRCUIT()
+{
+	// the nodes, ports and edges belong to the circuit
+}
+
+//
+// Orders the nodes with Kahn's algorithm on the combinational graph.
+// Dff and nodes with no combinational fanin start the order, in the order 
+// of the circuit, and the rest follow breadth first as their last 
+// combinational fanin is placed.
+//
+// PRE: the combinational graph has no cycles
+// POST: m_nodes, m_original_position and m_original_order hold the order
+//       each node's frozen index is its position in m_nodes
+//
+void FROZEN_CIRCUIT::order_nodes_topologically
+(
+	CIRCUIT * circuit
+)
+{
+	NODES & nodes = circuit->get_nodes();
+	NODE_INDEX nNodes = static_cast<NODE_INDEX>(nodes.size());
+	NODE_INDEXES unplaced_comb_fanin(nNodes, 0);
+	NODE_INDEX node_index = 0;
+	NODE_INDEX head = 0;
+	NODE * node = 0;
+	NODE * source_node = 0;
+	NODE * sink_node = 0;
+	PORTS input_ports;
+	PORTS::const_iterator port_iter;
+	EDGES output_edges;
+	EDGES::const_iterator edge_iter;
+
+	// for now the frozen index is the position in the circuit
+	for (node_index = 0; node_index < nNodes; node_index++)
+	{
+		nodes[node_index]->set_frozen_index(node_index);
+	}
+
+	m_original_position.reserve(nNodes);
+
+	for (node_index = 0; node_index < nNodes; node_index++)
+	{
+		node = nodes[node_index];
+		assert(node);
+
+		if (node->get_type() == NODE::COMB)
+		{
+			input_ports = node->get_input_ports();
+			for (port_iter = input_ports.begin(); port_iter != input_ports.end(); port_iter++)
+			{
+				source_node = (*port_iter)->get_node_that_fanout_to_me();
+				if (source_node && source_node->get_type() == NODE::COMB)
+				{
+					unplaced_comb_fanin[node_index]++;
+				}
+			}
+		}
+
+		if (unplaced_comb_fanin[node_index] == 0)
+		{
+			m_original_position.push_back(node_index);
+		}
+	}
+
+	// m_original_position is also the queue
+	for (head = 0; head < static_cast<NODE_INDEX>(m_original_position.size()); head++)
+	{
+		node = nodes[m_original_position[head]];
+
+		if (node->get_type() != NODE::COMB)
+		{
+			continue;
+		}
+
+		output_edges = node->get_output_edges();
+		for (edge_iter = output_edges.begin(); edge_iter != output_edges.end(); edge_iter++)
+		{
+			sink_node = (*edge_iter)->get_sink_node();
+			assert(sink_node);
+
+			if (sink_node->get_type() == NODE::COMB && 
+				--unplaced_comb_fanin[sink_node->get_frozen_index()] == 0)
+			{
+				m_original_position.push_back(sink_node->get_frozen_index());
+			}
+		}
+	}
+
+	if (static_cast<NODE_INDEX>(m_original_position.size()) != nNodes)
+	{
+		Fail("The combinational graph still has a cycle. Cannot order " 
+				<< nNodes - m_original_position.size() << " nodes.");
+	}
+
+	m_nodes.resize(nNodes);
+	m_original_order.resize(nNodes);
+
+	for (node_index = 0; node_index < nNodes; node_index++)
+	{
+		node = nodes[m_original_position[node_index]];
+		node->set_frozen_index(node_index);
+
+		m_nodes[node_index] = node;
+		m_original_order[m_original_position[node_index]] = node_index;
+	}
+}
+
+//
+// PRE: m_nodes is in frozen order
+// POST: the per node arrays have been filled
+//       output_ports holds the output port of each node in frozen order
+//
+void FROZEN_CIRCUIT::build_node_arrays
+(
+	PORTS & output_ports
+)
+{
+	NODE_INDEX nNodes = get_nNodes();
+	NODE_INDEX node_index = 0;
+	NODE * node = 0;
+
+	m_types.resize(nNodes);
+	m_is_PO.resize(nNodes);
+	m_levels.assign(nNodes, -1);
+	output_ports.resize(nNodes);
+
+	for (node_index = 0; node_index < nNodes; node_index++)
+	{
+		node = m_nodes[node_index];
+
+		output_ports[node_index] = node->get_output_port();
+		assert(output_ports[node_index]);
+
+		m_types[node_index] = node->get_type();
+		m_is_PO[node_index] = (output_ports[node_index]->get_type() == PORT::EXTERNAL);
+	}
+}
+
+//
+// Builds the fanout CSR of the output ports
+//
+// PRE: the nodes have their frozen index
+// POST: offsets, sinks and edges hold the fanout in the order of the 
+//       edges of each port
+//
+void FROZEN_CIRCUIT::build_fanout
+(
+	const PORTS & output_ports,
+	NUM_ELEMENTS_VECTOR & offsets,
+	NODE_INDEXES & sinks,
+	EDGES & edges
+) const
+{
+	NODE_INDEX nPorts = static_cast<NODE_INDEX>(output_ports.size());
+	NODE_INDEX port_index = 0;
+	PORT * port = 0;
+	EDGES port_edges;
+	EDGES::const_iterator edge_iter;
+	NODE * sink_node = 0;
+
+	offsets.assign(nPorts + 1, 0);
+	sinks.clear();
+	edges.clear();
+
+	for (port_index = 0; port_index < nPorts; port_index++)
+	{
+		port = output_ports[port_index];
+		assert(port);
+
+		port_edges = port->get_edges();
+		for (edge_iter = port_edges.begin(); edge_iter != port_edges.end(); edge_iter++)
+		{
+			sink_node = (*edge_iter)->get_sink_node();
+			assert(sink_node && sink_node->get_frozen_index() != NO_NODE_INDEX);
+
+			sinks.push_back(sink_node->get_frozen_index());
+			edges.push_back(*edge_iter);
+		}
+		offsets[port_index + 1] = static_cast<NUM_ELEMENTS>(sinks.size());
+	}
+}
+
+//
+// PRE: the nodes have their frozen index
+// POST: the fanin CSR and its edges have been built in the order of the 
+//       input ports (the clock port of a dff has the source NO_NODE_INDEX)
+//
+void FROZEN_CIRCUIT::build_fanin()
+{
+	NODE_INDEX nNodes = get_nNodes();
+	NODE_INDEX node_index = 0;
+	PORTS input_ports;
+	PORTS::const_iterator port_iter;
+	NODE * source_node = 0;
+
+	m_fanin_offsets.assign(nNodes + 1, 0);
+	m_fanin_sources.clear();
+	m_fanin_edges.clear();
+
+	for (node_index = 0; node_index < nNodes; node_index++)
+	{
+		input_ports = m_nodes[node_index]->get_input_ports();
+		for (port_iter = input_ports.begin(); port_iter != input_ports.end(); port_iter++)
+		{
+			source_node = (*port_iter)->get_node_that_fanout_to_me();
+
+			m_fanin_sources.push_back(source_node ? source_node->get_frozen_index() : NO_NODE_INDEX);
+			m_fanin_edges.push_back((*port_iter)->get_edge());
+			assert(m_fanin_edges.back());
+		}
+		m_fanin_offsets[node_index + 1] = static_cast<NUM_ELEMENTS>(m_fanin_sources.size());
+	}
+}
+
+//
+// PRE: the nodes have their frozen index
+// POST: the primary inputs and their fanout CSR have been recorded
+//       the global clock, if there is one, is the last primary input
+//
+void FROZEN_CIRCUIT::build_PI_arrays
+(
+	CIRCUIT * circuit
+)
+{
+	NODE_INDEX pi_index = 0;
+
+	m_PI = circuit->get_PI_with_clock();
+	m_is_clock_PI.resize(m_PI.size());
+
+	for (pi_index = 0; pi_index < get_nPI(); pi_index++)
+	{
+		m_is_clock_PI[pi_index] = (m_PI[pi_index]->get_io_direction() == PORT::CLOCK);
+	}
+
+	build_fanout(m_PI, m_PI_fanout_offsets, m_PI_fanout_sinks, m_PI_fanout_edges);
+}
+
+//
+// RETURNS: the number of combinational nodes the node fanouts to
+//
+NUM_ELEMENTS FROZEN_CIRCUIT::get_fanout_degree_to_combinational_nodes
+(
+	const NODE_INDEX & node
+) const
+{
+	const NODE_INDEX * sink_iter;
+	NUM_ELEMENTS fanout = 0;
+
+	for (sink_iter = fanout_begin(node); sink_iter != fanout_end(node); sink_iter++)
+	{
+		fanout += is_comb(*sink_iter);
+	}
+
+	return fanout;
+}
+
+//
+// RETURNS: the number of combinational nodes the primary input fanouts to
+//
+NUM_ELEMENTS FROZEN_CIRCUIT::get_PI_fanout_degree_to_combinational_nodes
+(
+	const NODE_INDEX & pi
+) const
+{
+	const NODE_INDEX * sink_iter;
+	NUM_ELEMENTS fanout = 0;
+
+	for (sink_iter = PI_fanout_begin(pi); sink_iter != PI_fanout_end(pi); sink_iter++)
+	{
+		fanout += is_comb(*sink_iter);
+	}
+
+	return fanout;
+}
+
+//
+// PRE: levels holds the combinational delay level of each node in frozen order
+// POST: the levels have been recorded and the nodes grouped by level
+//
+void FROZEN_CIRCUIT::set_levels
+(
+	const DELAYS & levels,
+	const DELAY_TYPE & max_level
+)
+{
+	assert(static_cast<NODE_INDEX>(levels.size()) == get_nNodes());
+
+	m_levels	= levels;
+	m_max_level = max_level;
+
+	group_nodes_by_level();
+
+	m_statistics.clear();
+}
+
+//
+// PRE: nothing
+// POST: the statistics have been found, unless they already were for 
+//       these levels
+//
+void FROZEN_CIRCUIT::calculate_statistics()
+{
+	if (! m_statistics.is_calculated())
+	{
+		m_statistics.calculate(this);
+	}
+}
+
+//
+// A counting sort of the nodes by level, in the order of the circuit
+//
+// PRE: the levels have been set
+// POST: m_level_offsets and m_level_nodes hold the nodes of each level
+//
+void FROZEN_CIRCUIT::group_nodes_by_level()
+{
+	NUM_ELEMENTS_VECTOR next_position;
+	NODE_INDEXES::const_iterator node_iter;
+	DELAYS::const_iterator level_iter;
+	DELAY_TYPE level = 0;
+
+	m_level_offsets.assign(m_max_level + 2, 0);
+	for (level_iter = m_levels.begin(); level_iter != m_levels.end(); level_iter++)
+	{
+		m_level_offsets[*level_iter + 1]++;
+	}
+	for (level = 0; level <= m_max_level; level++)
+	{
+		m_level_offsets[level + 1] += m_level_offsets[level];
+	}
+
+	next_position.assign(m_level_offsets.begin(), m_level_offsets.end() - 1);
+	m_level_nodes.resize(get_nNodes());
+
+	for (node_iter = m_original_order.begin(); node_iter != m_original_order.end(); node_iter++)
+	{
+		m_level_nodes[next_position[m_levels[*node_iter]]++] = *node_iter;
+	}
+}
@@ -0,0 +1,186 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef frozen_circuit_H
+#define frozen_circuit_H
+
+class FROZEN_CIRCUIT;
+class CIRCUIT;
+
+#include "circ.h"
+#include "frozen_statistics.h"
+
+//
+// Class_name FROZEN_CIRCUIT
+//
+// Description
+//
+//		A read-only compressed-sparse-row view of a circuit whose graph 
+//		will not change again.  
+//
+//		The nodes are renumbered in topological order of the combinational 
+//		graph (dff and nodes fed only by PI first) and everything about them 
+//		is kept in parallel arrays indexed by that number, so the analysis 
+//		passes walk contiguous memory instead of chasing NODE/PORT/EDGE 
+//		pointers.
+//
+//		The fanout of node v is m_fanout_sinks[m_fanout_offsets[v] .. 
+//		m_fanout_offsets[v+1]) and its fanin is m_fanin_sources over 
+//		m_fanin_offsets in the same way.  A fanin source of NO_NODE_INDEX is 
+//		a primary input (or the clock).  The fanout of the primary inputs 
+//		is kept the same way, in the order of CIRCUIT::get_PI_with_clock().
+//
+//		Once the delay levels are set the nodes are also grouped by level, 
+//		the wavefronts of the topological order, each in the order of the 
+//		circuit: level l is m_level_nodes[m_level_offsets[l] .. 
+//		m_level_offsets[l+1]).
+//
+
+typedef vector<NODE_INDEX> NODE_INDEXES;
+typedef vector<NODE::NODE_TYPE> NODE_TYPES;
+
+// what one primary input adds to the reconvergence of the circuit
+struct RNUM_CONTRIBUTION
+{
+	double			logdet;			// log2 of the spanning out-trees of its cone
+	NUM_ELEMENTS	cone_size;		// combinational nodes in its cone
+	bool			is_known;		// false until it has been counted
+};
+typedef vector<RNUM_CONTRIBUTION> RNUM_CONTRIBUTIONS;
+
+class FROZEN_CIRCUIT
+{
+public:
+	FROZEN_CIRCUIT(CIRCUIT * circuit);
+	FROZEN_CIRCUIT(const FROZEN_CIRCUIT & another_frozen_circuit);
+	FROZEN_CIRCUIT & operator=(const FROZEN_CIRCUIT & another_frozen_circuit);
+	~FROZEN_CIRCUIT();
+
+	NODE_INDEX			get_nNodes() const { return static_cast<NODE_INDEX>(m_nodes.size()); }
+	NODE_INDEX			get_nPI() const { return static_cast<NODE_INDEX>(m_PI.size()); }
+
+	NODE *				get_node(const NODE_INDEX & node) const { return m_nodes[node]; }
+	NODE::NODE_TYPE		get_type(const NODE_INDEX & node) const { return m_types[node]; }
+	bool				is_comb(const NODE_INDEX & node) const { return m_types[node] == NODE::COMB; }
+	bool				is_PO(const NODE_INDEX & node) const { return m_is_PO[node] != 0; }
+	DELAY_TYPE			get_level(const NODE_INDEX & node) const { return m_levels[node]; }
+
+	// the nodes in the order of CIRCUIT::get_nodes() 
+	const NODE_INDEXES&	get_original_order() const { return m_original_order; }
+	NODE_INDEX			get_original_position(const NODE_INDEX & node) const 
+							{ return m_original_position[node]; }
+
+	const NODE_INDEX *	fanout_begin(const NODE_INDEX & node) const 
+							{ return m_fanout_sinks.data() + m_fanout_offsets[node]; }
+	const NODE_INDEX *	fanout_end(const NODE_INDEX & node) const 
+							{ return m_fanout_sinks.data() + m_fanout_offsets[node + 1]; }
+	const NODE_INDEX *	fanin_begin(const NODE_INDEX & node) const 
+							{ return m_fanin_sources.data() + m_fanin_offsets[node]; }
+	const NODE_INDEX *	fanin_end(const NODE_INDEX & node) const 
+							{ return m_fanin_sources.data() + m_fanin_offsets[node + 1]; }
+	NUM_ELEMENTS		get_fanout_degree(const NODE_INDEX & node) const
+							{ return m_fanout_offsets[node + 1] - m_fanout_offsets[node]; }
+	NUM_ELEMENTS		get_fanin_degree(const NODE_INDEX & node) const
+							{ return m_fanin_offsets[node + 1] - m_fanin_offsets[node]; }
+	EDGE *				get_fanin_edge(const NUM_ELEMENTS & fanin_position) const 
+							{ return m_fanin_edges[fanin_position]; }
+	NUM_ELEMENTS		get_fanin_position(const NODE_INDEX & node) const 
+							{ return m_fanin_offsets[node]; }
+	NUM_ELEMENTS		get_fanout_degree_to_combinational_nodes(const NODE_INDEX & node) const;
+
+	PORT *				get_PI(const NODE_INDEX & pi) const { return m_PI[pi]; }
+	bool				is_clock_PI(const NODE_INDEX & pi) const { return m_is_clock_PI[pi] != 0; }
+	const NODE_INDEX *	PI_fanout_begin(const NODE_INDEX & pi) const 
+							{ return m_PI_fanout_sinks.data() + m_PI_fanout_offsets[pi]; }
+	const NODE_INDEX *	PI_fanout_end(const NODE_INDEX & pi) const 
+							{ return m_PI_fanout_sinks.data() + m_PI_fanout_offsets[pi + 1]; }
+	NUM_ELEMENTS		get_PI_fanout_degree(const NODE_INDEX & pi) const
+							{ return m_PI_fanout_offsets[pi + 1] - m_PI_fanout_offsets[pi]; }
+	NUM_ELEMENTS		get_PI_fanout_degree_to_combinational_nodes(const NODE_INDEX & pi) const;
+
+	// the edges of the fanout, for passes that must label the EDGE objects
+	EDGE *				get_fanout_edge(const NUM_ELEMENTS & fanout_position) const 
+							{ return m_fanout_edges[fanout_position]; }
+	NUM_ELEMENTS		get_fanout_position(const NODE_INDEX & node) const 
+							{ return m_fanout_offsets[node]; }
+	EDGE *				get_PI_fanout_edge(const NUM_ELEMENTS & fanout_position) const 
+							{ return m_PI_fanout_edges[fanout_position]; }
+	NUM_ELEMENTS		get_PI_fanout_position(const NODE_INDEX & pi) const 
+							{ return m_PI_fanout_offsets[pi]; }
+
+	const DELAYS &		get_levels() const { return m_levels; }
+	DELAY_TYPE			get_max_level() const { return m_max_level; }
+	void				set_levels(const DELAYS & levels, const DELAY_TYPE & max_level);
+	const NODE_INDEX *	level_begin(const DELAY_TYPE & level) const 
+							{ return m_level_nodes.data() + m_level_offsets[level]; }
+	const NODE_INDEX *	level_end(const DELAY_TYPE & level) const 
+							{ return m_level_nodes.data() + m_level_offsets[level + 1]; }
+	NUM_ELEMENTS		get_level_position(const DELAY_TYPE & level) const { return m_level_offsets[level]; }
+	NUM_ELEMENTS		get_level_size(const DELAY_TYPE & level) const
+							{ return m_level_offsets[level + 1] - m_level_offsets[level]; }
+	const NODE_INDEXES &	get_nodes_by_level() const { return m_level_nodes; }
+
+	// indexed by primary input, filled in by rnum() or carried over from the 
+	// previous circuit by INCREMENTAL_ANALYZER
+	RNUM_CONTRIBUTIONS &	get_rnum_contributions() { return m_rnum_contributions; }
+	const RNUM_CONTRIBUTIONS &	get_rnum_contributions() const { return m_rnum_contributions; }
+
+	// the degree histograms, shapes and distributions, found once for 
+	// DEGREE_INFO and the frozen SEQUENTIAL_LEVEL
+	void				calculate_statistics();
+	const FROZEN_STATISTICS &	get_statistics() const { return m_statistics; }
+private:
+	NODES				m_nodes;
+	NODE_TYPES			m_types;
+	vector<char>		m_is_PO;			// the output port is external
+	DELAYS				m_levels;			// combinational delay level, set by DELAY_LEVELER
+	DELAY_TYPE			m_max_level;
+
+	NODE_INDEXES		m_original_order;
+	NODE_INDEXES		m_original_position;
+
+	NUM_ELEMENTS_VECTOR	m_fanout_offsets;
+	NODE_INDEXES		m_fanout_sinks;
+	EDGES				m_fanout_edges;
+	NUM_ELEMENTS_VECTOR	m_fanin_offsets;
+	NODE_INDEXES		m_fanin_sources;
+	EDGES				m_fanin_edges;
+	NUM_ELEMENTS_VECTOR	m_level_offsets;	// the wavefronts, once the levels are set
+	NODE_INDEXES		m_level_nodes;
+
+	PORTS				m_PI;
+	vector<char>		m_is_clock_PI;
+	NUM_ELEMENTS_VECTOR	m_PI_fanout_offsets;
+	NODE_INDEXES		m_PI_fanout_sinks;
+	EDGES				m_PI_fanout_edges;
+
+	RNUM_CONTRIBUTIONS	m_rnum_contributions;
+	FROZEN_STATISTICS	m_statistics;		// depends on the levels, so set_levels clears it
+
+	void	order_nodes_topologically(CIRCUIT * circuit);
+	void	build_node_arrays(PORTS & output_ports);
+	void	build_fanout(const PORTS & output_ports, NUM_ELEMENTS_VECTOR & offsets,
+						NODE_INDEXES & sinks, EDGES & edges) const;
+	void	build_fanin();
+	void	build_PI_arrays(CIRCUIT * circuit);
+	void	group_nodes_by_level();
+};
+
+
+#endif
@@ -0,0 +1,451 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+#include "frozen_statistics.h"
+#include "frozen_circuit.h"
+#include "thread_pool.h"
+
+// the nodes and PI counted by one task of the pass
+const NUM_ELEMENTS STATISTICS_CHUNK = 4096;
+
+static void _add_to_histogram(NUM_ELEMENTS_VECTOR & histogram, const NUM_ELEMENTS & value);
+static void _add_histogram(NUM_ELEMENTS_VECTOR & sum, const NUM_ELEMENTS_VECTOR & histogram);
+
+DEGREE_HISTOGRAMS::DEGREE_HISTOGRAMS()
+{
+}
+
+DEGREE_HISTOGRAMS::DEGREE_HISTOGRAMS(const DEGREE_HISTOGRAMS & another_degree_histograms)
+{
+	m_comb_fanout	= another_degree_histograms.m_comb_fanout;
+	m_comb_fanin	= another_degree_histograms.m_comb_fanin;
+	m_dff_fanout	= another_degree_histograms.m_dff_fanout;
+	m_pi_fanout		= another_degree_histograms.m_pi_fanout;
+}
+
+DEGREE_HISTOGRAMS & DEGREE_HISTOGRAMS::operator=(const DEGREE_HISTOGRAMS & another_degree_histograms)
+{
+	m_comb_fanout	= another_degree_histograms.m_comb_fanout;
+	m_comb_fanin	= another_degree_histograms.m_comb_fanin;
+	m_dff_fanout	= another_degree_histograms.m_dff_fanout;
+	m_pi_fanout		= another_degree_histograms.m_pi_fanout;
+
+	return (*this);
+}
+
+DEGREE_HISTOGRAMS::~DEGREE_HISTOGRAMS()
+{
+}
+
+//
+// POST: a combinational node with this fanout and fanin has been counted
+//
+void DEGREE_HISTOGRAMS::add_comb
+(
+	const NUM_ELEMENTS & fanout,
+	const NUM_ELEMENTS & fanin
+)
+{
+	_add_to_histogram(m_comb_fanout, fanout);
+	_add_to_histogram(m_comb_fanin, fanin);
+}
+
+//
+// POST: a dff with this fanout has been counted
+//
+void DEGREE_HISTOGRAMS::add_dff
+(
+	const NUM_ELEMENTS & fanout
+)
+{
+	_add_to_histogram(m_dff_fanout, fanout);
+}
+
+//
+// POST: a pi with this fanout has been counted
+//
+void DEGREE_HISTOGRAMS::add_pi
+(
+	const NUM_ELEMENTS & fanout
+)
+{
+	_add_to_histogram(m_pi_fanout, fanout);
+}
+
+//
+// POST: the counts of another_degree_histograms have been added to these
+//
+void DEGREE_HISTOGRAMS::add_histograms
+(
+	const DEGREE_HISTOGRAMS & another_degree_histograms
+)
+{
+	_add_histogram(m_comb_fanout, another_degree_histograms.m_comb_fanout);
+	_add_histogram(m_comb_fanin, another_degree_histograms.m_comb_fanin);
+	_add_histogram(m_dff_fanout, another_degree_histograms.m_dff_fanout);
+	_add_histogram(m_pi_fanout, another_degree_histograms.m_pi_fanout);
+}
+
+void DEGREE_HISTOGRAMS::clear()
+{
+	m_comb_fanout.clear();
+	m_comb_fanin.clear();
+	m_dff_fanout.clear();
+	m_pi_fanout.clear();
+}
+
+
+FROZEN_STATISTICS::FROZEN_STATISTICS()
+{
+	m_is_calculated	= false;
+	m_has_shapes	= false;
+	m_PI_outputs	= 0;
+}
+
+FROZEN_STATISTICS::FROZEN_STATISTICS(const FROZEN_STATISTICS & another_frozen_statistics)
+{
+	m_is_calculated				= another_frozen_statistics.m_is_calculated;
+	m_has_shapes				= another_frozen_statistics.m_has_shapes;
+	m_degree_histograms			= another_frozen_statistics.m_degree_histograms;
+	m_input_shape				= another_frozen_statistics.m_input_shape;
+	m_output_shape				= another_frozen_statistics.m_output_shape;
+	m_latched_shape				= another_frozen_statistics.m_latched_shape;
+	m_PO_shape					= another_frozen_statistics.m_PO_shape;
+	m_edge_length_distribution	= another_frozen_statistics.m_edge_length_distribution;
+	m_fanout_distribution		= another_frozen_statistics.m_fanout_distribution;
+	m_PI_outputs				= another_frozen_statistics.m_PI_outputs;
+}
+
+FROZEN_STATISTICS & FROZEN_STATISTICS::operator=(const FROZEN_STATISTICS & another_frozen_statistics)
+{
+	m_is_calculated				= another_frozen_statistics.m_is_calculated;
+	m_has_shapes				= another_frozen_statistics.m_has_shapes;
+	m_degree_histograms			= another_frozen_statistics.m_degree_histograms;
+	m_input_shape				= another_frozen_statistics.m_input_shape;
+	m_output_shape				= another_frozen_statistics.m_output_shape;
+	m_latched_shape				= another_frozen_statistics.m_latched_shape;
+	m_PO_shape					= another_frozen_statistics.m_PO_shape;
+	m_edge_length_distribution	= another_frozen_statistics.m_edge_length_distribution;
+	m_fanout_distribution		= another_frozen_statistics.m_fanout_distribution;
+	m_PI_outputs				= another_frozen_statistics.m_PI_outputs;
+
+	return (*this);
+}
+
+FROZEN_STATISTICS::~FROZEN_STATISTICS()
+{
+}
+
+//
+// Counts everything in one pass over the nodes and the PI of the frozen 
+// circuit, in chunks spread over the threads
+//
+// PRE: frozen_circuit is valid
+// POST: the degree histograms have been found, and the shapes and 
+//       distributions if the delay levels of the circuit are known
+//
+void FROZEN_STATISTICS::calculate
+(
+	const FROZEN_CIRCUIT * frozen_circuit
+)
+{
+	assert(frozen_circuit);
+
+	NUM_ELEMENTS nNodes = frozen_circuit->get_nNodes();
+	NUM_ELEMENTS nItems = nNodes + frozen_circuit->get_nPI();
+	NUM_ELEMENTS nTasks = (nItems + STATISTICS_CHUNK - 1) / STATISTICS_CHUNK;
+	DELAY_TYPE max_level = frozen_circuit->get_max_level();
+	bool has_shapes = (max_level >= 0);
+	vector<FROZEN_STATISTICS>::iterator partial_iter;
+
+	THREAD_POOL thread_pool(static_cast<int>(MAX(1, MIN(g_options->get_nThreads(), nTasks))));
+
+	// each thread counts into its own
+	vector<FROZEN_STATISTICS> partials(thread_pool.get_nThreads());
+
+	for (partial_iter = partials.begin(); partial_iter != partials.end(); partial_iter++)
+	{
+		partial_iter->start(has_shapes, max_level);
+	}
+
+	thread_pool.run(nTasks, [&](NUM_ELEMENTS task, int thread_index)
+	{
+		FROZEN_STATISTICS & partial = partials[thread_index];
+		NUM_ELEMENTS item = 0;
+
+		for (item = task * STATISTICS_CHUNK; item < MIN(nItems, (task + 1) * STATISTICS_CHUNK); item++)
+		{
+			if (item < nNodes)
+			{
+				partial.add_node(frozen_circuit, static_cast<NODE_INDEX>(item));
+			}
+			else
+			{
+				partial.add_PI(frozen_circuit, static_cast<NODE_INDEX>(item - nNodes));
+			}
+		}
+	});
+
+	start(has_shapes, max_level);
+
+	for (partial_iter = partials.begin(); partial_iter != partials.end(); partial_iter++)
+	{
+		add_statistics(*partial_iter);
+	}
+
+	finish();
+}
+
+//
+// POST: nothing has been calculated
+//
+void FROZEN_STATISTICS::clear()
+{
+	start(false, -1);
+	m_is_calculated = false;
+}
+
+//
+// POST: everything is counted from 0, with the shapes as long as the 
+//       delay levels if has_shapes
+//
+void FROZEN_STATISTICS::start
+(
+	const bool & has_shapes,
+	const DELAY_TYPE & max_level
+)
+{
+	NUM_ELEMENTS nLevels = has_shapes ? max_level + 1 : 0;
+
+	m_is_calculated	= false;
+	m_has_shapes	= has_shapes;
+	m_PI_outputs	= 0;
+
+	m_degree_histograms.clear();
+	m_input_shape.assign(nLevels, 0);
+	m_output_shape.assign(nLevels, 0);
+	m_latched_shape.assign(nLevels, 0);
+	m_PO_shape.assign(nLevels, 0);
+	m_edge_length_distribution.assign(nLevels, 0);
+	m_fanout_distribution.clear();
+}
+
+//
+// Counts the node in the histograms and, at its delay level, in the shapes.
+// dff for our purposes have no inputs.  The edges into combinational nodes 
+// are counted by length, a primary input being at delay level 0.
+//
+// PRE: node is a node of frozen_circuit
+// POST: the node has been counted
+//
+void FROZEN_STATISTICS::add_node
+(
+	const FROZEN_CIRCUIT * frozen_circuit,
+	const NODE_INDEX & node
+)
+{
+	const NODE_INDEX * sink_iter;
+	const NODE_INDEX * source_iter;
+	NUM_ELEMENTS fanout_to_comb = 0;
+	DELAY_TYPE level = 0;
+	DELAY_TYPE edge_length = 0;
+	bool is_comb = frozen_circuit->is_comb(node);
+
+	if (is_comb)
+	{
+		m_degree_histograms.add_comb(frozen_circuit->get_fanout_degree(node), 
+									frozen_circuit->get_fanin_degree(node));
+	}
+	else
+	{
+		assert(frozen_circuit->get_type(node) == NODE::SEQ);
+
+		m_degree_histograms.add_dff(frozen_circuit->get_fanout_degree(node));
+	}
+
+	if (! m_has_shapes)
+	{
+		return;
+	}
+
+	level = frozen_circuit->get_level(node);
+	assert(level >= 0 && level < static_cast<signed>(m_input_shape.size()));
+
+	for (sink_iter = frozen_circuit->fanout_begin(node); 
+		 sink_iter != frozen_circuit->fanout_end(node); sink_iter++)
+	{
+		if (frozen_circuit->is_comb(*sink_iter))
+		{
+			fanout_to_comb++;
+		}
+		else
+		{
+			m_latched_shape[level]++;
+		}
+	}
+
+	m_output_shape[level] += fanout_to_comb;
+	_add_to_histogram(m_fanout_distribution, fanout_to_comb);
+
+	if (frozen_circuit->is_PO(node))
+	{
+		m_PO_shape[level]++;
+	}
+
+	if (! is_comb)
+	{
+		return;
+	}
+
+	m_input_shape[level] += frozen_circuit->get_fanin_degree(node);
+
+	for (source_iter = frozen_circuit->fanin_begin(node); 
+		 source_iter != frozen_circuit->fanin_end(node); source_iter++)
+	{
+		edge_length = level;
+		if (*source_iter != NO_NODE_INDEX)
+		{
+			edge_length -= frozen_circuit->get_level(*source_iter);
+		}
+		assert(edge_length >= 0 && 
+				static_cast<unsigned>(edge_length) < m_edge_length_distribution.size());
+
+		m_edge_length_distribution[edge_length]++;
+	}
+}
+
+//
+// Counts the primary input, which is at delay level 0.  The clock is not 
+// counted.
+//
+// PRE: pi_index is a primary input of frozen_circuit
+// POST: the primary input has been counted
+//
+void FROZEN_STATISTICS::add_PI
+(
+	const FROZEN_CIRCUIT * frozen_circuit,
+	const NODE_INDEX & pi_index
+)
+{
+	const NODE_INDEX * sink_iter;
+	NUM_ELEMENTS fanout_to_comb = 0;
+
+	if (frozen_circuit->is_clock_PI(pi_index))
+	{
+		return;
+	}
+
+	m_degree_histograms.add_pi(frozen_circuit->get_PI_fanout_degree(pi_index));
+
+	if (! m_has_shapes)
+	{
+		return;
+	}
+
+	for (sink_iter = frozen_circuit->PI_fanout_begin(pi_index); 
+		 sink_iter != frozen_circuit->PI_fanout_end(pi_index); sink_iter++)
+	{
+		if (frozen_circuit->is_comb(*sink_iter))
+		{
+			fanout_to_comb++;
+		}
+		else
+		{
+			m_latched_shape[0]++;
+		}
+	}
+
+	m_PI_outputs += fanout_to_comb;
+	_add_to_histogram(m_fanout_distribution, fanout_to_comb);
+}
+
+//
+// PRE: another_frozen_statistics was started the same way as these
+// POST: the counts of another_frozen_statistics have been added to these
+//
+void FROZEN_STATISTICS::add_statistics
+(
+	const FROZEN_STATISTICS & another_frozen_statistics
+)
+{
+	assert(m_has_shapes == another_frozen_statistics.m_has_shapes);
+
+	m_degree_histograms.add_histograms(another_frozen_statistics.m_degree_histograms);
+
+	_add_histogram(m_input_shape, another_frozen_statistics.m_input_shape);
+	_add_histogram(m_output_shape, another_frozen_statistics.m_output_shape);
+	_add_histogram(m_latched_shape, another_frozen_statistics.m_latched_shape);
+	_add_histogram(m_PO_shape, another_frozen_statistics.m_PO_shape);
+	_add_histogram(m_edge_length_distribution, another_frozen_statistics.m_edge_length_distribution);
+	_add_histogram(m_fanout_distribution, another_frozen_statistics.m_fanout_distribution);
+
+	m_PI_outputs += another_frozen_statistics.m_PI_outputs;
+}
+
+//
+// POST: the PI have been added to the output shape, which has no outputs 
+//       for the last delay level
+//
+void FROZEN_STATISTICS::finish()
+{
+	if (m_has_shapes && ! m_output_shape.empty())
+	{
+		m_output_shape.back() = 0;
+		m_output_shape[0] += m_PI_outputs;
+	}
+
+	m_is_calculated = true;
+}
+
+
+// POST: one more value has been counted in histogram
+static void _add_to_histogram
+(
+	NUM_ELEMENTS_VECTOR & histogram,
+	const NUM_ELEMENTS & value
+)
+{
+	assert(value >= 0);
+
+	if (static_cast<unsigned>(value) >= histogram.size())
+	{
+		histogram.resize(value + 1, 0);
+	}
+	histogram[value]++;
+}
+
+// POST: histogram has been added to sum, which is at least as long
+static void _add_histogram
+(
+	NUM_ELEMENTS_VECTOR & sum,
+	const NUM_ELEMENTS_VECTOR & histogram
+)
+{
+	NUM_ELEMENTS_VECTOR::size_type index;
+
+	if (histogram.size() > sum.size())
+	{
+		sum.resize(histogram.size(), 0);
+	}
+	for (index = 0; index < histogram.size(); index++)
+	{
+		sum[index] += histogram[index];
+	}
+}
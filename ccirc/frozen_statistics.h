@@ -0,0 +1,130 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef frozen_statistics_H
+#define frozen_statistics_H
+
+class FROZEN_STATISTICS;
+class FROZEN_CIRCUIT;
+
+#include "types.h"
+
+//
+// Class_name DEGREE_HISTOGRAMS
+//
+// Description
+//
+//		The number of nodes (or PI) at each fanout and fanin degree.  
+//
+//		The averages, the standard deviations and the counts of high degree 
+//		nodes of DEGREE_INFO are all found from these, so the nodes are only
+//		looked at once, and being counts they add up to the same thing in 
+//		any order.
+//
+
+class DEGREE_HISTOGRAMS
+{
+public:
+	DEGREE_HISTOGRAMS();
+	DEGREE_HISTOGRAMS(const DEGREE_HISTOGRAMS & another_degree_histograms);
+	DEGREE_HISTOGRAMS & operator=(const DEGREE_HISTOGRAMS & another_degree_histograms);
+	~DEGREE_HISTOGRAMS();
+
+	void add_comb(const NUM_ELEMENTS & fanout, const NUM_ELEMENTS & fanin);
+	void add_dff(const NUM_ELEMENTS & fanout);
+	void add_pi(const NUM_ELEMENTS & fanout);
+	void add_histograms(const DEGREE_HISTOGRAMS & another_degree_histograms);
+	void clear();
+
+	const NUM_ELEMENTS_VECTOR &	get_comb_fanout() const { return m_comb_fanout; }
+	const NUM_ELEMENTS_VECTOR &	get_comb_fanin() const { return m_comb_fanin; }
+	const NUM_ELEMENTS_VECTOR &	get_dff_fanout() const { return m_dff_fanout; }
+	const NUM_ELEMENTS_VECTOR &	get_pi_fanout() const { return m_pi_fanout; }
+private:
+	NUM_ELEMENTS_VECTOR	m_comb_fanout;
+	NUM_ELEMENTS_VECTOR	m_comb_fanin;
+	NUM_ELEMENTS_VECTOR	m_dff_fanout;
+	NUM_ELEMENTS_VECTOR	m_pi_fanout;		// the pi other than the clock
+};
+
+//
+// Class_name FROZEN_STATISTICS
+//
+// Description
+//
+//		The degree histograms, shapes and distributions of a frozen circuit, 
+//		found together in one pass over the nodes and PI.  
+//
+//		The pass is split into chunks over --threads threads; each thread 
+//		counts into its own FROZEN_STATISTICS and they are added up at the 
+//		end.  Everything is a count so the sums are the same for any number 
+//		of threads.
+//
+//		The shapes and distributions need the delay levels.  If they were 
+//		not found yet only the degree histograms are.
+//
+
+class FROZEN_STATISTICS
+{
+public:
+	FROZEN_STATISTICS();
+	FROZEN_STATISTICS(const FROZEN_STATISTICS & another_frozen_statistics);
+	FROZEN_STATISTICS & operator=(const FROZEN_STATISTICS & another_frozen_statistics);
+	~FROZEN_STATISTICS();
+
+	void calculate(const FROZEN_CIRCUIT * frozen_circuit);
+	void clear();
+
+	bool is_calculated() const { return m_is_calculated; }
+	bool has_shapes() const { return m_has_shapes; }
+
+	const DEGREE_HISTOGRAMS &	get_degree_histograms() const { return m_degree_histograms; }
+
+	// by delay level
+	const NUM_ELEMENTS_VECTOR &	get_input_shape() const { return m_input_shape; }
+	const NUM_ELEMENTS_VECTOR &	get_output_shape() const { return m_output_shape; }
+	const NUM_ELEMENTS_VECTOR &	get_latched_shape() const { return m_latched_shape; }
+	const NUM_ELEMENTS_VECTOR &	get_PO_shape() const { return m_PO_shape; }
+	// by edge length
+	const NUM_ELEMENTS_VECTOR &	get_edge_length_distribution() const { return m_edge_length_distribution; }
+	// by fanout to combinational nodes, as long as the largest one needs
+	const NUM_ELEMENTS_VECTOR &	get_fanout_distribution() const { return m_fanout_distribution; }
+private:
+	bool				m_is_calculated;
+	bool				m_has_shapes;
+
+	DEGREE_HISTOGRAMS	m_degree_histograms;
+
+	NUM_ELEMENTS_VECTOR	m_input_shape;
+	NUM_ELEMENTS_VECTOR	m_output_shape;
+	NUM_ELEMENTS_VECTOR	m_latched_shape;
+	NUM_ELEMENTS_VECTOR	m_PO_shape;
+	NUM_ELEMENTS_VECTOR	m_edge_length_distribution;
+	NUM_ELEMENTS_VECTOR	m_fanout_distribution;
+	NUM_ELEMENTS		m_PI_outputs;		// the PI's part of the output shape at level 0
+
+	void start(const bool & has_shapes, const DELAY_TYPE & max_level);
+	void add_node(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEX & node);
+	void add_PI(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEX & pi_index);
+	void add_statistics(const FROZEN_STATISTICS & another_frozen_statistics);
+	void finish();
+};
+
+
+#endif
@@ -0,0 +1,116 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+#include "graph_arena.h"
+#include "circ.h"
+
+// the size of the blocks objects are carved out of
+const size_t ARENA_BLOCK_SIZE = 256 * 1024;
+
+// every object starts on this boundary
+const size_t ARENA_ALIGNMENT = sizeof(void *) > sizeof(double) ? sizeof(void *) : sizeof(double);
+
+GRAPH_ARENA::GRAPH_ARENA()
+{
+	m_next				= 0;
+	m_end				= 0;
+	m_nBytes_allocated	= 0;
+}
+
+GRAPH_ARENA::GRAPH_ARENA(const GRAPH_ARENA & another_arena)
+{
+	// the blocks can only have one owner
+	assert(false);
+	m_blocks			= another_arena.m_blocks;
+	m_next				= another_arena.m_next;
+	m_end				= another_arena.m_end;
+	m_nBytes_allocated	= another_arena.m_nBytes_allocated;
+}
+
+GRAPH_ARENA & GRAPH_ARENA::operator=(const GRAPH_ARENA & another_arena)
+{
+	assert(false);
+	m_blocks			= another_arena.m_blocks;
+	m_next				= another_arena.m_next;
+	m_end				= another_arena.m_end;
+	m_nBytes_allocated	= another_arena.m_nBytes_allocated;
+
+	return (*this);
+}
+
+GRAPH_ARENA::~GRAPH_ARENA()
+{
+	vector<char *>::iterator block_iter;
+
+	for (block_iter = m_blocks.begin(); block_iter != m_blocks.end(); block_iter++)
+	{
+		delete [] *block_iter;
+	}
+
+	m_blocks.clear();
+	m_next = 0;
+	m_end = 0;
+}
+
+//
+// PRE: size > 0
+// RETURNS: size bytes of aligned memory that live as long as the arena
+//
+void * GRAPH_ARENA::allocate
+(
+	const size_t & size
+)
+{
+	size_t aligned_size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+	void * memory = 0;
+
+	assert(size > 0);
+
+	if (static_cast<size_t>(m_end - m_next) < aligned_size)
+	{
+		add_block(aligned_size);
+	}
+
+	memory = m_next;
+	m_next += aligned_size;
+	m_nBytes_allocated += aligned_size;
+
+	return memory;
+}
+
+//
+// PRE: nothing
+// POST: a new block of at least minimum_size bytes is the last block
+//       (whatever was left of the previous block is not used)
+//
+void GRAPH_ARENA::add_block
+(
+	const size_t & minimum_size
+)
+{
+	size_t block_size = MAX(ARENA_BLOCK_SIZE, minimum_size);
+	char * block = new char[block_size];
+	assert(block);
+
+	m_blocks.push_back(block);
+	m_next = block;
+	m_end = block + block_size;
+}
@@ -0,0 +1,64 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+#ifndef graph_arena_H
+#define graph_arena_H
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+#include "types.h"
+
+//
+// Class_name GRAPH_ARENA
+//
+// Description
+//
+//	Holds the memory of the nodes, ports and edges of one circuit.
+//
+//	Objects are carved out of large blocks one after the other and are 
+//	never given back one at a time: deleting a graph object runs its 
+//	destructor but the memory stays in the arena until the arena itself
+//	is deleted, which frees every block at once.
+//
+
+class GRAPH_ARENA
+{
+public:
+	GRAPH_ARENA();
+	GRAPH_ARENA(const GRAPH_ARENA & another_arena);
+	GRAPH_ARENA & operator=(const GRAPH_ARENA & another_arena);
+	~GRAPH_ARENA();
+
+	void *			allocate(const size_t & size);
+
+	NUM_ELEMENTS	get_nBlocks() const { return static_cast<NUM_ELEMENTS>(m_blocks.size()); }
+	size_t			get_nBytes_allocated() const { return m_nBytes_allocated; }
+private:
+	vector<char *>	m_blocks;
+	char *			m_next;			// the next free byte of the last block
+	char *			m_end;			// the end of the last block
+	size_t			m_nBytes_allocated;
+
+	void	add_block(const size_t & minimum_size);
+};
+
+#endif
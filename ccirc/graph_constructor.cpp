@@ -19,11 +19,7 @@
 
 
 #include "graph_constructor.h"
-
-// from the parser parse_blif.y
-extern 		int yyparse();
-extern 		int yyerror(char * error_text);
-extern		long g_linenum;
+#include "profiler.h"
 
 const string EDGE_CONNECTION_TEXT = "_TO_";	
 const string EDGE_SUFFIX			= "_EDGE";	
@@ -47,6 +43,7 @@ GRAPH_CONSTRUCTOR::GRAPH_CONSTRUCTOR(const string & circuit_name, OPTIONS * opti
 	m_options 				= options;
 	m_symbol_table 			= new SYMBOL_TABLE;
 	m_graph					= new CIRCUIT;	
+	m_line_number			= 0;
 
 	assert(m_symbol_table);
 	assert(m_graph);
@@ -61,6 +58,7 @@ GRAPH_CONSTRUCTOR::GRAPH_CONSTRUCTOR(OPTIONS * options)
 	m_options 				= options;
 	m_symbol_table 			= new SYMBOL_TABLE;
 	m_graph					= new CIRCUIT;	
+	m_line_number			= 0;
 
 	assert(m_symbol_table);
 	assert(m_graph);
@@ -75,6 +73,7 @@ GRAPH_CONSTRUCTOR::GRAPH_CONSTRUCTOR(const GRAPH_CONSTRUCTOR & another_graph_con
 	m_options				= another_graph_constructor.m_options;
 	m_graph					= another_graph_constructor.m_graph; 
 	m_symbol_table 			= another_graph_constructor.m_symbol_table;
+	m_line_number			= another_graph_constructor.m_line_number;
 }
 	
 GRAPH_CONSTRUCTOR & GRAPH_CONSTRUCTOR::operator=(const GRAPH_CONSTRUCTOR & another_graph_constructor)
@@ -82,6 +81,7 @@ GRAPH_CONSTRUCTOR & GRAPH_CONSTRUCTOR::operator=(const GRAPH_CONSTRUCTOR & anoth
 	m_options				= another_graph_constructor.m_options;
 	m_graph					= another_graph_constructor.m_graph; 
 	m_symbol_table 			= another_graph_constructor.m_symbol_table;
+	m_line_number			= another_graph_constructor.m_line_number;
 
 	return (*this);
 }
@@ -109,17 +109,17 @@ GRAPH_CONSTRUCTOR::~GRAPH_CONSTRUCTOR()
 //
 void GRAPH_CONSTRUCTOR::new_external_port
 (
-	const string & port_name,
+	const NET_NAME & port_name,
 	const PORT::EXTERNAL_TYPE & external_type
 )
 {
     PORT * port;
 
-    port = m_symbol_table->query_for_port(port_name);
+    port = m_symbol_table->query_for_port(port_name.get_id());
     if (!port) 
 	{
         port = m_graph->create_and_add_external_port(port_name, external_type);
-		m_symbol_table->insert_port(port_name, port);
+		m_symbol_table->insert_port(port_name.get_id(), port);
     } 
 	else 
 	{
@@ -144,7 +144,7 @@ void GRAPH_CONSTRUCTOR::new_combination_block
 	LUT * current_lut
 )
 {
-    string node_name; 
+    NET_NAME node_name; 
 	NODE * node;
 	PORTS input_ports;
 
@@ -177,7 +177,7 @@ void GRAPH_CONSTRUCTOR::new_combination_block
 	variable_name_stack->pop_back();
 
 	node = m_graph->create_node(node_name, NODE::COMB);	
-	m_symbol_table->insert_node(node_name, node);
+	m_symbol_table->insert_node(node_name.get_id(), node);
 
 	add_output_port(node, node_name);
 	add_input_ports_and_connect_to_graph(node, variable_name_stack);
@@ -209,12 +209,12 @@ void GRAPH_CONSTRUCTOR::new_combination_block
 PORT * GRAPH_CONSTRUCTOR::add_output_port
 (
 	NODE *	node,
-	const string & node_name
+	const NET_NAME & node_name
 )
 {
 	PORT * output_port = 0;
 
-	output_port = m_symbol_table->query_for_port(node_name);
+	output_port = m_symbol_table->query_for_port(node_name.get_id());
 
 	// check if the port exists if not create a new port
 	if (! output_port)
@@ -223,7 +223,7 @@ PORT * GRAPH_CONSTRUCTOR::add_output_port
 
 		output_port = node->create_and_add_port(node_name, PORT::INTERNAL, 
 												PORT::OUTPUT, PORT::NONE);
-		m_symbol_table->insert_port(node_name, output_port);
+		m_symbol_table->insert_port(node_name.get_id(), output_port);
 	}
 	else
 	{
@@ -254,21 +254,19 @@ void GRAPH_CONSTRUCTOR::add_input_ports_and_connect_to_graph
 	VARIABLE_STACK_TYPE	* variable_name_stack
 )
 {
-	string node_name = "";
-	string input_port_name = "";
-	string output_node_name = "";
+	NET_NAME node_name;
+	NET_NAME output_node_name;
 
 	assert(node);
-	node_name = node->get_name();
+	node_name = node->get_net_name();
 	
     //  Remaining stacked elements are the inputs to the node.   First
     //  make sure there are the right number of them.  Too few is ok.
     if (m_options->get_k() != 0) {
 	if (static_cast<K_TYPE>(variable_name_stack->size()) > m_options->get_k()) 
 	{
-	    Error("Too many arguments " << variable_name_stack->size() 
-				<< " for k= " << g_options->get_k());
-	    yyerror("");
+	    Fail("Too many arguments " << variable_name_stack->size() 
+				<< " for k= " << m_options->get_k());
 	}
     }
 
@@ -297,8 +295,8 @@ void GRAPH_CONSTRUCTOR::add_input_ports_and_connect_to_graph
 PORT * GRAPH_CONSTRUCTOR::add_an_input_port_and_connect_to_graph
 (
  	NODE * node,
-	const string & node_name,
-	const string & output_node_name
+	const NET_NAME & node_name,
+	const NET_NAME & output_node_name
 )
 {
 
@@ -324,14 +322,13 @@ PORT * GRAPH_CONSTRUCTOR::add_an_input_port_and_connect_to_graph
 void GRAPH_CONSTRUCTOR::add_clock_port_and_connect_to_clock
 (
  	NODE * node,
-	const string & node_name,
-	const string & clock_name
+	const NET_NAME & node_name,
+	const NET_NAME & clock_name
 )
 {
 
 	PORT * clock_port = 0;
 	PORT * global_clock_port = 0;
-	string edge_name;
 
     debugif(DCONST, "Adding an clock port with name : " << clock_name);
 
@@ -341,7 +338,7 @@ void GRAPH_CONSTRUCTOR::add_clock_port_and_connect_to_clock
 
 
 	debugif(DCONST,"Looking for global clock with name  " << clock_name);
-	global_clock_port  = m_symbol_table->query_for_port(clock_name);
+	global_clock_port  = m_symbol_table->query_for_port(clock_name.get_id());
 
 	if (global_clock_port == 0 || 
 			global_clock_port->get_type() == PORT::INTERNAL)
@@ -380,15 +377,13 @@ void GRAPH_CONSTRUCTOR::add_clock_port_and_connect_to_clock
 void GRAPH_CONSTRUCTOR::connect_input_port_to_graph
 (
 	PORT * input_port,
-	const string & input_node_name,
-	const string & output_port_name
+	const NET_NAME & input_node_name,
+	const NET_NAME & output_port_name
 )
 {	
 	assert(input_port);
 
-	string input_port_name = input_port->get_name();
-
-	PORT * output_port 		= m_symbol_table->query_for_port(output_port_name);
+	PORT * output_port 		= m_symbol_table->query_for_port(output_port_name.get_id());
 
 	debugif(DCONST, "Looking for an output port '" << output_port_name << "'" <<
 			" that feeds the input port");
@@ -400,9 +395,9 @@ void GRAPH_CONSTRUCTOR::connect_input_port_to_graph
 	if (!output_port)
 	{
 		debugif(DCONST, "No match has been found for output port. Creating one");
-		output_port = new PORT(output_port_name, PORT::INTERNAL, PORT::OUTPUT, PORT::NONE);	
+		output_port = new (m_graph->get_arena()) PORT(output_port_name, PORT::INTERNAL, PORT::OUTPUT, PORT::NONE);	
 		assert(output_port);
-		m_symbol_table->insert_port(output_port_name, output_port);
+		m_symbol_table->insert_port(output_port_name.get_id(), output_port);
 	}
 	else
 	{
@@ -423,36 +418,36 @@ void GRAPH_CONSTRUCTOR::connect_input_port_to_graph
 //
 void GRAPH_CONSTRUCTOR::add_edge_between_ports
 (
-	const string & input_node_name,
+	const NET_NAME & input_node_name,
 	PORT * input_port,
 	PORT * output_port
 )
 {
-	string edge_name = "";
 	EDGE * edge	= 0;
 
 	assert(input_port);
 	assert(output_port);
 
-	string output_port_name = output_port->get_name();
+	NET_NAME output_port_name = output_port->get_net_name();
 
 	// check to see if edge is duplicate
-	edge_name = get_edge_name(input_node_name, output_port_name);
-	edge = m_symbol_table->query_for_edge(edge_name);
+	edge = m_symbol_table->query_for_edge(output_port_name.get_id(), input_node_name.get_id());
 
 	assert(Dlook_at); // i am not adding the edge to the symbol table. why?
 					
 	if (! edge)
 	{
 		debugif(DCONST, "Adding an edge from " << output_port_name << " to " 
-				<< input_node_name << " with name " << edge_name);	
+				<< input_node_name << " with name " 
+				<< get_edge_name(input_node_name, output_port_name));	
 		edge = m_graph->create_edge(output_port, input_port, 1);
 		assert(edge);
 	}
 	else
 	{
-		Warning("Duplicate edge " << edge_name <<  " ignored near/above line " 
-				<<  g_linenum << " of input.");
+		Warning("Duplicate edge " << get_edge_name(input_node_name, output_port_name) 
+				<<  " ignored near/above line " 
+				<<  m_line_number << " of input.");
 	}
 
 }
@@ -490,8 +485,8 @@ void GRAPH_CONSTRUCTOR::new_truth_table_entry
 
     if (static_cast<short>(cube.size()) != number_input_variables) 
 	{
-		cout << "cube size " << cube.size() << " #inputs " << number_input_variables << endl;
-		yyerror("Wrong number of bits in this table entry");
+		Fail("Wrong number of bits in this table entry. cube size " << cube.size() 
+				<< " #inputs " << number_input_variables);
     }
 
     //  If we're not storing the LUTs, we're done.  Free the space and return.
@@ -509,7 +504,7 @@ void GRAPH_CONSTRUCTOR::new_truth_table_entry
 
     if (number_input_variables > m_options->get_k()) 
 	{
-		yyerror("Too many bits in this table entry");
+		Fail("Too many bits in this table entry");
     } 
 	else if (m_options->is_expand_luts() && 
 			number_input_variables < m_options->get_k()) 
@@ -556,7 +551,7 @@ VALUE_TYPE GRAPH_CONSTRUCTOR::new_value
     	// if already have a cube then all cubes should be in sum of products form
         if ( current_lut && current_lut->is_sum_of_products()) 
 		{
-        	yyerror("Both max/minterm specified for this function.");
+        	Fail("Both max/minterm specified for this function.");
         } 
 		else
 		{
@@ -568,7 +563,7 @@ VALUE_TYPE GRAPH_CONSTRUCTOR::new_value
     	// if already have a cube then all cubes should be in product of sums form
         if (current_lut && (! current_lut->is_sum_of_products()) )
 		{
-        	yyerror("Both max/minterm specified for this function.");
+        	Fail("Both max/minterm specified for this function.");
         } 
 		else
 		{
@@ -577,7 +572,7 @@ VALUE_TYPE GRAPH_CONSTRUCTOR::new_value
     } 
 	else 
 	{
-        yyerror("Illegal cover_value, must be 0 or 1");
+        Fail("Illegal cover_value, must be 0 or 1");
     }
     
 	debugif(DCONST, "new_value: done, returning " << value);
@@ -598,20 +593,20 @@ VALUE_TYPE GRAPH_CONSTRUCTOR::new_value
 //
 void GRAPH_CONSTRUCTOR::new_flip_flop
 (
-	string & input_port_name, 
-	string & output_port_name, 
-	string & clk_name
+	const NET_NAME & input_port_name, 
+	const NET_NAME & output_port_name, 
+	const NET_NAME & clk_name
 )
 {
 	NODE * node;
-	const string node_name = output_port_name;
-	const string output_to_node_name = input_port_name;
+	const NET_NAME node_name = output_port_name;
+	const NET_NAME output_to_node_name = input_port_name;
 
     debugif(DCONST, "---------------------------------------------------\n");
 	debugif(DCONST, "Creating a sequential node with name : " << node_name);
 
 	node = m_graph->create_node(node_name, NODE::SEQ);	
-	m_symbol_table->insert_node(node_name, node);
+	m_symbol_table->insert_node(node_name.get_id(), node);
 		
 	add_output_port(node, node_name);
 
@@ -630,6 +625,7 @@ void GRAPH_CONSTRUCTOR::new_flip_flop
 //
 void GRAPH_CONSTRUCTOR::delete_unusable_nodes()
 {
+	PROFILE_STAGE stage("graph_medic");
 	GRAPH_MEDIC graph_medic(m_graph, m_symbol_table);
 	
 	graph_medic.delete_unusable_nodes();
@@ -638,15 +634,18 @@ void GRAPH_CONSTRUCTOR::delete_unusable_nodes()
 }
 
 
+// Edges are looked up by name id so this is only built for messages
+//
 // RETURNS: a name for the edge
 string GRAPH_CONSTRUCTOR::get_edge_name
 (
-	const string & input_node_name,
-	const string & output_port_name
-)
+	const NET_NAME & input_node_name,
+	const NET_NAME & output_port_name
+) const
 {
 	assert(! input_node_name.empty());
 	assert(! output_port_name.empty());
 
-	return output_port_name + EDGE_CONNECTION_TEXT + input_node_name + EDGE_SUFFIX;
+	return output_port_name.to_string() + EDGE_CONNECTION_TEXT + 
+			input_node_name.to_string() + EDGE_SUFFIX;
 }
@@ -32,10 +32,10 @@
 //
 // Description
 // 		Builds the graph
-// 		Works with the parser parse_blif.y
+// 		Works with the parser BLIF_PARSER
 //
 
-typedef deque<string> VARIABLE_STACK_TYPE;
+typedef deque<NET_NAME> VARIABLE_STACK_TYPE;
 
 class GRAPH_CONSTRUCTOR
 {
@@ -46,48 +46,56 @@ public:
 	GRAPH_CONSTRUCTOR & operator=(const GRAPH_CONSTRUCTOR & another_graph_constructor);
 	~GRAPH_CONSTRUCTOR();
 
-	void new_external_port(const string & port_name,
+	void new_external_port(const NET_NAME & port_name,
 							const PORT::EXTERNAL_TYPE & external_type);
 	void new_combination_block(VARIABLE_STACK_TYPE * variable_name_stack,
 								LUT * current_lut);
-	void new_flip_flop(	string & input_port_name, string & output_port_name, 
-					string & clk_name);
+	void new_flip_flop(	const NET_NAME & input_port_name, const NET_NAME & output_port_name, 
+					const NET_NAME & clk_name);
 	void new_truth_table_entry(string & cube, VALUE_TYPE output_value, 
 							   short number_input_variables, LUT * current_lut);
 	VALUE_TYPE new_value(const string & value_text, LUT * current_lut);
 
 	CIRCUIT *	get_constructed_graph() { return m_graph;}
 
+	// the names given to the constructor must be interned in the graph
+	NET_NAME	intern_name(const char * name, const size_t & length)
+						{ return m_graph->intern_name(name, length); }
+
+	// the line of input being built, for messages
+	void		set_line_number(long line_number) { m_line_number = line_number; }
+
 	void 		delete_unusable_nodes();
 private:
 	CIRCUIT	*				m_graph; 
 	SYMBOL_TABLE *			m_symbol_table;
 	OPTIONS	*				m_options;
+	long					m_line_number;
 
 
 	/* functions to create the graph */
-	PORT * 	add_output_port(NODE * node, const string & node_name);
+	PORT * 	add_output_port(NODE * node, const NET_NAME & node_name);
 	void 	add_input_ports_and_connect_to_graph(NODE * node,
 										VARIABLE_STACK_TYPE * variable_name_stack);
 	PORT *  add_an_input_port_and_connect_to_graph(NODE * node, 
-										const string & node_name,
-				    					const string & output_node_name);
+										const NET_NAME & node_name,
+				    					const NET_NAME & output_node_name);
 	void 	add_clock_port_and_connect_to_clock(NODE * node, 
-										const string & node_name,
-										const string & global_clock_node_name);
+										const NET_NAME & node_name,
+										const NET_NAME & global_clock_node_name);
 
 	void 	connect_input_port_to_graph(PORT * input_port, 
-										const string & input_node_name,
-										const string & output_port_name);
+										const NET_NAME & input_node_name,
+										const NET_NAME & output_port_name);
 
-	void 	add_edge_between_ports(const string & input_node_name,
+	void 	add_edge_between_ports(const NET_NAME & input_node_name,
 							PORT * input_port,
 							PORT * output_port);
 
 	bool	open_circuit_input_file();
 
-	string	get_edge_name(const string & input_node_name,
-							const string & output_port_name);
+	string	get_edge_name(const NET_NAME & input_node_name,
+							const NET_NAME & output_port_name) const;
 
 };
 
@@ -232,7 +232,7 @@ void GRAPH_MEDIC::transfer_output_port_connections_to_node_above
 	EDGES::iterator edge_iter;
 	EDGE * edge;
 	NODE * node_in_fanout;
-	string source_node_name = output_port_of_node_above->get_name();
+	NET_NAME source_node_name = output_port_of_node_above->get_net_name();
 	PORT * node_in_fanout_input_port;
 
 	EDGES output_edges = output_port->get_edges();
@@ -363,12 +363,12 @@ void GRAPH_MEDIC::delete_unconnected_primary_inputs()
 					<< " has no connections.  Deleting");
 			port_iter = PI.erase(port_iter);
 
-			m_symbol_table->remove_port(output_port->get_name());
+			m_symbol_table->remove_port(output_port->get_name_id());
 			delete output_port;
 		}
 		else
 		{
-			m_symbol_table->remove_port(output_port->get_name());
+			m_symbol_table->remove_port(output_port->get_name_id());
 			port_iter++;
 		}
 	}
@@ -395,14 +395,15 @@ void GRAPH_MEDIC::delete_unconnected_global_clocks()
 		edges = output_port->get_edges();
 
 		debugif(DMEDIC, "Looking at port name " << output_port->get_name());
+		// remove it from the table whether or not we erase the clock
+		m_symbol_table->remove_port(output_port->get_name_id());
+
 		if (edges.empty())
 		{
 			Warning("Clock port " << output_port->get_name() << " has no connections.  Deleting");
 			m_graph->erase_global_clock();
 			delete output_port;
 		}
-		// now just remove it from the table whether or not we erased the clock
-		m_symbol_table->remove_port(output_port->get_name());
 	}
 }
 
@@ -434,16 +435,16 @@ void GRAPH_MEDIC::delete_unconnected_primary_outputs()
 					<< " has no driving node.  Deleting");
 
 			detach_output_port_from_references_in_fanout(output_port);		
-			if (m_symbol_table->query_for_port(output_port->get_name()))
+			if (m_symbol_table->query_for_port(output_port->get_name_id()))
 			{
-				m_symbol_table->remove_port(output_port->get_name());
+				m_symbol_table->remove_port(output_port->get_name_id());
 			}
 			port_iter = PO.erase(port_iter);
 			delete (output_port);
 		}
 		else
 		{
-			m_symbol_table->remove_port(output_port->get_name());
+			m_symbol_table->remove_port(output_port->get_name_id());
 			port_iter++;
 		}
 	}
@@ -459,17 +460,16 @@ void GRAPH_MEDIC::delete_unconnected_primary_outputs()
 //
 void GRAPH_MEDIC::delete_unreachable_nodes_from_outputs()
 {
+	// the marks go with this traversal so the nodes never need unmarking
+	NODE_VISITS visits(NODE::UNMARKED);
 
 	m_problem_nodes = GRAPH_MEDIC::NODES_NOT_CONNECTED_TO_PO;
 
 	debugif(DMEDIC, "Marking nodes up from the PO");
-	mark_up(NODE::MARKED);
+	mark_up(visits, NODE::MARKED);
 
 	debugif(DMEDIC, "Queing for deletion any unmarked node down from the PI");
-	eliminate_down();
-	
-	debugif(DMEDIC, "Unmarking the nodes up from the PO");
-	mark_up(NODE::UNMARKED);
+	eliminate_down(visits);
 }
 //
 // Colours the nodes up from the primary outputs
@@ -479,6 +479,7 @@ void GRAPH_MEDIC::delete_unreachable_nodes_from_outputs()
 //
 void GRAPH_MEDIC::mark_up
 (
+	NODE_VISITS & visits,
 	const NODE::COLOUR_TYPE & colour
 )
 {
@@ -495,48 +496,14 @@ void GRAPH_MEDIC::mark_up
 
 		node = output_port->get_my_node();
 
-		if (node && node->get_colour() != colour)
+		if (node)
 		{
-			mark_up_from_node(node, colour);
+			visits.colour_up_from_node(node, colour);
 		}
 	}
 
 }
 
-//
-// Colours the nodes up from this node
-//
-// PRE: node is valid
-// POST: all nodes up from this node that are reachable are coloured
-//
-void GRAPH_MEDIC::mark_up_from_node
-(
-	NODE * node,
-	const NODE::COLOUR_TYPE & colour
-)
-{
-	PORTS	input_ports;
-	NODE *			output_node;
-	PORTS::iterator port_iter;
-
-	assert(node);
-	node->set_colour(colour);
-
-	debugif(DMEDIC, node->get_name() << " = marked " << static_cast<short>(colour) );
-
-	input_ports = node->get_input_ports();
-
-	for (port_iter = input_ports.begin(); port_iter != input_ports.end(); port_iter++) 
-	{
-		assert(*port_iter);
-		output_node = (*port_iter)->get_node_that_fanout_to_me();
-
-		if (output_node && output_node->get_colour() != colour)
-		{
-			mark_up_from_node(output_node, colour);
-		}
-	}
-}
 //
 // Eliminates any UNMARKED node in the graph starting 
 // by added that node to a list of nodes queue for deletion
@@ -547,7 +514,10 @@ void GRAPH_MEDIC::mark_up_from_node
 // POST: all nodes reachable from the PI marked UNMARKED
 //       have been queue for deletion
 //
-void GRAPH_MEDIC::eliminate_down()
+void GRAPH_MEDIC::eliminate_down
+(
+	NODE_VISITS & visits
+)
 {
 	PORTS::iterator port_iter;
 	PORTS PI = m_graph->get_PI_with_clock();
@@ -559,7 +529,7 @@ void GRAPH_MEDIC::eliminate_down()
 		output_port = *port_iter;
 		assert(output_port);
 
-		eliminate_down_from_output_port(output_port);
+		eliminate_down_from_output_port(visits, output_port);
 	}
 }
 
@@ -568,26 +538,40 @@ void GRAPH_MEDIC::eliminate_down()
 // Eliminates any UNMARKED node in the graph starting 
 // down from this output port
 //
+// The nodes are queued in depth-first order, each port resuming at its 
+// next edge when the nodes below it are done.
+//
 // PRE: nodes in the graph may be marked UNMARKED 
 // POST: all nodes reachable from this output port down 
 //       and marked UNMARKED have been queue for deletion
 void GRAPH_MEDIC::eliminate_down_from_output_port
 (
+	NODE_VISITS & visits,
 	PORT * output_port
 )
 {
-	EDGES edges;	
-	EDGES::iterator edge_iter;	
+	FANOUT_STACK stack;
+	NUM_ELEMENTS edge_index;
 	EDGE * edge;
 	PORT * input_port;
 	NODE * node;
 
 	assert(output_port);
-	edges = output_port->get_edges();
+	stack.push_back(FANOUT_FRAME(output_port, 0));
 	
-	for(edge_iter = edges.begin(); edge_iter != edges.end(); edge_iter++)
+	while (! stack.empty())
 	{
-		edge = *edge_iter;
+		output_port = stack.back().first;
+		edge_index = stack.back().second;
+
+		if (edge_index == output_port->get_nEdges())
+		{
+			stack.pop_back();
+			continue;
+		}
+		stack.back().second++;
+
+		edge = output_port->get_edge(edge_index);
 		assert(edge);
 
 		input_port = edge->get_sink();
@@ -597,15 +581,14 @@ void GRAPH_MEDIC::eliminate_down_from_output_port
 		assert(node);
 	
 		// if we haven't seen the node, process it
-		if (node->get_colour() == NODE::MARKED || 
-			node->get_colour() == NODE::UNMARKED)
+		if (visits.get_colour(node) == NODE::MARKED || 
+			visits.get_colour(node) == NODE::UNMARKED)
 		{	
 			debugif(DMEDIC, "Eliminate down:  searching at " <<  node->get_name());
-			if_unmarked_queue_for_deletion(node);
+			if_unmarked_queue_for_deletion(visits, node);
 
-			output_port = node->get_output_port();
-			assert(output_port);
-			eliminate_down_from_output_port(output_port);
+			assert(node->get_output_port());
+			stack.push_back(FANOUT_FRAME(node->get_output_port(), 0));
 		}
 	}
 }
@@ -619,18 +602,15 @@ void GRAPH_MEDIC::eliminate_down_from_output_port
 //       queue for deletion
 void GRAPH_MEDIC::delete_unreachable_nodes_from_inputs()
 {
+	NODE_VISITS visits(NODE::UNMARKED);
 
 	m_problem_nodes = GRAPH_MEDIC::NODES_NOT_CONNECTED_TO_PI;
 
 	debugif(DMEDIC, "Marking nodes down from the PI");
-	mark_down(NODE::MARKED);
+	mark_down(visits, NODE::MARKED);
 
 	debugif(DMEDIC, "Queing for deletion up from the PO");
-	eliminate_up();
-
-	// reset the graph
-	debugif(DMEDIC, "Unmarking nodes down from the PI");
-	mark_down(NODE::UNMARKED);
+	eliminate_up(visits);
 }
 
 //
@@ -640,6 +620,7 @@ void GRAPH_MEDIC::delete_unreachable_nodes_from_inputs()
 // POST: all nodes reachable from the PIs are coloured
 void GRAPH_MEDIC::mark_down
 (
+	NODE_VISITS & visits,
 	const NODE::COLOUR_TYPE & colour
 )
 { 
@@ -653,64 +634,19 @@ void GRAPH_MEDIC::mark_down
 		output_port = *port_iter;
 
 		assert(output_port);
-		mark_down_from_output_port(output_port, colour);
+		visits.colour_down_from_port(output_port, colour);
 	}
 }
 
-
 //
-// Colour down from this output port
+// Queues for deletion any UNMARKED primary output node
 //
-// PRE: node is valid
-// POST: all nodes down from this node that are reachable are coloured
-void GRAPH_MEDIC::mark_down_from_output_port
+// PRE: nodes in the graph may be marked UNMARKED 
+// POST: all PO nodes marked UNMARKED have been queue for deletion
+void GRAPH_MEDIC::eliminate_up
 (
-	PORT * output_port,
-	const NODE::COLOUR_TYPE & colour
+	NODE_VISITS & visits
 )
-
-{
-	PORT * input_port;
-	NODE * node;
-	EDGES edges;
-	EDGES::iterator edge_iter;
-
-
-	assert(output_port);
-	edges = output_port->get_edges();
-
-	// over all the edges look for more nodes to mark
-	for (edge_iter = edges.begin(); edge_iter != edges.end(); edge_iter++) 
-	{
-		assert(*edge_iter);
-		
-		input_port = (*edge_iter)->get_sink();
-		assert(input_port);
-
-		node = input_port->get_my_node();
-		assert(node);	
-
-		// if we haven't visted this node before colour it
-		if (node->get_colour() != colour)
-		{
-			debugif(DMEDIC, node->get_name() << " = marked " 
-					<< static_cast<short>(colour) ); 
-			node->set_colour(colour);
-
-			output_port = node->get_output_port();
-			assert(output_port);
-			mark_down_from_output_port(output_port, colour);
-		}
-	}
-}
-
-//
-// Queues for deletion any UNMARKED node
-//
-// PRE: nodes in the graph may be marked UNMARKED 
-// POST: all nodes reachable from the PO marked UNMARKED
-//       have been queue for deletion
-void GRAPH_MEDIC::eliminate_up()
 {
 	PORTS::iterator port_iter;
 	PORTS PO = m_graph->get_PO();
@@ -725,51 +661,7 @@ void GRAPH_MEDIC::eliminate_up()
 		node = output_port->get_my_node();
 		if (node)
 		{
-			if_unmarked_queue_for_deletion(node);
-			eliminate_up_from_node(node);
-		}
-	}
-}
-
-// PRE: nodes in the graph may be marked UNMARKED 
-// POST: all nodes reachable from this output node up  
-//       and marked UNMARKED have been queue for deletion
-void GRAPH_MEDIC::eliminate_up_from_node
-(
-	NODE * node
-)
-{
-	PORTS	input_ports;
-	PORTS::iterator port_iter;
-	EDGE *	edge;
-	PORT *	output_port;
-	NODE *	output_node;
-
-	for (port_iter = input_ports.begin(); port_iter != input_ports.end(); port_iter++) 
-	{
-		// input ports should be connected to an edge and the edge should
-		// be connected to an output port
-
-		assert(*port_iter);
-		edge = (*port_iter)->get_edge();
-		assert(edge);
-		
-		output_port = edge->get_source();
-		assert(output_port);
-
-		// if the port is internal then the port should have a node
-		if (output_port->get_type() == PORT::INTERNAL)
-		{
-			output_node = output_port->get_my_node();
-			assert(output_node);
-
-			// if we haven't seen it before process it
-			if ((output_node->get_colour() == NODE::MARKED) ||
-				(output_node->get_colour() == NODE::UNMARKED))
-			{
-				if_unmarked_queue_for_deletion(node);
-				eliminate_up_from_node(output_node);
-			}
+			if_unmarked_queue_for_deletion(visits, node);
 		}
 	}
 }
@@ -785,22 +677,23 @@ void GRAPH_MEDIC::eliminate_up_from_node
 //       node is marked visited
 void GRAPH_MEDIC::if_unmarked_queue_for_deletion
 (
+	NODE_VISITS & visits,
 	NODE * node
 )
 {
 	assert(node);
 
-	assert(	node->get_colour() == NODE::MARKED || 
-			node->get_colour() == NODE::UNMARKED);
+	assert(	visits.get_colour(node) == NODE::MARKED || 
+			visits.get_colour(node) == NODE::UNMARKED);
 
-	if (node->get_colour() == NODE::MARKED) 
+	if (visits.get_colour(node) == NODE::MARKED) 
 	{
-		node->set_colour(NODE::MARKED_VISITED);
+		visits.set_colour(node, NODE::MARKED_VISITED);
 		
 	}
 	else
 	{
-		node->set_colour(NODE::UNMARKED_VISITED);
+		visits.set_colour(node, NODE::UNMARKED_VISITED);
 		show_node_deletion_warning(node);
 		Verbose("Adding " << node->get_name() << " to the deletion list");
 
@@ -965,12 +858,12 @@ void GRAPH_MEDIC::remove_from_symbol_table
 
 	assert(node);
 
-	m_symbol_table->remove_node(node->get_name());
+	m_symbol_table->remove_node(node->get_name_id());
 
 	output_port = node->get_output_port();
 	assert(output_port);
 
-	m_symbol_table->remove_port(output_port->get_name());
+	m_symbol_table->remove_port(output_port->get_name_id());
 		
 }
 
@@ -995,7 +888,7 @@ void GRAPH_MEDIC::delete_isolated_nodes()
 		m_symbol_table->pop_front_node();
 		output_port = node->get_output_port();
 		assert(output_port);
-		m_symbol_table->remove_port(output_port->get_name());
+		m_symbol_table->remove_port(output_port->get_name_id());
 
 		show_node_deletion_warning(node);
 		delete_node(node);
@@ -1137,7 +1030,7 @@ void GRAPH_MEDIC::check_sanity()
 
 	assert(m_graph->get_nNodes() == static_cast<signed>(m_graph->get_nodes().size()));
 	assert(m_graph->get_nEdges() == static_cast<signed>(m_graph->get_edges().size()));
-	m_graph->colour_graph(NODE::UNMARKED);
+	NODE_VISITS visits(NODE::UNMARKED);
 
 	if (m_graph->get_nDFF())
 	{
@@ -1160,9 +1053,9 @@ void GRAPH_MEDIC::check_sanity()
 		node = (*port_iter)->get_my_node();
 		assert(node);
 
-		if (node->get_colour() == NODE::UNMARKED)
+		if (visits.get_colour(node) == NODE::UNMARKED)
 		{
-			check_sanity_up_from_node(node, number_inputs, number_outputs);
+			check_sanity_up_from_node(visits, node, number_inputs, number_outputs);
 		}
 	}
 
@@ -1170,19 +1063,59 @@ void GRAPH_MEDIC::check_sanity()
 	debugif(DMEDIC, "The number of total outputs is " << number_outputs);
 
 	assert(number_inputs == number_outputs);
-
-	// reset the graph
-	mark_up(NODE::UNMARKED);
 }
 
 //
 // Do a sanity check on this node and all nodes up from this node
 //
+//  PRE: node is valid and UNMARKED
+//  POST: Number_inputs and number_outputs have been updated to reflect the nodes visited.
+//        The nodes visited are MARKED.
+//
+void GRAPH_MEDIC::check_sanity_up_from_node
+(
+	NODE_VISITS & visits,
+	NODE * node,
+    NUM_ELEMENTS & number_inputs,
+	NUM_ELEMENTS & number_outputs
+)
+{
+	NODES stack;
+	NUM_ELEMENTS port_index;
+	NODE * output_node;
+
+	assert(node);
+	visits.set_colour(node, NODE::MARKED);
+	stack.push_back(node);
+
+	while (! stack.empty())
+	{
+		node = stack.back();
+		stack.pop_back();
+
+		check_sanity_of_node(node, number_inputs, number_outputs);
+
+		for (port_index = 0; port_index < node->get_fanin_degree(); port_index++)
+		{
+			output_node = node->get_input_port(port_index)->get_node_that_fanout_to_me();
+
+			if (output_node && visits.get_colour(output_node) == NODE::UNMARKED)
+			{
+				visits.set_colour(output_node, NODE::MARKED);
+				stack.push_back(output_node);
+			}
+		}
+	}
+}
+
+//
+// Do a sanity check on this node
+//
 //
 //  PRE: node is valid
-//  POST: Number_inputs and number_outputs have been updated to reflect the nodes visited.
+//  POST: Number_inputs and number_outputs have been updated to count this node
 //
-//        We are sure that up from this node that:
+//        We are sure that at this node:
 //        a) If we have DFF there is a global clock
 //        b) every DFF has just 2 inputs 
 //        c) every DFF has a clock input
@@ -1190,7 +1123,7 @@ void GRAPH_MEDIC::check_sanity()
 //        e) no input to a combinational node is a clock
 //        f) if a node has no fanout it must have a primary output
 //
-void GRAPH_MEDIC::check_sanity_up_from_node
+void GRAPH_MEDIC::check_sanity_of_node
 (
 	NODE * node,
     NUM_ELEMENTS & number_inputs,
@@ -1201,7 +1134,6 @@ void GRAPH_MEDIC::check_sanity_up_from_node
 	PORTS	input_ports;
 	PORT *			input_port;
 	PORT *			clk_port;
-	NODE *			output_node;
 	PORTS::iterator port_iter;
 	EDGE *			clk_edge;
 
@@ -1216,8 +1148,6 @@ void GRAPH_MEDIC::check_sanity_up_from_node
 
 	debugif(DMEDIC, "Graph Sanity: name of output port is " << output_port->get_name());
 
-	node->set_colour(NODE::MARKED);
-
 	if (node->get_type() == NODE::SEQ)
 	{
 		// dff have 2 inputs, the clock and the D-input
@@ -1277,13 +1207,6 @@ void GRAPH_MEDIC::check_sanity_up_from_node
 		}
 
 		debugif(DMEDIC, "Graph Sanity: Node " << node->get_name() << " has input with name " << input_port->get_name());
-
-		output_node = input_port->get_node_that_fanout_to_me();
-
-		if (output_node && output_node->get_colour() == NODE::UNMARKED)
-		{
-			check_sanity_up_from_node(output_node, number_inputs, number_outputs);
-		}
 	}
 }
 
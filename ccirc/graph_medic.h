@@ -23,6 +23,7 @@
 #include "circ.h"
 #include "circuit.h"
 #include "symbol_table.h"
+#include "traversal.h"
 
 //
 // Class_name GRAPH_MEDIC
@@ -80,16 +81,13 @@ private:
 	void	delete_unconnected_primary_outputs();
 	void 	delete_unconnected_global_clocks();
 
-	void	mark_up(const NODE::COLOUR_TYPE & colour);
-	void	mark_up_from_node(NODE * node, const NODE::COLOUR_TYPE & colour);
-	void	eliminate_down();
-	void	eliminate_down_from_output_port(PORT * output_port);
-	void 	mark_down(const NODE::COLOUR_TYPE & colour);
-	void 	mark_down_from_output_port(PORT * output_port, const NODE::COLOUR_TYPE & colour);
-	void 	eliminate_up();
-	void	eliminate_up_from_node(NODE * node);
+	void	mark_up(NODE_VISITS & visits, const NODE::COLOUR_TYPE & colour);
+	void	eliminate_down(NODE_VISITS & visits);
+	void	eliminate_down_from_output_port(NODE_VISITS & visits, PORT * output_port);
+	void 	mark_down(NODE_VISITS & visits, const NODE::COLOUR_TYPE & colour);
+	void 	eliminate_up(NODE_VISITS & visits);
 
-	void	if_unmarked_queue_for_deletion(NODE * node);
+	void	if_unmarked_queue_for_deletion(NODE_VISITS & visits, NODE * node);
 	void 	remove_from_symbol_table(NODE * node);
 
 	void	delete_queued_nodes();
@@ -108,8 +106,9 @@ private:
 	void 	print_node_deletion_stats();
 
 	// sanity checks
-	void 	check_sanity_up_from_node(NODE * node, NUM_ELEMENTS & number_inputs,
+	void 	check_sanity_up_from_node(NODE_VISITS & visits, NODE * node, NUM_ELEMENTS & number_inputs,
 										NUM_ELEMENTS & number_outputs);
+	void 	check_sanity_of_node(NODE * node, NUM_ELEMENTS & number_inputs, NUM_ELEMENTS & number_outputs);
 	void 	check_input_port_not_connected_to_global_clock(PORT * input_port);
 	NUM_ELEMENTS get_fanout_number_from_PI();
 
@@ -0,0 +1,1565 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#include "hypergraph_partitioner.h"
+#include "circ.h"
+#include "rand.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+
+const HG_INDEX	HG_COARSEN_TO = 100;				// vertices left to bisect
+const HG_INDEX	HG_KWAY_COARSEN_PER_PART = 20;		// vertices left per part for k-way
+const double	HG_MIN_COARSENING = 0.95;			// a level must drop more than 5% of the vertices
+const int		HG_MATCHING_ROUNDS = 3;
+const HG_INDEX	HG_MAX_RATED_EDGE_SIZE = 50;		// bigger hyperedges don't pull vertices together
+const int		HG_INITIAL_TRIES = 8;
+const int		HG_FM_PASSES = 8;
+const HG_INDEX	HG_FM_MIN_BAD_MOVES = 50;			// moves without gain before a pass gives up
+const int		HG_KWAY_PASSES = 8;
+const HG_INDEX	HG_ITEMS_PER_TASK = 2048;
+const HG_INDEX	HG_NO_MATCH = -1;
+
+
+HYPERGRAPH::HYPERGRAPH()
+{
+	m_total_weight = 0;
+	m_edge_begin.assign(1, 0);
+	m_vertex_begin.assign(1, 0);
+}
+
+HYPERGRAPH::HYPERGRAPH(const HYPERGRAPH & another_hypergraph)
+{
+	m_vertex_weights	= another_hypergraph.m_vertex_weights;
+	m_edge_weights		= another_hypergraph.m_edge_weights;
+	m_total_weight		= another_hypergraph.m_total_weight;
+	m_edge_begin		= another_hypergraph.m_edge_begin;
+	m_pins				= another_hypergraph.m_pins;
+	m_vertex_begin		= another_hypergraph.m_vertex_begin;
+	m_incident_edges	= another_hypergraph.m_incident_edges;
+}
+
+HYPERGRAPH & HYPERGRAPH::operator=(const HYPERGRAPH & another_hypergraph)
+{
+	m_vertex_weights	= another_hypergraph.m_vertex_weights;
+	m_edge_weights		= another_hypergraph.m_edge_weights;
+	m_total_weight		= another_hypergraph.m_total_weight;
+	m_edge_begin		= another_hypergraph.m_edge_begin;
+	m_pins				= another_hypergraph.m_pins;
+	m_vertex_begin		= another_hypergraph.m_vertex_begin;
+	m_incident_edges	= another_hypergraph.m_incident_edges;
+
+	return (*this);
+}
+
+HYPERGRAPH::~HYPERGRAPH()
+{
+}
+
+//
+// PRE: edge_begin and pins are laid out as for hMetis, edge_begin[0] == 0
+//      each pin is a vertex index below nVertices
+// POST: the hypergraph holds the vertices and hyperedges 
+//
+void HYPERGRAPH::set
+(
+	const HG_INDEX & nVertices, 
+	const HG_INDEX & nEdges, 
+	const int * edge_begin, 
+	const int * pins, 
+	const int * vertex_weights, 
+	const int * edge_weights
+)
+{
+	assert(nVertices >= 0 && nEdges >= 0);
+	assert(nEdges == 0 || (edge_begin && pins && edge_begin[0] == 0));
+
+	if (vertex_weights)
+	{
+		m_vertex_weights.assign(vertex_weights, vertex_weights + nVertices);
+	}
+	else
+	{
+		m_vertex_weights.assign(nVertices, 1);
+	}
+
+	if (edge_weights)
+	{
+		m_edge_weights.assign(edge_weights, edge_weights + nEdges);
+	}
+	else
+	{
+		m_edge_weights.assign(nEdges, 1);
+	}
+
+	if (nEdges > 0)
+	{
+		m_edge_begin.assign(edge_begin, edge_begin + nEdges + 1);
+		m_pins.assign(pins, pins + edge_begin[nEdges]);
+	}
+	else
+	{
+		m_edge_begin.assign(1, 0);
+		m_pins.clear();
+	}
+
+	connect_vertices();
+}
+
+//
+// PRE: the vertex weights and the hyperedges are set
+// POST: each vertex knows its hyperedges and the total weight is set
+//
+void HYPERGRAPH::connect_vertices()
+{
+	HG_INDEX vertex = 0;
+	HG_INDEX edge = 0;
+	const HG_INDEX * pin_iter;
+	HG_INDEXES next_position;
+
+	m_total_weight = accumulate(m_vertex_weights.begin(), m_vertex_weights.end(), 0);
+
+	m_vertex_begin.assign(get_nVertices() + 1, 0);
+	for (edge = 0; edge < get_nEdges(); edge++)
+	{
+		for (pin_iter = pins_begin(edge); pin_iter != pins_end(edge); pin_iter++)
+		{
+			assert(*pin_iter >= 0 && *pin_iter < get_nVertices());
+			m_vertex_begin[*pin_iter + 1]++;
+		}
+	}
+	for (vertex = 0; vertex < get_nVertices(); vertex++)
+	{
+		m_vertex_begin[vertex + 1] += m_vertex_begin[vertex];
+	}
+
+	next_position.assign(m_vertex_begin.begin(), m_vertex_begin.end() - 1);
+	m_incident_edges.resize(m_pins.size());
+	for (edge = 0; edge < get_nEdges(); edge++)
+	{
+		for (pin_iter = pins_begin(edge); pin_iter != pins_end(edge); pin_iter++)
+		{
+			m_incident_edges[next_position[*pin_iter]++] = edge;
+		}
+	}
+}
+
+
+
+BISECTION_REFINER::BISECTION_REFINER()
+{
+	m_hypergraph = 0;
+	m_sides = 0;
+	m_side_weights[0] = m_side_weights[1] = 0;
+	m_cut = 0;
+}
+
+BISECTION_REFINER::BISECTION_REFINER(const BISECTION_REFINER & another_refiner)
+{
+	// only the scratch space would be copied
+	m_hypergraph = 0;
+	m_sides = 0;
+	m_side_weights[0] = another_refiner.m_side_weights[0];
+	m_side_weights[1] = another_refiner.m_side_weights[1];
+	m_cut = another_refiner.m_cut;
+}
+
+BISECTION_REFINER & BISECTION_REFINER::operator=(const BISECTION_REFINER & another_refiner)
+{
+	m_hypergraph = 0;
+	m_sides = 0;
+	m_side_weights[0] = another_refiner.m_side_weights[0];
+	m_side_weights[1] = another_refiner.m_side_weights[1];
+	m_cut = another_refiner.m_cut;
+
+	return (*this);
+}
+
+BISECTION_REFINER::~BISECTION_REFINER()
+{
+}
+
+//
+// Grow a bisection from first_vertex
+//
+// PRE: first_vertex is a vertex of the hypergraph
+// POST: sides[v] is the side of vertex v.  side 0 was grown to about 
+//       target_weight and then refined
+// RETURNS: the weight of the hyperedges cut
+//
+HG_WEIGHT BISECTION_REFINER::grow
+(
+	const HYPERGRAPH & hypergraph, 
+	const HG_INDEX & first_vertex, 
+	const HG_WEIGHT & target_weight, 
+	const HG_WEIGHT max_weights[2], 
+	HG_INDEXES & sides
+)
+{
+	HG_INDEX vertex = 0;
+
+	assert(first_vertex >= 0 && first_vertex < hypergraph.get_nVertices());
+
+	sides.assign(hypergraph.get_nVertices(), 1);
+	start(hypergraph, sides);
+	compute_gains();
+
+	m_heaps[0] = GAIN_HEAP();
+	m_heaps[1] = GAIN_HEAP();
+	for (vertex = 0; vertex < hypergraph.get_nVertices(); vertex++)
+	{
+		m_heaps[1].push(GAIN_ENTRY(m_gains[vertex], vertex));
+	}
+
+	move(first_vertex);
+	while (m_side_weights[0] < target_weight && get_best_move(1, vertex))
+	{
+		move(vertex);
+	}
+
+	return refine(hypergraph, max_weights, sides);
+}
+
+//
+// PRE: sides[v] is 0 or 1 for each vertex v
+// POST: sides has been improved by FM passes until a pass found nothing
+// RETURNS: the weight of the hyperedges cut
+//
+HG_WEIGHT BISECTION_REFINER::refine
+(
+	const HYPERGRAPH & hypergraph, 
+	const HG_WEIGHT max_weights[2], 
+	HG_INDEXES & sides
+)
+{
+	int pass = 0;
+
+	start(hypergraph, sides);
+
+	for (pass = 0; pass < HG_FM_PASSES; pass++)
+	{
+		if (! do_pass(max_weights))
+		{
+			break;
+		}
+	}
+
+	return m_cut;
+}
+
+//
+// POST: the pin counts, side weights and cut are those of sides
+//
+void BISECTION_REFINER::start
+(
+	const HYPERGRAPH & hypergraph, 
+	HG_INDEXES & sides
+)
+{
+	HG_INDEX vertex = 0;
+	HG_INDEX edge = 0;
+	const HG_INDEX * pin_iter;
+
+	assert(static_cast<HG_INDEX>(sides.size()) == hypergraph.get_nVertices());
+
+	m_hypergraph = &hypergraph;
+	m_sides = &sides;
+
+	m_side_weights[0] = m_side_weights[1] = 0;
+	for (vertex = 0; vertex < hypergraph.get_nVertices(); vertex++)
+	{
+		assert(sides[vertex] == 0 || sides[vertex] == 1);
+		m_side_weights[sides[vertex]] += hypergraph.get_vertex_weight(vertex);
+	}
+
+	m_cut = 0;
+	m_pin_counts.assign(2 * hypergraph.get_nEdges(), 0);
+	for (edge = 0; edge < hypergraph.get_nEdges(); edge++)
+	{
+		for (pin_iter = hypergraph.pins_begin(edge); pin_iter != hypergraph.pins_end(edge); pin_iter++)
+		{
+			m_pin_counts[2 * edge + sides[*pin_iter]]++;
+		}
+		if (m_pin_counts[2 * edge] > 0 && m_pin_counts[2 * edge + 1] > 0)
+		{
+			m_cut += hypergraph.get_edge_weight(edge);
+		}
+	}
+
+	m_gains.assign(hypergraph.get_nVertices(), 0);
+	m_is_locked.assign(hypergraph.get_nVertices(), false);
+	m_moves.clear();
+}
+
+//
+// POST: m_gains[v] is how much the cut drops if v changes sides
+//
+void BISECTION_REFINER::compute_gains()
+{
+	HG_INDEX vertex = 0;
+	const HG_INDEX * edge_iter;
+	HG_WEIGHT gain = 0;
+
+	for (vertex = 0; vertex < m_hypergraph->get_nVertices(); vertex++)
+	{
+		gain = 0;
+		for (edge_iter = m_hypergraph->edges_begin(vertex); edge_iter != m_hypergraph->edges_end(vertex); edge_iter++)
+		{
+			gain += get_edge_gain(*edge_iter, (*m_sides)[vertex]);
+		}
+		m_gains[vertex] = gain;
+	}
+}
+
+//
+// RETURNS: what the hyperedge adds to the gain of a vertex leaving side
+//          given the pin counts.  The hyperedge is uncut if the vertex is 
+//          the last pin on its side, and cut if no pin is on the other side.
+//
+HG_WEIGHT BISECTION_REFINER::get_edge_gain
+(
+	const HG_INDEX & edge, 
+	const HG_INDEX & side
+) const
+{
+	HG_WEIGHT gain = 0;
+
+	if (m_hypergraph->get_edge_size(edge) < 2)
+	{
+		return 0;
+	}
+
+	if (m_pin_counts[2 * edge + side] == 1)
+	{
+		gain += m_hypergraph->get_edge_weight(edge);
+	}
+	if (m_pin_counts[2 * edge + 1 - side] == 0)
+	{
+		gain -= m_hypergraph->get_edge_weight(edge);
+	}
+
+	return gain;
+}
+
+//
+// PRE: the heap of from_side holds every unlocked vertex there whose gain changed
+// POST: stale heap entries have been dropped
+// RETURNS: true and the unlocked vertex with the highest gain on from_side, if any
+//
+bool BISECTION_REFINER::get_best_move
+(
+	const HG_INDEX & from_side, 
+	HG_INDEX & vertex
+)
+{
+	GAIN_HEAP & heap = m_heaps[from_side];
+	GAIN_ENTRY entry;
+
+	while (! heap.empty())
+	{
+		entry = heap.top();
+
+		if (m_is_locked[entry.second] || (*m_sides)[entry.second] != from_side || 
+			m_gains[entry.second] != entry.first)
+		{
+			heap.pop();
+			continue;
+		}
+
+		vertex = entry.second;
+		return true;
+	}
+
+	return false;
+}
+
+//
+// Move a vertex to the other side and lock it
+//
+// POST: the pin counts, the cut, the side weights and the gains of the 
+//       unlocked pins on the vertex's hyperedges have been updated
+//
+void BISECTION_REFINER::move
+(
+	const HG_INDEX & vertex
+)
+{
+	HG_INDEX from_side = (*m_sides)[vertex];
+	HG_INDEX to_side = 1 - from_side;
+	const HG_INDEX * edge_iter;
+	const HG_INDEX * pin_iter;
+	HG_INDEX edge = 0;
+	HG_INDEX pin = 0;
+	HG_WEIGHT gains_before[2], gains_after[2];
+	HG_WEIGHT gain_change = 0;
+	bool was_cut = false, is_cut = false;
+
+	for (edge_iter = m_hypergraph->edges_begin(vertex); edge_iter != m_hypergraph->edges_end(vertex); edge_iter++)
+	{
+		edge = *edge_iter;
+
+		gains_before[0] = get_edge_gain(edge, 0);
+		gains_before[1] = get_edge_gain(edge, 1);
+		was_cut = (m_pin_counts[2 * edge] > 0 && m_pin_counts[2 * edge + 1] > 0);
+
+		m_pin_counts[2 * edge + from_side]--;
+		m_pin_counts[2 * edge + to_side]++;
+
+		gains_after[0] = get_edge_gain(edge, 0);
+		gains_after[1] = get_edge_gain(edge, 1);
+		is_cut = (m_pin_counts[2 * edge] > 0 && m_pin_counts[2 * edge + 1] > 0);
+
+		if (was_cut != is_cut)
+		{
+			m_cut += (is_cut ? 1 : -1) * m_hypergraph->get_edge_weight(edge);
+		}
+
+		if (gains_before[0] == gains_after[0] && gains_before[1] == gains_after[1])
+		{
+			continue;
+		}
+
+		for (pin_iter = m_hypergraph->pins_begin(edge); pin_iter != m_hypergraph->pins_end(edge); pin_iter++)
+		{
+			pin = *pin_iter;
+			if (pin == vertex || m_is_locked[pin])
+			{
+				continue;
+			}
+
+			gain_change = gains_after[(*m_sides)[pin]] - gains_before[(*m_sides)[pin]];
+			if (gain_change != 0)
+			{
+				m_gains[pin] += gain_change;
+				m_heaps[(*m_sides)[pin]].push(GAIN_ENTRY(m_gains[pin], pin));
+			}
+		}
+	}
+
+	(*m_sides)[vertex] = to_side;
+	m_side_weights[from_side] -= m_hypergraph->get_vertex_weight(vertex);
+	m_side_weights[to_side] += m_hypergraph->get_vertex_weight(vertex);
+
+	// moving back undoes the move
+	m_gains[vertex] = -m_gains[vertex];
+	m_is_locked[vertex] = true;
+}
+
+//
+// RETURNS: how much heavier than allowed the sides are
+//
+HG_WEIGHT BISECTION_REFINER::get_overweight
+(
+	const HG_WEIGHT max_weights[2]
+) const
+{
+	return MAX(0, m_side_weights[0] - max_weights[0]) + MAX(0, m_side_weights[1] - max_weights[1]);
+}
+
+//
+// One FM pass.  Moves that would make the sides more overweight are not 
+// taken, so a bisection that starts out of balance is brought back first.
+//
+// POST: the best prefix of the moves of the pass has been kept
+// RETURNS: true if the pass improved the balance or the cut
+//
+bool BISECTION_REFINER::do_pass
+(
+	const HG_WEIGHT max_weights[2]
+)
+{
+	HG_INDEX vertex = 0;
+	HG_INDEX side = 0;
+	HG_INDEX candidates[2];
+	bool has_candidate[2];
+	HG_INDEX from_side = 0;
+	HG_WEIGHT overweight = 0;
+	HG_WEIGHT start_cut = m_cut;
+	HG_WEIGHT start_overweight = get_overweight(max_weights);
+	HG_WEIGHT best_cut = start_cut;
+	HG_WEIGHT best_overweight = start_overweight;
+	HG_INDEX nBest_moves = 0;
+	HG_INDEX max_bad_moves = MAX(HG_FM_MIN_BAD_MOVES, m_hypergraph->get_nVertices() / 50);
+	const HG_INDEX * edge_iter;
+	bool is_boundary = false;
+
+	compute_gains();
+	fill(m_is_locked.begin(), m_is_locked.end(), false);
+	m_moves.clear();
+	m_heaps[0] = GAIN_HEAP();
+	m_heaps[1] = GAIN_HEAP();
+
+	// only the vertices on a cut hyperedge, or on an overweight side, can gain from moving
+	for (vertex = 0; vertex < m_hypergraph->get_nVertices(); vertex++)
+	{
+		side = (*m_sides)[vertex];
+		is_boundary = (m_side_weights[side] > max_weights[side]);
+		for (edge_iter = m_hypergraph->edges_begin(vertex); 
+			 edge_iter != m_hypergraph->edges_end(vertex) && ! is_boundary; edge_iter++)
+		{
+			is_boundary = (m_pin_counts[2 * *edge_iter + 1 - side] > 0);
+		}
+		if (is_boundary)
+		{
+			m_heaps[side].push(GAIN_ENTRY(m_gains[vertex], vertex));
+		}
+	}
+
+	while (true)
+	{
+		overweight = get_overweight(max_weights);
+
+		for (side = 0; side < 2; side++)
+		{
+			has_candidate[side] = get_best_move(side, candidates[side]);
+			if (has_candidate[side])
+			{
+				// the move may not make the balance worse
+				HG_WEIGHT weight = m_hypergraph->get_vertex_weight(candidates[side]);
+				HG_WEIGHT overweight_after = 
+					MAX(0, m_side_weights[side] - weight - max_weights[side]) + 
+					MAX(0, m_side_weights[1 - side] + weight - max_weights[1 - side]);
+				has_candidate[side] = (overweight_after <= overweight);
+			}
+		}
+
+		if (! has_candidate[0] && ! has_candidate[1])
+		{
+			break;
+		}
+		else if (has_candidate[0] && has_candidate[1])
+		{
+			if (m_gains[candidates[0]] != m_gains[candidates[1]])
+			{
+				from_side = (m_gains[candidates[0]] > m_gains[candidates[1]]) ? 0 : 1;
+			}
+			else
+			{
+				from_side = (m_side_weights[0] >= m_side_weights[1]) ? 0 : 1;
+			}
+		}
+		else
+		{
+			from_side = has_candidate[0] ? 0 : 1;
+		}
+
+		move(candidates[from_side]);
+		m_moves.push_back(candidates[from_side]);
+
+		overweight = get_overweight(max_weights);
+		if (overweight < best_overweight || (overweight == best_overweight && m_cut < best_cut))
+		{
+			best_overweight = overweight;
+			best_cut = m_cut;
+			nBest_moves = static_cast<HG_INDEX>(m_moves.size());
+		}
+		else if (static_cast<HG_INDEX>(m_moves.size()) - nBest_moves > max_bad_moves)
+		{
+			break;
+		}
+	}
+
+	// undo the moves after the best point
+	while (static_cast<HG_INDEX>(m_moves.size()) > nBest_moves)
+	{
+		move(m_moves.back());
+		m_moves.pop_back();
+	}
+	assert(m_cut == best_cut);
+
+	return (best_overweight < start_overweight || best_cut < start_cut);
+}
+
+
+
+HYPERGRAPH_PARTITIONER::HYPERGRAPH_PARTITIONER
+(
+	const int & nThreads, 
+	const long & seed
+)
+	: m_thread_pool(nThreads)
+{
+	m_seed = seed;
+}
+
+HYPERGRAPH_PARTITIONER::HYPERGRAPH_PARTITIONER(const HYPERGRAPH_PARTITIONER & another_partitioner)
+	: m_thread_pool(1)
+{
+	// the thread pool can't be copied
+	assert(false);
+	m_seed = another_partitioner.m_seed;
+}
+
+HYPERGRAPH_PARTITIONER & HYPERGRAPH_PARTITIONER::operator=(const HYPERGRAPH_PARTITIONER & another_partitioner)
+{
+	assert(false);
+	m_seed = another_partitioner.m_seed;
+
+	return (*this);
+}
+
+HYPERGRAPH_PARTITIONER::~HYPERGRAPH_PARTITIONER()
+{
+}
+
+//
+// Partition by recursive bisection
+//
+// PRE: nParts >= 1
+// POST: parts[v] is the part of vertex v, from 0 to nParts-1
+// RETURNS: the weight of the hyperedges cut
+//
+HG_WEIGHT HYPERGRAPH_PARTITIONER::partition_recursive
+(
+	const HYPERGRAPH & hypergraph, 
+	const int & nParts, 
+	const int & ubfactor, 
+	HG_INDEXES & parts
+)
+{
+	assert(nParts >= 1);
+	assert(ubfactor >= 0);
+
+	bisect_recursively(hypergraph, nParts, 0, ubfactor / 50.0, get_random(0, 0), parts);
+
+	return get_cut(hypergraph, parts);
+}
+
+//
+// Partition into nParts parts at once
+//
+// PRE: nParts >= 1
+// POST: parts[v] is the part of vertex v, from 0 to nParts-1
+// RETURNS: the weight of the hyperedges cut
+//
+HG_WEIGHT HYPERGRAPH_PARTITIONER::partition_kway
+(
+	const HYPERGRAPH & hypergraph, 
+	const int & nParts, 
+	const int & ubfactor, 
+	HG_INDEXES & parts
+)
+{
+	HYPERGRAPHS levels;
+	vector<HG_INDEXES> coarse_vertices;
+	HG_INDEXES finer_parts;
+	HG_INDEX level = 0;
+	HG_INDEX vertex = 0;
+	HG_WEIGHT min_part_weight = 0;
+	HG_WEIGHT max_part_weight = 0;
+	double average_part_weight = 0.0;
+	double bisection_imbalance = 0.0;
+	int nBisection_levels = 0;
+
+	assert(nParts >= 1);
+	assert(ubfactor >= 0);
+
+	if (nParts == 1)
+	{
+		parts.assign(hypergraph.get_nVertices(), 0);
+		return 0;
+	}
+
+	average_part_weight = static_cast<double>(hypergraph.get_total_weight()) / nParts;
+	min_part_weight = MAX(1, static_cast<HG_WEIGHT>(floor(average_part_weight * MAX(0.0, 1.0 - ubfactor / 100.0))));
+	max_part_weight = static_cast<HG_WEIGHT>(ceil(average_part_weight * (1.0 + ubfactor / 100.0)));
+
+	coarsen(hypergraph, MAX(HG_COARSEN_TO, HG_KWAY_COARSEN_PER_PART * nParts), get_random(1, 0), 
+			levels, coarse_vertices);
+
+	// share the imbalance between the bisections of the initial partition
+	nBisection_levels = static_cast<int>(ceil(log(static_cast<double>(nParts)) / log(2.0)));
+	bisection_imbalance = pow(1.0 + ubfactor / 100.0, 1.0 / nBisection_levels) - 1.0;
+
+	const HYPERGRAPH & coarsest = levels.empty() ? hypergraph : levels.back();
+	bisect_recursively(coarsest, nParts, 0, bisection_imbalance, get_random(1, 1), parts);
+	refine_kway(coarsest, nParts, min_part_weight, max_part_weight, parts);
+
+	for (level = static_cast<HG_INDEX>(levels.size()) - 1; level >= 0; level--)
+	{
+		const HYPERGRAPH & finer = (level == 0) ? hypergraph : levels[level - 1];
+
+		finer_parts.resize(finer.get_nVertices());
+		for (vertex = 0; vertex < finer.get_nVertices(); vertex++)
+		{
+			finer_parts[vertex] = parts[coarse_vertices[level][vertex]];
+		}
+		parts.swap(finer_parts);
+
+		refine_kway(finer, nParts, min_part_weight, max_part_weight, parts);
+	}
+
+	return get_cut(hypergraph, parts);
+}
+
+//
+// RETURNS: the weight of the hyperedges with pins in more than one part
+//
+HG_WEIGHT HYPERGRAPH_PARTITIONER::get_cut
+(
+	const HYPERGRAPH & hypergraph, 
+	const HG_INDEXES & parts
+)
+{
+	HG_INDEX edge = 0;
+	const HG_INDEX * pin_iter;
+	HG_WEIGHT cut = 0;
+
+	assert(static_cast<HG_INDEX>(parts.size()) == hypergraph.get_nVertices());
+
+	for (edge = 0; edge < hypergraph.get_nEdges(); edge++)
+	{
+		for (pin_iter = hypergraph.pins_begin(edge); pin_iter != hypergraph.pins_end(edge); pin_iter++)
+		{
+			if (parts[*pin_iter] != parts[*hypergraph.pins_begin(edge)])
+			{
+				cut += hypergraph.get_edge_weight(edge);
+				break;
+			}
+		}
+	}
+
+	return cut;
+}
+
+//
+// A counter based random number: the same seed, stream and counter 
+// always give the same number, whichever thread asks.
+//
+// RETURNS: a well mixed 64 bit number
+//
+unsigned long long HYPERGRAPH_PARTITIONER::get_random
+(
+	const unsigned long long & stream, 
+	const unsigned long long & counter
+) const
+{
+	return RANDOM_STREAM::mix(static_cast<unsigned long long>(m_seed), stream, counter);
+}
+
+//
+// Coarsen until at most coarsen_to vertices are left or a level stops 
+// getting smaller.
+//
+// POST: levels[i] is the hypergraph of level i, each coarser than the one before
+//       coarse_vertices[i][v] is the vertex of levels[i] that vertex v of the 
+//       level before (the hypergraph itself for i = 0) was merged into
+//
+void HYPERGRAPH_PARTITIONER::coarsen
+(
+	const HYPERGRAPH & hypergraph, 
+	const HG_INDEX & coarsen_to, 
+	const unsigned long long & stream,
+	HYPERGRAPHS & levels, 
+	vector<HG_INDEXES> & coarse_vertices
+)
+{
+	// coarse vertices stay small enough to balance the parts
+	HG_WEIGHT max_vertex_weight = static_cast<HG_WEIGHT>(MAX(1LL, 
+		(3LL * hypergraph.get_total_weight()) / (2LL * coarsen_to)));
+	HG_INDEX nLevels = 0;
+
+	levels.clear();
+	coarse_vertices.clear();
+
+	while ((levels.empty() ? hypergraph : levels.back()).get_nVertices() > coarsen_to)
+	{
+		nLevels = static_cast<HG_INDEX>(levels.size());
+		levels.resize(nLevels + 1);
+		coarse_vertices.resize(nLevels + 1);
+
+		const HYPERGRAPH & fine = (nLevels == 0) ? hypergraph : levels[nLevels - 1];
+
+		if (! coarsen_level(fine, max_vertex_weight, get_random(stream, nLevels), 
+							levels.back(), coarse_vertices.back()))
+		{
+			levels.pop_back();
+			coarse_vertices.pop_back();
+			break;
+		}
+	}
+}
+
+//
+// POST: coarse is fine with its matched vertices merged
+// RETURNS: true if the level is enough smaller to keep
+//
+bool HYPERGRAPH_PARTITIONER::coarsen_level
+(
+	const HYPERGRAPH & fine, 
+	const HG_WEIGHT & max_vertex_weight, 
+	const unsigned long long & stream, 
+	HYPERGRAPH & coarse, 
+	HG_INDEXES & coarse_vertices
+)
+{
+	HG_INDEXES matches;
+
+	match_vertices(fine, max_vertex_weight, stream, matches);
+	contract(fine, matches, coarse, coarse_vertices);
+
+	return (coarse.get_nVertices() <= HG_MIN_COARSENING * fine.get_nVertices());
+}
+
+//
+// Heavy-edge matching.  In each round every free vertex picks, in 
+// parallel, the free neighbour it is most connected to; the picks are 
+// then granted in a random order.  A vertex whose pick was taken picks 
+// again in the next round.
+//
+// POST: matches[v] is the vertex v is merged with, v itself if none
+//
+void HYPERGRAPH_PARTITIONER::match_vertices
+(
+	const HYPERGRAPH & fine, 
+	const HG_WEIGHT & max_vertex_weight, 
+	const unsigned long long & stream, 
+	HG_INDEXES & matches
+)
+{
+	HG_INDEX nVertices = fine.get_nVertices();
+	HG_INDEXES preferred(nVertices);
+	HG_INDEXES order(nVertices);
+	vector<unsigned long long> tie_breaks(nVertices);
+	vector<vector<double> > thread_ratings(m_thread_pool.get_nThreads());
+	vector<HG_INDEXES> thread_neighbours(m_thread_pool.get_nThreads());
+	NUM_ELEMENTS nTasks = (nVertices + HG_ITEMS_PER_TASK - 1) / HG_ITEMS_PER_TASK;
+	HG_INDEX vertex = 0;
+	HG_INDEX nMatched = 0;
+	int round = 0;
+
+	matches.assign(nVertices, HG_NO_MATCH);
+
+	for (vertex = 0; vertex < nVertices; vertex++)
+	{
+		tie_breaks[vertex] = get_random(stream, vertex);
+		order[vertex] = vertex;
+	}
+	sort(order.begin(), order.end(), 
+		 [&tie_breaks](HG_INDEX a, HG_INDEX b) { return tie_breaks[a] < tie_breaks[b]; });
+
+	for (round = 0; round < HG_MATCHING_ROUNDS; round++)
+	{
+		m_thread_pool.run(nTasks, [&](NUM_ELEMENTS task_index, int thread_index)
+		{
+			vector<double> & ratings = thread_ratings[thread_index];
+			HG_INDEXES & neighbours = thread_neighbours[thread_index];
+			HG_INDEX first = static_cast<HG_INDEX>(task_index) * HG_ITEMS_PER_TASK;
+			HG_INDEX last = MIN(nVertices, first + HG_ITEMS_PER_TASK);
+			HG_INDEX vertex, neighbour, best;
+			const HG_INDEX * edge_iter;
+			const HG_INDEX * pin_iter;
+			HG_INDEX edge_size;
+			double rating, best_rating;
+
+			if (static_cast<HG_INDEX>(ratings.size()) != nVertices)
+			{
+				ratings.assign(nVertices, 0.0);
+			}
+
+			for (vertex = first; vertex < last; vertex++)
+			{
+				preferred[vertex] = vertex;
+				if (matches[vertex] != HG_NO_MATCH)
+				{
+					continue;
+				}
+
+				for (edge_iter = fine.edges_begin(vertex); edge_iter != fine.edges_end(vertex); edge_iter++)
+				{
+					edge_size = fine.get_edge_size(*edge_iter);
+					if (edge_size < 2 || edge_size > HG_MAX_RATED_EDGE_SIZE)
+					{
+						continue;
+					}
+
+					rating = static_cast<double>(fine.get_edge_weight(*edge_iter)) / (edge_size - 1);
+					for (pin_iter = fine.pins_begin(*edge_iter); pin_iter != fine.pins_end(*edge_iter); pin_iter++)
+					{
+						neighbour = *pin_iter;
+						if (neighbour == vertex || matches[neighbour] != HG_NO_MATCH ||
+							fine.get_vertex_weight(vertex) + fine.get_vertex_weight(neighbour) > max_vertex_weight)
+						{
+							continue;
+						}
+						if (ratings[neighbour] == 0.0)
+						{
+							neighbours.push_back(neighbour);
+						}
+						ratings[neighbour] += rating;
+					}
+				}
+
+				best = vertex;
+				best_rating = 0.0;
+				for (pin_iter = neighbours.data(); pin_iter != neighbours.data() + neighbours.size(); pin_iter++)
+				{
+					neighbour = *pin_iter;
+					if (ratings[neighbour] > best_rating || 
+						(ratings[neighbour] == best_rating && tie_breaks[neighbour] < tie_breaks[best]))
+					{
+						best = neighbour;
+						best_rating = ratings[neighbour];
+					}
+					ratings[neighbour] = 0.0;
+				}
+				neighbours.clear();
+
+				preferred[vertex] = best;
+			}
+		});
+
+		nMatched = 0;
+		for (vertex = 0; vertex < nVertices; vertex++)
+		{
+			HG_INDEX first = order[vertex];
+			HG_INDEX second = preferred[first];
+
+			if (matches[first] == HG_NO_MATCH && second != first && matches[second] == HG_NO_MATCH)
+			{
+				matches[first] = second;
+				matches[second] = first;
+				nMatched++;
+			}
+		}
+
+		if (nMatched == 0)
+		{
+			break;
+		}
+	}
+
+	for (vertex = 0; vertex < nVertices; vertex++)
+	{
+		if (matches[vertex] == HG_NO_MATCH)
+		{
+			matches[vertex] = vertex;
+		}
+	}
+}
+
+//
+// Merge the matched vertices.  The pins of each hyperedge are mapped to
+// the coarse vertices in parallel; hyperedges left with a single pin are 
+// dropped and hyperedges left with the same pins are merged, adding 
+// their weights.
+//
+// POST: coarse is the contracted hypergraph
+//       coarse_vertices[v] is the coarse vertex of fine vertex v
+//
+void HYPERGRAPH_PARTITIONER::contract
+(
+	const HYPERGRAPH & fine, 
+	const HG_INDEXES & matches, 
+	HYPERGRAPH & coarse, 
+	HG_INDEXES & coarse_vertices
+)
+{
+	HG_INDEX vertex = 0;
+	HG_INDEX nCoarse_vertices = 0;
+	HG_INDEX nEdges = fine.get_nEdges();
+	HG_INDEXES mapped_pins(fine.m_pins.size());
+	HG_INDEXES mapped_sizes(nEdges);
+	vector<unsigned long long> hashes(nEdges);
+	HG_INDEXES edge_order;
+	NUM_ELEMENTS nTasks = (nEdges + HG_ITEMS_PER_TASK - 1) / HG_ITEMS_PER_TASK;
+	HG_INDEX order_index = 0;
+	HG_INDEX edge = 0;
+
+	coarse_vertices.assign(fine.get_nVertices(), HG_NO_MATCH);
+	for (vertex = 0; vertex < fine.get_nVertices(); vertex++)
+	{
+		if (coarse_vertices[vertex] == HG_NO_MATCH)
+		{
+			coarse_vertices[vertex] = nCoarse_vertices;
+			coarse_vertices[matches[vertex]] = nCoarse_vertices;
+			nCoarse_vertices++;
+		}
+	}
+
+	coarse.m_vertex_weights.assign(nCoarse_vertices, 0);
+	for (vertex = 0; vertex < fine.get_nVertices(); vertex++)
+	{
+		coarse.m_vertex_weights[coarse_vertices[vertex]] += fine.get_vertex_weight(vertex);
+	}
+
+	m_thread_pool.run(nTasks, [&](NUM_ELEMENTS task_index, int)
+	{
+		HG_INDEX first = static_cast<HG_INDEX>(task_index) * HG_ITEMS_PER_TASK;
+		HG_INDEX last = MIN(nEdges, first + HG_ITEMS_PER_TASK);
+		HG_INDEX edge;
+		HG_INDEX * begin;
+		HG_INDEX * end;
+		HG_INDEX * pin_iter;
+		unsigned long long hash;
+
+		for (edge = first; edge < last; edge++)
+		{
+			begin = mapped_pins.data() + fine.m_edge_begin[edge];
+			end = mapped_pins.data() + fine.m_edge_begin[edge + 1];
+			for (pin_iter = begin; pin_iter != end; pin_iter++)
+			{
+				*pin_iter = coarse_vertices[fine.m_pins[pin_iter - mapped_pins.data()]];
+			}
+			sort(begin, end);
+			end = unique(begin, end);
+			mapped_sizes[edge] = static_cast<HG_INDEX>(end - begin);
+
+			hash = 0xCBF29CE484222325ULL;
+			for (pin_iter = begin; pin_iter != end; pin_iter++)
+			{
+				hash = (hash ^ static_cast<unsigned long long>(*pin_iter)) * 0x100000001B3ULL;
+			}
+			hashes[edge] = hash;
+		}
+	});
+
+	// bring the hyperedges with the same pins together
+	for (edge = 0; edge < nEdges; edge++)
+	{
+		if (mapped_sizes[edge] >= 2)
+		{
+			edge_order.push_back(edge);
+		}
+	}
+	sort(edge_order.begin(), edge_order.end(), [&](HG_INDEX a, HG_INDEX b)
+	{
+		HG_INDEXES::const_iterator a_pins = mapped_pins.begin() + fine.m_edge_begin[a];
+		HG_INDEXES::const_iterator b_pins = mapped_pins.begin() + fine.m_edge_begin[b];
+		pair<HG_INDEXES::const_iterator, HG_INDEXES::const_iterator> difference;
+
+		if (hashes[a] != hashes[b])
+		{
+			return hashes[a] < hashes[b];
+		}
+		if (mapped_sizes[a] != mapped_sizes[b])
+		{
+			return mapped_sizes[a] < mapped_sizes[b];
+		}
+		difference = mismatch(a_pins, a_pins + mapped_sizes[a], b_pins);
+		if (difference.first != a_pins + mapped_sizes[a])
+		{
+			return *difference.first < *difference.second;
+		}
+		return a < b;
+	});
+
+	coarse.m_edge_begin.assign(1, 0);
+	coarse.m_pins.clear();
+	coarse.m_edge_weights.clear();
+	for (order_index = 0; order_index < static_cast<HG_INDEX>(edge_order.size()); order_index++)
+	{
+		edge = edge_order[order_index];
+		HG_INDEXES::const_iterator begin = mapped_pins.begin() + fine.m_edge_begin[edge];
+		HG_INDEXES::const_iterator end = begin + mapped_sizes[edge];
+
+		if (! coarse.m_edge_weights.empty() && 
+			coarse.m_edge_begin.back() - coarse.m_edge_begin[coarse.m_edge_begin.size() - 2] == mapped_sizes[edge] &&
+			equal(begin, end, coarse.m_pins.begin() + coarse.m_edge_begin[coarse.m_edge_begin.size() - 2]))
+		{
+			coarse.m_edge_weights.back() += fine.get_edge_weight(edge);
+			continue;
+		}
+
+		coarse.m_pins.insert(coarse.m_pins.end(), begin, end);
+		coarse.m_edge_begin.push_back(static_cast<HG_INDEX>(coarse.m_pins.size()));
+		coarse.m_edge_weights.push_back(fine.get_edge_weight(edge));
+	}
+
+	coarse.connect_vertices();
+}
+
+//
+// Multilevel bisection
+//
+// POST: sides[v] is the side of vertex v.  side 0 aims for target_weight
+//       and neither side is heavier than its maximum if that can be helped
+//
+void HYPERGRAPH_PARTITIONER::bisect
+(
+	const HYPERGRAPH & hypergraph, 
+	const HG_WEIGHT & target_weight, 
+	const HG_WEIGHT max_weights[2], 
+	const unsigned long long & stream, 
+	HG_INDEXES & sides
+)
+{
+	HYPERGRAPHS levels;
+	vector<HG_INDEXES> coarse_vertices;
+	HG_INDEXES finer_sides;
+	BISECTION_REFINER refiner;
+	HG_INDEX level = 0;
+	HG_INDEX vertex = 0;
+
+	coarsen(hypergraph, HG_COARSEN_TO, get_random(stream, 0), levels, coarse_vertices);
+
+	bisect_initially(levels.empty() ? hypergraph : levels.back(), target_weight, max_weights, 
+					 get_random(stream, 1), sides);
+
+	for (level = static_cast<HG_INDEX>(levels.size()) - 1; level >= 0; level--)
+	{
+		const HYPERGRAPH & finer = (level == 0) ? hypergraph : levels[level - 1];
+
+		finer_sides.resize(finer.get_nVertices());
+		for (vertex = 0; vertex < finer.get_nVertices(); vertex++)
+		{
+			finer_sides[vertex] = sides[coarse_vertices[level][vertex]];
+		}
+		sides.swap(finer_sides);
+
+		refiner.refine(finer, max_weights, sides);
+	}
+}
+
+//
+// Grow a bisection from several random vertices at once and keep the best
+//
+// POST: sides[v] is the side of vertex v
+//
+void HYPERGRAPH_PARTITIONER::bisect_initially
+(
+	const HYPERGRAPH & hypergraph, 
+	const HG_WEIGHT & target_weight, 
+	const HG_WEIGHT max_weights[2], 
+	const unsigned long long & stream, 
+	HG_INDEXES & sides
+)
+{
+	vector<HG_INDEXES> tries(HG_INITIAL_TRIES);
+	HG_WEIGHTS cuts(HG_INITIAL_TRIES, 0);
+	HG_WEIGHTS overweights(HG_INITIAL_TRIES, 0);
+	vector<BISECTION_REFINER> thread_refiners(m_thread_pool.get_nThreads());
+	int try_index = 0;
+	int best_try = 0;
+
+	if (hypergraph.get_nVertices() == 0)
+	{
+		sides.clear();
+		return;
+	}
+
+	m_thread_pool.run(HG_INITIAL_TRIES, [&](NUM_ELEMENTS task_index, int thread_index)
+	{
+		HG_INDEX first_vertex = static_cast<HG_INDEX>(get_random(stream, task_index) % hypergraph.get_nVertices());
+		HG_WEIGHT side_weights[2] = {0, 0};
+		HG_INDEX vertex;
+
+		cuts[task_index] = thread_refiners[thread_index].grow(hypergraph, first_vertex, target_weight, 
+															  max_weights, tries[task_index]);
+
+		for (vertex = 0; vertex < hypergraph.get_nVertices(); vertex++)
+		{
+			side_weights[tries[task_index][vertex]] += hypergraph.get_vertex_weight(vertex);
+		}
+		overweights[task_index] = MAX(0, side_weights[0] - max_weights[0]) + 
+								  MAX(0, side_weights[1] - max_weights[1]);
+	});
+
+	for (try_index = 1; try_index < HG_INITIAL_TRIES; try_index++)
+	{
+		if (overweights[try_index] < overweights[best_try] || 
+			(overweights[try_index] == overweights[best_try] && cuts[try_index] < cuts[best_try]))
+		{
+			best_try = try_index;
+		}
+	}
+
+	sides.swap(tries[best_try]);
+}
+
+//
+// Split into nParts parts by bisecting and bisecting the sides again.
+// The cut hyperedges are dropped from the sides, as they are cut already.
+// As in hMetis each side weighs between (50-b)/(50+b) of its share, for 
+// an imbalance of b/50, so a side with parts is never left empty.
+//
+// PRE: imbalance is how much heavier or lighter than its share each side may be
+// POST: parts[v] is the part of vertex v, from first_part to first_part+nParts-1.
+//       each part has a vertex if there are at least nParts vertices
+//
+void HYPERGRAPH_PARTITIONER::bisect_recursively
+(
+	const HYPERGRAPH & hypergraph, 
+	const int & nParts, 
+	const int & first_part, 
+	const double & imbalance, 
+	const unsigned long long & stream, 
+	HG_INDEXES & parts
+)
+{
+	HG_INDEXES sides;
+	HG_INDEXES sub_parts;
+	HG_INDEXES vertices;
+	HYPERGRAPH sub_hypergraph;
+	HG_WEIGHT target_weights[2];
+	HG_WEIGHT min_weights[2];
+	HG_WEIGHT max_weights[2];
+	HG_INDEX nSide_vertices[2] = {0, 0};
+	int side_nParts[2];
+	int side_first_part[2];
+	HG_INDEX side = 0;
+	HG_INDEX index = 0;
+	HG_INDEX vertex = 0;
+
+	if (nParts <= 1 || hypergraph.get_nVertices() == 0)
+	{
+		parts.assign(hypergraph.get_nVertices(), first_part);
+		return;
+	}
+
+	side_nParts[0] = nParts / 2;
+	side_nParts[1] = nParts - side_nParts[0];
+	side_first_part[0] = first_part;
+	side_first_part[1] = first_part + side_nParts[0];
+
+	target_weights[0] = static_cast<HG_WEIGHT>((static_cast<long long>(hypergraph.get_total_weight()) * 
+												side_nParts[0]) / nParts);
+	target_weights[1] = hypergraph.get_total_weight() - target_weights[0];
+	for (side = 0; side < 2; side++)
+	{
+		min_weights[side] = MAX(static_cast<HG_WEIGHT>(side_nParts[side]), 
+							static_cast<HG_WEIGHT>(ceil(target_weights[side] * (1.0 - imbalance))));
+		max_weights[side] = MAX(target_weights[side] + 1, 
+							static_cast<HG_WEIGHT>(floor(target_weights[side] * (1.0 + imbalance))));
+	}
+
+	// a side under its minimum makes the other side overweight, which the 
+	// refiner brings back
+	for (side = 0; side < 2; side++)
+	{
+		max_weights[side] = MAX(target_weights[side], 
+							MIN(max_weights[side], hypergraph.get_total_weight() - min_weights[1 - side]));
+	}
+
+	bisect(hypergraph, target_weights[0], max_weights, get_random(stream, 0), sides);
+
+	// a vertex for each part of a side, taken from the other side's spares
+	for (vertex = 0; vertex < hypergraph.get_nVertices(); vertex++)
+	{
+		nSide_vertices[sides[vertex]]++;
+	}
+	for (vertex = 0; vertex < hypergraph.get_nVertices(); vertex++)
+	{
+		side = 1 - sides[vertex];
+		if (nSide_vertices[side] < side_nParts[side] && nSide_vertices[1 - side] > side_nParts[1 - side])
+		{
+			sides[vertex] = side;
+			nSide_vertices[side]++;
+			nSide_vertices[1 - side]--;
+		}
+	}
+
+	parts.resize(hypergraph.get_nVertices());
+	for (side = 0; side < 2; side++)
+	{
+		extract_side(hypergraph, sides, side, sub_hypergraph, vertices);
+		bisect_recursively(sub_hypergraph, side_nParts[side], side_first_part[side], imbalance, 
+						   get_random(stream, 1 + side), sub_parts);
+
+		for (index = 0; index < static_cast<HG_INDEX>(vertices.size()); index++)
+		{
+			parts[vertices[index]] = sub_parts[index];
+		}
+	}
+}
+
+//
+// POST: sub_hypergraph holds the vertices on side and the hyperedges 
+//       with all their pins there.  vertices[i] is the vertex that 
+//       became vertex i of sub_hypergraph
+//
+void HYPERGRAPH_PARTITIONER::extract_side
+(
+	const HYPERGRAPH & hypergraph, 
+	const HG_INDEXES & sides, 
+	const HG_INDEX & side,
+	HYPERGRAPH & sub_hypergraph, 
+	HG_INDEXES & vertices
+)
+{
+	HG_INDEXES sub_vertices(hypergraph.get_nVertices(), HG_NO_MATCH);
+	HG_INDEX vertex = 0;
+	HG_INDEX edge = 0;
+	const HG_INDEX * pin_iter;
+	bool is_inside = false;
+
+	vertices.clear();
+	sub_hypergraph.m_vertex_weights.clear();
+	for (vertex = 0; vertex < hypergraph.get_nVertices(); vertex++)
+	{
+		if (sides[vertex] == side)
+		{
+			sub_vertices[vertex] = static_cast<HG_INDEX>(vertices.size());
+			vertices.push_back(vertex);
+			sub_hypergraph.m_vertex_weights.push_back(hypergraph.get_vertex_weight(vertex));
+		}
+	}
+
+	sub_hypergraph.m_edge_begin.assign(1, 0);
+	sub_hypergraph.m_pins.clear();
+	sub_hypergraph.m_edge_weights.clear();
+	for (edge = 0; edge < hypergraph.get_nEdges(); edge++)
+	{
+		if (hypergraph.get_edge_size(edge) < 2)
+		{
+			continue;
+		}
+
+		is_inside = true;
+		for (pin_iter = hypergraph.pins_begin(edge); pin_iter != hypergraph.pins_end(edge) && is_inside; pin_iter++)
+		{
+			is_inside = (sides[*pin_iter] == side);
+		}
+		if (! is_inside)
+		{
+			continue;
+		}
+
+		for (pin_iter = hypergraph.pins_begin(edge); pin_iter != hypergraph.pins_end(edge); pin_iter++)
+		{
+			sub_hypergraph.m_pins.push_back(sub_vertices[*pin_iter]);
+		}
+		sub_hypergraph.m_edge_begin.push_back(static_cast<HG_INDEX>(sub_hypergraph.m_pins.size()));
+		sub_hypergraph.m_edge_weights.push_back(hypergraph.get_edge_weight(edge));
+	}
+
+	sub_hypergraph.connect_vertices();
+}
+
+//
+// Greedy k-way refinement.  Each pass finds the best move of every vertex
+// in parallel, then makes the moves from the best gain down, checking 
+// each against the moves already made.  A move must lower the cut, or 
+// keep it and even out the part weights, or take a vertex out of an 
+// overweight part or into an underweight one.
+//
+// POST: parts has been improved until a pass moved nothing
+//
+void HYPERGRAPH_PARTITIONER::refine_kway
+(
+	const HYPERGRAPH & hypergraph, 
+	const int & nParts, 
+	const HG_WEIGHT & min_part_weight, 
+	const HG_WEIGHT & max_part_weight, 
+	HG_INDEXES & parts
+)
+{
+	HG_INDEX nVertices = hypergraph.get_nVertices();
+	HG_WEIGHTS part_weights(nParts, 0);
+	HG_INDEXES best_parts(nVertices);
+	HG_WEIGHTS best_gains(nVertices);
+	HG_INDEXES candidates;
+	vector<KWAY_MOVE_SCRATCH> thread_scratch(m_thread_pool.get_nThreads());
+	NUM_ELEMENTS nTasks = (nVertices + HG_ITEMS_PER_TASK - 1) / HG_ITEMS_PER_TASK;
+	HG_INDEX vertex = 0;
+	HG_INDEX best_part = 0;
+	HG_INDEX index = 0;
+	HG_INDEX nMoved = 0;
+	int pass = 0;
+
+	for (index = 0; index < static_cast<HG_INDEX>(thread_scratch.size()); index++)
+	{
+		thread_scratch[index].gains.assign(nParts, 0);
+		thread_scratch[index].is_adjacent.assign(nParts, false);
+		thread_scratch[index].pin_counts.assign(nParts, 0);
+	}
+
+	for (vertex = 0; vertex < nVertices; vertex++)
+	{
+		assert(parts[vertex] >= 0 && parts[vertex] < nParts);
+		part_weights[parts[vertex]] += hypergraph.get_vertex_weight(vertex);
+	}
+
+	for (pass = 0; pass < HG_KWAY_PASSES; pass++)
+	{
+		m_thread_pool.run(nTasks, [&](NUM_ELEMENTS task_index, int thread_index)
+		{
+			HG_INDEX first = static_cast<HG_INDEX>(task_index) * HG_ITEMS_PER_TASK;
+			HG_INDEX last = MIN(nVertices, first + HG_ITEMS_PER_TASK);
+			HG_INDEX vertex;
+
+			for (vertex = first; vertex < last; vertex++)
+			{
+				best_gains[vertex] = get_best_kway_move(hypergraph, parts, part_weights, min_part_weight, 
+											max_part_weight, vertex, thread_scratch[thread_index], best_parts[vertex]);
+			}
+		});
+
+		candidates.clear();
+		for (vertex = 0; vertex < nVertices; vertex++)
+		{
+			if (best_parts[vertex] != parts[vertex])
+			{
+				candidates.push_back(vertex);
+			}
+		}
+		sort(candidates.begin(), candidates.end(), [&best_gains](HG_INDEX a, HG_INDEX b)
+		{
+			return best_gains[a] > best_gains[b] || (best_gains[a] == best_gains[b] && a < b);
+		});
+
+		nMoved = 0;
+		for (index = 0; index < static_cast<HG_INDEX>(candidates.size()); index++)
+		{
+			vertex = candidates[index];
+			get_best_kway_move(hypergraph, parts, part_weights, min_part_weight, max_part_weight, 
+							   vertex, thread_scratch[0], best_part);
+			if (best_part != parts[vertex])
+			{
+				part_weights[parts[vertex]] -= hypergraph.get_vertex_weight(vertex);
+				part_weights[best_part] += hypergraph.get_vertex_weight(vertex);
+				parts[vertex] = best_part;
+				nMoved++;
+			}
+		}
+
+		if (nMoved == 0)
+		{
+			break;
+		}
+	}
+}
+
+//
+// Find where a vertex is best moved to.  The pins of each of its 
+// hyperedges are counted per part: moving the vertex to part p uncuts the
+// hyperedge if all its other pins are in p, and cuts it if all its pins 
+// are in the vertex's part.
+//
+// POST: best_part is the part the vertex should move to, its own part if none
+// RETURNS: the drop in the cut weight the move gives
+//
+HG_WEIGHT HYPERGRAPH_PARTITIONER::get_best_kway_move
+(
+	const HYPERGRAPH & hypergraph, 
+	const HG_INDEXES & parts, 
+	const HG_WEIGHTS & part_weights, 
+	const HG_WEIGHT & min_part_weight, 
+	const HG_WEIGHT & max_part_weight, 
+	const HG_INDEX & vertex, 
+	KWAY_MOVE_SCRATCH & scratch, 
+	HG_INDEX & best_part
+) const
+{
+	HG_INDEX from_part = parts[vertex];
+	HG_WEIGHT weight = hypergraph.get_vertex_weight(vertex);
+	bool is_overweight = (part_weights[from_part] > max_part_weight);
+	bool can_leave = (is_overweight || part_weights[from_part] - weight >= min_part_weight);
+	HG_WEIGHT internal_weight = 0;		// of the hyperedges the move would cut
+	HG_WEIGHT best_gain = 0;
+	HG_WEIGHT gain = 0;
+	HG_INDEX edge_size = 0;
+	HG_INDEX part = 0;
+	const HG_INDEX * edge_iter;
+	const HG_INDEX * pin_iter;
+	HG_INDEXES::const_iterator part_iter;
+	bool is_acceptable = false;
+
+	best_part = from_part;
+	if (! can_leave)
+	{
+		return 0;
+	}
+
+	for (edge_iter = hypergraph.edges_begin(vertex); edge_iter != hypergraph.edges_end(vertex); edge_iter++)
+	{
+		edge_size = hypergraph.get_edge_size(*edge_iter);
+		if (edge_size < 2)
+		{
+			continue;
+		}
+
+		for (pin_iter = hypergraph.pins_begin(*edge_iter); pin_iter != hypergraph.pins_end(*edge_iter); pin_iter++)
+		{
+			if (scratch.pin_counts[parts[*pin_iter]]++ == 0)
+			{
+				scratch.edge_parts.push_back(parts[*pin_iter]);
+			}
+		}
+
+		if (scratch.pin_counts[from_part] == edge_size)
+		{
+			internal_weight += hypergraph.get_edge_weight(*edge_iter);
+		}
+
+		for (part_iter = scratch.edge_parts.begin(); part_iter != scratch.edge_parts.end(); part_iter++)
+		{
+			if (*part_iter == from_part)
+			{
+				continue;
+			}
+			if (! scratch.is_adjacent[*part_iter])
+			{
+				scratch.is_adjacent[*part_iter] = true;
+				scratch.adjacent_parts.push_back(*part_iter);
+			}
+			if (scratch.pin_counts[*part_iter] == edge_size - 1)
+			{
+				scratch.gains[*part_iter] += hypergraph.get_edge_weight(*edge_iter);
+			}
+		}
+
+		for (part_iter = scratch.edge_parts.begin(); part_iter != scratch.edge_parts.end(); part_iter++)
+		{
+			scratch.pin_counts[*part_iter] = 0;
+		}
+		scratch.edge_parts.clear();
+	}
+
+	for (part_iter = scratch.adjacent_parts.begin(); part_iter != scratch.adjacent_parts.end(); part_iter++)
+	{
+		part = *part_iter;
+		gain = scratch.gains[part] - internal_weight;
+		scratch.gains[part] = 0;
+		scratch.is_adjacent[part] = false;
+
+		if (part_weights[part] + weight > max_part_weight)
+		{
+			continue;
+		}
+
+		is_acceptable = (gain > 0 || is_overweight || part_weights[part] < min_part_weight ||
+						 (gain == 0 && part_weights[part] + weight < part_weights[from_part]));
+		if (is_acceptable && 
+			(best_part == from_part || gain > best_gain || 
+			 (gain == best_gain && part_weights[part] < part_weights[best_part])))
+		{
+			best_part = part;
+			best_gain = gain;
+		}
+	}
+	scratch.adjacent_parts.clear();
+
+	// an overweight part gives its vertex to the lightest part with room if need be
+	if (is_overweight && best_part == from_part)
+	{
+		for (part = 0; part < static_cast<HG_INDEX>(part_weights.size()); part++)
+		{
+			if (part != from_part && part_weights[part] + weight <= max_part_weight && 
+				(best_part == from_part || part_weights[part] < part_weights[best_part]))
+			{
+				best_part = part;
+				best_gain = -internal_weight;
+			}
+		}
+	}
+
+	return (best_part == from_part) ? 0 : best_gain;
+}
@@ -0,0 +1,237 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef hypergraph_partitioner_H
+#define hypergraph_partitioner_H
+
+#include <vector>
+#include <deque>
+#include <queue>
+#include <utility>
+using namespace std;
+#include "types.h"
+#include "thread_pool.h"
+
+typedef int HG_INDEX;					// a vertex, hyperedge or part
+typedef int HG_WEIGHT;
+typedef vector<HG_INDEX> HG_INDEXES;
+typedef vector<HG_WEIGHT> HG_WEIGHTS;
+
+//
+// Class_name HYPERGRAPH
+//
+// Description
+//
+//	Weighted vertices joined by weighted hyperedges, kept in the layout 
+//	hMetis takes: the pins of hyperedge e are 
+//	pins[edge_begin[e]] .. pins[edge_begin[e+1]-1].  The hyperedges of 
+//	each vertex are kept the same way so that both directions are a 
+//	single array walk.
+//
+
+class HYPERGRAPH
+{
+public:
+	HYPERGRAPH();
+	HYPERGRAPH(const HYPERGRAPH & another_hypergraph);
+	HYPERGRAPH & operator=(const HYPERGRAPH & another_hypergraph);
+	~HYPERGRAPH();
+
+	// the weights can be 0 for weights of 1
+	void		set(const HG_INDEX & nVertices, const HG_INDEX & nEdges, 
+					const int * edge_begin, const int * pins, 
+					const int * vertex_weights, const int * edge_weights);
+
+	HG_INDEX	get_nVertices() const { return static_cast<HG_INDEX>(m_vertex_weights.size()); }
+	HG_INDEX	get_nEdges() const { return static_cast<HG_INDEX>(m_edge_weights.size()); }
+	HG_WEIGHT	get_total_weight() const { return m_total_weight; }
+	HG_WEIGHT	get_vertex_weight(const HG_INDEX & vertex) const { return m_vertex_weights[vertex]; }
+	HG_WEIGHT	get_edge_weight(const HG_INDEX & edge) const { return m_edge_weights[edge]; }
+	HG_INDEX	get_edge_size(const HG_INDEX & edge) const 
+					{ return m_edge_begin[edge+1] - m_edge_begin[edge]; }
+
+	const HG_INDEX *	pins_begin(const HG_INDEX & edge) const { return m_pins.data() + m_edge_begin[edge]; }
+	const HG_INDEX *	pins_end(const HG_INDEX & edge) const { return m_pins.data() + m_edge_begin[edge+1]; }
+	const HG_INDEX *	edges_begin(const HG_INDEX & vertex) const 
+							{ return m_incident_edges.data() + m_vertex_begin[vertex]; }
+	const HG_INDEX *	edges_end(const HG_INDEX & vertex) const 
+							{ return m_incident_edges.data() + m_vertex_begin[vertex+1]; }
+
+private:
+	HG_WEIGHTS	m_vertex_weights;
+	HG_WEIGHTS	m_edge_weights;
+	HG_WEIGHT	m_total_weight;
+	HG_INDEXES	m_edge_begin;		// nEdges + 1 entries
+	HG_INDEXES	m_pins;
+	HG_INDEXES	m_vertex_begin;		// nVertices + 1 entries
+	HG_INDEXES	m_incident_edges;
+
+	friend class HYPERGRAPH_PARTITIONER;	// builds the coarse hypergraphs in place
+
+	void		connect_vertices();
+};
+
+typedef deque<HYPERGRAPH> HYPERGRAPHS;		// the levels stay put as more are added
+
+
+//
+// Class_name BISECTION_REFINER
+//
+// Description
+//
+//	Fiduccia-Mattheyses refinement of a bisection.  Each pass moves the 
+//	unlocked vertex with the highest gain from either side, as long as the
+//	side it moves to stays under its maximum weight, then keeps the best
+//	prefix of the moves.  The gains are kept in a lazy max-heap per side: 
+//	a changed gain is pushed again and stale entries are dropped when 
+//	they reach the top.
+//
+//	It also grows an initial bisection: from everything on side 1, the
+//	best vertices are moved to side 0 until side 0 has its target weight.
+//
+
+class BISECTION_REFINER
+{
+public:
+	BISECTION_REFINER();
+	BISECTION_REFINER(const BISECTION_REFINER & another_refiner);
+	BISECTION_REFINER & operator=(const BISECTION_REFINER & another_refiner);
+	~BISECTION_REFINER();
+
+	// RETURNS: the weight of the hyperedges cut
+	HG_WEIGHT	grow(const HYPERGRAPH & hypergraph, const HG_INDEX & first_vertex, 
+					 const HG_WEIGHT & target_weight, const HG_WEIGHT max_weights[2], HG_INDEXES & sides);
+	HG_WEIGHT	refine(const HYPERGRAPH & hypergraph, const HG_WEIGHT max_weights[2], HG_INDEXES & sides);
+
+private:
+	typedef pair<HG_WEIGHT, HG_INDEX> GAIN_ENTRY;
+	typedef priority_queue<GAIN_ENTRY> GAIN_HEAP;
+
+	const HYPERGRAPH *	m_hypergraph;
+	HG_INDEXES *		m_sides;
+	HG_INDEXES			m_pin_counts;		// 2 per hyperedge: the pins on side 0 and side 1
+	HG_WEIGHTS			m_gains;
+	vector<bool>		m_is_locked;
+	GAIN_HEAP			m_heaps[2];			// the vertices that can leave each side
+	HG_WEIGHT			m_side_weights[2];
+	HG_WEIGHT			m_cut;
+	HG_INDEXES			m_moves;
+
+	void		start(const HYPERGRAPH & hypergraph, HG_INDEXES & sides);
+	void		compute_gains();
+	HG_WEIGHT	get_edge_gain(const HG_INDEX & edge, const HG_INDEX & side) const;
+	bool		get_best_move(const HG_INDEX & from_side, HG_INDEX & vertex);
+	void		move(const HG_INDEX & vertex);
+	bool		do_pass(const HG_WEIGHT max_weights[2]);
+	HG_WEIGHT	get_overweight(const HG_WEIGHT max_weights[2]) const;
+};
+
+
+//
+// What a thread needs to find the best k-way move of a vertex
+//
+struct KWAY_MOVE_SCRATCH
+{
+	HG_WEIGHTS	gains;			// per part: the hyperedge weight a move there uncuts
+	vector<bool>	is_adjacent;	// per part: shares a hyperedge with the vertex
+	HG_INDEXES	adjacent_parts;
+	HG_INDEXES	pin_counts;		// per part: the pins of the hyperedge being looked at
+	HG_INDEXES	edge_parts;		// the parts with a pin count
+};
+
+
+//
+// Class_name HYPERGRAPH_PARTITIONER
+//
+// Description
+//
+//	Multilevel hypergraph partitioning in the manner of hMetis.
+//
+//	The hypergraph is coarsened by heavy-edge matching: each vertex is 
+//	paired with the free neighbour it shares the most hyperedge weight 
+//	with, a hyperedge of p pins counting 1/(p-1) of its weight per pair.  
+//	The coarsest hypergraph is bisected by growing the best of several 
+//	random starts and the bisection is refined by FM on each level on the 
+//	way back up.
+//
+//	partition_recursive() bisects recursively, each bisection giving each 
+//	side between (50 - ubfactor)% and (50 + ubfactor)% of the weight, 
+//	scaled to the number of parts going to each side.  
+//
+//	partition_kway() coarsens once for all the parts, partitions the 
+//	coarsest hypergraph by recursive bisection and refines all the parts 
+//	together on the way up.  Each part is kept within ubfactor% of the 
+//	average part.
+//
+//	The matching, the contraction, the initial bisections and the search 
+//	for k-way moves run on the thread pool.  The randomness comes from 
+//	hashing the seed with what is being decided, so the result depends 
+//	on the seed only and not on the number of threads.
+//
+
+class HYPERGRAPH_PARTITIONER
+{
+public:
+	HYPERGRAPH_PARTITIONER(const int & nThreads, const long & seed);
+	HYPERGRAPH_PARTITIONER(const HYPERGRAPH_PARTITIONER & another_partitioner);
+	HYPERGRAPH_PARTITIONER & operator=(const HYPERGRAPH_PARTITIONER & another_partitioner);
+	~HYPERGRAPH_PARTITIONER();
+
+	// RETURNS: the number of hyperedges cut.  parts[v] is the part of vertex v
+	HG_WEIGHT	partition_kway(const HYPERGRAPH & hypergraph, const int & nParts, 
+						const int & ubfactor, HG_INDEXES & parts);
+	HG_WEIGHT	partition_recursive(const HYPERGRAPH & hypergraph, const int & nParts, 
+						const int & ubfactor, HG_INDEXES & parts);
+
+	// RETURNS: the weight of the hyperedges that span more than one part
+	static HG_WEIGHT	get_cut(const HYPERGRAPH & hypergraph, const HG_INDEXES & parts);
+
+private:
+	THREAD_POOL		m_thread_pool;
+	long			m_seed;
+
+	unsigned long long	get_random(const unsigned long long & stream, const unsigned long long & counter) const;
+
+	void	coarsen(const HYPERGRAPH & hypergraph, const HG_INDEX & coarsen_to, const unsigned long long & stream,
+					HYPERGRAPHS & levels, vector<HG_INDEXES> & coarse_vertices);
+	bool	coarsen_level(const HYPERGRAPH & fine, const HG_WEIGHT & max_vertex_weight, 
+					const unsigned long long & stream, HYPERGRAPH & coarse, HG_INDEXES & coarse_vertices);
+	void	match_vertices(const HYPERGRAPH & fine, const HG_WEIGHT & max_vertex_weight,
+					const unsigned long long & stream, HG_INDEXES & matches);
+	void	contract(const HYPERGRAPH & fine, const HG_INDEXES & matches, 
+					HYPERGRAPH & coarse, HG_INDEXES & coarse_vertices);
+
+	void	bisect(const HYPERGRAPH & hypergraph, const HG_WEIGHT & target_weight, 
+					const HG_WEIGHT max_weights[2], const unsigned long long & stream, HG_INDEXES & sides);
+	void	bisect_initially(const HYPERGRAPH & hypergraph, const HG_WEIGHT & target_weight, 
+					const HG_WEIGHT max_weights[2], const unsigned long long & stream, HG_INDEXES & sides);
+	void	bisect_recursively(const HYPERGRAPH & hypergraph, const int & nParts, const int & first_part,
+					const double & imbalance, const unsigned long long & stream, HG_INDEXES & parts);
+	void	extract_side(const HYPERGRAPH & hypergraph, const HG_INDEXES & sides, const HG_INDEX & side,
+					HYPERGRAPH & sub_hypergraph, HG_INDEXES & vertices);
+
+	void	refine_kway(const HYPERGRAPH & hypergraph, const int & nParts, const HG_WEIGHT & min_part_weight,
+					const HG_WEIGHT & max_part_weight, HG_INDEXES & parts);
+	HG_WEIGHT	get_best_kway_move(const HYPERGRAPH & hypergraph, const HG_INDEXES & parts, 
+					const HG_WEIGHTS & part_weights, const HG_WEIGHT & min_part_weight, 
+					const HG_WEIGHT & max_part_weight, const HG_INDEX & vertex, 
+					KWAY_MOVE_SCRATCH & scratch, HG_INDEX & best_part) const;
+};
+
+#endif
@@ -0,0 +1,524 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#include "incremental_analyzer.h"
+#include "delay_leveler.h"
+#include "rnum.h"
+
+INCREMENTAL_ANALYZER::INCREMENTAL_ANALYZER()
+{
+	m_previous_frozen_circuit = 0;
+	m_frozen_circuit = 0;
+
+	m_nChanged_nodes = 0;
+	m_nReused_PI = 0;
+	m_nCounted_PI = 0;
+}
+
+INCREMENTAL_ANALYZER::INCREMENTAL_ANALYZER(const INCREMENTAL_ANALYZER & another_incremental_analyzer)
+{
+	assert(false);
+	m_previous_frozen_circuit	= another_incremental_analyzer.m_previous_frozen_circuit;
+	m_frozen_circuit			= another_incremental_analyzer.m_frozen_circuit;
+	m_previous_node				= another_incremental_analyzer.m_previous_node;
+	m_is_changed				= another_incremental_analyzer.m_is_changed;
+	m_is_previous_changed		= another_incremental_analyzer.m_is_previous_changed;
+	m_known_levels				= another_incremental_analyzer.m_known_levels;
+	m_nChanged_nodes			= another_incremental_analyzer.m_nChanged_nodes;
+	m_nReused_PI				= another_incremental_analyzer.m_nReused_PI;
+	m_nCounted_PI				= another_incremental_analyzer.m_nCounted_PI;
+}
+
+INCREMENTAL_ANALYZER & INCREMENTAL_ANALYZER::operator=(const INCREMENTAL_ANALYZER & another_incremental_analyzer)
+{
+	assert(false);
+	m_previous_frozen_circuit	= another_incremental_analyzer.m_previous_frozen_circuit;
+	m_frozen_circuit			= another_incremental_analyzer.m_frozen_circuit;
+	m_previous_node				= another_incremental_analyzer.m_previous_node;
+	m_is_changed				= another_incremental_analyzer.m_is_changed;
+	m_is_previous_changed		= another_incremental_analyzer.m_is_previous_changed;
+	m_known_levels				= another_incremental_analyzer.m_known_levels;
+	m_nChanged_nodes			= another_incremental_analyzer.m_nChanged_nodes;
+	m_nReused_PI				= another_incremental_analyzer.m_nReused_PI;
+	m_nCounted_PI				= another_incremental_analyzer.m_nCounted_PI;
+
+	return (*this);
+}
+
+INCREMENTAL_ANALYZER::~INCREMENTAL_ANALYZER()
+{
+}
+
+//
+// Match the circuit against the previous one and carry over what has 
+// not changed
+//
+// PRE: both circuits are frozen
+//      the previous circuit has been fully analyzed
+// POST: the known levels hold the delay level of each node that is not 
+//       downstream of a change, UNKNOWN_DELAY_LEVEL otherwise
+//       the circuit has the rnum contribution of each primary input whose 
+//       cone is unchanged
+//
+void INCREMENTAL_ANALYZER::match_circuits
+(
+	CIRCUIT * previous_circuit,
+	CIRCUIT * circuit
+)
+{
+	assert(previous_circuit && previous_circuit->is_frozen());
+	assert(circuit && circuit->is_frozen());
+
+	vector<NAME_ID> previous_name_ids;
+	NUM_ELEMENTS nPrevious_names = previous_circuit->get_name_pool()->get_nNames();
+
+	m_previous_frozen_circuit = previous_circuit->get_frozen_circuit();
+	m_frozen_circuit = circuit->get_frozen_circuit();
+
+	translate_names(previous_circuit, circuit, previous_name_ids);
+	match_nodes(previous_name_ids, nPrevious_names);
+	mark_nodes_out_of_order();
+	find_known_levels();
+	carry_over_rnum_contributions(previous_name_ids, nPrevious_names);
+
+	Log("Incremental: " << m_nChanged_nodes << " of " << m_frozen_circuit->get_nNodes() <<
+		" nodes changed, reusing " << m_nReused_PI << " of " << m_nCounted_PI << 
+		" primary input cones");
+}
+
+//
+// Check the carried over analysis against a full analysis of the circuit
+//
+// PRE: the circuits have been matched and the delay levels calculated
+// POST: every rnum contribution of the circuit is known
+//       we have failed if anything differs from the full analysis
+//
+void INCREMENTAL_ANALYZER::verify()
+{
+	assert(m_frozen_circuit);
+
+	DELAY_LEVELER delay_leveler;
+	DELAYS levels;
+	DELAY_TYPE max_level = 0;
+	RNUM_CONTRIBUTIONS & contributions = m_frozen_circuit->get_rnum_contributions();
+	RNUM_CONTRIBUTIONS full_contributions;
+	NODE_INDEX node = 0;
+	NODE_INDEX pi_index = 0;
+
+	delay_leveler.find_levels(m_frozen_circuit, DELAYS(), levels, max_level);
+
+	if (max_level != m_frozen_circuit->get_max_level())
+	{
+		Fail("Incremental analysis found a max delay level of " << m_frozen_circuit->get_max_level() <<
+			 " instead of " << max_level);
+	}
+	for (node = 0; node < m_frozen_circuit->get_nNodes(); node++)
+	{
+		if (levels[node] != m_frozen_circuit->get_level(node))
+		{
+			Fail("Incremental analysis found a delay level of " << m_frozen_circuit->get_level(node) <<
+				 " instead of " << levels[node] << " for node " << 
+				 m_frozen_circuit->get_node(node)->get_name());
+		}
+	}
+
+	rnum_contributions(m_frozen_circuit, &contributions);
+	rnum_contributions(m_frozen_circuit, &full_contributions);
+
+	for (pi_index = 0; pi_index < m_frozen_circuit->get_nPI(); pi_index++)
+	{
+		if (contributions[pi_index].logdet != full_contributions[pi_index].logdet ||
+			contributions[pi_index].cone_size != full_contributions[pi_index].cone_size)
+		{
+			Fail("Incremental analysis found a different reconvergence for primary input " <<
+				 m_frozen_circuit->get_PI(pi_index)->get_name());
+		}
+	}
+
+	Log("Incremental: the analysis matches a full analysis");
+}
+
+//
+// PRE: the circuits have name pools
+// POST: previous_name_ids holds, for each name of the circuit, the id of 
+//       the same name in the previous circuit or NO_NAME_ID
+//
+void INCREMENTAL_ANALYZER::translate_names
+(
+	CIRCUIT * previous_circuit,
+	CIRCUIT * circuit,
+	vector<NAME_ID> & previous_name_ids
+) const
+{
+	const NAME_POOL * previous_name_pool = previous_circuit->get_name_pool();
+	const NAME_POOL * name_pool = circuit->get_name_pool();
+	NAME_ID name_id = 0;
+
+	previous_name_ids.resize(name_pool->get_nNames());
+
+	for (name_id = 0; name_id < name_pool->get_nNames(); name_id++)
+	{
+		previous_name_ids[name_id] = previous_name_pool->find(name_pool->get_text(name_id), 
+															   name_pool->get_length(name_id));
+	}
+}
+
+//
+// Match each node to the node of the same name in the previous circuit 
+// and find the ones that have changed
+//
+// PRE: previous_name_ids translates the names of the circuit
+// POST: m_previous_node holds the match of each node, if it has one
+//       m_is_changed is set for each node without a match or that differs 
+//       from its match
+//
+void INCREMENTAL_ANALYZER::match_nodes
+(
+	const vector<NAME_ID> & previous_name_ids,
+	NUM_ELEMENTS nPrevious_names
+)
+{
+	NODE_INDEX nNodes = m_frozen_circuit->get_nNodes();
+	NODE_INDEXES previous_node_by_name(nPrevious_names, NO_NODE_INDEX);
+	vector<char> is_previous_matched(m_previous_frozen_circuit->get_nNodes(), 0);
+	NODE_INDEX node = 0;
+	NODE_INDEX previous_node = NO_NODE_INDEX;
+	NAME_ID name_id = NO_NAME_ID;
+
+	for (node = 0; node < m_previous_frozen_circuit->get_nNodes(); node++)
+	{
+		previous_node_by_name[m_previous_frozen_circuit->get_node(node)->get_name_id()] = node;
+	}
+
+	// a node is matched at most once so that nodes with the same name 
+	// can't both be taken as unchanged
+	m_previous_node.assign(nNodes, NO_NODE_INDEX);
+	for (node = 0; node < nNodes; node++)
+	{
+		name_id = previous_name_ids[m_frozen_circuit->get_node(node)->get_name_id()];
+		previous_node = (name_id == NO_NAME_ID ? NO_NODE_INDEX : previous_node_by_name[name_id]);
+
+		if (previous_node != NO_NODE_INDEX && ! is_previous_matched[previous_node])
+		{
+			m_previous_node[node] = previous_node;
+			is_previous_matched[previous_node] = 1;
+		}
+	}
+
+	m_is_changed.assign(nNodes, 0);
+	for (node = 0; node < nNodes; node++)
+	{
+		m_is_changed[node] = is_node_changed(node, previous_name_ids);
+	}
+}
+
+//
+// RETURNS: true if the node has no match or it differs from its match in 
+//          type, output or fanin
+//
+bool INCREMENTAL_ANALYZER::is_node_changed
+(
+	const NODE_INDEX & node,
+	const vector<NAME_ID> & previous_name_ids
+) const
+{
+	NODE_INDEX previous_node = m_previous_node[node];
+	const NODE_INDEX * source_iter;
+	const NODE_INDEX * previous_source_iter;
+	NUM_ELEMENTS fanin_index = 0;
+	NAME_ID name_id = NO_NAME_ID;
+
+	if (previous_node == NO_NODE_INDEX ||
+		m_frozen_circuit->get_type(node) != m_previous_frozen_circuit->get_type(previous_node) ||
+		m_frozen_circuit->is_PO(node) != m_previous_frozen_circuit->is_PO(previous_node) ||
+		m_frozen_circuit->get_fanin_degree(node) != m_previous_frozen_circuit->get_fanin_degree(previous_node))
+	{
+		return true;
+	}
+
+	// the fanin must come from the matches of the same nodes, or from 
+	// primary inputs of the same name, in the same order
+	previous_source_iter = m_previous_frozen_circuit->fanin_begin(previous_node);
+	for (source_iter = m_frozen_circuit->fanin_begin(node); 
+		 source_iter != m_frozen_circuit->fanin_end(node); 
+		 source_iter++, previous_source_iter++, fanin_index++)
+	{
+		if (*source_iter == NO_NODE_INDEX)
+		{
+			name_id = m_frozen_circuit->get_node(node)->get_input_port(fanin_index)->get_name_id();
+
+			if (*previous_source_iter != NO_NODE_INDEX ||
+				previous_name_ids[name_id] != 
+				m_previous_frozen_circuit->get_node(previous_node)->get_input_port(fanin_index)->get_name_id())
+			{
+				return true;
+			}
+		}
+		else if (*previous_source_iter == NO_NODE_INDEX || 
+				 m_previous_node[*source_iter] != *previous_source_iter)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//
+// The reconvergence of a cone is summed in the order of the circuit, so a 
+// node that has moved relative to the other unchanged nodes would change 
+// the sum.  Keep the longest run of unchanged nodes that are in the same 
+// order in both circuits and take the rest as changed.
+//
+// PRE: the nodes have been matched
+// POST: the unchanged nodes are in the same order in both circuits
+//       m_is_previous_changed is set for each previous node that no 
+//       unchanged node matches
+//
+void INCREMENTAL_ANALYZER::mark_nodes_out_of_order()
+{
+	const NODE_INDEXES & original_order = m_frozen_circuit->get_original_order();
+	NODE_INDEXES run_ends;				// the last node of the best run of each length
+	NODE_INDEXES run_positions;			// and its previous position
+	NODE_INDEXES previous_in_run(original_order.size(), NO_NODE_INDEX);
+	vector<char> is_in_run(original_order.size(), 0);
+	NODE_INDEXES::const_iterator order_iter;
+	NODE_INDEXES::iterator position_iter;
+	NODE_INDEX node = NO_NODE_INDEX;
+	NODE_INDEX position = 0;
+	size_t run_length = 0;
+
+	for (order_iter = original_order.begin(); order_iter != original_order.end(); order_iter++)
+	{
+		node = *order_iter;
+		if (m_is_changed[node])
+		{
+			continue;
+		}
+
+		position = m_previous_frozen_circuit->get_original_position(m_previous_node[node]);
+		position_iter = lower_bound(run_positions.begin(), run_positions.end(), position);
+		run_length = position_iter - run_positions.begin();
+
+		if (run_length > 0)
+		{
+			previous_in_run[node] = run_ends[run_length - 1];
+		}
+		if (position_iter == run_positions.end())
+		{
+			run_positions.push_back(position);
+			run_ends.push_back(node);
+		}
+		else
+		{
+			*position_iter = position;
+			run_ends[run_length] = node;
+		}
+	}
+
+	for (node = (run_ends.empty() ? NO_NODE_INDEX : run_ends.back()); 
+		 node != NO_NODE_INDEX; node = previous_in_run[node])
+	{
+		is_in_run[node] = 1;
+	}
+
+	m_is_previous_changed.assign(m_previous_frozen_circuit->get_nNodes(), 1);
+	m_nChanged_nodes = 0;
+	for (node = 0; node < m_frozen_circuit->get_nNodes(); node++)
+	{
+		if (! is_in_run[node])
+		{
+			m_is_changed[node] = 1;
+			m_nChanged_nodes++;
+		}
+		else
+		{
+			m_is_previous_changed[m_previous_node[node]] = 0;
+		}
+	}
+}
+
+//
+// A node keeps its delay level unless it is changed or it has a 
+// combinational fanin whose level may change.
+//
+// PRE: the changed nodes are known
+//      the previous circuit has its delay levels
+// POST: m_known_levels holds the level of each node that keeps it and 
+//       UNKNOWN_DELAY_LEVEL for the rest
+//
+void INCREMENTAL_ANALYZER::find_known_levels()
+{
+	NODE_INDEX nNodes = m_frozen_circuit->get_nNodes();
+	vector<char> is_dirty(nNodes, 0);
+	const NODE_INDEX * source_iter;
+	NODE_INDEX node = 0;
+
+	m_known_levels.assign(nNodes, UNKNOWN_DELAY_LEVEL);
+
+	// the fanin of a node comes before it in frozen order
+	for (node = 0; node < nNodes; node++)
+	{
+		is_dirty[node] = m_is_changed[node];
+
+		for (source_iter = m_frozen_circuit->fanin_begin(node); 
+			 ! is_dirty[node] && source_iter != m_frozen_circuit->fanin_end(node); source_iter++)
+		{
+			if (*source_iter != NO_NODE_INDEX && m_frozen_circuit->is_comb(*source_iter) &&
+				is_dirty[*source_iter])
+			{
+				is_dirty[node] = 1;
+			}
+		}
+
+		if (! is_dirty[node])
+		{
+			m_known_levels[node] = m_previous_frozen_circuit->get_level(m_previous_node[node]);
+		}
+	}
+}
+
+//
+// Find the nodes whose rnum cone could reach a changed node: the cone of a 
+// node takes in the combinational fanout of every node of the cone that 
+// is not a PO.
+//
+// PRE: is_changed flags the changed nodes of frozen_circuit
+// POST: is_reaching flags the changed nodes and every node whose cone 
+//       reaches one
+//
+void INCREMENTAL_ANALYZER::find_nodes_reaching_a_change
+(
+	const FROZEN_CIRCUIT * frozen_circuit,
+	const vector<char> & is_changed,
+	vector<char> & is_reaching
+) const
+{
+	NODE_INDEXES nodes_to_visit;
+	const NODE_INDEX * source_iter;
+	NODE_INDEX node = 0;
+	NODE_INDEX source = NO_NODE_INDEX;
+
+	is_reaching = is_changed;
+	for (node = 0; node < frozen_circuit->get_nNodes(); node++)
+	{
+		if (is_reaching[node])
+		{
+			nodes_to_visit.push_back(node);
+		}
+	}
+
+	while (! nodes_to_visit.empty())
+	{
+		node = nodes_to_visit.back();
+		nodes_to_visit.pop_back();
+
+		if (! frozen_circuit->is_comb(node))
+		{
+			continue;
+		}
+
+		for (source_iter = frozen_circuit->fanin_begin(node); 
+			 source_iter != frozen_circuit->fanin_end(node); source_iter++)
+		{
+			source = *source_iter;
+			if (source != NO_NODE_INDEX && ! frozen_circuit->is_PO(source) && ! is_reaching[source])
+			{
+				is_reaching[source] = 1;
+				nodes_to_visit.push_back(source);
+			}
+		}
+	}
+}
+
+//
+// A primary input keeps its rnum contribution if its cone starts at the 
+// match of the same node and reaches no change in either circuit.
+//
+// PRE: the changed nodes of both circuits are known
+// POST: the circuit has the contribution of each primary input that keeps it
+//
+void INCREMENTAL_ANALYZER::carry_over_rnum_contributions
+(
+	const vector<NAME_ID> & previous_name_ids,
+	NUM_ELEMENTS nPrevious_names
+)
+{
+	const RNUM_CONTRIBUTIONS & previous_contributions = m_previous_frozen_circuit->get_rnum_contributions();
+	RNUM_CONTRIBUTIONS & contributions = m_frozen_circuit->get_rnum_contributions();
+	RNUM_CONTRIBUTION unknown;
+	NODE_INDEXES previous_PI_by_name(nPrevious_names, NO_NODE_INDEX);
+	vector<char> is_reaching;
+	vector<char> is_previous_reaching;
+	NODE_INDEX pi_index = 0;
+	NODE_INDEX previous_pi_index = NO_NODE_INDEX;
+	NODE_INDEX start_node = NO_NODE_INDEX;
+	NAME_ID name_id = NO_NAME_ID;
+
+	unknown.logdet = 0.0;
+	unknown.cone_size = 0;
+	unknown.is_known = false;
+	contributions.assign(m_frozen_circuit->get_nPI(), unknown);
+
+	m_nReused_PI = 0;
+	m_nCounted_PI = 0;
+
+	if (static_cast<NODE_INDEX>(previous_contributions.size()) != m_previous_frozen_circuit->get_nPI())
+	{
+		// the previous circuit never got as far as its reconvergence
+		return;
+	}
+
+	find_nodes_reaching_a_change(m_frozen_circuit, m_is_changed, is_reaching);
+	find_nodes_reaching_a_change(m_previous_frozen_circuit, m_is_previous_changed, is_previous_reaching);
+
+	for (pi_index = 0; pi_index < m_previous_frozen_circuit->get_nPI(); pi_index++)
+	{
+		previous_PI_by_name[m_previous_frozen_circuit->get_PI(pi_index)->get_name_id()] = pi_index;
+	}
+
+	for (pi_index = 0; pi_index < m_frozen_circuit->get_nPI(); pi_index++)
+	{
+		// clocks and primary inputs without fanout are not counted
+		if (m_frozen_circuit->is_clock_PI(pi_index) || m_frozen_circuit->get_PI_fanout_degree(pi_index) == 0)
+		{
+			continue;
+		}
+		m_nCounted_PI++;
+
+		name_id = previous_name_ids[m_frozen_circuit->get_PI(pi_index)->get_name_id()];
+		previous_pi_index = (name_id == NO_NAME_ID ? NO_NODE_INDEX : previous_PI_by_name[name_id]);
+		if (previous_pi_index == NO_NODE_INDEX || 
+			m_previous_frozen_circuit->is_clock_PI(previous_pi_index) ||
+			m_previous_frozen_circuit->get_PI_fanout_degree(previous_pi_index) == 0 ||
+			! previous_contributions[previous_pi_index].is_known)
+		{
+			continue;
+		}
+
+		start_node = *m_frozen_circuit->PI_fanout_begin(pi_index);
+		if (! is_reaching[start_node] && 
+			m_previous_node[start_node] == *m_previous_frozen_circuit->PI_fanout_begin(previous_pi_index) &&
+			! is_previous_reaching[m_previous_node[start_node]])
+		{
+			contributions[pi_index] = previous_contributions[previous_pi_index];
+			m_nReused_PI++;
+		}
+	}
+}
@@ -0,0 +1,86 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef incremental_analyzer_H
+#define incremental_analyzer_H
+
+#include "circ.h"
+#include "circuit.h"
+#include "frozen_circuit.h"
+#include "name_pool.h"
+
+//
+// Class_name INCREMENTAL_ANALYZER
+//
+// Description
+//
+//		Carries the analysis of the previous circuit over to the next one 
+//		when consecutive circuits differ only a little (e.g. the netlists 
+//		of an optimization loop sent to the server one after another).
+//
+//		The nodes of the two circuits are matched by name.  A node is 
+//		changed if it has no match or its type, output or fanin differ.
+//		Every node that is not downstream of a change keeps its delay level
+//		and every primary input whose cone reaches no change, in either 
+//		circuit, keeps its reconvergence contribution.  The rest is 
+//		calculated as usual, so the results are those of a full analysis; 
+//		verify() checks that they are.
+//
+
+
+class INCREMENTAL_ANALYZER
+{
+public:
+	INCREMENTAL_ANALYZER();
+	INCREMENTAL_ANALYZER(const INCREMENTAL_ANALYZER & another_incremental_analyzer);
+	INCREMENTAL_ANALYZER & operator=(const INCREMENTAL_ANALYZER & another_incremental_analyzer);
+	~INCREMENTAL_ANALYZER();
+
+	void	match_circuits(CIRCUIT * previous_circuit, CIRCUIT * circuit);
+	void	verify();
+
+	// the levels for DELAY_LEVELER, empty until the circuits are matched
+	const DELAYS &	get_known_levels() const { return m_known_levels; }
+private:
+	FROZEN_CIRCUIT *	m_previous_frozen_circuit;
+	FROZEN_CIRCUIT *	m_frozen_circuit;
+
+	NODE_INDEXES		m_previous_node;		// the match of each node or NO_NODE_INDEX
+	vector<char>		m_is_changed;
+	vector<char>		m_is_previous_changed;	// no unchanged node matches it
+	DELAYS				m_known_levels;
+
+	NUM_ELEMENTS		m_nChanged_nodes;
+	NUM_ELEMENTS		m_nReused_PI;
+	NUM_ELEMENTS		m_nCounted_PI;
+
+	void	translate_names(CIRCUIT * previous_circuit, CIRCUIT * circuit, 
+							vector<NAME_ID> & previous_name_ids) const;
+	void	match_nodes(const vector<NAME_ID> & previous_name_ids, NUM_ELEMENTS nPrevious_names);
+	bool	is_node_changed(const NODE_INDEX & node, const vector<NAME_ID> & previous_name_ids) const;
+	void	mark_nodes_out_of_order();
+	void	find_known_levels();
+	void	find_nodes_reaching_a_change(const FROZEN_CIRCUIT * frozen_circuit, 
+							const vector<char> & is_changed, vector<char> & is_reaching) const;
+	void	carry_over_rnum_contributions(const vector<NAME_ID> & previous_name_ids, 
+							NUM_ELEMENTS nPrevious_names);
+};
+
+
+#endif
@@ -28,30 +28,74 @@
 #include "circ_version.h"
 #include <iostream>
 
-OPTIONS * g_options;
-
 int main(int argc, char ** argv)
 {
-	cout << "\n\n";
-	cout << "CCIRC Circuit Characterization Software Version " << circ_version();
-	cout << endl;
-	cout << "By Paul Kundarewich, Mike Hutton, and Jonathan Rose\n";
-	cout << "This code is licensed only for non-commercial use.\n" << endl;
+	// in server mode stdout only carries the replies, and with --out - the stats
+	bool serving = false,
+		 stats_to_stdout = false;
+	int arg_index;
+	for (arg_index = 1; arg_index < argc; arg_index++)
+	{
+		serving = serving || string(argv[arg_index]) == "--serve";
+		stats_to_stdout = stats_to_stdout || 
+			(string(argv[arg_index]) == "--out" && arg_index + 1 < argc && string(argv[arg_index + 1]) == "-");
+	}
+	ostream & banner_stream = ((serving || stats_to_stdout) ? cerr : cout);
+	ostream stats_stream(cout.rdbuf());
+	if (stats_to_stdout && ! serving)
+	{
+		cout.rdbuf(cerr.rdbuf());
+	}
+
+	banner_stream << "\n\n";
+	banner_stream << "CCIRC Circuit Characterization Software Version " << circ_version();
+	banner_stream << endl;
+	banner_stream << "By Paul Kundarewich, Mike Hutton, and Jonathan Rose\n";
+	banner_stream << "This code is licensed only for non-commercial use.\n" << endl;
 
 	CIRC_CONTROL circ_control;
+	if (stats_to_stdout && ! serving)
+	{
+		circ_control.write_stats_to(&stats_stream);
+	}
 
     if (argc == 1) { circ_control.help(); exit(0); }
 
 	g_options = new OPTIONS;
 	assert(g_options);
 
-	g_options->process_options(argc, argv);
+	try
+	{
+		g_options->process_options(argc, argv);
+
+		if (g_options->is_help())
+		{
+			g_options->display_option_usage();
+			return 0;
+		}
+
+		if (g_options->is_serve())
+		{
+			circ_control.serve();
+			return 0;
+		}
+
+		if (g_options->is_batch())
+		{
+			return (circ_control.run_batch() == 0) ? 0 : -1;
+		}
 
-	debug("Reading in the circuits");
-	circ_control.read_circuits();
+		debug("Reading in the circuits");
+		circ_control.read_circuits();
 
-	debug("Analyzing the circuits"); debugSep;
-	circ_control.analyze_graphs();
+		debug("Analyzing the circuits"); debugSep;
+		circ_control.analyze_graphs();
+	}
+	catch (const CIRC_FAILURE & failure)
+	{
+		cerr << endl << "Terminal Error: " << failure.what() << endl;
+		return -1;
+	}
 
 	return 0;
 }
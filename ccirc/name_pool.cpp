@@ -0,0 +1,209 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+#include "name_pool.h"
+#include <assert.h>
+#include <cstring>
+
+const size_t INITIAL_NUMBER_SLOTS = 1024;
+
+NAME_POOL::NAME_POOL()
+{
+	m_starts.push_back(0);
+	m_slots.assign(INITIAL_NUMBER_SLOTS, NO_NAME_ID);
+}
+
+NAME_POOL::NAME_POOL(const NAME_POOL & another_pool)
+{
+	m_text		= another_pool.m_text;
+	m_starts	= another_pool.m_starts;
+	m_hashes	= another_pool.m_hashes;
+	m_slots		= another_pool.m_slots;
+}
+
+NAME_POOL & NAME_POOL::operator=(const NAME_POOL & another_pool)
+{
+	m_text		= another_pool.m_text;
+	m_starts	= another_pool.m_starts;
+	m_hashes	= another_pool.m_hashes;
+	m_slots		= another_pool.m_slots;
+
+	return (*this);
+}
+
+NAME_POOL::~NAME_POOL()
+{
+}
+
+//
+// PRE: text points to length characters (they need not be terminated)
+// POST: the name is in the pool
+// RETURNS: the id of the name
+//
+NAME_ID NAME_POOL::intern
+(
+	const char * text,
+	const size_t & length
+)
+{
+	size_t hash_value = hash(text, length);
+	size_t slot = find_slot(text, length, hash_value);
+	NAME_ID id = m_slots[slot];
+
+	if (id != NO_NAME_ID)
+	{
+		return id;
+	}
+
+	id = static_cast<NAME_ID>(m_hashes.size());
+	m_text.insert(m_text.end(), text, text + length);
+	m_starts.push_back(m_text.size());
+	m_hashes.push_back(hash_value);
+	m_slots[slot] = id;
+
+	// keep the table at most half full
+	if (2 * m_hashes.size() > m_slots.size())
+	{
+		grow_table();
+	}
+
+	return id;
+}
+
+//
+// RETURNS: the id of the name or NO_NAME_ID if it has not been interned
+//
+NAME_ID NAME_POOL::find
+(
+	const char * text,
+	const size_t & length
+) const
+{
+	return m_slots[find_slot(text, length, hash(text, length))];
+}
+
+//
+// RETURNS: the text of the name
+//
+string NAME_POOL::get_name
+(
+	const NAME_ID & id
+) const
+{
+	size_t length = get_length(id);
+
+	return (length ? string(&m_text[m_starts[id]], length) : string());
+}
+
+size_t NAME_POOL::get_length
+(
+	const NAME_ID & id
+) const
+{
+	assert(id >= 0 && id < get_nNames());
+
+	return m_starts[id + 1] - m_starts[id];
+}
+
+//
+// FNV-1a
+//
+size_t NAME_POOL::hash
+(
+	const char * text,
+	const size_t & length
+) const
+{
+	unsigned long hash_value = 2166136261UL;
+	size_t index;
+
+	for (index = 0; index < length; index++)
+	{
+		hash_value ^= static_cast<unsigned char>(text[index]);
+		hash_value *= 16777619UL;
+	}
+
+	return static_cast<size_t>(hash_value);
+}
+
+//
+// RETURNS: the slot that holds the name or the empty slot where it belongs
+//
+size_t NAME_POOL::find_slot
+(
+	const char * text,
+	const size_t & length,
+	const size_t & hash_value
+) const
+{
+	size_t mask = m_slots.size() - 1;
+	size_t slot = hash_value & mask;
+
+	while (m_slots[slot] != NO_NAME_ID && 
+			(m_hashes[m_slots[slot]] != hash_value || ! is_equal(m_slots[slot], text, length)))
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+bool NAME_POOL::is_equal
+(
+	const NAME_ID & id,
+	const char * text,
+	const size_t & length
+) const
+{
+	return (get_length(id) == length && 
+			(length == 0 || memcmp(&m_text[m_starts[id]], text, length) == 0));
+}
+
+//
+// PRE: the table is more than half full
+// POST: the table is twice the size and every id has been rehashed into it
+//
+void NAME_POOL::grow_table()
+{
+	size_t mask = 2 * m_slots.size() - 1;
+	size_t slot;
+	NAME_ID id;
+
+	m_slots.assign(mask + 1, NO_NAME_ID);
+
+	for (id = 0; id < get_nNames(); id++)
+	{
+		slot = m_hashes[id] & mask;
+		while (m_slots[slot] != NO_NAME_ID)
+		{
+			slot = (slot + 1) & mask;
+		}
+		m_slots[slot] = id;
+	}
+}
+
+ostream & operator<<
+(
+	ostream & out,
+	const NET_NAME & name
+)
+{
+	return out << name.to_string();
+}
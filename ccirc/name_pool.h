@@ -0,0 +1,107 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef name_pool_H
+#define name_pool_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+using namespace std;
+#include "types.h"
+
+//
+// Class_name NAME_POOL
+//
+// Description
+//
+//	Interns the net names of a circuit.  Each distinct name is stored
+//	once and given a dense integer id (0, 1, 2, ...) so that ports, nodes
+//	and edges can be found and compared by id instead of by string.
+//
+//	The text of all names is kept back to back in one buffer and is found
+//	through an open-addressed hash table of ids.
+//
+
+typedef int NAME_ID;
+const NAME_ID NO_NAME_ID = -1;
+
+class NAME_POOL
+{
+public:
+	NAME_POOL();
+	NAME_POOL(const NAME_POOL & another_pool);
+	NAME_POOL & operator=(const NAME_POOL & another_pool);
+	~NAME_POOL();
+
+	// returns the id of the name, adding it to the pool if it is new
+	NAME_ID			intern(const char * text, const size_t & length);
+	NAME_ID			intern(const string & text) { return intern(text.data(), text.size()); }
+
+	// returns the id of the name or NO_NAME_ID if it is not in the pool
+	NAME_ID			find(const char * text, const size_t & length) const;
+
+	string			get_name(const NAME_ID & id) const;
+	const char *	get_text(const NAME_ID & id) const { return m_text.data() + m_starts[id]; }
+	size_t			get_length(const NAME_ID & id) const;
+	NUM_ELEMENTS	get_nNames() const { return static_cast<NUM_ELEMENTS>(m_hashes.size()); }
+private:
+	vector<char>	m_text;		// the text of every name, back to back
+	vector<size_t>	m_starts;	// name i is m_text[m_starts[i], m_starts[i+1])
+	vector<size_t>	m_hashes;	// the hash of each name, kept for rehashing
+	vector<NAME_ID>	m_slots;	// the hash table, a power of 2 in size
+
+	size_t	hash(const char * text, const size_t & length) const;
+	size_t	find_slot(const char * text, const size_t & length, const size_t & hash_value) const;
+	bool	is_equal(const NAME_ID & id, const char * text, const size_t & length) const;
+	void	grow_table();
+};
+
+
+//
+// Class_name NET_NAME
+//
+// Description
+//
+//	The name of a port or node: an id into the name pool of its circuit.
+//	It is only resolved back to text for messages and reports.
+//
+
+class NET_NAME
+{
+public:
+	NET_NAME() : m_pool(0), m_id(NO_NAME_ID) {}
+	NET_NAME(const NAME_POOL * pool, const NAME_ID & id) : m_pool(pool), m_id(id) {}
+
+	NAME_ID		get_id() const { return m_id; }
+	string		to_string() const { return (m_pool ? m_pool->get_name(m_id) : string()); }
+	bool		empty() const { return (! m_pool || m_pool->get_length(m_id) == 0); }
+
+	bool operator==(const NET_NAME & another_name) const { return m_id == another_name.m_id; }
+	bool operator!=(const NET_NAME & another_name) const { return m_id != another_name.m_id; }
+private:
+	const NAME_POOL *	m_pool;
+	NAME_ID				m_id;
+};
+
+ostream & operator<<(ostream & out, const NET_NAME & name);
+
+
+#endif
@@ -0,0 +1,262 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+//
+// Makes a synthetic netlist for scaling and stress tests.
+//
+//	netlist_gen [--nodes N] [--k K] [--depth D] [--shape N,N,... | --shape_from file.stats]
+//				[--fanout_skew F] [--reconvergence F] [--dff_ratio F] [--seed S] [--name NAME]
+//				[--blif file | - ] [--analyze [ccirc options]]
+//
+// The netlist has N LUTs and flip-flops (10000 by default), a fraction F of 
+// them flip-flops.  Its delay levels follow the Node_shape given, or read 
+// from the circuit-wide stats of a circuit, scaled to N nodes; without one 
+// they thin out linearly over D levels.  See NETLIST_GENERATOR for what the 
+// fanout skew and reconvergence do.
+//
+// It is written as BLIF to the file, or to stdout by default.  With --analyze 
+// the graph is built in memory instead and ccirc analyzes it directly, with 
+// the options that follow, e.g. --analyze --profile --format json --out -
+//
+
+#include "circ.h"
+#include "circ_control.h"
+#include "netlist_generator.h"
+#include "util.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+typedef chrono::steady_clock GENERATOR_CLOCK;
+
+static double seconds_since
+(
+	const GENERATOR_CLOCK::time_point & start
+)
+{
+	return chrono::duration<double>(GENERATOR_CLOCK::now() - start).count();
+}
+
+//
+// RETURNS: the numbers of a comma separated list
+//
+static NUM_ELEMENTS_VECTOR read_shape
+(
+	const string & shape_list
+)
+{
+	NUM_ELEMENTS_VECTOR shape;
+	istringstream shape_stream(shape_list);
+	string number;
+
+	while (getline(shape_stream, number, ','))
+	{
+		shape.push_back(atol(number.c_str()));
+	}
+	return shape;
+}
+
+//
+// Analyzes the netlist as ccirc would had it read it
+//
+// RETURNS: 0 if the analysis finished
+//
+static int analyze_netlist
+(
+	const NETLIST_GENERATOR & generator,
+	const string & name,
+	int argc,
+	char ** argv
+)
+{
+	vector<char *> option_argv;
+	GENERATOR_CLOCK::time_point start;
+	CIRC_CONTROL circ_control;
+	int argnum;
+
+	// the circuit name stands in for the input file, which names the stats
+	string input_name = name + ".blif";
+	option_argv.push_back(const_cast<char *>("netlist_gen"));
+	option_argv.push_back(const_cast<char *>(input_name.c_str()));
+	for (argnum = 0; argnum < argc; argnum++)
+	{
+		option_argv.push_back(argv[argnum]);
+	}
+
+	// what ccirc logs goes to stderr, stdout only carries the stats of --out -
+	ostream stats_stream(cout.rdbuf());
+	cout.rdbuf(cerr.rdbuf());
+
+	g_options->process_options(static_cast<int>(option_argv.size()), &option_argv[0]);
+	if (g_options->is_output_to_stdout())
+	{
+		circ_control.write_stats_to(&stats_stream);
+	}
+
+	start = GENERATOR_CLOCK::now();
+	circ_control.use_circuit(generator.build_circuit());
+	cerr << "netlist_gen: built the graph in " << seconds_since(start) << " s" << endl;
+
+	start = GENERATOR_CLOCK::now();
+	circ_control.analyze_graphs();
+	cerr << "netlist_gen: analyzed it in " << seconds_since(start) << " s, peak RSS " 
+		<< util_peak_resident_kb() << " kB" << endl;
+
+	circ_control.delete_circuit();
+	cout.rdbuf(stats_stream.rdbuf());
+
+	return 0;
+}
+
+int main(int argc, char ** argv)
+{
+	NETLIST_GENERATOR generator;
+	NUM_ELEMENTS_VECTOR shape;
+	GENERATOR_CLOCK::time_point start;
+	string name = "synthetic", blif_name = "-", arg;
+	int argnum = 1;
+	bool is_analyzing = false;
+
+	while (argnum < argc)
+	{
+		arg = argv[argnum];
+
+		if (arg == "--analyze")
+		{
+			is_analyzing = true;
+			argnum++;
+			break;
+		}
+		if (argnum + 1 >= argc)
+		{
+			break;
+		}
+
+		if (arg == "--nodes")
+		{
+			generator.set_nNodes(atol(argv[argnum + 1]));
+		}
+		else if (arg == "--k")
+		{
+			generator.set_k(static_cast<K_TYPE>(atoi(argv[argnum + 1])));
+		}
+		else if (arg == "--depth")
+		{
+			generator.set_depth(static_cast<DELAY_TYPE>(atoi(argv[argnum + 1])));
+		}
+		else if (arg == "--shape")
+		{
+			generator.set_node_shape(read_shape(argv[argnum + 1]));
+		}
+		else if (arg == "--shape_from")
+		{
+			if (! NETLIST_GENERATOR::read_node_shape(argv[argnum + 1], shape))
+			{
+				cerr << "Could not read a Node_shape from " << argv[argnum + 1] << endl;
+				return 1;
+			}
+			generator.set_node_shape(shape);
+		}
+		else if (arg == "--fanout_skew")
+		{
+			generator.set_fanout_skew(atof(argv[argnum + 1]));
+		}
+		else if (arg == "--reconvergence")
+		{
+			generator.set_reconvergence(atof(argv[argnum + 1]));
+		}
+		else if (arg == "--dff_ratio")
+		{
+			generator.set_dff_ratio(atof(argv[argnum + 1]));
+		}
+		else if (arg == "--seed")
+		{
+			generator.set_seed(atol(argv[argnum + 1]));
+		}
+		else if (arg == "--name")
+		{
+			name = argv[argnum + 1];
+		}
+		else if (arg == "--blif")
+		{
+			blif_name = argv[argnum + 1];
+		}
+		else
+		{
+			break;
+		}
+		argnum += 2;
+	}
+
+	if (argnum < argc && ! is_analyzing)
+	{
+		cerr << "Usage:  netlist_gen [--nodes N] [--k K] [--depth D] [--shape N,N,... | --shape_from file.stats]\n"
+			<< "                   [--fanout_skew F] [--reconvergence F] [--dff_ratio F] [--seed S] [--name NAME]\n"
+			<< "                   [--blif file | - ] [--analyze [ccirc options]]" << endl;
+		return 1;
+	}
+
+	generator.set_name(name);
+
+	// the generator warns and fails as ccirc does
+	g_options = new OPTIONS;
+
+	try
+	{
+		start = GENERATOR_CLOCK::now();
+		generator.generate();
+		cerr << "netlist_gen: " << name << " has " << generator.get_nPI() << " PI, " 
+			<< generator.get_nDFF() << " DFF, " << generator.get_nLUT() << " LUTs, " 
+			<< generator.get_nEdges() << " edges and " << generator.get_nPO() << " PO, drawn in " 
+			<< seconds_since(start) << " s" << endl;
+
+		if (is_analyzing)
+		{
+			return analyze_netlist(generator, name, argc - argnum, argv + argnum);
+		}
+
+		start = GENERATOR_CLOCK::now();
+		if (blif_name == "-")
+		{
+			generator.write_blif(cout);
+			cout.flush();
+		}
+		else
+		{
+			ofstream blif_file(blif_name.c_str());
+			if (! blif_file)
+			{
+				cerr << "Could not write " << blif_name << endl;
+				return 1;
+			}
+			generator.write_blif(blif_file);
+		}
+		cerr << "netlist_gen: wrote " << blif_name << " in " << seconds_since(start) << " s" << endl;
+	}
+	catch (const CIRC_FAILURE & failure)
+	{
+		cerr << "Error: " << failure.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,582 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+#include "netlist_generator.h"
+#include <fstream>
+#include <sstream>
+
+// the lowest LUT size that does not make buffers, which are removed when read
+const K_TYPE MINIMUM_GENERATED_K = 2;
+
+// the netlist drawn when neither a size nor a shape is given
+const NUM_ELEMENTS DEFAULT_GENERATED_NODES = 10000;
+const DELAY_TYPE DEFAULT_GENERATED_DEPTH = 16;
+
+// the resolution of the probabilities drawn
+const NUM_ELEMENTS PROBABILITY_STEPS = 1 << 20;
+
+// how often an input is drawn again when it repeats one the LUT already has
+const int FANIN_DRAW_ATTEMPTS = 4;
+
+const string GENERATED_CLOCK_NAME = "clk";
+
+static double _random_fraction(RANDOM_NUMBER & random);
+static void _write_name_list(ostream & blif_stream, const string & keyword, const vector<string> & names);
+
+NETLIST_GENERATOR::NETLIST_GENERATOR()
+{
+	m_name			= "synthetic";
+	m_nNodes		= 0;
+	m_k				= 4;
+	m_depth			= DEFAULT_GENERATED_DEPTH;
+	m_fanout_skew	= 0.5;
+	m_reconvergence	= 0.2;
+	m_dff_ratio		= 0.0;
+	m_seed			= 1;
+	m_nPI			= 0;
+	m_nDFF			= 0;
+}
+
+NETLIST_GENERATOR::NETLIST_GENERATOR(const NETLIST_GENERATOR & another_generator)
+{
+	m_name			= another_generator.m_name;
+	m_nNodes		= another_generator.m_nNodes;
+	m_k				= another_generator.m_k;
+	m_depth			= another_generator.m_depth;
+	m_target_shape	= another_generator.m_target_shape;
+	m_fanout_skew	= another_generator.m_fanout_skew;
+	m_reconvergence	= another_generator.m_reconvergence;
+	m_dff_ratio		= another_generator.m_dff_ratio;
+	m_seed			= another_generator.m_seed;
+	m_nPI			= another_generator.m_nPI;
+	m_nDFF			= another_generator.m_nDFF;
+	m_level_start	= another_generator.m_level_start;
+	m_fanin_start	= another_generator.m_fanin_start;
+	m_fanins		= another_generator.m_fanins;
+	m_dff_drivers	= another_generator.m_dff_drivers;
+	m_has_fanout	= another_generator.m_has_fanout;
+}
+
+NETLIST_GENERATOR & NETLIST_GENERATOR::operator=(const NETLIST_GENERATOR & another_generator)
+{
+	m_name			= another_generator.m_name;
+	m_nNodes		= another_generator.m_nNodes;
+	m_k				= another_generator.m_k;
+	m_depth			= another_generator.m_depth;
+	m_target_shape	= another_generator.m_target_shape;
+	m_fanout_skew	= another_generator.m_fanout_skew;
+	m_reconvergence	= another_generator.m_reconvergence;
+	m_dff_ratio		= another_generator.m_dff_ratio;
+	m_seed			= another_generator.m_seed;
+	m_nPI			= another_generator.m_nPI;
+	m_nDFF			= another_generator.m_nDFF;
+	m_level_start	= another_generator.m_level_start;
+	m_fanin_start	= another_generator.m_fanin_start;
+	m_fanins		= another_generator.m_fanins;
+	m_dff_drivers	= another_generator.m_dff_drivers;
+	m_has_fanout	= another_generator.m_has_fanout;
+
+	return (*this);
+}
+
+NETLIST_GENERATOR::~NETLIST_GENERATOR()
+{
+}
+
+//
+// Draws the netlist
+//
+// PRE: the size, shape and mix of the netlist have been set
+// POST: the netlist has been drawn into the arrays of the generator,
+//       the same one for the same settings and seed
+//
+void NETLIST_GENERATOR::generate()
+{
+	RANDOM_NUMBER random(m_seed);
+	NUM_ELEMENTS_VECTOR level_sizes;
+	NUM_ELEMENTS nSources, nNodes, level_begin, level_end, node, first_fanin, previous_begin, previous_size;
+	NUM_ELEMENTS next_unused_source = 0, lut, dff;
+	size_t level, input, nInputs, first_input;
+	unsigned fanin;
+	int attempt;
+	bool is_repeated;
+
+	if (m_k < MINIMUM_GENERATED_K)
+	{
+		Fail("Generated LUTs need at least " << MINIMUM_GENERATED_K << " inputs, not k = " << m_k);
+	}
+
+	find_level_sizes(level_sizes);
+
+	nSources = level_sizes[0];
+	m_level_start.assign(1, 0);
+	for (level = 0; level < level_sizes.size(); level++)
+	{
+		m_level_start.push_back(m_level_start.back() + level_sizes[level]);
+	}
+	nNodes = m_level_start.back();
+
+	m_fanin_start.assign(1, 0);
+	m_fanin_start.reserve(nNodes - nSources + 1);
+	m_fanins.clear();
+	m_fanins.reserve((nNodes - nSources) * (m_k + MINIMUM_GENERATED_K) / 2);
+	m_dff_drivers.clear();
+	m_has_fanout.assign(nNodes, false);
+
+	for (level = 1; level < level_sizes.size(); level++)
+	{
+		level_begin 	= m_level_start[level];
+		level_end 		= m_level_start[level + 1];
+		previous_begin 	= m_level_start[level - 1];
+		previous_size 	= level_begin - previous_begin;
+
+		for (node = level_begin; node < level_end; node++)
+		{
+			// the first input puts the LUT on this level.  every node of the 
+			// level below gets one fanout before any gets two
+			if (node - level_begin < previous_size)
+			{
+				first_fanin = previous_begin + (node - level_begin);
+			}
+			else
+			{
+				first_fanin = previous_begin + random.random_number(previous_size - 1);
+			}
+
+			nInputs = MINIMUM_GENERATED_K + random.random_number(m_k - MINIMUM_GENERATED_K);
+			nInputs = min(nInputs, static_cast<size_t>(level_begin));
+
+			first_input = m_fanins.size();
+			m_fanins.push_back(static_cast<unsigned>(first_fanin));
+			m_has_fanout[first_fanin] = true;
+
+			for (input = 1; input < nInputs; input++)
+			{
+				for (attempt = 0; attempt < FANIN_DRAW_ATTEMPTS; attempt++)
+				{
+					fanin = draw_fanin(random, static_cast<unsigned>(first_fanin), level_begin, 
+										nSources, next_unused_source);
+					is_repeated = (find(m_fanins.begin() + first_input, m_fanins.end(), fanin) != m_fanins.end());
+
+					if (! is_repeated)
+					{
+						m_fanins.push_back(fanin);
+						m_has_fanout[fanin] = true;
+						break;
+					}
+				}
+			}
+			m_fanin_start.push_back(static_cast<unsigned>(m_fanins.size()));
+		}
+	}
+
+	// the flip-flops are fed from LUTs anywhere in the netlist
+	for (dff = 0; dff < m_nDFF; dff++)
+	{
+		lut = nSources + random.random_number(nNodes - nSources - 1);
+		m_dff_drivers.push_back(static_cast<unsigned>(lut));
+		m_has_fanout[lut] = true;
+	}
+
+	while (next_unused_source < nSources && m_has_fanout[next_unused_source])
+	{
+		next_unused_source++;
+	}
+	if (next_unused_source < nSources)
+	{
+		Warning("Generated " << m_name << " has inputs without fanout. It needs more LUTs for its sources");
+	}
+}
+
+//
+// PRE: random is the generator's random numbers
+//      first_fanin is the input the LUT already has from the level below
+//      level_begin is the first node of the LUT's level
+//      next_unused_source is the first source that may have no fanout yet
+// RETURNS: another input for the LUT, from below its level.  sources without
+//          fanout are used up first so that none is left dangling
+//
+unsigned NETLIST_GENERATOR::draw_fanin
+(
+	RANDOM_NUMBER & random,
+	const unsigned & first_fanin,
+	const NUM_ELEMENTS & level_begin,
+	const NUM_ELEMENTS & nSources,
+	NUM_ELEMENTS & next_unused_source
+)
+{
+	NUM_ELEMENTS first_lut, first_lut_inputs;
+	double draw;
+
+	while (next_unused_source < nSources && m_has_fanout[next_unused_source])
+	{
+		next_unused_source++;
+	}
+	if (next_unused_source < nSources)
+	{
+		return static_cast<unsigned>(next_unused_source);
+	}
+
+	draw = _random_fraction(random);
+
+	if (draw < m_reconvergence && first_fanin >= nSources)
+	{
+		// an input of the first input reaches the LUT both ways
+		first_lut = first_fanin - nSources;
+		first_lut_inputs = m_fanin_start[first_lut + 1] - m_fanin_start[first_lut];
+
+		return m_fanins[m_fanin_start[first_lut] + random.random_number(first_lut_inputs - 1)];
+	}
+	else if (_random_fraction(random) < m_fanout_skew && ! m_fanins.empty())
+	{
+		// the source of an edge, so in proportion to the fanout so far
+		return m_fanins[random.random_number(static_cast<NUM_ELEMENTS>(m_fanins.size()) - 1)];
+	}
+	else
+	{
+		return static_cast<unsigned>(random.random_number(level_begin - 1));
+	}
+}
+
+//
+// PRE: the size and shape settings are final
+// POST: level_sizes holds the number of nodes of each level, the sources in
+//       level 0, scaled from the target shape or the default one.
+//       m_nPI and m_nDFF have been set
+//
+void NETLIST_GENERATOR::find_level_sizes
+(
+	NUM_ELEMENTS_VECTOR & level_sizes
+)
+{
+	NUM_ELEMENTS_VECTOR shape = m_target_shape;
+	NUM_ELEMENTS nNodes = m_nNodes, nLUT, nShape_luts = 0, scaled_total, largest;
+	double scale, cumulative = 0;
+	size_t level;
+
+	if (shape.size() < 2)
+	{
+		// by default the levels thin out linearly, as most mapped circuits do
+		shape.clear();
+		for (level = 0; level <= static_cast<size_t>(m_depth); level++)
+		{
+			shape.push_back(m_depth + 1 - static_cast<NUM_ELEMENTS>(level));
+		}
+	}
+	for (level = 1; level < shape.size(); level++)
+	{
+		nShape_luts += shape[level];
+	}
+	if (nShape_luts <= 0)
+	{
+		Fail("The target node shape has no LUTs");
+	}
+
+	if (nNodes <= 0)
+	{
+		nNodes = m_target_shape.size() < 2 ? DEFAULT_GENERATED_NODES : nShape_luts;
+	}
+
+	// there are at most as many flip-flops as LUTs, which feed them
+	m_nDFF = static_cast<NUM_ELEMENTS>(min(max(m_dff_ratio, 0.0), 0.5) * nNodes + 0.5);
+	nLUT = nNodes - m_nDFF;
+	if (nLUT < 1)
+	{
+		Fail("A generated netlist of " << nNodes << " nodes would have no LUTs");
+	}
+	scale = static_cast<double>(nLUT) / nShape_luts;
+
+	// rounding the running total keeps the sum of the levels at nLUT.  every 
+	// level keeps a node since a level can only be reached through the one below
+	level_sizes.assign(shape.size(), 0);
+	scaled_total = 0;
+	for (level = 1; level < shape.size() && scaled_total < nLUT; level++)
+	{
+		cumulative += shape[level] * scale;
+		level_sizes[level] = max(static_cast<NUM_ELEMENTS>(cumulative + 0.5) - scaled_total, 1L);
+		scaled_total += level_sizes[level];
+	}
+	level_sizes.resize(level);
+
+	while (scaled_total > nLUT)
+	{
+		largest = max_element(level_sizes.begin() + 1, level_sizes.end()) - level_sizes.begin();
+		level_sizes[largest]--;
+		scaled_total--;
+	}
+
+	// every source needs an input to feed: the first inputs of level 1 and
+	// a second input of every LUT.  two inputs at least so no LUT is a buffer
+	m_nPI = static_cast<NUM_ELEMENTS>(shape[0] * scale + 0.5) - m_nDFF;
+	m_nPI = max(min(m_nPI, nLUT + level_sizes[1] - m_nDFF), 2L);
+	level_sizes[0] = m_nPI + m_nDFF;
+}
+
+//
+// Builds the netlist drawn as a graph through the circuit creation methods
+//
+// PRE: generate() has been called
+// RETURNS: a new circuit of the netlist, as it would be read from write_blif()
+//
+CIRCUIT * NETLIST_GENERATOR::build_circuit() const
+{
+	CIRCUIT * circuit = new CIRCUIT;
+	vector<PORT *> output_ports(m_has_fanout.size(), 0);
+	NODES dffs;
+	NET_NAME node_name;
+	NODE * node;
+	PORT * clock;
+	PORT * input_port;
+	NUM_ELEMENTS nSources = m_nPI + m_nDFF;
+	NUM_ELEMENTS source, lut;
+	unsigned input;
+
+	assert(circuit);
+	assert(! m_level_start.empty());
+
+	circuit->set_name(m_name);
+
+	for (source = 0; source < m_nPI; source++)
+	{
+		output_ports[source] = circuit->create_and_add_external_port(
+									circuit->intern_name(get_node_name(source)), PORT::PI);
+	}
+
+	if (m_nDFF > 0)
+	{
+		clock = circuit->create_and_add_external_port(circuit->intern_name(GENERATED_CLOCK_NAME), PORT::PI);
+		circuit->set_global_clock(clock);
+
+		for (source = m_nPI; source < nSources; source++)
+		{
+			node = circuit->create_dff(get_node_name(source), 
+										get_node_name(m_dff_drivers[source - m_nPI]));
+			output_ports[source] = node->get_output_port();
+			dffs.push_back(node);
+		}
+	}
+
+	for (lut = 0; lut < get_nLUT(); lut++)
+	{
+		node_name = circuit->intern_name(get_node_name(nSources + lut));
+		node = circuit->create_node(node_name, NODE::COMB);
+
+		if (is_po(nSources + lut))
+		{
+			output_ports[nSources + lut] = circuit->create_and_add_external_port(node_name, PORT::PO);
+			node->add_port(output_ports[nSources + lut]);
+			output_ports[nSources + lut]->set_my_node(node);
+		}
+		else
+		{
+			output_ports[nSources + lut] = node->create_and_add_port(node_name, PORT::INTERNAL, 
+																	PORT::OUTPUT, PORT::NONE);
+		}
+
+		for (input = m_fanin_start[lut]; input < m_fanin_start[lut + 1]; input++)
+		{
+			input_port = node->create_and_add_port(output_ports[m_fanins[input]]->get_net_name(), 
+													PORT::INTERNAL, PORT::INPUT, PORT::NONE);
+			circuit->create_edge(output_ports[m_fanins[input]], input_port, 1);
+		}
+	}
+
+	for (source = 0; source < m_nDFF; source++)
+	{
+		circuit->create_edge(output_ports[m_dff_drivers[source]], dffs[source]->get_D_port(), 1);
+	}
+
+	return circuit;
+}
+
+//
+// Writes the netlist drawn as BLIF.  Every LUT is an AND of its inputs
+//
+// PRE: generate() has been called
+// POST: the netlist has been written to blif_stream
+//
+void NETLIST_GENERATOR::write_blif
+(
+	ostream & blif_stream
+) const
+{
+	NUM_ELEMENTS nSources = m_nPI + m_nDFF;
+	NUM_ELEMENTS node, lut, dff;
+	vector<string> names;
+	unsigned input;
+
+	assert(! m_level_start.empty());
+
+	blif_stream << "# synthetic netlist: " << m_nPI << " PI, " << m_nDFF << " DFF, " << get_nLUT() 
+		<< " LUTs of k = " << m_k << " on " << m_level_start.size() - 2 << " levels, seed " << m_seed << "\n";
+	blif_stream << ".model " << m_name << "\n";
+
+	for (node = 0; node < m_nPI; node++)
+	{
+		names.push_back(get_node_name(node));
+	}
+	if (m_nDFF > 0)
+	{
+		names.push_back(GENERATED_CLOCK_NAME);
+	}
+	_write_name_list(blif_stream, ".inputs", names);
+
+	names.clear();
+	for (node = nSources; node < static_cast<NUM_ELEMENTS>(m_has_fanout.size()); node++)
+	{
+		if (is_po(node))
+		{
+			names.push_back(get_node_name(node));
+		}
+	}
+	_write_name_list(blif_stream, ".outputs", names);
+
+	for (dff = 0; dff < m_nDFF; dff++)
+	{
+		blif_stream << ".latch " << get_node_name(m_dff_drivers[dff]) << " " << get_node_name(m_nPI + dff)
+			<< " re " << GENERATED_CLOCK_NAME << " 0\n";
+	}
+
+	for (lut = 0; lut < get_nLUT(); lut++)
+	{
+		blif_stream << ".names";
+		for (input = m_fanin_start[lut]; input < m_fanin_start[lut + 1]; input++)
+		{
+			blif_stream << " " << get_node_name(m_fanins[input]);
+		}
+		blif_stream << " " << get_node_name(nSources + lut) << "\n" 
+			<< string(m_fanin_start[lut + 1] - m_fanin_start[lut], '1') << " 1\n";
+	}
+
+	blif_stream << ".end\n";
+}
+
+// RETURNS: the number of LUTs without fanout, which are the primary outputs
+NUM_ELEMENTS NETLIST_GENERATOR::get_nPO() const
+{
+	NUM_ELEMENTS node, nPO = 0;
+
+	for (node = m_nPI + m_nDFF; node < static_cast<NUM_ELEMENTS>(m_has_fanout.size()); node++)
+	{
+		nPO += is_po(node);
+	}
+	return nPO;
+}
+
+// RETURNS: true if the node is a LUT without fanout
+bool NETLIST_GENERATOR::is_po
+(
+	const NUM_ELEMENTS & node
+) const
+{
+	return (node >= m_nPI + m_nDFF && ! m_has_fanout[node]);
+}
+
+// RETURNS: the name of the net the node drives
+string NETLIST_GENERATOR::get_node_name
+(
+	const NUM_ELEMENTS & node
+) const
+{
+	ostringstream name;
+
+	if (node < m_nPI)
+	{
+		name << "pi" << node;
+	}
+	else if (node < m_nPI + m_nDFF)
+	{
+		name << "ff" << node - m_nPI;
+	}
+	else
+	{
+		name << "n" << node - m_nPI - m_nDFF;
+	}
+	return name.str();
+}
+
+//
+// Reads the circuit's Node_shape from a text stats file
+//
+// PRE: stats_file_name is the name of a stats file
+// POST: node_shape holds the nodes of each delay level of the circuit
+// RETURNS: false if the file can't be read or has no Node_shape
+//
+bool NETLIST_GENERATOR::read_node_shape
+(
+	const string & stats_file_name,
+	NUM_ELEMENTS_VECTOR & node_shape
+)
+{
+	ifstream stats_file(stats_file_name.c_str());
+	string line, token;
+	NUM_ELEMENTS nNodes;
+
+	node_shape.clear();
+
+	while (getline(stats_file, line))
+	{
+		if (line.compare(0, 11, "Node_shape:") != 0)
+		{
+			continue;
+		}
+
+		istringstream shape_stream(line.substr(11));
+		shape_stream >> token;
+		while (token == "(" && shape_stream >> nNodes)
+		{
+			node_shape.push_back(nNodes);
+		}
+		break;
+	}
+
+	return (node_shape.size() >= 2);
+}
+
+// RETURNS: a number in [0, 1) drawn from random
+static double _random_fraction
+(
+	RANDOM_NUMBER & random
+)
+{
+	return static_cast<double>(random.random_number(PROBABILITY_STEPS - 1)) / PROBABILITY_STEPS;
+}
+
+//
+// PRE: keyword is .inputs or .outputs
+// POST: the names have been written after the keyword, a few to a line
+//
+static void _write_name_list
+(
+	ostream & blif_stream,
+	const string & keyword,
+	const vector<string> & names
+)
+{
+	const size_t NAMES_PER_LINE = 16;
+	size_t index;
+
+	blif_stream << keyword;
+	for (index = 0; index < names.size(); index++)
+	{
+		if (index > 0 && index % NAMES_PER_LINE == 0)
+		{
+			blif_stream << " \\\n";
+		}
+		blif_stream << " " << names[index];
+	}
+	blif_stream << "\n";
+}
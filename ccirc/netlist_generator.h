@@ -0,0 +1,108 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+#ifndef netlist_generator_H
+#define netlist_generator_H
+
+#include "circ.h"
+#include "circuit.h"
+#include "rand.h"
+
+//
+// Class_name NETLIST_GENERATOR
+//
+// Description
+//
+//		Makes random synthetic netlists of any size for scaling and stress 
+//		tests.  The netlist is drawn once by generate() into flat arrays and 
+//		can then be built as a CIRCUIT or written as BLIF.
+//
+//		Its nodes are laid out by delay level following a target Node_shape:
+//		level 0 holds the primary inputs and the flip-flops and every other 
+//		level the LUTs of that delay.  A LUT has 2 to k inputs.  The first 
+//		comes from the level below so the LUT sits on its level, the others 
+//		from any lower level
+//			- with the probability reconvergence, from the fanin of the 
+//			  first input, which closes a reconvergent path
+//			- otherwise with the probability fanout_skew, from the source of 
+//			  an edge already drawn, which favours high fanout nodes and 
+//			  gives a heavy tailed fanout distribution
+//			- otherwise from any lower node alike
+//		Each flip-flop is fed by a LUT of any level.  LUTs without fanout 
+//		become the primary outputs.
+//
+
+class NETLIST_GENERATOR
+{
+public:
+	NETLIST_GENERATOR();
+	NETLIST_GENERATOR(const NETLIST_GENERATOR & another_generator);
+	NETLIST_GENERATOR & operator=(const NETLIST_GENERATOR & another_generator);
+	~NETLIST_GENERATOR();
+
+	void	set_name(const string & name) { m_name = name; }
+	void	set_nNodes(const NUM_ELEMENTS & nNodes) { m_nNodes = nNodes; }
+	void	set_k(const K_TYPE & k) { m_k = k; }
+	void	set_depth(const DELAY_TYPE & depth) { m_depth = depth; }
+	void	set_node_shape(const NUM_ELEMENTS_VECTOR & node_shape) { m_target_shape = node_shape; }
+	void	set_fanout_skew(const double & fanout_skew) { m_fanout_skew = fanout_skew; }
+	void	set_reconvergence(const double & reconvergence) { m_reconvergence = reconvergence; }
+	void	set_dff_ratio(const double & dff_ratio) { m_dff_ratio = dff_ratio; }
+	void	set_seed(const long & seed) { m_seed = seed; }
+
+	void		generate();
+	CIRCUIT *	build_circuit() const;
+	void		write_blif(ostream & blif_stream) const;
+
+	NUM_ELEMENTS	get_nPI() const { return m_nPI; }
+	NUM_ELEMENTS	get_nDFF() const { return m_nDFF; }
+	NUM_ELEMENTS	get_nLUT() const { return static_cast<NUM_ELEMENTS>(m_fanin_start.size()) - 1; }
+	NUM_ELEMENTS	get_nEdges() const { return static_cast<NUM_ELEMENTS>(m_fanins.size()) + m_nDFF; }
+	NUM_ELEMENTS	get_nPO() const;
+
+	static bool	read_node_shape(const string & stats_file_name, NUM_ELEMENTS_VECTOR & node_shape);
+
+private:
+	string				m_name;
+	NUM_ELEMENTS		m_nNodes;			// the LUTs and flip-flops wanted
+	K_TYPE				m_k;
+	DELAY_TYPE			m_depth;			// the levels of LUTs, without a target shape
+	NUM_ELEMENTS_VECTOR	m_target_shape;		// nodes by level, scaled to m_nNodes
+	double				m_fanout_skew;
+	double				m_reconvergence;
+	double				m_dff_ratio;
+	long				m_seed;
+
+	// the netlist drawn.  the sources are numbered first, primary inputs 
+	// then flip-flops, and the LUTs after them in level order
+	NUM_ELEMENTS		m_nPI;
+	NUM_ELEMENTS		m_nDFF;
+	NUM_ELEMENTS_VECTOR	m_level_start;		// the first node of each level, and the end
+	vector<unsigned>	m_fanin_start;		// where the inputs of each LUT start in m_fanins
+	vector<unsigned>	m_fanins;
+	vector<unsigned>	m_dff_drivers;		// the LUT feeding each flip-flop
+	vector<bool>		m_has_fanout;
+
+	void	find_level_sizes(NUM_ELEMENTS_VECTOR & level_sizes);
+	unsigned	draw_fanin(RANDOM_NUMBER & random, const unsigned & first_fanin, 
+						const NUM_ELEMENTS & level_begin, const NUM_ELEMENTS & nSources,
+						NUM_ELEMENTS & next_unused_source);
+	bool	is_po(const NUM_ELEMENTS & node) const;
+	string	get_node_name(const NUM_ELEMENTS & node) const;
+};
+
+
+#endif
@@ -22,15 +22,7 @@
 const bool DCP = false;
 
 #include "node_partitioner.h"
-
-// extern "C" int HMETIS_PartKway(int number_of_nodes,int number_of_edges, int * node_weights, 
-// 							int * start_of_edges_array, int * hyper_edges, int * edge_weights, 
-// 								int number_parts, int ubfactor, int * options, int * results, int* edge_cut);
-
-// extern "C" int HMETIS_PartRecursive(int number_of_nodes,int number_of_edges, int * node_weights, 
-// 								int * start_of_edges_array, int * hyper_edges, int * edge_weights, 
-// 									int number_parts, int ubfactor, int * options, int * results, int* edge_cut);
-
+#include "hypergraph_partitioner.h"
 
 NODE_PARTITIONER::NODE_PARTITIONER()
 {
@@ -166,22 +158,21 @@ COST_TYPE NODE_PARTITIONER::partition_graph()
 {
 	int number_of_nodes = 0;
 	int number_of_edges = 0;
-	int * node_weights = 0;
 	int * start_of_edges_array = 0;
 	int * edges_info = 0;
 
-	int * edge_weights = 0;	
 	int ubfactor = g_options->get_ub_factor();
 	// ubfactor: balancing factor. defined differently for k-way vs. bi-partitioning
 		
-	int options[9] = {0,0,0,0,0,0,0,0,0};
-	int * results;			// where the results of the partitioning are returned
-	int k_way_edge_cut = 0; // returns the number of hyperedges cut
-	int rec_edge_cut = 0; // returns the number of hyperedges cut
-	COST_TYPE k_way_scaled_cost = 0.0;
-	COST_TYPE recursive_scaled_cost = 0.0;
+	HYPERGRAPH hypergraph;
+	HG_INDEXES results;		// where the results of the partitioning are returned
+	int edge_cut = 0; 		// the number of hyperedges cut
 	COST_TYPE cost = 0.0;
 
+	// the seed is fixed unless one is given so that the clusters are repeatable
+	HYPERGRAPH_PARTITIONER partitioner(g_options->get_nThreads(), 
+							g_options->get_seed() ? g_options->get_seed() : 1);
+
 
 	debug("ubfactor is " << ubfactor);
 
@@ -200,62 +191,47 @@ COST_TYPE NODE_PARTITIONER::partition_graph()
 
 
 	// Maps each output port to a number
-	// This will allow us to use the hMetis API
 	create_port_ptr_to_index_map();
 
-	// create the data structures for hMetis
+	// create the data structures for the partitioner, laid out as for hMetis
 	start_of_edges_array = new int[number_of_edges+1];
 	edges_info = new int[number_of_edges*2];
-	results = new int[number_of_nodes];
-
-	edge_weights = 0; 
 
-	// fill in the data structures we pass to hMetis
+	// fill in the data structures we pass to the partitioner
 	fill_in_edge_info(start_of_edges_array, edges_info);
 
+	// each node has a weight of 1 and so does each edge
+	hypergraph.set(number_of_nodes, number_of_edges, start_of_edges_array, edges_info, 0, 0);
+
 	// Call the correct partitioner
 	if (g_options->get_type_of_partitioning() == OPTIONS::KWAY)
 	{
-		debug("The total scaled cost \tk_way_scaled_cost");
-
-		// disabled for 64bit usage 
-		// HMETIS_PartKway(number_of_nodes, number_of_edges, node_weights, 
-		// 	start_of_edges_array, edges_info, edge_weights, 
-		// 	number_partitions, ubfactor, options, results, &k_way_edge_cut);
-
-		k_way_scaled_cost = get_scaled_cost(number_of_edges, number_partitions, 
-												number_of_nodes, edges_info, results);
-		cost = k_way_scaled_cost;
-
-		debug(number_partitions << "\t" << k_way_scaled_cost);
+		edge_cut = partitioner.partition_kway(hypergraph, number_partitions, ubfactor, results);
 	}
 	else
 	{
 		assert(g_options->get_type_of_partitioning() == OPTIONS::RECURSIVE_BI);
 
-		debug("The total scaled cost \trecursive_scaled_cost");
-
-		// HMETIS_PartRecursive(number_of_nodes, number_of_edges, node_weights, 
-		// 	start_of_edges_array, edges_info, edge_weights, 
-		// 	number_partitions, ubfactor, options, results, &rec_edge_cut);
+		edge_cut = partitioner.partition_recursive(hypergraph, number_partitions, ubfactor, results);
+	}
+	assert(static_cast<int>(results.size()) == number_of_nodes);
 
-		recursive_scaled_cost = get_scaled_cost(number_of_edges, number_partitions, 
-												number_of_nodes, edges_info, results);
-		cost = k_way_scaled_cost;
+	cost = get_scaled_cost(number_of_edges, number_partitions, number_of_nodes, edges_info, results.data());
 
-		debug(number_partitions << "\t" << recursive_scaled_cost);
-	}
+	Log("Partitioned " << number_of_nodes << " nodes into " << number_partitions << " parts: " << 
+		edge_cut << " edges cut, scaled cost " << cost);
 
-	// from the results we obtained from hMetis label each node with the partition they belong to
-	label_nodes_with_the_partition_they_belong_to(results, number_of_nodes, number_partitions); 
+	// from the results label each node with the partition they belong to
+	label_nodes_with_the_partition_they_belong_to(results.data(), number_of_nodes, number_partitions); 
 
 	// construct the clusters 
 	construct_clusters(number_partitions);
 
-	m_circuit->set_scaled_cost(cost);
+	if (m_partition_type == NODE_PARTITIONER::CIRCUIT_TYPE)
+	{
+		m_circuit->set_scaled_cost(cost);
+	}
 
-	delete [] results;
-	results = 0;
 	delete [] start_of_edges_array;
 	start_of_edges_array = 0;
 	delete [] edges_info;
@@ -283,36 +259,31 @@ COST_TYPE NODE_PARTITIONER::get_scaled_cost
 	COST_TYPE total_cost = 0.0;
 	int edge_index = 0;
 	int partition_index = 0;
-	int edges_cut_for_partition = 0;
 	int vertex_A, vertex_B;
+	PARTITION_WEIGHTS_TYPE_ALSO edges_cut_by_partition(number_partitions, 0);
 
 	PARTITION_WEIGHTS_TYPE_ALSO partition_weights = get_partition_weights(results, number_of_nodes, 
 																	number_partitions);
 	
-	// sum the cost over all the partitions
-	for (partition_index = 0; partition_index < number_partitions; partition_index++)
+	// a cut edge cuts both the partitions it joins
+	for (edge_index = 0; edge_index < number_of_edges; edge_index++)
 	{
-		edges_cut_for_partition = 0;
+		vertex_A = edges_info[edge_index*2];
+		vertex_B = edges_info[edge_index*2+1];
 
-		debugif(DCP, "Looking at partition " << partition_index);
-		// check all the edges to see if any of them cut the partition
-		for (edge_index = 0; edge_index < number_of_edges; edge_index++)
+		if (results[vertex_A] != results[vertex_B])
 		{
-			vertex_A = edges_info[edge_index*2];
-			vertex_B = edges_info[edge_index*2+1];
+			debugif(DCP, "\tFound a edge " << vertex_A << " to " << vertex_B);
+			edges_cut_by_partition[results[vertex_A]]++;
+			edges_cut_by_partition[results[vertex_B]]++;
+		}
+	}	
 
-			if (results[vertex_A] == partition_index || results[vertex_B] == partition_index)
-			{
-				// check to see if the edge is cuts the partition
-				if ((results[vertex_A] != partition_index || results[vertex_B] != partition_index))
-				{
-					debugif(DCP, "\tFound a edge " << vertex_A << " to " << vertex_B);
-					edges_cut_for_partition++;
-				}
-			}
-		}	
+	// sum the cost over all the partitions
+	for (partition_index = 0; partition_index < number_partitions; partition_index++)
+	{
 		// note some partitions have zero weight. this will cause the cost to have infinite cost
-		total_cost += (static_cast<COST_TYPE>(edges_cut_for_partition))/
+		total_cost += (static_cast<COST_TYPE>(edges_cut_by_partition[partition_index]))/
 					 (static_cast<COST_TYPE>(partition_weights[partition_index]));
 	}	
 
@@ -327,7 +298,7 @@ COST_TYPE NODE_PARTITIONER::get_scaled_cost
 
 	
 //
-// fill in a data structures we pass to hMetis that details what connects to what
+// fill in a data structures we pass to the partitioner that details what connects to what
 //  If we are partitioning a circuit all edges (sans edges connected to clocks) are dealt with
 //  If we are partitioning a cluster only intra-cluster edges are dealt with
 //
@@ -363,7 +334,7 @@ void NODE_PARTITIONER::fill_in_edge_info
 	EDGE * edge = 0;
 	NUM_ELEMENTS number_of_edges = get_nEdges();
 
-	// for each edge write to the hMetis datastructure what each connects to
+	// for each edge write to the partitioner's datastructure what each connects to
 	debugif(DCP, "About to fill in edge information");
 	for (edge_iter = edges.begin(); edge_iter != edges.end(); edge_iter++)
 	{
@@ -499,12 +470,12 @@ void NODE_PARTITIONER::create_port_ptr_to_index_map()
 		m_port_index_map[port] = index;
 		index++;
 	}
-	assert(index = get_size());
+	assert(index == get_size());
 }
 
 //
 // label each node with the partition they belong to 
-// PRE: hMetis has been called. results array contains the results
+// PRE: the partitioner has been called. results array contains the results
 // POST: each node and primary output has its partition labelled
 void NODE_PARTITIONER::label_nodes_with_the_partition_they_belong_to
 (
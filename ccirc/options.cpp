@@ -21,19 +21,27 @@
 #include "options.h"
 #include "util.h"
 #include "circ.h"
+#include "thread_pool.h"
 
 #define Warning_for_options
 
+// the options of the circuit being analyzed. set by main, by the library or
+// for each circuit of a batch, so each thread has its own
+thread_local OPTIONS * g_options = 0;
 
 OPTIONS::OPTIONS()
 {
 	m_input_file_name   = "";
 	m_output_file_name	= "";
+	m_output_format		= OPTIONS::TEXT_FORMAT;
+	m_stats_list		= "";
+	m_profile			= false;
+	m_trace_file_name	= "";
 	m_circuit_name		= "";
 
     m_k					= 6;					
 	m_partitioning_type = OPTIONS::KWAY;
-	m_nPartitions		= 8;
+	m_nPartitions		= 1;		// a single cluster: no partitioning
 
 
 	m_verbose 			= true;
@@ -45,8 +53,18 @@ OPTIONS::OPTIONS()
 
 
 	m_determine_wirelength_approx = false;
+	m_wirelength_time_budget = 0;		// no limit
+	m_wirelength_schedule = OPTIONS::WL_ADAPTIVE_SCHEDULE;
+	m_wirelength_mode = OPTIONS::WL_ANNEAL;
 
     m_draw 				= false;
+	m_serve				= false;
+	m_help				= false;
+	m_batch_name		= "";
+	m_batch_table_name	= "";
+	m_nJobs				= 1;
+	m_incremental		= false;
+	m_verify_incremental = false;
 
     m_expand_luts 		= false;	
 
@@ -55,6 +73,14 @@ OPTIONS::OPTIONS()
 	m_display_statistics_on_delay_defining_edges = false;
 
 	m_ubfactor			= 20;		// balancing factor. defined differently for k-way vs. bi-partitioning
+	m_nThreads			= THREAD_POOL::get_default_nThreads();
+	m_rnum_engine		= OPTIONS::RNUM_BITSET;
+	m_rnum_mode			= OPTIONS::RNUM_QUICK;
+	m_rnum_full_cap		= 5000;
+	m_rnum_full_work	= 20000000;
+	m_rnum_sample		= 0;		// count every PI
+	m_rnum_tolerance	= 0;		// never stop early
+	m_seed				= 0;		// seed from the clock
 }
 
 OPTIONS::OPTIONS(const OPTIONS & another_options)
@@ -64,16 +90,40 @@ OPTIONS::OPTIONS(const OPTIONS & another_options)
 	m_no_warn			= another_options.m_no_warn;
 	m_circuit_name		= another_options.m_circuit_name;
 
+	m_input_file_name	= another_options.m_input_file_name;
 	m_output_file_name	= another_options.m_output_file_name;
+	m_output_format		= another_options.m_output_format;
+	m_stats_list		= another_options.m_stats_list;
+	m_profile			= another_options.m_profile;
+	m_trace_file_name	= another_options.m_trace_file_name;
 
     m_k					= another_options.m_k;
 	m_store_luts		= false;
 	m_partitioning_type = another_options.m_partitioning_type;
 	m_nPartitions		= another_options.m_nPartitions;
+	m_ubfactor			= another_options.m_ubfactor;
+	m_nThreads			= another_options.m_nThreads;
+	m_rnum_engine		= another_options.m_rnum_engine;
+	m_rnum_mode			= another_options.m_rnum_mode;
+	m_rnum_full_cap		= another_options.m_rnum_full_cap;
+	m_rnum_full_work	= another_options.m_rnum_full_work;
+	m_rnum_sample		= another_options.m_rnum_sample;
+	m_rnum_tolerance	= another_options.m_rnum_tolerance;
+	m_seed				= another_options.m_seed;
 
 	m_determine_wirelength_approx = another_options.m_determine_wirelength_approx;
+	m_wirelength_time_budget = another_options.m_wirelength_time_budget;
+	m_wirelength_schedule = another_options.m_wirelength_schedule;
+	m_wirelength_mode = another_options.m_wirelength_mode;
 
     m_draw 					= another_options.m_draw;
+	m_serve					= another_options.m_serve;
+	m_help					= another_options.m_help;
+	m_batch_name			= another_options.m_batch_name;
+	m_batch_table_name		= another_options.m_batch_table_name;
+	m_nJobs					= another_options.m_nJobs;
+	m_incremental			= another_options.m_incremental;
+	m_verify_incremental	= another_options.m_verify_incremental;
 
     m_expand_luts 		= another_options.m_expand_luts;
 
@@ -92,17 +142,41 @@ OPTIONS & OPTIONS::operator=(const OPTIONS & another_options)
 	m_no_warn			= another_options.m_no_warn;
 	m_circuit_name		= another_options.m_circuit_name;
 
+	m_input_file_name	= another_options.m_input_file_name;
 	m_output_file_name	= another_options.m_output_file_name;
+	m_output_format		= another_options.m_output_format;
+	m_stats_list		= another_options.m_stats_list;
+	m_profile			= another_options.m_profile;
+	m_trace_file_name	= another_options.m_trace_file_name;
 
     /* processing options and information*/
     m_k					= another_options.m_k;
 	m_store_luts		= false;
 	m_partitioning_type = another_options.m_partitioning_type;
 	m_nPartitions		= another_options.m_nPartitions;
+	m_ubfactor			= another_options.m_ubfactor;
+	m_nThreads			= another_options.m_nThreads;
+	m_rnum_engine		= another_options.m_rnum_engine;
+	m_rnum_mode			= another_options.m_rnum_mode;
+	m_rnum_full_cap		= another_options.m_rnum_full_cap;
+	m_rnum_full_work	= another_options.m_rnum_full_work;
+	m_rnum_sample		= another_options.m_rnum_sample;
+	m_rnum_tolerance	= another_options.m_rnum_tolerance;
+	m_seed				= another_options.m_seed;
 
 	m_determine_wirelength_approx = another_options.m_determine_wirelength_approx;
+	m_wirelength_time_budget = another_options.m_wirelength_time_budget;
+	m_wirelength_schedule = another_options.m_wirelength_schedule;
+	m_wirelength_mode = another_options.m_wirelength_mode;
 
     m_draw 					= another_options.m_draw;
+	m_serve					= another_options.m_serve;
+	m_help					= another_options.m_help;
+	m_batch_name			= another_options.m_batch_name;
+	m_batch_table_name		= another_options.m_batch_table_name;
+	m_nJobs					= another_options.m_nJobs;
+	m_incremental			= another_options.m_incremental;
+	m_verify_incremental	= another_options.m_verify_incremental;
 
     m_expand_luts 		= another_options.m_expand_luts;
 
@@ -132,7 +206,23 @@ void OPTIONS::process_options
 {
 	read_arguments(argc, argv);
 
-	m_circuit_name = get_circuit_name_from_filename(m_input_file_name);
+	// in server and batch mode the circuits arrive with each request
+	if (! m_input_file_name.empty())
+	{
+		m_circuit_name = get_circuit_name_from_filename(m_input_file_name);
+	}
+
+	// asking for the wirelength is enough to measure it
+	if ((string(",") + m_stats_list + ",").find(",Wirelength_approx,") != string::npos)
+	{
+		m_determine_wirelength_approx = true;
+	}
+
+	// the jobs of a batch share the hardware threads unless told otherwise
+	if (m_nJobs > 1 && m_nThreads == THREAD_POOL::get_default_nThreads())
+	{
+		m_nThreads = MAX(1, m_nThreads / m_nJobs);
+	}
 
 }
 // PRE: argc contains the number of command line arguments
@@ -157,9 +247,17 @@ void OPTIONS::read_arguments
 
 	if (arg == "--help" || arg == "help" || arg == "-h" || arg == "-help")
 	{
-		display_option_usage();
-		exit(0);
+		m_help = true;
 	} 
+	else if (arg == "--serve")
+	{
+		m_serve = true;
+	}
+	else if (arg == "--batch")
+	{
+		// the batch names the circuits. read it with the other options
+		argnum--;
+	}
 	else
 	{
 		m_input_file_name = string(argv[argnum]);
@@ -172,8 +270,7 @@ void OPTIONS::read_arguments
 
 		if (arg =="--help" || arg =="help" || arg =="-h" || arg =="-help")
 		{
-			display_option_usage();
-			exit(0);
+			m_help = true;
 		} 
 		else if (arg == "--partition_type") 
 		{
@@ -209,6 +306,54 @@ void OPTIONS::read_arguments
 			}
 			cout << "option: output file: " << m_output_file_name << endl;
 		} 
+		else if (arg == "--stats") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				m_stats_list = string(argv[argnum]);
+				cout << "option: stats: " << m_stats_list << endl;
+			}
+		} 
+		else if (arg == "--profile") 
+		{
+			m_profile = true;
+		} 
+		else if (arg == "--trace") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				m_trace_file_name = string(argv[argnum]);
+				cout << "option: trace file: " << m_trace_file_name << endl;
+			}
+		} 
+		else if (arg == "--format") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+
+				if (next_arg == "text")
+				{
+					m_output_format = OPTIONS::TEXT_FORMAT;
+				}
+				else if (next_arg == "json")
+				{
+					m_output_format = OPTIONS::JSON_FORMAT;
+				}
+				else if (next_arg == "bin")
+				{
+					m_output_format = OPTIONS::BINARY_FORMAT;
+				}
+				else
+				{
+					cerr << "Warning: unknown output format found:'" << next_arg  
+						<< "'.  Ignoring. "  << endl;
+				}
+			}
+		} 
 		else if (arg == "--verbose") 
 		{
 			m_verbose = true;
@@ -253,16 +398,260 @@ void OPTIONS::read_arguments
 				m_ubfactor = atoi(next_arg.c_str());
 				cout << "option:  ubfactor: " << m_ubfactor << endl;
 			}
+        } 
+		else if (arg == "--threads") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+				m_nThreads = atoi(next_arg.c_str());
+				if (m_nThreads < 1)
+				{
+					cerr << "Warning: --threads needs a positive number, not '" << next_arg  
+						<< "'.  Using " << THREAD_POOL::get_default_nThreads() << "." << endl;
+					m_nThreads = THREAD_POOL::get_default_nThreads();
+				}
+				cout << "option:  threads: " << m_nThreads << endl;
+			}
+        } 
+		else if (arg == "--rnum") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+
+				if (next_arg == "quick")
+				{
+					m_rnum_mode = OPTIONS::RNUM_QUICK;
+				}
+				else if (next_arg == "full")
+				{
+					cout << "option:  rnum: full\n";
+					m_rnum_mode = OPTIONS::RNUM_FULL;
+				}
+				else if (next_arg == "both")
+				{
+					cout << "option:  rnum: quick and full\n";
+					m_rnum_mode = OPTIONS::RNUM_BOTH;
+				}
+				else
+				{
+					cerr << "Warning: unknown rnum mode found:'" << next_arg  
+						<< "'.  Ignoring. "  << endl;
+				}
+			}
+        } 
+		else if (arg == "--rnum_full_cap") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+				m_rnum_full_cap = atol(next_arg.c_str());
+				cout << "option:  rnum full cap: " << m_rnum_full_cap << endl;
+			}
+        } 
+		else if (arg == "--rnum_full_work") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+				m_rnum_full_work = atol(next_arg.c_str());
+				cout << "option:  rnum full work: " << m_rnum_full_work << endl;
+			}
+        } 
+		else if (arg == "--rnum_sample") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+				m_rnum_sample = atof(next_arg.c_str());
+				if (m_rnum_sample <= 0)
+				{
+					cerr << "Warning: --rnum_sample needs a fraction or a count of primary inputs, not '" 
+						<< next_arg << "'.  Counting every primary input." << endl;
+					m_rnum_sample = 0;
+				}
+				else
+				{
+					cout << "option:  rnum sample: " << m_rnum_sample << endl;
+				}
+			}
+        } 
+		else if (arg == "--rnum_tolerance") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+				m_rnum_tolerance = atof(next_arg.c_str());
+				cout << "option:  rnum tolerance: " << m_rnum_tolerance << endl;
+			}
+        } 
+		else if (arg == "--seed") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+				m_seed = atol(next_arg.c_str());
+				cout << "option:  seed: " << m_seed << endl;
+			}
+        } 
+		else if (arg == "--rnum_engine") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+
+				if (next_arg == "bitset")
+				{
+					m_rnum_engine = OPTIONS::RNUM_BITSET;
+				}
+				else if (next_arg == "cone")
+				{
+					m_rnum_engine = OPTIONS::RNUM_CONE;
+				}
+				else if (next_arg == "check")
+				{
+					cout << "option:  rnum: checking the bitset engine against the cone by cone count\n";
+					m_rnum_engine = OPTIONS::RNUM_CHECK;
+				}
+				else
+				{
+					cerr << "Warning: unknown rnum engine found:'" << next_arg  
+						<< "'.  Ignoring. "  << endl;
+				}
+			}
         } 
 		else if (arg == "--wirelength_approx")
 		{
 			m_determine_wirelength_approx = true;
 			cout << "option:  Determine wirelength_approx" << endl;
+        } 
+		else if (arg == "--wirelength_time_budget")
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+				m_wirelength_time_budget = atof(next_arg.c_str());
+				if (m_wirelength_time_budget < 0)
+				{
+					cerr << "Warning: --wirelength_time_budget needs a number of seconds, not '" 
+						<< next_arg << "'.  Annealing without a limit." << endl;
+					m_wirelength_time_budget = 0;
+				}
+				else
+				{
+					cout << "option:  wirelength time budget: " << m_wirelength_time_budget << " s" << endl;
+				}
+			}
+        } 
+		else if (arg == "--wirelength_schedule")
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+
+				if (next_arg == "fixed")
+				{
+					m_wirelength_schedule = OPTIONS::WL_FIXED_SCHEDULE;
+				}
+				else if (next_arg == "adaptive")
+				{
+					m_wirelength_schedule = OPTIONS::WL_ADAPTIVE_SCHEDULE;
+				}
+				else
+				{
+					cerr << "Warning: unknown wirelength schedule found:'" << next_arg  
+						<< "'.  Ignoring. "  << endl;
+				}
+			}
+        } 
+		else if (arg == "--wirelength_mode")
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+
+				if (next_arg == "anneal")
+				{
+					m_wirelength_mode = OPTIONS::WL_ANNEAL;
+				}
+				else if (next_arg == "analytic")
+				{
+					m_wirelength_mode = OPTIONS::WL_ANALYTIC;
+				}
+				else if (next_arg == "analytic_anneal")
+				{
+					m_wirelength_mode = OPTIONS::WL_ANALYTIC_ANNEAL;
+				}
+				else
+				{
+					cerr << "Warning: unknown wirelength mode found:'" << next_arg  
+						<< "'.  Ignoring. "  << endl;
+				}
+			}
         } 
 		else if (arg == "--draw") 
 		{
 	    	m_draw = true;
 		} 
+		else if (arg == "--serve") 
+		{
+			m_serve = true;
+		} 
+		else if (arg == "--batch") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				m_batch_name = string(argv[argnum]);
+				cout << "option:  batch: " << m_batch_name << endl;
+			}
+		} 
+		else if (arg == "--batch_table") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				m_batch_table_name = string(argv[argnum]);
+				cout << "option:  batch table: " << m_batch_table_name << endl;
+			}
+		} 
+		else if (arg == "-j" || arg == "--jobs") 
+		{
+			if (additional_arguments(argnum, argc, arg))
+			{
+				argnum++;
+				next_arg = string(argv[argnum]);
+				m_nJobs = atoi(next_arg.c_str());
+				if (m_nJobs < 1)
+				{
+					cerr << "Warning: " << arg << " needs a positive number of jobs, not '" 
+						<< next_arg << "'.  Using 1." << endl;
+					m_nJobs = 1;
+				}
+				cout << "option:  jobs: " << m_nJobs << endl;
+			}
+		} 
+		else if (arg == "--incremental") 
+		{
+			m_incremental = true;
+		} 
+		else if (arg == "--verify_incremental") 
+		{
+			m_incremental = true;
+			m_verify_incremental = true;
+		} 
 		else if (arg == "--display_pi_and_dff_distributions") 
 		{
 	    	m_display_pi_and_dff_distributions = true;
@@ -301,19 +690,81 @@ void OPTIONS::display_option_usage() const
 	cout << "General Options:\n";
 	cout << "        [--help] \n";
 	cout << "        [--nowarn]\n";
-	cout << "        [--out]\n";
+	cout << "        [--out <file | ->]   (default: <circuit>.stats, .json or .bin; - for stdout)\n";
+	cout << "        [--format text | json | bin]\n";
+	cout << "                text (default), one json object per circuit per line,\n";
+	cout << "                or a fixed-schema little-endian binary record per circuit.\n";
+	cout << "        [--stats <name,name,...> | all]   (default: all)\n";
+	cout << "                report only these statistics and skip the passes they do not need,\n";
+	cout << "                e.g. Number_of_Nodes,Avg_fanout,Reconvergence.  Cluster_summary, Clusters\n";
+	cout << "                and Inter_cluster_adjacency_matrix name those groups.  Logs the pass times.\n";
+	cout << "        [--profile]\n";
+	cout << "                add a PROFILE section with the wall and cpu time and the change in\n";
+	cout << "                resident memory of each stage, and the peak resident memory.\n";
+	cout << "                The stages are in the order they began, a stage inside another is\n";
+	cout << "                named parent.stage, and the cpu time is of the circuit's own threads.\n";
+	cout << "        [--trace <file.json>]\n";
+	cout << "                write the stages and the spans inside them as a Chrome trace.\n";
+	cout << "        [--threads <int>]   (default: one per hardware thread)\n";
 	cout << endl;
 	cout << "Partitioning Options:\n";
 	cout << "        [--partition_type  bi | kway]\n";
-	cout << "        [--partitions <int>]\n";
-	cout << "        [--ubfactor <int>]";
+	cout << "        [--partitions <int>]   (default: 1, the circuit is not partitioned)\n";
+	cout << "        [--ubfactor <int>]   (default: 20)";
+	cout << endl;
+	cout << "Reconvergence Options:\n";
+	cout << "        [--rnum quick | full | both]\n";
+	cout << "                full takes the Kirchhoff log-determinant of each sequential cone.\n";
+	cout << "        [--rnum_full_cap <int>]\n";
+	cout << "                cones with more nodes are counted quick in full mode (default 5000).\n";
+	cout << "        [--rnum_full_work <int>]\n";
+	cout << "                so are cones whose determinant scans or updates more matrix entries\n";
+	cout << "                (default 20000000).\n";
+	cout << "        [--rnum_sample <fraction | count>]\n";
+	cout << "                estimate from a sample of the primary inputs, drawn by cone size.\n";
+	cout << "                Reconvergence_max and _min are then over the primary inputs drawn.\n";
+	cout << "        [--rnum_tolerance <float>]\n";
+	cout << "                stop sampling once the 95% confidence interval is within +/- this,\n";
+	cout << "                after at least 30 draws.\n";
+	cout << "        [--seed <int>]   (default: seed from the clock)\n";
+	cout << "        [--rnum_engine bitset | cone | check]\n";
+	cout << "                bitset counts 64 primary inputs per pass (default),\n";
+	cout << "                cone counts one cone at a time, check runs both and compares.\n";
 	cout << endl;
 	cout << "Calculate Wirelength-approx:\n";
 	cout << "        [--wirelength_approx]\n";
+	cout << "        [--wirelength_time_budget <seconds>]   (default: 0, no limit)\n";
+	cout << "                one annealing chain runs per thread, sharing the best every few steps.\n";
+	cout << "                --seed makes the result repeatable for a number of threads.\n";
+	cout << "        [--wirelength_schedule fixed | adaptive]\n";
+	cout << "                adaptive steers the acceptance rate and limits the swap distance (default),\n";
+	cout << "                fixed cools by a table of the acceptance rate.\n";
+	cout << "        [--wirelength_mode anneal | analytic | analytic_anneal]\n";
+	cout << "                anneal the positions (default), place them by a quadratic solve\n";
+	cout << "                per delay level, much faster but longer, or anneal from that placement.\n";
 	cout << endl;
 	cout << "Output a dot drawning of the clone:\n";
 	cout << "        [--draw]\n";
 	cout << endl;
+	cout << "Server mode (ccirc --serve [Options...]):\n";
+	cout << "        Reads one request per line on stdin: 'circuit.blif [Options...]'\n";
+	cout << "        or '- [Options...]' followed by inline BLIF up to '.end'.\n";
+	cout << "        Replies on stdout with the stats followed by a '.done' line.\n";
+	cout << "        [--incremental]\n";
+	cout << "                Only re-analyze the parts of each circuit that differ\n";
+	cout << "                from the circuit of the previous request.\n";
+	cout << "        [--verify_incremental]\n";
+	cout << "                As --incremental, and check the result against a full analysis.\n";
+	cout << endl;
+	cout << "Batch mode (ccirc --batch <list.txt | 'glob'> [Options...]):\n";
+	cout << "        Analyzes every circuit of the list, one 'circuit.blif [Options...]' per line,\n";
+	cout << "        or every file the quoted glob matches.  The options of a line are applied\n";
+	cout << "        on top of the batch's.  Each circuit's stats go to its .stats file.\n";
+	cout << "        [-j | --jobs <int>]   (default: 1)\n";
+	cout << "                circuits analyzed at once. they share the threads unless --threads is given.\n";
+	cout << "        [--batch_table <file>]\n";
+	cout << "                write the stats of the whole batch as one table, a row per circuit.\n";
+	cout << endl;
 }
 
 // PRE: file_name has the file name
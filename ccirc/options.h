@@ -36,33 +36,64 @@ class OPTIONS
 {
 public:
 	enum TYPE_OF_PARTITIONING {RECURSIVE_BI, KWAY};
+	enum RNUM_ENGINE {RNUM_BITSET, RNUM_CONE, RNUM_CHECK};
+	enum RNUM_MODE {RNUM_QUICK, RNUM_FULL, RNUM_BOTH};
+	enum WIRELENGTH_SCHEDULE {WL_FIXED_SCHEDULE, WL_ADAPTIVE_SCHEDULE};
+	enum WIRELENGTH_MODE {WL_ANNEAL, WL_ANALYTIC, WL_ANALYTIC_ANNEAL};
+	enum OUTPUT_FORMAT {TEXT_FORMAT, JSON_FORMAT, BINARY_FORMAT};
 
 	OPTIONS();
 	OPTIONS(const OPTIONS & another_options);
 	OPTIONS & operator=(const OPTIONS & another_options);
 	~OPTIONS();
 	void process_options(int argc,char **argv);
+	void display_option_usage() const;
 
 	void print_options() const;
 
 	string	get_circuit_name() const { return m_circuit_name;}
 	string	get_output_file_name() const { return m_output_file_name; }
+	bool	is_output_to_stdout() const { return m_output_file_name == "-"; }
+	OUTPUT_FORMAT	get_output_format() const { return m_output_format; }
+	string	get_stats_list() const { return m_stats_list; }
+	bool	is_profile() const { return m_profile; }
+	string	get_trace_file_name() const { return m_trace_file_name; }
 	string	get_input_file_name() const { return m_input_file_name;}
 
 	bool 	is_verbose() const { return m_verbose; }
 	bool	is_no_warn() const { return m_no_warn; }
 	bool	is_quiet() const 	 { return m_quiet; }
 
+	bool	is_serve() const { return m_serve; }
+	bool	is_help() const { return m_help; }
+	bool	is_batch() const { return ! m_batch_name.empty(); }
+	string	get_batch_name() const { return m_batch_name; }
+	string	get_batch_table_name() const { return m_batch_table_name; }
+	int		get_nJobs() const { return m_nJobs; }
+	bool	is_incremental() const { return m_incremental; }
+	bool	is_verify_incremental() const { return m_verify_incremental; }
+
 	bool	is_draw_circuit() const { return m_draw; }
 	bool    is_determine_wirelength_approx() const { return m_determine_wirelength_approx; }
+	double	get_wirelength_time_budget() const { return m_wirelength_time_budget; }
+	WIRELENGTH_SCHEDULE	get_wirelength_schedule() const { return m_wirelength_schedule; }
+	WIRELENGTH_MODE		get_wirelength_mode() const { return m_wirelength_mode; }
 
 
 
 	K_TYPE	get_k() const { return m_k;}
 	int		get_nPartitions() const { return m_nPartitions; }
 	int 	get_ub_factor() const { return m_ubfactor; }
+	int		get_nThreads() const { return m_nThreads; }
 
 	TYPE_OF_PARTITIONING 	get_type_of_partitioning() const { return m_partitioning_type;}
+	RNUM_ENGINE				get_rnum_engine() const { return m_rnum_engine; }
+	RNUM_MODE				get_rnum_mode() const { return m_rnum_mode; }
+	long					get_rnum_full_cap() const { return m_rnum_full_cap; }
+	long					get_rnum_full_work() const { return m_rnum_full_work; }
+	double					get_rnum_sample() const { return m_rnum_sample; }
+	double					get_rnum_tolerance() const { return m_rnum_tolerance; }
+	long					get_seed() const { return m_seed; }
 	
 
 
@@ -80,7 +111,11 @@ public:
 private:
 
 	string					m_input_file_name;	
-	string					m_output_file_name;	
+	string					m_output_file_name;	// "-" for stdout
+	OUTPUT_FORMAT			m_output_format;		// text, json lines or binary records
+	string					m_stats_list;			// the statistics to report. empty for all
+	bool					m_profile;				// report what each stage cost
+	string					m_trace_file_name;		// if set, write a trace of the stages here
 	string 					m_circuit_name;
 
     K_TYPE  				m_k;					// define LUT-size for analysis
@@ -88,6 +123,14 @@ private:
 	int						m_nPartitions;			// how many clusters to create
 	int 					m_ubfactor;				// balancing factor. defined differently for 
 													//   k-way vs. bi-partitioning
+	int						m_nThreads;				// threads for the passes that can use them
+	RNUM_ENGINE				m_rnum_engine;			// how the quick rnum cones are counted
+	RNUM_MODE				m_rnum_mode;			// quick and/or full reconvergence
+	long					m_rnum_full_cap;		// larger cones are counted quick in full mode
+	long					m_rnum_full_work;		// and so are cones whose determinant takes more work
+	double					m_rnum_sample;			// < 1 a fraction of the PIs, else a count. 0 for all
+	double					m_rnum_tolerance;		// stop sampling at this confidence half-width
+	long					m_seed;					// random number seed. 0 to use the clock
 
 	bool					m_verbose;
 	bool					m_no_warn;
@@ -95,16 +138,26 @@ private:
 
 
 
-	void display_option_usage() const;
 	void read_arguments(int argc, char ** argv);
 	string get_circuit_name_from_filename(const string & file_name);
 
 
 	// measure the wirelength approx
 	bool m_determine_wirelength_approx;
+	double m_wirelength_time_budget;	// seconds the annealing may take. 0 for no limit
+	WIRELENGTH_SCHEDULE m_wirelength_schedule;	// how the annealing cools
+	WIRELENGTH_MODE m_wirelength_mode;	// anneal, place analytically or both
 
 	bool m_draw; 		// draw the circuit
 
+	bool m_serve;		// keep running and answer requests on stdin
+	bool m_help;		// --help: main shows the usage. the server and the library never exit for it
+	string m_batch_name;	// a file listing the circuits to analyze, or a glob of them
+	string m_batch_table_name;	// if set, the stats of the batch go in one table here
+	int m_nJobs;		// circuits of the batch analyzed at once
+	bool m_incremental;	// reuse the analysis of the previous circuit served
+	bool m_verify_incremental;	// check the reused analysis against a full one
+
 
 
 
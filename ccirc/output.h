@@ -21,6 +21,9 @@
 #ifndef OUT_H
 #define OUT_H
 
+#include <sstream>
+#include <stdexcept>
+
 // Warnings
 //
 
@@ -32,10 +35,21 @@
 //
 
 #define Error(error_text) cerr << "Error: " << error_text << endl;
+
+//
+// Fail throws instead of exiting so that whoever drives the analysis
+// (main, the server or the library) decides if the process should end
+//
+class CIRC_FAILURE : public runtime_error
+{
+public:
+	CIRC_FAILURE(const string & fail_text) : runtime_error(fail_text) {}
+};
 	
 #define Fail(fail_text) { \
-			cerr << endl << "Terminal Error: " << fail_text << endl; \
-			exit(-1);	}
+			ostringstream fail_stream; \
+			fail_stream << fail_text; \
+			throw CIRC_FAILURE(fail_stream.str());	}
 
 #define Verbose(verbose_output) \
 		if ((DEBUG || g_options->is_verbose()) && (! g_options->is_quiet()) ) \
@@ -0,0 +1,204 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+//
+// Measures how fast BLIF is read.
+//
+//	parse_bench [--repeat N] [--tokenize_only] circuit.blif [circuit.blif ...]
+//
+// For each circuit it reports the throughput in MB/s of 
+//	tokenize	splitting the mapped file into tokens only
+//	parse		BLIF_PARSER::parse() on the open file, which maps it and
+//				builds the graph. skipped with --tokenize_only since building
+//				the graph of a very large circuit takes much longer than reading it
+//
+// and, when the graph is built, the milliseconds to delete the circuit and 
+// the peak resident set size of the process so far.
+//
+
+#include "circ.h"
+#include "blif_parser.h"
+#include "blif_tokenizer.h"
+#include "util.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+
+typedef chrono::steady_clock BENCH_CLOCK;
+
+static double seconds_since
+(
+	const BENCH_CLOCK::time_point & start
+)
+{
+	return chrono::duration<double>(BENCH_CLOCK::now() - start).count();
+}
+
+//
+// RETURNS: the text of file_name, or an empty string if it can't be read
+//
+static string read_file
+(
+	const string & file_name
+)
+{
+	string text;
+	char buffer[BUFSIZ];
+	size_t nRead;
+	FILE * input_file = fopen(file_name.c_str(), "r");
+
+	if (input_file)
+	{
+		while ((nRead = fread(buffer, 1, sizeof(buffer), input_file)) > 0)
+		{
+			text.append(buffer, nRead);
+		}
+		fclose(input_file);
+	}
+
+	return text;
+}
+
+static void bench_circuit
+(
+	const string & file_name,
+	int nRepeats,
+	bool tokenize_only
+)
+{
+	string text = read_file(file_name);
+	double megabytes = text.size() / (1024.0 * 1024.0);
+	double tokenize_seconds, parse_seconds = 0, teardown_seconds = 0;
+	long nTokens = 0;
+	BLIF_TOKENS tokens;
+	BENCH_CLOCK::time_point start;
+	int repeat;
+
+	if (text.empty())
+	{
+		cerr << "Could not read " << file_name << endl;
+		return;
+	}
+
+	start = BENCH_CLOCK::now();
+	for (repeat = 0; repeat < nRepeats; repeat++)
+	{
+		BLIF_TOKENIZER tokenizer(text.data(), text.size());
+		while (tokenizer.read_line(tokens))
+		{
+			nTokens += tokens.size();
+		}
+	}
+	tokenize_seconds = seconds_since(start);
+
+	for (repeat = 0; repeat < nRepeats && ! tokenize_only; repeat++)
+	{
+		FILE * input_file = fopen(file_name.c_str(), "r");
+		assert(input_file);
+
+		start = BENCH_CLOCK::now();
+		BLIF_PARSER parser(g_options);
+		CIRCUIT * circuit = parser.parse(input_file);
+		parse_seconds += seconds_since(start);
+		fclose(input_file);
+
+		start = BENCH_CLOCK::now();
+		delete circuit;
+		teardown_seconds += seconds_since(start);
+	}
+
+	cout << setw(24) << left << util_strip_directory_name(file_name) << right
+		<< setw(10) << fixed << setprecision(2) << megabytes
+		<< setw(12) << nTokens / nRepeats
+		<< setw(14) << megabytes * nRepeats / tokenize_seconds;
+
+	if (tokenize_only)
+	{
+		cout << setw(14) << "-" << setw(14) << "-" << setw(14) << "-" << endl;
+	}
+	else
+	{
+		cout << setw(14) << megabytes * nRepeats / parse_seconds
+			<< setw(14) << 1000.0 * teardown_seconds / nRepeats
+			<< setw(14) << util_peak_resident_kb() / 1024.0 << endl;
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	int nRepeats = 5;
+	bool tokenize_only = false;
+	int argnum = 1;
+
+	while (argnum < argc && argv[argnum][0] == '-')
+	{
+		if (string(argv[argnum]) == "--repeat" && argnum + 1 < argc)
+		{
+			nRepeats = atoi(argv[argnum + 1]);
+			argnum += 2;
+		}
+		else if (string(argv[argnum]) == "--tokenize_only")
+		{
+			tokenize_only = true;
+			argnum++;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if (argnum >= argc || nRepeats < 1)
+	{
+		cerr << "Usage:  parse_bench [--repeat N] [--tokenize_only] circuit.blif [circuit.blif ...]" 
+			<< endl;
+		return 1;
+	}
+
+	// the graph constructor needs options. we only want the warnings off
+	char program_name[] = "parse_bench";
+	char no_warn[] = "--nowarn";
+	char * option_argv[] = { program_name, argv[argnum], no_warn };
+
+	g_options = new OPTIONS;
+	g_options->process_options(3, option_argv);
+
+	cout << setw(24) << left << "circuit" << right << setw(10) << "MB" 
+		<< setw(12) << "tokens" << setw(14) << "tokenize MB/s" 
+		<< setw(14) << "parse MB/s" << setw(14) << "teardown ms" 
+		<< setw(14) << "peak RSS MB" << endl;
+
+	try
+	{
+		for (; argnum < argc; argnum++)
+		{
+			bench_circuit(argv[argnum], nRepeats, tokenize_only);
+		}
+	}
+	catch (const CIRC_FAILURE & failure)
+	{
+		cerr << "Error: " << failure.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,302 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+#include "profiler.h"
+#include "circ.h"
+#include "util.h"
+#include <fstream>
+#include <cstdio>
+
+// the profiler of the circuit being analyzed, if --profile or --trace
+thread_local PROFILER * g_profiler = 0;
+
+static void _write_trace_string(ostream & output_stream, const string & text);
+
+PROFILER::PROFILER()
+{
+	m_start = PROFILER_CLOCK::now();
+}
+
+PROFILER::PROFILER(const PROFILER & another_profiler)
+{
+	unique_lock<mutex> lock(another_profiler.m_mutex);
+
+	m_start				= another_profiler.m_start;
+	m_stages			= another_profiler.m_stages;
+	m_open_stages		= another_profiler.m_open_stages;
+	m_events			= another_profiler.m_events;
+	m_thread_numbers	= another_profiler.m_thread_numbers;
+}
+
+PROFILER & PROFILER::operator=(const PROFILER & another_profiler)
+{
+	if (this != &another_profiler)
+	{
+		unique_lock<mutex> lock(another_profiler.m_mutex);
+
+		m_start				= another_profiler.m_start;
+		m_stages			= another_profiler.m_stages;
+		m_open_stages		= another_profiler.m_open_stages;
+	m_open_stages		= another_profiler.m_open_stages;
+		m_events			= another_profiler.m_events;
+		m_thread_numbers	= another_profiler.m_thread_numbers;
+	}
+
+	return (*this);
+}
+
+PROFILER::~PROFILER()
+{
+}
+
+//
+// POST: nothing is recorded and the trace starts now
+//
+void PROFILER::clear()
+{
+	unique_lock<mutex> lock(m_mutex);
+
+	m_start = PROFILER_CLOCK::now();
+	m_stages.clear();
+	m_open_stages.clear();
+	m_events.clear();
+	m_thread_numbers.clear();
+}
+
+//
+// POST: a stage called name has been recorded inside the open stages
+// RETURNS: its index, for end_stage
+//
+int PROFILER::begin_stage
+(
+	const string & name
+)
+{
+	unique_lock<mutex> lock(m_mutex);
+
+	PROFILE_RECORD record;
+
+	record.name = name;
+	record.depth = static_cast<int>(m_open_stages.size());
+	record.parent = m_open_stages.empty() ? -1 : m_open_stages.back();
+	record.wall_seconds = 0;
+	record.cpu_seconds = 0;
+	record.rss_delta_kb = 0;
+
+	m_stages.push_back(record);
+	m_open_stages.push_back(static_cast<int>(m_stages.size()) - 1);
+
+	return m_open_stages.back();
+}
+
+//
+// PRE: stage is the innermost open stage and began at start
+// POST: the stage has its costs, on top of the cpu time of the pool 
+//       threads, and has been added to the trace
+//
+void PROFILER::end_stage
+(
+	const int & stage,
+	const PROFILER_CLOCK::time_point & start,
+	const double & wall_seconds,
+	const double & cpu_seconds,
+	const long & rss_delta_kb
+)
+{
+	string name;
+
+	{
+		unique_lock<mutex> lock(m_mutex);
+
+		assert(! m_open_stages.empty() && m_open_stages.back() == stage);
+
+		m_open_stages.pop_back();
+		m_stages[stage].wall_seconds = wall_seconds;
+		m_stages[stage].cpu_seconds += cpu_seconds;
+		m_stages[stage].rss_delta_kb = rss_delta_kb;
+		name = m_stages[stage].name;
+	}
+
+	add_event(name, true, start, start + 
+			  chrono::duration_cast<PROFILER_CLOCK::duration>(chrono::duration<double>(wall_seconds)));
+}
+
+//
+// POST: the cpu time of a pool thread has been added to the open stages
+//
+void PROFILER::add_pool_cpu
+(
+	const double & cpu_seconds
+)
+{
+	unique_lock<mutex> lock(m_mutex);
+
+	vector<int>::const_iterator stage_iter;
+
+	for (stage_iter = m_open_stages.begin(); stage_iter != m_open_stages.end(); stage_iter++)
+	{
+		m_stages[*stage_iter].cpu_seconds += cpu_seconds;
+	}
+}
+
+//
+// POST: the span from start to end has been added to the trace
+//
+void PROFILER::add_span
+(
+	const char * name,
+	const PROFILER_CLOCK::time_point & start,
+	const PROFILER_CLOCK::time_point & end
+)
+{
+	add_event(name, false, start, end);
+}
+
+void PROFILER::add_event
+(
+	const string & name,
+	bool is_stage,
+	const PROFILER_CLOCK::time_point & start,
+	const PROFILER_CLOCK::time_point & end
+)
+{
+	unique_lock<mutex> lock(m_mutex);
+
+	TRACE_EVENT event;
+	map<thread::id, int>::iterator number_iter = m_thread_numbers.find(this_thread::get_id());
+
+	if (number_iter == m_thread_numbers.end())
+	{
+		number_iter = m_thread_numbers.insert(make_pair(this_thread::get_id(), 
+													static_cast<int>(m_thread_numbers.size()))).first;
+	}
+
+	event.name = name;
+	event.is_stage = is_stage;
+	event.start_us = chrono::duration<double, micro>(start - m_start).count();
+	event.duration_us = chrono::duration<double, micro>(end - start).count();
+	event.thread_number = number_iter->second;
+
+	m_events.push_back(event);
+}
+
+//
+// Write the stages and spans as a Chrome trace
+//
+// POST: file_name holds the trace or we have failed
+//
+void PROFILER::write_trace
+(
+	const string & file_name
+) const
+{
+	unique_lock<mutex> lock(m_mutex);
+
+	ofstream trace_file(file_name.c_str());
+	vector<TRACE_EVENT>::const_iterator event_iter;
+	char times[96];
+
+	if (! trace_file.is_open())
+	{
+		Fail("Could not open the trace file '" << file_name << "'");
+	}
+
+	trace_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (event_iter = m_events.begin(); event_iter != m_events.end(); event_iter++)
+	{
+		sprintf(times, "\"ts\":%.3f,\"dur\":%.3f", event_iter->start_us, event_iter->duration_us);
+
+		trace_file << (event_iter == m_events.begin() ? "\n" : ",\n");
+		trace_file << "{\"name\":";
+		_write_trace_string(trace_file, event_iter->name);
+		trace_file << ",\"cat\":\"" << (event_iter->is_stage ? "stage" : "span") << "\"," 
+				   << "\"ph\":\"X\"," << times << ",\"pid\":1,\"tid\":" << event_iter->thread_number << "}";
+	}
+	trace_file << "\n]}\n";
+
+	Log("Wrote the trace to " << file_name);
+}
+
+PROFILE_STAGE::PROFILE_STAGE
+(
+	const char * name
+)
+{
+	m_profiler = g_profiler;
+	m_stage = -1;
+
+	if (m_profiler)
+	{
+		m_stage = m_profiler->begin_stage(name);
+		m_start = PROFILER::PROFILER_CLOCK::now();
+		m_start_cpu_seconds = util_thread_cputime();
+		m_start_rss_kb = util_resident_kb();
+	}
+}
+
+PROFILE_STAGE::~PROFILE_STAGE()
+{
+	if (m_profiler)
+	{
+		m_profiler->end_stage(m_stage, m_start, 
+							  chrono::duration<double>(PROFILER::PROFILER_CLOCK::now() - m_start).count(),
+							  util_thread_cputime() - m_start_cpu_seconds,
+							  util_resident_kb() - m_start_rss_kb);
+	}
+}
+
+PROFILE_SPAN::PROFILE_SPAN
+(
+	const char * name
+)
+{
+	m_profiler = g_profiler;
+	m_name = name;
+
+	if (m_profiler)
+	{
+		m_start = PROFILER::PROFILER_CLOCK::now();
+	}
+}
+
+PROFILE_SPAN::~PROFILE_SPAN()
+{
+	if (m_profiler)
+	{
+		m_profiler->add_span(m_name, m_start, PROFILER::PROFILER_CLOCK::now());
+	}
+}
+
+// POST: text has been written as a quoted json string
+static void _write_trace_string
+(
+	ostream & output_stream,
+	const string & text
+)
+{
+	string::const_iterator char_iter;
+
+	output_stream << '"';
+	for (char_iter = text.begin(); char_iter != text.end(); char_iter++)
+	{
+		if (*char_iter == '"' || *char_iter == '\\')
+		{
+			output_stream << '\\';
+		}
+		output_stream << *char_iter;
+	}
+	output_stream << '"';
+}
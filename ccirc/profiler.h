@@ -0,0 +1,146 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+#ifndef profiler_H
+#define profiler_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+using namespace std;
+
+// the cost of one stage of the analysis
+struct PROFILE_RECORD
+{
+	string		name;
+	int			depth;				// 0 for a stage not inside another
+	int			parent;				// the index of the stage it is inside, -1 if none
+	double		wall_seconds;
+	double		cpu_seconds;		// of the thread that ran it and of the pool threads working for it
+	long		rss_delta_kb;		// change in the resident memory
+};
+typedef vector<PROFILE_RECORD> PROFILE_RECORDS;
+
+//
+// Class_name PROFILER
+//
+// Description
+//
+//	Records what each stage of the analysis of a circuit costs for --profile
+//	and the spans inside them for --trace.
+//
+//	g_profiler is per thread, like g_options, and is 0 unless profiling.
+//	The stages and spans are timed by PROFILE_STAGE and PROFILE_SPAN 
+//	objects, which do nothing when g_profiler is 0, so they can be left 
+//	in the passes.  The threads of a THREAD_POOL take the caller's 
+//	g_profiler, so the spans of the tasks land in the trace too.
+//
+//	The stages are kept in the order they began, each with the stage it 
+//	is inside.  They are only begun by the thread that owns the profiler,
+//	so the cpu time of a stage is that thread's, plus the time the pool 
+//	threads report from the runs made while the stage was open.  Other 
+//	circuits of a batch do not count.
+//
+//	The trace is in the Chrome trace-event format: chrome://tracing or 
+//	https://ui.perfetto.dev open it.
+//
+
+class PROFILER
+{
+public:
+	typedef chrono::steady_clock PROFILER_CLOCK;
+
+	PROFILER();
+	PROFILER(const PROFILER & another_profiler);
+	PROFILER & operator=(const PROFILER & another_profiler);
+	~PROFILER();
+
+	void	clear();
+
+	int		begin_stage(const string & name);
+	void	end_stage(const int & stage, const PROFILER_CLOCK::time_point & start, const double & wall_seconds, 
+					  const double & cpu_seconds, const long & rss_delta_kb);
+	void	add_span(const char * name, const PROFILER_CLOCK::time_point & start, 
+					 const PROFILER_CLOCK::time_point & end);
+	void	add_pool_cpu(const double & cpu_seconds);
+
+	const PROFILE_RECORDS & get_stages() const { return m_stages; }
+	void	write_trace(const string & file_name) const;
+private:
+	// one complete event of the trace
+	struct TRACE_EVENT
+	{
+		string			name;
+		bool			is_stage;
+		double			start_us;		// since m_start
+		double			duration_us;
+		int				thread_number;
+	};
+
+	mutable mutex			m_mutex;			// the tasks of a pool add spans at once
+	PROFILER_CLOCK::time_point	m_start;
+	PROFILE_RECORDS			m_stages;			// in the order they began
+	vector<int>				m_open_stages;		// the stages begun but not ended, innermost last
+	vector<TRACE_EVENT>		m_events;
+	map<thread::id, int>	m_thread_numbers;	// small numbers for the threads of the trace
+
+	void	add_event(const string & name, bool is_stage, const PROFILER_CLOCK::time_point & start, 
+					  const PROFILER_CLOCK::time_point & end);
+};
+
+extern thread_local PROFILER * g_profiler;
+
+//
+// Times a stage of the analysis, from its construction to its destruction
+//
+class PROFILE_STAGE
+{
+public:
+	PROFILE_STAGE(const char * name);
+	~PROFILE_STAGE();
+private:
+	PROFILER *		m_profiler;
+	int				m_stage;			// in the profiler
+	PROFILER::PROFILER_CLOCK::time_point	m_start;
+	double			m_start_cpu_seconds;
+	long			m_start_rss_kb;
+
+	PROFILE_STAGE(const PROFILE_STAGE &);
+	PROFILE_STAGE & operator=(const PROFILE_STAGE &);
+};
+
+//
+// Times a span inside a stage for the trace, from its construction to 
+// its destruction
+//
+class PROFILE_SPAN
+{
+public:
+	PROFILE_SPAN(const char * name);
+	~PROFILE_SPAN();
+private:
+	PROFILER *		m_profiler;
+	const char *	m_name;
+	PROFILER::PROFILER_CLOCK::time_point	m_start;
+
+	PROFILE_SPAN(const PROFILE_SPAN &);
+	PROFILE_SPAN & operator=(const PROFILE_SPAN &);
+};
+
+#endif
@@ -29,6 +29,10 @@
 #ifdef VISUAL_C
 static long g_current_seed = 0L;      // for MSVC substitute
 const double M_PI = 3.14159265358979323846;
+#else
+// random() keeps writing to the last state vector it was given.
+// when we go away it gets this one so it never writes to freed memory
+static long g_detached_state[32];
 #endif
 
 RANDOM_NUMBER::RANDOM_NUMBER()
@@ -80,8 +84,9 @@ RANDOM_NUMBER::RANDOM_NUMBER(long seed)
 }
 RANDOM_NUMBER::~RANDOM_NUMBER()
 {
-
-
+#ifndef VISUAL_C
+	initstate(m_seed, (char *) g_detached_state, 128);
+#endif
 }
 
 //
@@ -164,3 +169,80 @@ double RANDOM_NUMBER::random_double_number(const NUM_ELEMENTS& max_number) const
 
 	return number;
 }
+
+
+
+RANDOM_STREAM::RANDOM_STREAM()
+{
+	m_seed		= 0;
+	m_stream	= 0;
+	m_counter	= 0;
+}
+
+RANDOM_STREAM::RANDOM_STREAM
+(
+	const unsigned long long & seed, 
+	const unsigned long long & stream
+)
+{
+	m_seed		= seed;
+	m_stream	= stream;
+	m_counter	= 0;
+}
+
+RANDOM_STREAM::RANDOM_STREAM(const RANDOM_STREAM & another_stream)
+{
+	m_seed		= another_stream.m_seed;
+	m_stream	= another_stream.m_stream;
+	m_counter	= another_stream.m_counter;
+}
+
+RANDOM_STREAM & RANDOM_STREAM::operator=(const RANDOM_STREAM & another_stream)
+{
+	m_seed		= another_stream.m_seed;
+	m_stream	= another_stream.m_stream;
+	m_counter	= another_stream.m_counter;
+
+	return (*this);
+}
+
+RANDOM_STREAM::~RANDOM_STREAM()
+{
+}
+
+//
+// RETURNS: a random number between 0 and max_number
+//
+NUM_ELEMENTS RANDOM_STREAM::random_number(const NUM_ELEMENTS& max_number)
+{
+	assert(max_number >= 0);
+
+	return static_cast<NUM_ELEMENTS>(next() % (static_cast<unsigned long long>(max_number) + 1));
+}
+
+//
+// RETURNS: a random number in [0, 1)
+//
+double RANDOM_STREAM::random_fraction()
+{
+	// the top 53 bits fill the mantissa
+	return static_cast<double>(next() >> 11) / 9007199254740992.0;
+}
+
+//
+// RETURNS: the number the counter'th draw of the stream gives
+//
+unsigned long long RANDOM_STREAM::mix
+(
+	const unsigned long long & seed, 
+	const unsigned long long & stream, 
+	const unsigned long long & counter
+)
+{
+	unsigned long long mixed = seed + 0x9E3779B97F4A7C15ULL * (stream * 0x100000001B3ULL + counter + 1);
+
+	mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+
+	return mixed ^ (mixed >> 31);
+}
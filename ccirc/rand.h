@@ -58,6 +58,37 @@ private:
 	long m_seed;
 };
 
+//
+// Class_name RANDOM_STREAM
+//
+// Description
+//		A counter based random number stream (splitmix64).  A number depends
+//		only on the seed, the stream and how many numbers the stream gave
+//		before, so parallel streams are repeatable whichever thread draws
+//		from them, and they leave the state of random() alone.
+//
+
+class RANDOM_STREAM
+{
+public:
+	RANDOM_STREAM();
+	RANDOM_STREAM(const unsigned long long & seed, const unsigned long long & stream);
+	RANDOM_STREAM(const RANDOM_STREAM & another_stream);
+	RANDOM_STREAM & operator=(const RANDOM_STREAM & another_stream);
+	~RANDOM_STREAM();
+
+	unsigned long long	next() { return mix(m_seed, m_stream, m_counter++); }
+	NUM_ELEMENTS 		random_number(const NUM_ELEMENTS& max_number);
+	double 				random_fraction();
+
+	static unsigned long long	mix(const unsigned long long & seed, const unsigned long long & stream,
+									const unsigned long long & counter);
+private:
+	unsigned long long	m_seed;
+	unsigned long long	m_stream;
+	unsigned long long	m_counter;		// how many numbers have been drawn
+};
+
 
 #ifdef VISUAL_C
 long random(void);
@@ -1,304 +1,1355 @@
-/*-------------------------------------------------------------------------*
- * Copyright 1996 by Michael Hutton, Jonathan Rose and the University of   *
- * Toronto.  Use is permitted, provided that this attribution is retained  *
- * and no part of the code is re-distributed or included in any commercial *
- * product except by written agreement with the above parties.             *
- *                                                                         *
- * For more information, contact us directly:                              *
- *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)    *
- *    Jonathan Rose  (jayar@eecg.toronto.edu)                              *
- *    Department of Electrical and Computer Engineering                    *
- *    University of Toronto, 10 King's College Rd.,                        *
- *    Toronto, Ontario, CANADA M5S 1A4                                     *
- *    Phone: (416) 978-6992  Fax: (416) 971-2286                           *
- *-------------------------------------------------------------------------*/
- /* $Revision: by GUANGLEI (Gabriel) ZHOU, July 2021 $ */
-/*
-
-(12/7/2021): Remove all the Non-sparse matrix setting (CONFIRM = 0) 
-Roadmap: Implement the rnum_of_node -> rnum_entire_graph   
-rnum_of_node: doing the quick_calculate , log2(fanin) every node that is the outcone of a node
-
-Some background about quick/full: 
-
-\item [rnum] Output the reconvergence number, R, of the circuit as a whole, and 
-		the minimum and maximum reconvergence number of any PI.  The
-		complete definition of reconvergence is beyond the scope
-		of this document, but it is a quantification of the 
-		``amount" of reconvergence in the circuit, as a real number
-		between 0 and the $\log_2($k$)$ where $k$ is the maximum
-		fanin (usually LUT-size) of any node.  If neither
-		rnum=quick or rnum=full is specified, both will be 
-		calculated.   Note that quick and full are equivalent for
-		combinational circuits, so the full calculation will
-		never be done on a circuit without DFF nodes.
-
-\item [rnum=quick] Perform the quicker (O(nLOG * nPI)), but less accurate,
-		reconvergence calculation.  
-
-\item [rnum=full] Perform the slow (O($\mbox{nLOG}^2$ * nPI)), 
-		but more accurate, reconvergence calculation.  NOTE: this 
-		can take a long time, and a lot of memory, as it requires	
-		several matrix determinant calculations on matrices
-		of size equal to the number of out-cones of an input.  
-		For this reason, the `all' option specifies rnum=quick, not rnum=full.
-
-
-For the interest of my project , we would be primarily targetting the combinational circuit
-Only quick mode will be implemented for this integration as quick and full are equivalent for combinational circuits.  
-
-The next step: 
-[] look into the ccirc to see the graph definition, and replace the graph definition in here(circ)  
-
-*/
-
-
-
-
-
-
-/* $Revision: 3.0 $ */
-
-/*
- *  Calculate the reconvergence number and related values for graph.
- *
- *  M. Hutton, November 1994.
- * 
- *  The reconvergence number is the weighted average, over all PIs x
- *  of log_2(det(K(x)))/conesize(x), where K(x) is the Kirchoff matrix
- *  of G induced by the recursive fanout of x.  The Kirchoff matrix
- *  of a graph is defined by defined by:
- *        K[i,i] = num_fanins(i)
- *        K[i,j] = -1 if (i,j) is an edge in G
- *        K[i,j] = 0 otherwise.
- *  and conesize is the size of the fanout-cone from PI x.
- *
- *  The logdet is the log_2 of the number of spanning out-trees from the
- *  relevant PI.  See the external doc'n for the theory behind this.
- *
- *  Before calulating determinant, need to take minor with respect to
- *  root node, which has fanin 0 and would make the determinant 0.
- *
- *  For connected single-source (x) graphs with no cycles, this can 
- *  be evaluated simply as product_i(log_2(num_fanins(x_i))).  For
- *  graphs with cycles, we have to actually calculate the n^3 size
- *  Kirchoff matrix.  This requires, for any reasonable size graphs, 
- *  a sparse matrix approach to the determinant (or a lot of waiting).
- *  
- *  Option "quick" causes this faster method to be used even if there
- *  are back-edges.
- *  
- *  For more details, read the external documentation. 
- *
- *  In order to test the sparse code, have CONFIRM to use both sparse
- *  and full matrix calculations.  Should normally be off.
- *
- *  The COLLAPSE feature is new -- I re-wrote the marking routines to
- *  identify nodes with a single marked fanin to that fanin, recursively.
- *  This should speed things up significantly.  Will take out the ifdefs
- *  after I have tested it further and done the formal proof.
- */
-
-
-
-
-
-#include "rnum.h"
-
-
-/*
- *  Calculate rnum. 
- *  return the reconvergence + its max/min
- */
-void
-rnum(CIRCUIT * circuit,double *m_R0,double *m_R0max,double *m_R0min)
-{
-    PORTS PI;
-    PORTS::iterator port_iter;
-    PORT * port;
-    NODE * PI_node;
-    double R0min, R0max;
-    double R0sum, R0;
-    int    R0num;
-    double n0;		/* numerators for rnum calc */
-    int    d0;		/* numerators for rnum calc */
-
-    R0sum = 0.0;
-    R0min = 9999999;
-    R0max = 0.0;
-    R0num = 0;
-	PI = circuit->get_PI();
-
-	Log("Start Calculating the rnum" );
-
-    /* Calculate rnum of each PI; update the max/min R values                */
-	// for each PI break cycles connected to it
-	for (port_iter = PI.begin(); port_iter != PI.end(); port_iter++)
-	{
-		port = *port_iter;
-        if (port->get_io_direction() != PORT::CLOCK){ /* we're ignoring clocks */
-	    /* n0 are logdets,  d0 are conesizes */
-	    /* Together they are the numerator, denominators for rnum */       
-        PI_node = port->get_edge()->get_sink()->get_my_node(); 
-		if(PI_node){
-			_rnum_of_node(circuit, PI_node, &n0, &d0);
-			if (d0 > 0) {
-				R0min = MIN(R0min, n0/d0); 
-				R0max = MAX(R0max, n0/d0);
-			}
-			R0sum += n0; 
-			R0num += d0;
-			}
-		}
-	}
-    /* Calculate the R values of the entire graph */
-    R0 = R0num > 0 ? R0sum / R0num : 0.0;
-
-    *m_R0 = R0; *m_R0min = R0min; *m_R0max = R0max; 
-
-}
-
-
-/*
- *  Calculate reconvergence from a specified root, specifying
- *  the logdet value and the conesize.
- *
- *  Array marked is owned, throughout the life of rnum(), by rnum itself.
- *  To take advantage of sparsity, we keep marked as a list of marked nodes,
- *  which we sort to do topological traversal of all nodes.  This is 
- *  a log n penalty if the conesize is actually O(graph->size), but it
- *  saves us a pile of time with cones that are really small.
- *
- *  After calculating R for node, have to re-zero marks for all marked nodes.
- */
-static void _rnum_of_node(CIRCUIT * circuit, NODE * node,double *n0, int *d0)
-{
-
-    *n0 = 0.0;
-    *d0 = 0;
-
-    _reset_marks(circuit);
-    _mark_outcone(circuit, node);
-    _quick_count(circuit, n0, d0);
-}
-
-
-
-/*
- *  Re-set all marks to 0
- */
-static void
-_reset_marks(CIRCUIT * circuit)
-{
-	assert(circuit);
-
-	NODES & nodes = circuit->get_nodes();
-	NODES::iterator node_iter;
-	NODE * node = 0;
-
-	for (node_iter = nodes.begin(); node_iter != nodes.end(); node_iter++)
-	{
-		node = *node_iter;
-		assert(node);
-		node->set_colour(NODE::UNMARKED);
-	}
-}
-
-
-/*
- *   Mark the recursive fanout of the original node.
- */
-static void _mark_outcone(CIRCUIT * circuit, NODE * node)
-{
-    int i;
-    EDGES m_edges;
-    EDGES::const_iterator edge_iter;	
-	EDGE * edge = 0;
-	NODE * sink_node = 0;
-
-    /* quit on visited already, dummy node or is PO */
-    //what is dummy node ?
-    if (node->get_colour() == NODE::MARKED_OUTCONE|| node->get_output_port()->get_type() == PORT::PO ){
-		return;			/* been here already; */
-	}
-
-    node->set_colour(NODE::MARKED_OUTCONE); 		/* mark self before recurse to avoid cycles */
-    m_edges = node->get_output_edges();
-
-    for (edge_iter = m_edges.begin(); edge_iter != m_edges.end(); edge_iter++)
-	{
-		edge = *edge_iter;
-		assert(edge);
-		sink_node = edge->get_sink_node();
-
-		if (sink_node->get_type() != NODE::SEQ)
-		{
-			_mark_outcone(circuit, sink_node);
-		}
-	}
-}
-
-
-/*
- *  For quick rnum calculation, just have to get sum of the log-det of
- *  each node, and the number of nodes.  Can do this by just counting 
- *  marked fanins of marked nodes in a single pass.
- */
-static void 
-_quick_count(CIRCUIT * circuit, double *n0, int *d0)
-{
-    int    num, num_fanins;
-    double sum;
-
-    sum = 0.0;
-    num = 0;
-	NODES & nodes = circuit->get_nodes();
-	NODES::iterator node_iter;
-	NODE * node = 0;
-
-	for (node_iter = nodes.begin(); node_iter != nodes.end(); node_iter++)
-	{
-        node = *node_iter;
-		assert(node);
-        if (node->get_type() == NODE::COMB) 
-        {
-                if (node->get_colour() == NODE::MARKED_OUTCONE)
-				{
-                num += 1;
-                num_fanins = _count_marked_fanin(node);
-                sum += num_fanins ? log2( (double) num_fanins) : 0.0;
-                }
-        }
-    }
-    *n0 = sum;
-    *d0 = num;
-}
-
-/*
- *  For quick rnum calculation, just counting marked fanins of a node in a single pass.
- *  A fanin should be only counted if it is coming from the outcone(x)     
- *  Return the marked fanin number of a node  
- */
-static int _count_marked_fanin(NODE *node)
-{
-    EDGES m_edges;
-    EDGE * edge = 0;
-    NODE * sink_node = 0;
-    EDGES::const_iterator edge_iter;	
-    int num;
-	m_edges = node->get_output_edges();
-
-    num = 0;
-	for (edge_iter = m_edges.begin(); edge_iter != m_edges.end(); edge_iter++)
-	{
-		edge = *edge_iter;
-		assert(edge);
-		sink_node = edge->get_sink_node();
-
-		if (sink_node->get_colour() == NODE::MARKED_OUTCONE)
-		{
-			++num;
-		}
-	}
-    return num;
-}
+/*-------------------------------------------------------------------------*
+ * Copyright 1996 by Michael Hutton, Jonathan Rose and the University of   *
+ * Toronto.  Use is permitted, provided that this attribution is retained  *
+ * and no part of the code is re-distributed or included in any commercial *
+ * product except by written agreement with the above parties.             *
+ *                                                                         *
+ * For more information, contact us directly:                              *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)    *
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                              *
+ *    Department of Electrical and Computer Engineering                    *
+ *    University of Toronto, 10 King's College Rd.,                        *
+ *    Toronto, Ontario, CANADA M5S 1A4                                     *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                           *
+ *-------------------------------------------------------------------------*/
+ /* $Revision: by GUANGLEI (Gabriel) ZHOU, July 2021 $ */
+/*
+
+(12/7/2021): Remove all the Non-sparse matrix setting (CONFIRM = 0) 
+Roadmap: Implement the rnum_of_node -> rnum_entire_graph   
+rnum_of_node: doing the quick_calculate , log2(fanin) every node that is the outcone of a node
+
+Some background about quick/full: 
+
+\item [rnum] Output the reconvergence number, R, of the circuit as a whole, and 
+		the minimum and maximum reconvergence number of any PI.  The
+		complete definition of reconvergence is beyond the scope
+		of this document, but it is a quantification of the 
+		``amount" of reconvergence in the circuit, as a real number
+		between 0 and the $\log_2($k$)$ where $k$ is the maximum
+		fanin (usually LUT-size) of any node.  If neither
+		rnum=quick or rnum=full is specified, both will be 
+		calculated.   Note that quick and full are equivalent for
+		combinational circuits, so the full calculation will
+		never be done on a circuit without DFF nodes.
+
+\item [rnum=quick] Perform the quicker (O(nLOG * nPI)), but less accurate,
+		reconvergence calculation.  
+
+\item [rnum=full] Perform the slow (O($\mbox{nLOG}^2$ * nPI)), 
+		but more accurate, reconvergence calculation.  NOTE: this 
+		can take a long time, and a lot of memory, as it requires	
+		several matrix determinant calculations on matrices
+		of size equal to the number of out-cones of an input.  
+		For this reason, the `all' option specifies rnum=quick, not rnum=full.
+
+
+For the interest of my project , we would be primarily targetting the combinational circuit
+Only quick mode will be implemented for this integration as quick and full are equivalent for combinational circuits.  
+
+The next step: 
+[] look into the ccirc to see the graph definition, and replace the graph definition in here(circ)  
+
+*/
+
+
+
+
+
+
+/* $Revision: 3.0 $ */
+
+/*
+ *  Calculate the reconvergence number and related values for graph.
+ *
+ *  M. Hutton, November 1994.
+ * 
+ *  The reconvergence number is the weighted average, over all PIs x
+ *  of log_2(det(K(x)))/conesize(x), where K(x) is the Kirchoff matrix
+ *  of G induced by the recursive fanout of x.  The Kirchoff matrix
+ *  of a graph is defined by defined by:
+ *        K[i,i] = num_fanins(i)
+ *        K[i,j] = -1 if (i,j) is an edge in G
+ *        K[i,j] = 0 otherwise.
+ *  and conesize is the size of the fanout-cone from PI x.
+ *
+ *  The logdet is the log_2 of the number of spanning out-trees from the
+ *  relevant PI.  See the external doc'n for the theory behind this.
+ *
+ *  Before calulating determinant, need to take minor with respect to
+ *  root node, which has fanin 0 and would make the determinant 0.
+ *
+ *  For connected single-source (x) graphs with no cycles, this can 
+ *  be evaluated simply as product_i(log_2(num_fanins(x_i))).  For
+ *  graphs with cycles, we have to actually calculate the n^3 size
+ *  Kirchoff matrix.  This requires, for any reasonable size graphs, 
+ *  a sparse matrix approach to the determinant (or a lot of waiting).
+ *  
+ *  Option "quick" causes this faster method to be used even if there
+ *  are back-edges.
+ *  
+ *  For more details, read the external documentation. 
+ *
+ *  In order to test the sparse code, have CONFIRM to use both sparse
+ *  and full matrix calculations.  Should normally be off.
+ *
+ *  The COLLAPSE feature is new -- I re-wrote the marking routines to
+ *  identify nodes with a single marked fanin to that fanin, recursively.
+ *  This should speed things up significantly.  Will take out the ifdefs
+ *  after I have tested it further and done the formal proof.
+ */
+
+
+
+
+
+#include "rnum.h"
+#include "util.h"
+#include "profiler.h"
+
+/* INTERNALS */
+static void _rnum_of_node(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX node, RNUM_MARKS * marks,
+						double *n0, int *d0);
+static void _reset_marks(RNUM_MARKS * marks);
+static void _mark_outcone(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX node, RNUM_MARKS * marks);
+static void _quick_count(const FROZEN_CIRCUIT * frozen_circuit, RNUM_MARKS * marks, double *n0, int *d0);
+static int _count_marked_fanin(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX node, const RNUM_MARKS * marks);
+static void _count_cones(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEXES & PIs_to_count, 
+						RNUM_CONTRIBUTIONS * contributions);
+static void _count_bitsets(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEXES & PIs_to_count, 
+						RNUM_CONTRIBUTIONS * contributions);
+static void _mark_outcones_of_pass(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEX * pi_indexes, int nPIs,
+						RNUM_BITSETS * bitsets);
+static void _quick_count_pass(const FROZEN_CIRCUIT * frozen_circuit, const DOUBLE_VECTOR & log2_of,
+						RNUM_BITSETS * bitsets, double *n0, int *d0);
+static void _add_to_planes(RNUM_PI_MASK * planes, int nPlanes, RNUM_PI_MASK pi_mask);
+static void _combine_contributions(const FROZEN_CIRCUIT * frozen_circuit, const RNUM_CONTRIBUTIONS & contributions,
+						double *m_R0, double *m_R0max, double *m_R0min);
+static double _seconds_since(RNUM_CLOCK::time_point start);
+static void _count_quick_cones(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEXES & PIs_to_count, 
+						RNUM_CONTRIBUTIONS * contributions);
+static void _count_full_cones(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEXES & PIs_to_count, 
+						RNUM_CONTRIBUTIONS * contributions, long * nDeterminants, long * nCapped);
+static void _estimate_cone_sizes(const FROZEN_CIRCUIT * frozen_circuit, bool is_full, const NODE_INDEXES & counted_PIs,
+						DOUBLE_VECTOR * estimates);
+static void _full_rnum_of_PI(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX pi_index, RNUM_FULL_WORK * work,
+						long cap, long max_work, double *n0, int *d0, bool *is_capped, bool *is_cyclic);
+static bool _mark_sequential_outcone(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX pi_index, long cap, 
+									 RNUM_MARKS * marks);
+static long _count_cone_fanin(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX node, const RNUM_MARKS * marks);
+static NUM_ELEMENTS _draw_index(RANDOM_STREAM * random_stream, const DOUBLE_VECTOR & cumulative_probability);
+static void _add_draw(RNUM_SAMPLE * sample, const RNUM_CONTRIBUTION & contribution, double probability);
+static void _estimate_rnum(const RNUM_SAMPLE & sample, double *m_R0, double *m_R0error);
+static bool _is_counted_PI(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX pi_index);
+
+
+/*
+ *  Order the nodes of a cone by their position in the circuit.
+ */
+class ORIGINAL_POSITION_LESS
+{
+public:
+	ORIGINAL_POSITION_LESS(const FROZEN_CIRCUIT * frozen_circuit) : m_frozen_circuit(frozen_circuit) {}
+	bool operator()(const NODE_INDEX & a, const NODE_INDEX & b) const
+	{
+		return m_frozen_circuit->get_original_position(a) < m_frozen_circuit->get_original_position(b);
+	}
+private:
+	const FROZEN_CIRCUIT * m_frozen_circuit;
+};
+
+
+/*
+ *  Calculate rnum. 
+ *  return the reconvergence + its max/min
+ *
+ *  Works on the frozen view of the circuit; the circuit must be frozen.
+ *  The contribution of each PI is kept with the frozen circuit, so any 
+ *  that are already known (carried over from the previous circuit in 
+ *  incremental mode) are not counted again.
+ */
+void
+rnum(CIRCUIT * circuit,double *m_R0,double *m_R0max,double *m_R0min)
+{
+    FROZEN_CIRCUIT * frozen_circuit;
+    RNUM_CLOCK::time_point start;
+
+    assert(circuit && circuit->is_frozen());
+    frozen_circuit = circuit->get_frozen_circuit();
+
+	Log("Start Calculating the rnum" );
+	start = RNUM_CLOCK::now();
+
+	RNUM_CONTRIBUTIONS & contributions = frozen_circuit->get_rnum_contributions();
+	rnum_contributions(frozen_circuit, &contributions);
+
+	_combine_contributions(frozen_circuit, contributions, m_R0, m_R0max, m_R0min);
+
+	Log("rnum: the quick count took " << _seconds_since(start) << " s");
+}
+
+
+/*
+ *  Calculate the full rnum: the log2 of the determinant of the Kirchhoff
+ *  matrix of each cone, as described at the top of this file.
+ *  return the reconvergence + its max/min
+ *
+ *  The cone of a PI follows the fanout through the dffs too, so unlike 
+ *  the quick count it sees the cycles of a sequential circuit.  A cone
+ *  with no cycle doesn't need a determinant: it is the product of the 
+ *  number of fanins in the cone.  A cone larger than the cap is counted 
+ *  as the quick count does, and its marking stops at the cap.
+ *
+ *  The cones are counted on g_options->get_nThreads() threads; the 
+ *  results are the same for any number of threads.
+ */
+void
+rnum_full(CIRCUIT * circuit,double *m_R0,double *m_R0max,double *m_R0min,long *m_nCapped)
+{
+    FROZEN_CIRCUIT * frozen_circuit;
+    RNUM_CLOCK::time_point start;
+    RNUM_CONTRIBUTION nothing;
+    RNUM_CONTRIBUTIONS contributions;
+    NODE_INDEXES PIs_to_count;
+    NODE_INDEX pi_index;
+    long nCapped, nDeterminants;
+
+    assert(circuit && circuit->is_frozen());
+    frozen_circuit = circuit->get_frozen_circuit();
+
+	Log("Start Calculating the full rnum" );
+	start = RNUM_CLOCK::now();
+
+    nothing.logdet = 0.0;
+    nothing.cone_size = 0;
+    nothing.is_known = true;
+	contributions.assign(frozen_circuit->get_nPI(), nothing);
+
+	for (pi_index = 0; pi_index < frozen_circuit->get_nPI(); pi_index++)
+	{
+        if (_is_counted_PI(frozen_circuit, pi_index))
+		{ 
+			PIs_to_count.push_back(pi_index);
+		}
+	}
+
+	_count_full_cones(frozen_circuit, PIs_to_count, &contributions, &nDeterminants, &nCapped);
+
+	_combine_contributions(frozen_circuit, contributions, m_R0, m_R0max, m_R0min);
+	*m_nCapped = nCapped;
+
+	Log("rnum: the full count took " << _seconds_since(start) << " s (" << nDeterminants << 
+		" determinants, " << nCapped << " cones over the cap of " << g_options->get_rnum_full_cap() <<
+		" nodes or the work budget of " << g_options->get_rnum_full_work() << " counted quick)");
+}
+
+
+/*
+ *  Count the full rnum of the PIs on g_options->get_nThreads() threads.
+ *  The cones over the cap or the work budget are then counted all at 
+ *  once by the quick engine.
+ *  POST: nDeterminants is the number of cones that needed a determinant,
+ *        nCapped the number counted quick
+ */
+static void
+_count_full_cones(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEXES & PIs_to_count, 
+				  RNUM_CONTRIBUTIONS * contributions, long * nDeterminants, long * nCapped)
+{
+    atomic<long> nCapped_cones(0), nCyclic_cones(0);
+    NODE_INDEXES capped_PIs;
+
+	THREAD_POOL thread_pool(MAX(1, MIN(g_options->get_nThreads(), static_cast<int>(PIs_to_count.size()))));
+	vector<RNUM_FULL_WORK> thread_work(thread_pool.get_nThreads());
+
+	thread_pool.run(static_cast<NUM_ELEMENTS>(PIs_to_count.size()), 
+		[&](NUM_ELEMENTS task_index, int thread_index)
+		{
+			PROFILE_SPAN span("rnum full cone");
+			RNUM_FULL_WORK & work = thread_work[thread_index];
+			RNUM_CONTRIBUTION & contribution = (*contributions)[PIs_to_count[task_index]];
+			bool is_capped = false, is_cyclic = false;
+			double n0;
+			int    d0;
+
+			if (work.marks.visits.get_size() == 0)
+			{
+				work.marks.visits.resize(frozen_circuit->get_nNodes());
+				work.minor_index.assign(frozen_circuit->get_nNodes(), 0);
+				work.nPI_fanin.assign(frozen_circuit->get_nNodes(), 0);
+			}
+
+			_full_rnum_of_PI(frozen_circuit, PIs_to_count[task_index], &work, 
+							 g_options->get_rnum_full_cap(), g_options->get_rnum_full_work(), 
+							 &n0, &d0, &is_capped, &is_cyclic);
+
+			contribution.logdet = n0;
+			contribution.cone_size = d0;
+			contribution.is_known = ! is_capped;
+			if (is_capped)
+			{
+				nCapped_cones++;
+			}
+			if (is_cyclic)
+			{
+				nCyclic_cones++;
+			}
+		});
+
+	for (NODE_INDEXES::const_iterator pi_iter = PIs_to_count.begin(); pi_iter != PIs_to_count.end(); pi_iter++)
+	{
+		if (! (*contributions)[*pi_iter].is_known)
+		{
+			capped_PIs.push_back(*pi_iter);
+		}
+	}
+	if (! capped_PIs.empty())
+	{
+		_count_quick_cones(frozen_circuit, capped_PIs, contributions);
+	}
+
+	*nDeterminants = nCyclic_cones;
+	*nCapped = nCapped_cones;
+}
+
+
+/*
+ *  Estimate rnum from a sample of the PIs.
+ *  return the reconvergence, its max/min over the sample, the half-width
+ *  of its 95% confidence interval and the number of PIs counted
+ *
+ *  The PIs are drawn with replacement, with a probability that is half 
+ *  in proportion to an estimate of the cone size and half uniform, and 
+ *  R0 = sum(n0)/sum(d0) is estimated by the ratio of the Hansen-Hurwitz
+ *  estimates of the sums.  Weighting by cone size makes n0/p nearly 
+ *  constant, so few draws are needed; the uniform half keeps a bad 
+ *  estimate from starving a PI.
+ *
+ *  g_options->get_rnum_sample() is the number of draws, or the fraction
+ *  of the PIs if it is less than 1.  The PIs are drawn a pass at a time
+ *  and the sampling stops early once the confidence interval is within 
+ *  g_options->get_rnum_tolerance().  A sample at least as large as the 
+ *  number of PIs counts them all, with no error.
+ */
+void
+rnum_sampled(CIRCUIT * circuit, bool is_full, double *m_R0, double *m_R0max, double *m_R0min, 
+			 double *m_R0error, long *m_nSampled, long *m_nCapped)
+{
+    FROZEN_CIRCUIT * frozen_circuit;
+    RNUM_CLOCK::time_point start;
+    RNUM_CONTRIBUTION nothing;
+    RNUM_CONTRIBUTIONS contributions;
+    RNUM_SAMPLE sample;
+    NODE_INDEXES counted_PIs, PIs_to_count, draws;
+    DOUBLE_VECTOR estimates, cumulative_probability;
+    vector<bool> is_drawn;
+    NODE_INDEX pi_index;
+    NUM_ELEMENTS draw;
+    long nDraws_wanted, nCapped, nDeterminants;
+    double total_estimate, R0min, R0max;
+    bool is_stopped_early;
+    unsigned long long seed;
+
+    assert(circuit && circuit->is_frozen());
+    frozen_circuit = circuit->get_frozen_circuit();
+    seed = static_cast<unsigned long long>(g_options->get_seed());
+
+	for (pi_index = 0; pi_index < frozen_circuit->get_nPI(); pi_index++)
+	{
+        if (_is_counted_PI(frozen_circuit, pi_index))
+		{ 
+			counted_PIs.push_back(pi_index);
+		}
+	}
+
+	if (g_options->get_rnum_sample() < 1)
+	{
+		nDraws_wanted = static_cast<long>(ceil(g_options->get_rnum_sample() * counted_PIs.size()));
+	}
+	else
+	{
+		nDraws_wanted = static_cast<long>(g_options->get_rnum_sample());
+	}
+
+	if (nDraws_wanted >= static_cast<long>(counted_PIs.size()))
+	{
+		Log("rnum: the sample of " << nDraws_wanted << " covers all " << counted_PIs.size() << 
+			" primary inputs; counting them all");
+		*m_nCapped = 0;
+		if (is_full)
+		{
+			rnum_full(circuit, m_R0, m_R0max, m_R0min, m_nCapped);
+		}
+		else
+		{
+			rnum(circuit, m_R0, m_R0max, m_R0min);
+		}
+		*m_R0error = 0;
+		*m_nSampled = static_cast<long>(counted_PIs.size());
+		return;
+	}
+
+	/* a stream of our own: random() is shared by every circuit in a batch */
+	if (seed == 0)
+	{
+		seed = static_cast<unsigned long long>(util_ticks());
+	}
+	RANDOM_STREAM random_stream(seed, 0);
+
+	Log("Start Sampling the " << (is_full ? "full " : "") << "rnum: " << nDraws_wanted << " of " << 
+		counted_PIs.size() << " primary inputs, seed " << seed);
+	start = RNUM_CLOCK::now();
+
+	_estimate_cone_sizes(frozen_circuit, is_full, counted_PIs, &estimates);
+
+	total_estimate = accumulate(estimates.begin(), estimates.end(), 0.0);
+	cumulative_probability.resize(counted_PIs.size());
+	for (draw = 0; draw < static_cast<NUM_ELEMENTS>(counted_PIs.size()); draw++)
+	{
+		cumulative_probability[draw] = (draw > 0 ? cumulative_probability[draw - 1] : 0.0) + 
+				0.5 * estimates[draw] / total_estimate + 0.5 / counted_PIs.size();
+	}
+
+    nothing.logdet = 0.0;
+    nothing.cone_size = 0;
+    nothing.is_known = true;
+	contributions.assign(frozen_circuit->get_nPI(), nothing);
+	is_drawn.assign(counted_PIs.size(), false);
+	is_stopped_early = false;
+	nCapped = nDeterminants = 0;
+
+	while (sample.nDraws < nDraws_wanted && ! is_stopped_early)
+	{
+		draws.clear();
+		PIs_to_count.clear();
+		while (static_cast<long>(draws.size()) < MIN(static_cast<long>(RNUM_PIS_PER_PASS), nDraws_wanted - sample.nDraws))
+		{
+			draw = _draw_index(&random_stream, cumulative_probability);
+			draws.push_back(draw);
+			if (! is_drawn[draw])
+			{
+				is_drawn[draw] = true;
+				PIs_to_count.push_back(counted_PIs[draw]);
+			}
+		}
+
+		if (is_full)
+		{
+			long nPass_capped, nPass_determinants;
+			_count_full_cones(frozen_circuit, PIs_to_count, &contributions, &nPass_determinants, &nPass_capped);
+			nCapped += nPass_capped;
+			nDeterminants += nPass_determinants;
+		}
+		else
+		{
+			_count_quick_cones(frozen_circuit, PIs_to_count, &contributions);
+		}
+
+		for (NODE_INDEXES::const_iterator draw_iter = draws.begin(); draw_iter != draws.end(); draw_iter++)
+		{
+			_add_draw(&sample, contributions[counted_PIs[*draw_iter]], 
+					  cumulative_probability[*draw_iter] - (*draw_iter > 0 ? cumulative_probability[*draw_iter - 1] : 0.0));
+		}
+
+		_estimate_rnum(sample, m_R0, m_R0error);
+		is_stopped_early = g_options->get_rnum_tolerance() > 0 && sample.nDraws >= RNUM_MIN_DRAWS_TO_STOP && 
+						   sample.nDraws < nDraws_wanted && *m_R0error <= g_options->get_rnum_tolerance();
+	}
+
+	/* the max and min are only over the PIs that were drawn */
+    R0min = 9999999;
+    R0max = 0.0;
+	*m_nSampled = 0;
+	for (draw = 0; draw < static_cast<NUM_ELEMENTS>(counted_PIs.size()); draw++)
+	{
+		const RNUM_CONTRIBUTION & contribution = contributions[counted_PIs[draw]];
+		if (is_drawn[draw])
+		{
+			(*m_nSampled)++;
+			if (contribution.cone_size > 0)
+			{
+				R0min = MIN(R0min, contribution.logdet / contribution.cone_size); 
+				R0max = MAX(R0max, contribution.logdet / contribution.cone_size);
+			}
+		}
+	}
+	*m_R0min = R0min; 
+	*m_R0max = R0max;
+	*m_nCapped = nCapped;
+
+	if (is_stopped_early)
+	{
+		Log("rnum: stopped after " << sample.nDraws << " draws, the confidence interval is within " << 
+			g_options->get_rnum_tolerance());
+	}
+	Log("rnum: the sampled " << (is_full ? "full " : "") << "count took " << _seconds_since(start) << 
+		" s for " << *m_nSampled << " primary inputs (R = " << *m_R0 << " +/- " << *m_R0error << ")");
+	if (is_full)
+	{
+		Log("rnum: " << nDeterminants << " determinants, " << nCapped << " cones over the cap of " << 
+			g_options->get_rnum_full_cap() << " nodes or the work budget of " << g_options->get_rnum_full_work() << 
+			" counted quick");
+	}
+}
+
+
+/*
+ *  Estimate the size of the cone of each PI in counted_PIs for sampling.  
+ *
+ *  The estimate of a node is itself plus the estimates of its sinks, so
+ *  reconvergent paths are counted more than once; it is only used to 
+ *  weight the draws.  The quick cone starts at the first fanout of the 
+ *  PI and only follows combinational sinks.  The full cone starts at 
+ *  all of them and goes through the dffs, but only the first level of 
+ *  the cone past the dffs is counted.
+ */
+static void
+_estimate_cone_sizes(const FROZEN_CIRCUIT * frozen_circuit, bool is_full, const NODE_INDEXES & counted_PIs,
+					 DOUBLE_VECTOR * estimates)
+{
+    DOUBLE_VECTOR node_estimates(frozen_circuit->get_nNodes(), 0.0);
+    NODE_INDEXES::const_iterator pi_iter;
+    const NODE_INDEX * sink_iter;
+    NODE_INDEX node;
+    double estimate;
+    int pass;
+
+	/* combinational sinks come after their combinational fanin, so the 
+	   combinational nodes are done first, backwards, then the others */
+	for (pass = 0; pass < 2; pass++)
+	{
+		for (node = frozen_circuit->get_nNodes() - 1; node >= 0; node--)
+		{
+			if (frozen_circuit->is_comb(node) != (pass == 0) || frozen_circuit->is_PO(node))
+			{
+				continue;
+			}
+
+			estimate = 1.0;
+			for (sink_iter = frozen_circuit->fanout_begin(node); 
+				 sink_iter != frozen_circuit->fanout_end(node); sink_iter++)
+			{
+				if (frozen_circuit->is_comb(*sink_iter) || (is_full && pass == 1))
+				{
+					estimate += node_estimates[*sink_iter];
+				}
+			}
+			node_estimates[node] = MIN(estimate, static_cast<double>(frozen_circuit->get_nNodes()));
+		}
+	}
+
+	estimates->clear();
+	for (pi_iter = counted_PIs.begin(); pi_iter != counted_PIs.end(); pi_iter++)
+	{
+		estimate = 0.0;
+		for (sink_iter = frozen_circuit->PI_fanout_begin(*pi_iter); 
+			 sink_iter != frozen_circuit->PI_fanout_end(*pi_iter); sink_iter++)
+		{
+			estimate += node_estimates[*sink_iter];
+			if (! is_full)
+			{
+				break;
+			}
+		}
+		estimates->push_back(MAX(1.0, MIN(estimate, static_cast<double>(frozen_circuit->get_nNodes()))));
+	}
+}
+
+
+/*
+ *  RETURNS: an index drawn with the probabilities given by their running sum
+ */
+static NUM_ELEMENTS
+_draw_index(RANDOM_STREAM * random_stream, const DOUBLE_VECTOR & cumulative_probability)
+{
+    double uniform;
+    NUM_ELEMENTS index;
+
+	uniform = random_stream->random_fraction();
+	index = static_cast<NUM_ELEMENTS>(upper_bound(cumulative_probability.begin(), cumulative_probability.end(), 
+										uniform * cumulative_probability.back()) - cumulative_probability.begin());
+
+	return MIN(index, static_cast<NUM_ELEMENTS>(cumulative_probability.size() - 1));
+}
+
+
+/*
+ *  Add a PI drawn with the given probability to the sums of the sample.
+ */
+static void
+_add_draw(RNUM_SAMPLE * sample, const RNUM_CONTRIBUTION & contribution, double probability)
+{
+    double n0, d0;
+
+    assert(probability > 0);
+    n0 = contribution.logdet / probability;
+    d0 = contribution.cone_size / probability;
+
+    sample->nDraws++;
+    sample->sum_n0 += n0;
+    sample->sum_d0 += d0;
+    sample->sum_n0_n0 += n0 * n0;
+    sample->sum_d0_d0 += d0 * d0;
+    sample->sum_n0_d0 += n0 * d0;
+}
+
+
+/*
+ *  Estimate R0 = sum(n0)/sum(d0) from the sample, and the half-width of 
+ *  its 95% confidence interval by the usual linearization of a ratio:
+ *  the variance of the residuals n0 - R0*d0 over nDraws * mean(d0)^2.
+ */
+static void
+_estimate_rnum(const RNUM_SAMPLE & sample, double *m_R0, double *m_R0error)
+{
+    double R0, residual_variance, mean_d0;
+
+    *m_R0 = 0.0;
+    *m_R0error = 0.0;
+    if (sample.nDraws == 0 || sample.sum_d0 <= 0)
+	{
+		return;
+	}
+
+    R0 = sample.sum_n0 / sample.sum_d0;
+    mean_d0 = sample.sum_d0 / sample.nDraws;
+    *m_R0 = R0;
+
+    if (sample.nDraws > 1)
+	{
+		residual_variance = (sample.sum_n0_n0 - 2 * R0 * sample.sum_n0_d0 + R0 * R0 * sample.sum_d0_d0) / 
+							(sample.nDraws - 1);
+		residual_variance = MAX(0.0, residual_variance);
+		*m_R0error = RNUM_CONFIDENCE_Z * sqrt(residual_variance / sample.nDraws) / mean_d0;
+	}
+}
+
+
+/*
+ *  Combine the rnum of each PI in order; find the max/min R values.
+ */
+static void
+_combine_contributions(const FROZEN_CIRCUIT * frozen_circuit, const RNUM_CONTRIBUTIONS & contributions,
+					   double *m_R0, double *m_R0max, double *m_R0min)
+{
+    NODE_INDEX pi_index;
+    double R0min, R0max;
+    double R0sum, R0;
+    int    R0num;
+    double n0;		/* numerators for rnum calc */
+    int    d0;		/* numerators for rnum calc */
+
+    R0sum = 0.0;
+    R0min = 9999999;
+    R0max = 0.0;
+    R0num = 0;
+
+	for (pi_index = 0; pi_index < frozen_circuit->get_nPI(); pi_index++)
+	{
+        if (_is_counted_PI(frozen_circuit, pi_index))
+		{ 
+	    /* n0 are logdets,  d0 are conesizes */
+	    /* Together they are the numerator, denominators for rnum */       
+			assert(contributions[pi_index].is_known);
+			n0 = contributions[pi_index].logdet;
+			d0 = contributions[pi_index].cone_size;
+
+			if (d0 > 0) {
+				R0min = MIN(R0min, n0/d0); 
+				R0max = MAX(R0max, n0/d0);
+			}
+			R0sum += n0; 
+			R0num += d0;
+		}
+	}
+    /* Calculate the R values of the entire graph */
+    R0 = R0num > 0 ? R0sum / R0num : 0.0;
+
+    *m_R0 = R0; *m_R0min = R0min; *m_R0max = R0max; 
+}
+
+
+static double
+_seconds_since(RNUM_CLOCK::time_point start)
+{
+	return chrono::duration<double>(RNUM_CLOCK::now() - start).count();
+}
+
+
+/*
+ *  Count the logdet and conesize of every PI whose contribution is not
+ *  yet known.  An empty contributions vector is sized to the PIs with 
+ *  nothing known.  PIs that are not counted (clocks and PIs without 
+ *  fanout) are known to contribute nothing.
+ *
+ *  The counting is spread over g_options->get_nThreads() threads.  Every
+ *  PI only writes its own contribution, so the results are the same for 
+ *  any number of threads, and for either engine: both sum each cone in 
+ *  the order of the circuit.
+ */
+void
+rnum_contributions(const FROZEN_CIRCUIT * frozen_circuit, RNUM_CONTRIBUTIONS * contributions)
+{
+    RNUM_CONTRIBUTION nothing;
+    NODE_INDEXES PIs_to_count;
+    NODE_INDEX pi_index;
+
+    assert(frozen_circuit && contributions);
+
+    nothing.logdet = 0.0;
+    nothing.cone_size = 0;
+    nothing.is_known = false;
+
+    if (contributions->empty())
+	{
+		contributions->assign(frozen_circuit->get_nPI(), nothing);
+	}
+    assert(static_cast<NODE_INDEX>(contributions->size()) == frozen_circuit->get_nPI());
+
+	nothing.is_known = true;
+	for (pi_index = 0; pi_index < frozen_circuit->get_nPI(); pi_index++)
+	{
+		if ((*contributions)[pi_index].is_known)
+		{
+			continue;
+		}
+
+        if (_is_counted_PI(frozen_circuit, pi_index))
+		{ 
+			PIs_to_count.push_back(pi_index);
+		}
+		else
+		{
+			(*contributions)[pi_index] = nothing;
+		}
+	}
+
+	if (PIs_to_count.empty())
+	{
+		return;
+	}
+
+	_count_quick_cones(frozen_circuit, PIs_to_count, contributions);
+}
+
+
+/*
+ *  Count the quick rnum of the PIs with the engine given in the options.
+ */
+static void
+_count_quick_cones(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEXES & PIs_to_count, 
+				   RNUM_CONTRIBUTIONS * contributions)
+{
+    RNUM_CONTRIBUTIONS cone_contributions;
+    NODE_INDEX pi_index;
+
+	switch (g_options->get_rnum_engine())
+	{
+	case OPTIONS::RNUM_CONE:
+		_count_cones(frozen_circuit, PIs_to_count, contributions);
+		break;
+	case OPTIONS::RNUM_BITSET:
+		_count_bitsets(frozen_circuit, PIs_to_count, contributions);
+		break;
+	case OPTIONS::RNUM_CHECK:
+		cone_contributions = *contributions;
+		_count_cones(frozen_circuit, PIs_to_count, &cone_contributions);
+		_count_bitsets(frozen_circuit, PIs_to_count, contributions);
+
+		for (pi_index = 0; pi_index < frozen_circuit->get_nPI(); pi_index++)
+		{
+			if ((*contributions)[pi_index].logdet != cone_contributions[pi_index].logdet ||
+				(*contributions)[pi_index].cone_size != cone_contributions[pi_index].cone_size)
+			{
+				Fail("rnum: the bitset engine counts " << (*contributions)[pi_index].logdet << "/" <<
+					 (*contributions)[pi_index].cone_size << " for primary input " << 
+					 frozen_circuit->get_PI(pi_index)->get_name() << " instead of " << 
+					 cone_contributions[pi_index].logdet << "/" << cone_contributions[pi_index].cone_size);
+			}
+		}
+		Log("rnum: the bitset engine matches the cone by cone count");
+		break;
+	default:
+		assert(false);
+	}
+}
+
+
+/*
+ *  The reference engine: mark and count the cone of each PI in turn, 
+ *  each thread with its own marks.
+ */
+static void
+_count_cones(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEXES & PIs_to_count, 
+			 RNUM_CONTRIBUTIONS * contributions)
+{
+	THREAD_POOL thread_pool(MIN(g_options->get_nThreads(), static_cast<int>(PIs_to_count.size())));
+	vector<RNUM_MARKS> thread_marks(thread_pool.get_nThreads());
+
+	thread_pool.run(static_cast<NUM_ELEMENTS>(PIs_to_count.size()), 
+		[&](NUM_ELEMENTS task_index, int thread_index)
+		{
+			PROFILE_SPAN span("rnum cone");
+			RNUM_MARKS & marks = thread_marks[thread_index];
+			RNUM_CONTRIBUTION & contribution = (*contributions)[PIs_to_count[task_index]];
+			double n0;
+			int    d0;
+
+			/* the marks are only needed once there is a cone to count */
+			if (marks.visits.get_size() == 0)
+			{
+				marks.visits.resize(frozen_circuit->get_nNodes());
+			}
+
+			_rnum_of_node(frozen_circuit, *frozen_circuit->PI_fanout_begin(PIs_to_count[task_index]), 
+						  &marks, &n0, &d0);
+
+			contribution.logdet = n0;
+			contribution.cone_size = d0;
+			contribution.is_known = true;
+		});
+}
+
+
+/*
+ *  The bitset engine: count the cones of RNUM_PIS_PER_PASS PIs at once.
+ *  Each pass is one task for the threads, each thread with its own masks.
+ */
+static void
+_count_bitsets(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEXES & PIs_to_count, 
+			   RNUM_CONTRIBUTIONS * contributions)
+{
+	NUM_ELEMENTS nPasses = (PIs_to_count.size() + RNUM_PIS_PER_PASS - 1) / RNUM_PIS_PER_PASS;
+	THREAD_POOL thread_pool(MIN(g_options->get_nThreads(), static_cast<int>(nPasses)));
+	vector<RNUM_BITSETS> thread_bitsets(thread_pool.get_nThreads());
+	DOUBLE_VECTOR log2_of;
+	NUM_ELEMENTS max_fanout = 1;
+	NUM_ELEMENTS count;
+	NODE_INDEX node;
+
+	/* the log2 of every count a node can have, the same values _quick_count takes */
+	for (node = 0; node < frozen_circuit->get_nNodes(); node++)
+	{
+		max_fanout = MAX(max_fanout, frozen_circuit->get_fanout_degree(node));
+	}
+	log2_of.assign(max_fanout + 1, 0.0);
+	for (count = 1; count <= max_fanout; count++)
+	{
+		log2_of[count] = log2( (double) count);
+	}
+
+	thread_pool.run(nPasses, 
+		[&](NUM_ELEMENTS task_index, int thread_index)
+		{
+			PROFILE_SPAN span("rnum pass");
+			RNUM_BITSETS & bitsets = thread_bitsets[thread_index];
+			NUM_ELEMENTS first = task_index * RNUM_PIS_PER_PASS;
+			int nPIs = static_cast<int>(MIN(static_cast<NUM_ELEMENTS>(RNUM_PIS_PER_PASS), 
+											 static_cast<NUM_ELEMENTS>(PIs_to_count.size()) - first));
+			double n0[RNUM_PIS_PER_PASS];
+			int    d0[RNUM_PIS_PER_PASS];
+			int    bit;
+
+			_mark_outcones_of_pass(frozen_circuit, &PIs_to_count[first], nPIs, &bitsets);
+			_quick_count_pass(frozen_circuit, log2_of, &bitsets, n0, d0);
+
+			for (bit = 0; bit < nPIs; bit++)
+			{
+				RNUM_CONTRIBUTION & contribution = (*contributions)[PIs_to_count[first + bit]];
+
+				contribution.logdet = n0[bit];
+				contribution.cone_size = d0[bit];
+				contribution.is_known = true;
+			}
+		});
+}
+
+
+/*
+ *  Mark the outcones of the PIs of one pass: bit b of the mask of a node 
+ *  is set if the node is in the cone of pi_indexes[b].  As in 
+ *  _mark_outcone, a cone starts at the first fanout of its PI, takes in 
+ *  the combinational fanout of its nodes and stops at POs.
+ *
+ *  A combinational node comes after its combinational fanin in the frozen
+ *  order, so one pass in that order pushes the masks through the cones.  
+ *  Only a start can be a dff, and a dff is not ordered after its fanin, 
+ *  so a dff start marks its fanout right away.
+ */
+static void
+_mark_outcones_of_pass(const FROZEN_CIRCUIT * frozen_circuit, const NODE_INDEX * pi_indexes, int nPIs,
+					   RNUM_BITSETS * bitsets)
+{
+    const NODE_INDEX * sink_iter;
+    NODE_INDEX node;
+    RNUM_PI_MASK pi_mask;
+    int bit;
+
+	bitsets->mask.assign(frozen_circuit->get_nNodes(), 0);
+
+	for (bit = 0; bit < nPIs; bit++)
+	{
+		node = *frozen_circuit->PI_fanout_begin(pi_indexes[bit]);
+		pi_mask = static_cast<RNUM_PI_MASK>(1) << bit;
+
+		if (frozen_circuit->is_PO(node))
+		{
+			continue;		/* an empty cone */
+		}
+
+		bitsets->mask[node] |= pi_mask;
+
+		if (! frozen_circuit->is_comb(node))
+		{
+			for (sink_iter = frozen_circuit->fanout_begin(node); 
+				 sink_iter != frozen_circuit->fanout_end(node); sink_iter++)
+			{
+				if (frozen_circuit->is_comb(*sink_iter) && ! frozen_circuit->is_PO(*sink_iter))
+				{
+					bitsets->mask[*sink_iter] |= pi_mask;
+				}
+			}
+		}
+	}
+
+	for (node = 0; node < frozen_circuit->get_nNodes(); node++)
+	{
+		pi_mask = bitsets->mask[node];
+		if (pi_mask == 0 || ! frozen_circuit->is_comb(node))
+		{
+			continue;
+		}
+
+		for (sink_iter = frozen_circuit->fanout_begin(node); 
+			 sink_iter != frozen_circuit->fanout_end(node); sink_iter++)
+		{
+			if (frozen_circuit->is_comb(*sink_iter) && ! frozen_circuit->is_PO(*sink_iter))
+			{
+				assert(*sink_iter > node);
+				bitsets->mask[*sink_iter] |= pi_mask;
+			}
+		}
+	}
+}
+
+
+/*
+ *  The quick count of every cone of the pass at once.  The marked fanout 
+ *  of a node is counted for all the PIs together in bit-sliced counters: 
+ *  bit b of plane i is bit i of the count for PI b.  Only a count of 2 or 
+ *  more adds anything to a logdet.
+ *
+ *  The nodes are taken in the order of the circuit so that each logdet is
+ *  summed in the same order as _quick_count sums it.
+ */
+static void
+_quick_count_pass(const FROZEN_CIRCUIT * frozen_circuit, const DOUBLE_VECTOR & log2_of,
+				  RNUM_BITSETS * bitsets, double *n0, int *d0)
+{
+    const NODE_INDEXES & original_order = frozen_circuit->get_original_order();
+    NODE_INDEXES::const_iterator node_iter;
+    const NODE_INDEX * sink_iter;
+    NODE_INDEX node;
+    RNUM_PI_MASK pi_mask, many_mask;
+    int nPlanes, plane, bit;
+    NUM_ELEMENTS count;
+
+	for (bit = 0; bit < RNUM_PIS_PER_PASS; bit++)
+	{
+		n0[bit] = 0.0;
+		d0[bit] = 0;
+	}
+	bitsets->cone_size_planes.assign(RNUM_COUNT_PLANES, 0);
+
+	for (node_iter = original_order.begin(); node_iter != original_order.end(); node_iter++)
+	{
+		node = *node_iter;
+		pi_mask = bitsets->mask[node];
+		if (pi_mask == 0 || ! frozen_circuit->is_comb(node))
+		{
+			continue;
+		}
+
+		_add_to_planes(&bitsets->cone_size_planes[0], RNUM_COUNT_PLANES, pi_mask);
+
+		/* enough planes to hold the fanout degree */
+		for (nPlanes = 1; (static_cast<NUM_ELEMENTS>(1) << nPlanes) <= frozen_circuit->get_fanout_degree(node); nPlanes++)
+			;
+		bitsets->count_planes.assign(nPlanes, 0);
+
+		for (sink_iter = frozen_circuit->fanout_begin(node); 
+			 sink_iter != frozen_circuit->fanout_end(node); sink_iter++)
+		{
+			_add_to_planes(&bitsets->count_planes[0], nPlanes, pi_mask & bitsets->mask[*sink_iter]);
+		}
+
+		many_mask = 0;
+		for (plane = 1; plane < nPlanes; plane++)
+		{
+			many_mask |= bitsets->count_planes[plane];
+		}
+
+		while (many_mask != 0)
+		{
+			bit = __builtin_ctzll(many_mask);
+			many_mask &= many_mask - 1;
+
+			count = 0;
+			for (plane = 0; plane < nPlanes; plane++)
+			{
+				count |= static_cast<NUM_ELEMENTS>((bitsets->count_planes[plane] >> bit) & 1) << plane;
+			}
+			n0[bit] += log2_of[count];
+		}
+	}
+
+	for (bit = 0; bit < RNUM_PIS_PER_PASS; bit++)
+	{
+		for (plane = 0; plane < RNUM_COUNT_PLANES; plane++)
+		{
+			d0[bit] |= static_cast<int>((bitsets->cone_size_planes[plane] >> bit) & 1) << plane;
+		}
+	}
+}
+
+
+/*
+ *  Add one to the bit-sliced counter of every PI in pi_mask.
+ */
+static void
+_add_to_planes(RNUM_PI_MASK * planes, int nPlanes, RNUM_PI_MASK pi_mask)
+{
+    RNUM_PI_MASK carry;
+    int plane;
+
+	for (plane = 0; pi_mask != 0 && plane < nPlanes; plane++)
+	{
+		carry = planes[plane] & pi_mask;
+		planes[plane] ^= pi_mask;
+		pi_mask = carry;
+	}
+	assert(pi_mask == 0);
+}
+
+
+/*
+ *  Only PIs with fanout count; we're ignoring clocks.
+ *  A PI's cone starts at its first fanout.
+ */
+static bool
+_is_counted_PI(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX pi_index)
+{
+	return (! frozen_circuit->is_clock_PI(pi_index) &&
+			frozen_circuit->get_PI_fanout_degree(pi_index) > 0);
+}
+
+
+/*
+ *  Calculate reconvergence from a specified root, specifying
+ *  the logdet value and the conesize.
+ *
+ *  The marks are owned, throughout the life of rnum(), by rnum itself.
+ *  To take advantage of sparsity, we keep the cone as a list of marked 
+ *  nodes, which we sort to count the nodes in the order of the circuit.
+ *  This is a log n penalty if the conesize is actually O(graph->size), 
+ *  but it saves us a pile of time with cones that are really small.
+ */
+static void _rnum_of_node(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX node, RNUM_MARKS * marks,
+						double *n0, int *d0)
+{
+
+    *n0 = 0.0;
+    *d0 = 0;
+
+    _reset_marks(marks);
+    _mark_outcone(frozen_circuit, node, marks);
+    _quick_count(frozen_circuit, marks, n0, d0);
+}
+
+
+
+/*
+ *  Start a new cone.
+ */
+static void
+_reset_marks(RNUM_MARKS * marks)
+{
+	assert(marks);
+
+	marks->cone.clear();
+	marks->visits.restart();
+}
+
+
+/*
+ *   Mark the recursive fanout of the original node.
+ *   The nodes are visited with an explicit stack so deep cones can't 
+ *   overflow the call stack.
+ */
+static void _mark_outcone(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX node, RNUM_MARKS * marks)
+{
+    const NODE_INDEX * sink_iter;
+
+    marks->stack.clear();
+    marks->stack.push_back(node);
+
+    while (! marks->stack.empty())
+	{
+		node = marks->stack.back();
+		marks->stack.pop_back();
+
+		/* quit on visited already or is PO */
+		if (marks->visits.is_visited(node) || frozen_circuit->is_PO(node)) {
+			continue;			/* been here already; */
+		}
+
+		marks->visits.visit(node);		/* mark self before the fanout to avoid cycles */
+		marks->cone.push_back(node);
+
+		for (sink_iter = frozen_circuit->fanout_begin(node); 
+			 sink_iter != frozen_circuit->fanout_end(node); sink_iter++)
+		{
+			if (frozen_circuit->is_comb(*sink_iter) && ! marks->visits.is_visited(*sink_iter))
+			{
+				marks->stack.push_back(*sink_iter);
+			}
+		}
+	}
+}
+
+
+/*
+ *  For quick rnum calculation, just have to get sum of the log-det of
+ *  each node, and the number of nodes.  Can do this by just counting 
+ *  marked fanins of marked nodes in a single pass over the cone, in the
+ *  order of the circuit so the sum is the same however the cone was found.
+ */
+static void 
+_quick_count(const FROZEN_CIRCUIT * frozen_circuit, RNUM_MARKS * marks, double *n0, int *d0)
+{
+    int    num, num_fanins;
+    double sum;
+    NODE_INDEXES::const_iterator node_iter;
+    NODE_INDEX node;
+
+    sum = 0.0;
+    num = 0;
+
+    sort(marks->cone.begin(), marks->cone.end(), ORIGINAL_POSITION_LESS(frozen_circuit));
+
+	for (node_iter = marks->cone.begin(); node_iter != marks->cone.end(); node_iter++)
+	{
+        node = *node_iter;
+        if (frozen_circuit->is_comb(node)) 
+        {
+                num += 1;
+                num_fanins = _count_marked_fanin(frozen_circuit, node, marks);
+                sum += num_fanins ? log2( (double) num_fanins) : 0.0;
+        }
+    }
+    *n0 = sum;
+    *d0 = num;
+}
+
+/*
+ *  For quick rnum calculation, just counting marked fanins of a node in a single pass.
+ *  A fanin should be only counted if it is coming from the outcone(x)     
+ *  Return the marked fanin number of a node  
+ */
+static int _count_marked_fanin(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX node, const RNUM_MARKS * marks)
+{
+    const NODE_INDEX * sink_iter;
+    int num;
+
+    num = 0;
+	for (sink_iter = frozen_circuit->fanout_begin(node); 
+		 sink_iter != frozen_circuit->fanout_end(node); sink_iter++)
+	{
+		if (marks->visits.is_visited(*sink_iter))
+		{
+			++num;
+		}
+	}
+    return num;
+}
+
+
+/*
+ *  Calculate the full reconvergence of a PI: the logdet is log2 of the 
+ *  determinant of the Kirchhoff matrix of its cone, less the row and 
+ *  column of the PI, and the conesize is the number of nodes in the cone.
+ *
+ *  K[v,v] is the number of fanins of v from the cone or the PI and K[u,v] 
+ *  is minus the number of edges from u to v.  Self-loops cancel out.
+ *
+ *  Cones over the cap, or whose determinant takes more than max_work, are
+ *  flagged is_capped and not counted; the caller counts them quick.  The
+ *  marking stops at the cap, so a capped cone costs no more than cap nodes.
+ */
+static void _full_rnum_of_PI(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX pi_index, RNUM_FULL_WORK * work,
+						long cap, long max_work, double *n0, int *d0, bool *is_capped, bool *is_cyclic)
+{
+    RNUM_MARKS * marks = &work->marks;
+    NODE_INDEXES::const_iterator node_iter;
+    const NODE_INDEX * node_ptr;
+    NODE_INDEX cone_node, source;
+    INDEX_SIZE minor_size;
+    long nFanin;
+
+    *n0 = 0.0;
+    *d0 = 0;
+    *is_capped = false;
+    *is_cyclic = false;
+
+    _reset_marks(marks);
+    if (! _mark_sequential_outcone(frozen_circuit, pi_index, cap, marks))
+	{
+		*is_capped = true;
+		return;
+	}
+
+    *d0 = static_cast<int>(marks->cone.size());
+    if (marks->cone.empty())
+	{
+		return;
+	}
+
+	for (node_ptr = frozen_circuit->PI_fanout_begin(pi_index); 
+		 node_ptr != frozen_circuit->PI_fanout_end(pi_index); node_ptr++)
+	{
+		work->nPI_fanin[*node_ptr]++;
+	}
+
+    sort(marks->cone.begin(), marks->cone.end(), ORIGINAL_POSITION_LESS(frozen_circuit));
+
+	/* the combinational graph is acyclic: a cycle has to go through a dff */
+	for (node_iter = marks->cone.begin(); node_iter != marks->cone.end(); node_iter++)
+	{
+		if (! frozen_circuit->is_comb(*node_iter))
+		{
+			*is_cyclic = true;
+		}
+	}
+
+	if (*is_cyclic)
+	{
+		/* number the rows of the minor in the order of the circuit */
+		minor_size = 0;
+		for (node_iter = marks->cone.begin(); node_iter != marks->cone.end(); node_iter++)
+		{
+			work->minor_index[*node_iter] = minor_size++;
+		}
+
+		work->kirchhoff.resize(minor_size);
+		for (node_iter = marks->cone.begin(); node_iter != marks->cone.end(); node_iter++)
+		{
+			cone_node = *node_iter;
+			if (work->nPI_fanin[cone_node] > 0)
+			{
+				work->kirchhoff.add(work->minor_index[cone_node], work->minor_index[cone_node], 
+									work->nPI_fanin[cone_node]);
+			}
+
+			for (node_ptr = frozen_circuit->fanin_begin(cone_node); 
+				 node_ptr != frozen_circuit->fanin_end(cone_node); node_ptr++)
+			{
+				source = *node_ptr;
+				if (source == NO_NODE_INDEX || source == cone_node || ! marks->visits.is_visited(source))
+				{
+					continue;
+				}
+
+				work->kirchhoff.add(work->minor_index[cone_node], work->minor_index[cone_node], 1.0);
+				work->kirchhoff.add(work->minor_index[source], work->minor_index[cone_node], -1.0);
+			}
+		}
+
+		/* the fill can make the determinant cubic in the cone size */
+		if (! work->kirchhoff.get_log2_determinant(*n0, max_work))
+		{
+			*is_capped = true;
+			*is_cyclic = false;
+		}
+	}
+
+	if (! *is_cyclic && ! *is_capped)
+	{
+		/* K is triangular in topological order once the cycles are ignored */
+		*n0 = 0.0;
+		for (node_iter = marks->cone.begin(); node_iter != marks->cone.end(); node_iter++)
+		{
+			nFanin = _count_cone_fanin(frozen_circuit, *node_iter, marks) + work->nPI_fanin[*node_iter];
+			*n0 += nFanin > 0 ? log2( (double) nFanin) : 0.0;
+		}
+	}
+
+	for (node_ptr = frozen_circuit->PI_fanout_begin(pi_index); 
+		 node_ptr != frozen_circuit->PI_fanout_end(pi_index); node_ptr++)
+	{
+		work->nPI_fanin[*node_ptr] = 0;
+	}
+}
+
+
+/*
+ *   Mark the recursive fanout of a PI through the dffs.
+ *   Like _mark_outcone, POs stop the cone.
+ *   Return false, with the cone cut short, once it has more than cap nodes
+ */
+static bool _mark_sequential_outcone(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX pi_index, long cap, 
+									 RNUM_MARKS * marks)
+{
+    const NODE_INDEX * sink_iter;
+    NODE_INDEX node;
+
+    marks->stack.assign(frozen_circuit->PI_fanout_begin(pi_index), frozen_circuit->PI_fanout_end(pi_index));
+
+    while (! marks->stack.empty())
+	{
+		node = marks->stack.back();
+		marks->stack.pop_back();
+
+		if (marks->visits.is_visited(node) || frozen_circuit->is_PO(node)) {
+			continue;
+		}
+
+		marks->visits.visit(node);
+		marks->cone.push_back(node);
+		if (static_cast<long>(marks->cone.size()) > cap)
+		{
+			return false;
+		}
+
+		for (sink_iter = frozen_circuit->fanout_begin(node); 
+			 sink_iter != frozen_circuit->fanout_end(node); sink_iter++)
+		{
+			if (! marks->visits.is_visited(*sink_iter))
+			{
+				marks->stack.push_back(*sink_iter);
+			}
+		}
+	}
+	return true;
+}
+
+
+/*
+ *  Return the number of fanins of a node that come from the cone, not 
+ *  counting the node itself.
+ */
+static long _count_cone_fanin(const FROZEN_CIRCUIT * frozen_circuit, NODE_INDEX node, const RNUM_MARKS * marks)
+{
+    const NODE_INDEX * source_iter;
+    long num;
+
+    num = 0;
+	for (source_iter = frozen_circuit->fanin_begin(node); 
+		 source_iter != frozen_circuit->fanin_end(node); source_iter++)
+	{
+		if (*source_iter != NO_NODE_INDEX && *source_iter != node && 
+			marks->visits.is_visited(*source_iter))
+		{
+			++num;
+		}
+	}
+    return num;
+}
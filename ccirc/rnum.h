@@ -1,40 +1,107 @@
-/*--------------------------------------------------------------------------*
- * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
- * and the University of Toronto. 											*
- * Use is permitted, provided that this attribution is retained  			*
- * and no part of the code is re-distributed or included in any commercial	*
- * product except by written agreement with the above parties.              *
- *                                                                          *
- * For more information, contact us directly:                               *
- *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
- *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
- *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
- *    Department of Electrical and Computer Engineering                     *
- *    University of Toronto, 10 King's College Rd.,                         *
- *    Toronto, Ontario, CANADA M5S 1A4                                      *
- *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
- *--------------------------------------------------------------------------*/
-
-
-
-#ifndef RNUM_H
-#define RNUM_H
-
-using namespace std;
-#include "circ.h"
-#include "circuit.h"
-#include <math.h>
-#include "edges_and_nodes.h"
-
-/* EXPORTS */
-void rnum(CIRCUIT * circuit,double *m_R0,double *m_R0max,double *m_R0min); // iterate through each PI and returned the weighted rnum value (quick count method )
-
-/* INTERNALS */
-static void _rnum_of_node(CIRCUIT * circuit, NODE * node,double *n0, int *d0);
-static void _reset_marks(CIRCUIT * circuit);
-static void _mark_outcone(CIRCUIT * circuit, NODE * node);
-static void _quick_count(CIRCUIT * circuit, double *n0, int *d0);
-static int _count_marked_fanin(NODE *node);
-
-
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef RNUM_H
+#define RNUM_H
+
+using namespace std;
+#include "circ.h"
+#include "circuit.h"
+#include "frozen_circuit.h"
+#include "thread_pool.h"
+#include "sparse_matrix.h"
+#include "rand.h"
+#include <chrono>
+#include <atomic>
+#include <math.h>
+#include <algorithm>
+#include <numeric>
+#include "edges_and_nodes.h"
+#include "traversal.h"
+
+/* EXPORTS */
+void rnum(CIRCUIT * circuit,double *m_R0,double *m_R0max,double *m_R0min); // iterate through each PI and returned the weighted rnum value (quick count method )
+void rnum_full(CIRCUIT * circuit,double *m_R0,double *m_R0max,double *m_R0min,long *m_nCapped); // the same, from the Kirchhoff matrix of each sequential cone, and how many were counted quick
+void rnum_sampled(CIRCUIT * circuit, bool is_full, double *m_R0, double *m_R0max, double *m_R0min, 
+				  double *m_R0error, long *m_nSampled, long *m_nCapped); // estimate either from a sample of the PIs
+void rnum_contributions(const FROZEN_CIRCUIT * frozen_circuit, RNUM_CONTRIBUTIONS * contributions); // count each PI that is not yet known
+
+/* INTERNALS */
+
+/*
+ *  The marks of the outcone being counted.  The visits are epoch stamped,
+ *  so starting a new cone does not clear a mark on every node of the 
+ *  circuit.
+ */
+struct RNUM_MARKS
+{
+	INDEX_VISITS		visits;		/* indexed by frozen node index */
+	NODE_INDEXES		cone;		/* the marked nodes */
+	NODE_INDEXES		stack;
+};
+
+/*
+ *  The masks of the bitset engine.  Bit b of a mask stands for PI b of 
+ *  the pass.
+ */
+typedef unsigned long long RNUM_PI_MASK;
+const int RNUM_PIS_PER_PASS = 64;
+const int RNUM_COUNT_PLANES = 31;		/* enough for any cone size */
+
+struct RNUM_BITSETS
+{
+	vector<RNUM_PI_MASK>	mask;				/* indexed by frozen node index */
+	vector<RNUM_PI_MASK>	count_planes;		/* the marked fanout of one node */
+	vector<RNUM_PI_MASK>	cone_size_planes;
+};
+
+/*
+ *  What each thread needs for the full count.
+ */
+struct RNUM_FULL_WORK
+{
+	RNUM_MARKS			marks;
+	vector<INDEX_SIZE>	minor_index;	/* the row of each cone node in the matrix */
+	vector<int>			nPI_fanin;		/* the edges from the PI to each node */
+	SPARSE_MATRIX		kirchhoff;
+};
+
+typedef chrono::steady_clock RNUM_CLOCK;
+
+/*
+ *  The running sums of a sample of PIs, each n0 and d0 divided by the
+ *  probability of drawing the PI.
+ */
+struct RNUM_SAMPLE
+{
+	RNUM_SAMPLE() : nDraws(0), sum_n0(0), sum_d0(0), sum_n0_n0(0), sum_d0_d0(0), sum_n0_d0(0) {}
+
+	long	nDraws;
+	double	sum_n0;
+	double	sum_d0;
+	double	sum_n0_n0;
+	double	sum_d0_d0;
+	double	sum_n0_d0;
+};
+
+const double RNUM_CONFIDENCE_Z = 1.96;		/* 95% */
+const long RNUM_MIN_DRAWS_TO_STOP = 30;		/* before the interval is trusted */
+
+
 #endif
\ No newline at end of file
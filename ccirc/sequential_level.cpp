@@ -20,6 +20,7 @@
 
 
 #include "sequential_level.h"
+#include "frozen_circuit.h"
 #include <algorithm>
 #include <numeric>
 
@@ -31,6 +32,8 @@ SEQUENTIAL_LEVEL::SEQUENTIAL_LEVEL()
 	m_max_delay					= -1;
 	m_number_of_nodes			= 0;
 	m_is_clustered				= false;
+	m_clock_port				= 0;
+	m_frozen_circuit			= 0;
 }
 
 SEQUENTIAL_LEVEL::SEQUENTIAL_LEVEL(const LEVEL_TYPE & seq_level_number)
@@ -39,6 +42,8 @@ SEQUENTIAL_LEVEL::SEQUENTIAL_LEVEL(const LEVEL_TYPE & seq_level_number)
 	m_max_delay					= -1;
 	m_number_of_nodes			= 0;
 	m_is_clustered          	= false;
+	m_clock_port				= 0;
+	m_frozen_circuit			= 0;
 }
 
 SEQUENTIAL_LEVEL::SEQUENTIAL_LEVEL(const SEQUENTIAL_LEVEL & another_sequential_level)
@@ -50,6 +55,8 @@ SEQUENTIAL_LEVEL::SEQUENTIAL_LEVEL(const SEQUENTIAL_LEVEL & another_sequential_l
 	m_sequential_level_number	= another_sequential_level.m_sequential_level_number;
 	m_number_of_nodes			= another_sequential_level.m_number_of_nodes;
 	m_is_clustered				= another_sequential_level.m_is_clustered;
+	m_clock_port				= another_sequential_level.m_clock_port;
+	m_frozen_circuit			= another_sequential_level.m_frozen_circuit;
 
     m_internal_edges			= another_sequential_level.m_internal_edges;			                       
     m_output_to_dff_edges		= another_sequential_level.m_output_to_dff_edges;
@@ -69,6 +76,8 @@ SEQUENTIAL_LEVEL & SEQUENTIAL_LEVEL::operator=(const SEQUENTIAL_LEVEL & another_
 	m_sequential_level_number	= another_sequential_level.m_sequential_level_number;
 	m_number_of_nodes			= another_sequential_level.m_number_of_nodes;
 	m_is_clustered				= another_sequential_level.m_is_clustered;
+	m_clock_port				= another_sequential_level.m_clock_port;
+	m_frozen_circuit			= another_sequential_level.m_frozen_circuit;
 
     m_internal_edges			= another_sequential_level.m_internal_edges;			                       
     m_output_to_dff_edges		= another_sequential_level.m_output_to_dff_edges;
@@ -138,6 +147,60 @@ void  SEQUENTIAL_LEVEL::add_primary_input
 
 }
 
+// adds all the nodes and primary inputs of a frozen circuit 
+//
+// PRE: the frozen circuit has its delay levels
+//      the maximum combinational delay has been set
+//      nothing has been added to the sequential level
+//      delay_levels holds the nodes of each delay level in the order of the 
+//      circuit, as DELAY_LEVELER places them
+// POST: the nodes are in their delay levels and delay_levels is empty,
+//       the PI and PO have been recorded and the shapes will come from 
+//       the frozen circuit
+//
+void SEQUENTIAL_LEVEL::add_frozen_circuit
+(
+	const FROZEN_CIRCUIT * frozen_circuit,
+	DELAY_LEVELS & delay_levels
+)
+{
+	assert(frozen_circuit && ! m_frozen_circuit && ! m_is_clustered);
+	assert(m_number_of_nodes == 0 && m_PI.empty());
+	assert(frozen_circuit->get_max_level() == m_max_delay);
+	assert(delay_levels.size() == m_delay_levels.size());
+
+	const NODE_INDEXES & original_order = frozen_circuit->get_original_order();
+	NODE_INDEXES::const_iterator node_iter;
+	NODE_INDEX pi_index = 0;
+
+	m_frozen_circuit = frozen_circuit;
+
+	for (pi_index = 0; pi_index < frozen_circuit->get_nPI(); pi_index++)
+	{
+		if (frozen_circuit->is_clock_PI(pi_index))
+		{
+			assert(m_clock_port == 0);
+			m_clock_port = frozen_circuit->get_PI(pi_index);
+		}
+		else
+		{
+			m_PI.push_back(frozen_circuit->get_PI(pi_index));
+		}
+	}
+
+	m_delay_levels.swap(delay_levels);
+	delay_levels.clear();
+	m_number_of_nodes = frozen_circuit->get_nNodes();
+
+	for (node_iter = original_order.begin(); node_iter != original_order.end(); node_iter++)
+	{
+		if (frozen_circuit->is_PO(*node_iter))
+		{
+			m_PO.push_back(frozen_circuit->get_node(*node_iter)->get_output_port());
+		}
+	}
+}
+
 // adds all the edges of the node 
 //
 // PRE: the node is valid
@@ -421,6 +484,10 @@ SHAPE SEQUENTIAL_LEVEL::get_node_shape() const
 //
 SHAPE SEQUENTIAL_LEVEL::get_input_shape() const
 {
+	if (m_frozen_circuit)
+	{
+		return get_frozen_input_shape();
+	}
 
 	SHAPE input_shape;
 
@@ -491,6 +558,10 @@ NUM_ELEMENTS SEQUENTIAL_LEVEL::get_number_of_non_clock_inputs
 //
 SHAPE SEQUENTIAL_LEVEL::get_output_shape() const
 {
+	if (m_frozen_circuit)
+	{
+		return get_frozen_output_shape();
+	}
 
 
 	DELAY_TYPE delay_level_index = 0;
@@ -588,6 +659,10 @@ SHAPE SEQUENTIAL_LEVEL::get_PO_shape() const
 	{
 		return shape;
 	}
+	if (m_frozen_circuit)
+	{
+		return get_frozen_statistics().get_PO_shape();
+	}
 	shape.resize(m_delay_levels.size(), 0);
 
 	PORTS::const_iterator port_iter;
@@ -627,6 +702,11 @@ SHAPE SEQUENTIAL_LEVEL::get_latched_shape() const
 	}
 	latched_shape.resize(m_delay_levels.size(), 0);
 
+	if (m_frozen_circuit)
+	{
+		return get_frozen_latched_shape();
+	}
+
 	if 	(m_output_to_dff_edges.size() == 0 && m_inter_cluster_output_to_dff_edges.size() == 0)
 	{
 		return latched_shape;
@@ -694,6 +774,10 @@ void SEQUENTIAL_LEVEL::add_latched_nodes_to_shape
 DISTRIBUTION SEQUENTIAL_LEVEL::get_intra_cluster_edge_length_distribution() const
 {
 	//debug("intra cluster edge length");
+	if (m_frozen_circuit)
+	{
+		return get_frozen_edge_length_distribution();
+	}
 	return find_edge_length_distribution(m_internal_edges);
 }
 
@@ -749,29 +833,17 @@ DISTRIBUTION SEQUENTIAL_LEVEL::find_edge_length_distribution
 //          that input into the delay level specified
 //
 DISTRIBUTION SEQUENTIAL_LEVEL::get_intra_cluster_input_edge_length_distribution(const DELAY_TYPE& delay_level)
-{
-	// inefficient but hey it works.
-	EDGES input_edges_to_a_delay_level;
-	// because we are not using 0 length edges we can leave it empty
-	EDGES dff_edges; assert(Dlook_at);	
-	EDGES::iterator edge_iter;
-	EDGE * edge = 0;
-	NODE * sink_node = 0;
+{ 
+	DISTRIBUTIONS input_distributions;
+	DISTRIBUTIONS output_distributions;
 
-	for (edge_iter = m_internal_edges.begin(); edge_iter != m_internal_edges.end(); edge_iter++)
-	{
-		edge = *edge_iter;
-		assert(edge);
-		sink_node = edge->get_sink_node();
-		assert(sink_node);
+	find_edge_length_distributions_by_delay_level(m_internal_edges, input_distributions, output_distributions);
 
-		if (sink_node->get_max_comb_delay_level() == delay_level)
-		{
-			input_edges_to_a_delay_level.push_back(edge);
-		}
+	if (static_cast<unsigned>(delay_level) >= input_distributions.size())
+	{
+		return DISTRIBUTION(m_delay_levels.size(), 0);
 	}
-
-	return find_edge_length_distribution(input_edges_to_a_delay_level);
+	return input_distributions[delay_level];
 }
 
 //
@@ -780,41 +852,16 @@ DISTRIBUTION SEQUENTIAL_LEVEL::get_intra_cluster_input_edge_length_distribution(
 //
 DISTRIBUTION SEQUENTIAL_LEVEL::get_intra_cluster_output_edge_length_distribution(const DELAY_TYPE& delay_level)
 { 
-	// inefficient but hey it works.
-	EDGES output_edges_to_a_delay_level;
-	// because we are not using 0 length edges we can leave it empty
-	EDGES dff_edges; assert(Dlook_at);	
-	EDGES::iterator edge_iter;
-	EDGE * edge = 0;
-	NODE * source_node = 0;
-
-	for (edge_iter = m_internal_edges.begin(); edge_iter != m_internal_edges.end(); edge_iter++)
-	{
-		edge = *edge_iter;
-		assert(edge);
-		source_node = edge->get_source_node();
+	DISTRIBUTIONS input_distributions;
+	DISTRIBUTIONS output_distributions;
 
-		if (source_node)
-		{
-			if (source_node->get_max_comb_delay_level() == delay_level)
-			{
-				output_edges_to_a_delay_level.push_back(edge);
-			}
-		}
-		else
-		{
-			// we have a primary input if we are looking for delay level 0 nodes 
-			// add the edge the output edges
-
-			if (delay_level == 0)
-			{
-				output_edges_to_a_delay_level.push_back(edge);
-			}
-		}
+	find_edge_length_distributions_by_delay_level(m_internal_edges, input_distributions, output_distributions);
 
+	if (static_cast<unsigned>(delay_level) >= output_distributions.size())
+	{
+		return DISTRIBUTION(m_delay_levels.size(), 0);
 	}
-
-	return find_edge_length_distribution(output_edges_to_a_delay_level);
+	return output_distributions[delay_level];
 }
 //
 // RETURNS: the number of edges at each edge length that are inter-cluster edges
@@ -822,73 +869,114 @@ DISTRIBUTION SEQUENTIAL_LEVEL::get_intra_cluster_output_edge_length_distribution
 //
 DISTRIBUTION SEQUENTIAL_LEVEL::get_inter_cluster_input_edge_length_distribution(const DELAY_TYPE& delay_level)
 { 
-	// inefficient but hey it works.
-	EDGES input_edges_to_a_delay_level;
-	// because we are not using 0 length edges we can leave it empty
-	EDGES dff_edges; assert(Dlook_at);	
-	EDGES::iterator edge_iter;
-	EDGE * edge = 0;
-	NODE * sink_node = 0;
+	DISTRIBUTIONS input_distributions;
+	DISTRIBUTIONS output_distributions;
 
-	for (edge_iter = m_inter_cluster_input_edges.begin(); edge_iter != m_inter_cluster_input_edges.end();
-			edge_iter++)
-	{
-		edge = *edge_iter;
-		assert(edge);
-		sink_node = edge->get_sink_node();
-		assert(sink_node);
+	find_edge_length_distributions_by_delay_level(m_inter_cluster_input_edges, 
+												input_distributions, output_distributions);
 
-		if (sink_node->get_max_comb_delay_level() == delay_level)
-		{
-			input_edges_to_a_delay_level.push_back(edge);
-		}
+	if (static_cast<unsigned>(delay_level) >= input_distributions.size())
+	{
+		return DISTRIBUTION(m_delay_levels.size(), 0);
 	}
-
-	return find_edge_length_distribution(input_edges_to_a_delay_level);
+	return input_distributions[delay_level];
 }
 //
 // RETURNS: the number of edges at each edge length that are inter-cluster edges
 //          that ouput out of the delay level specified
 //
 DISTRIBUTION SEQUENTIAL_LEVEL::get_inter_cluster_output_edge_length_distribution(const DELAY_TYPE& delay_level)
+{ 
+	DISTRIBUTIONS input_distributions;
+	DISTRIBUTIONS output_distributions;
+
+	find_edge_length_distributions_by_delay_level(m_inter_cluster_output_edges, 
+												input_distributions, output_distributions);
 
+	if (static_cast<unsigned>(delay_level) >= output_distributions.size())
+	{
+		return DISTRIBUTION(m_delay_levels.size(), 0);
+	}
+	return output_distributions[delay_level];
+}
+
+//
+// The edge length distributions of every delay level at once, for reporting 
+// them all without going over the edges once per delay level
+//
+// PRE: the delay levels have been created
+// POST: the distributions of each delay level are in the same order as the 
+//       getters for one delay level
+//
+void SEQUENTIAL_LEVEL::get_edge_length_distributions_by_delay_level
+(
+	DISTRIBUTIONS & intra_cluster_input_distributions,
+	DISTRIBUTIONS & intra_cluster_output_distributions,
+	DISTRIBUTIONS & inter_cluster_input_distributions,
+	DISTRIBUTIONS & inter_cluster_output_distributions
+) const
 {
-	// inefficient but hey it works.
-	EDGES output_edges_to_a_delay_level;
-	// because we are not using 0 length edges we can leave it empty
-	EDGES dff_edges; assert(Dlook_at);	
-	EDGES::iterator edge_iter;
+	DISTRIBUTIONS unused_distributions;
+
+	find_edge_length_distributions_by_delay_level(m_internal_edges, 
+				intra_cluster_input_distributions, intra_cluster_output_distributions);
+	find_edge_length_distributions_by_delay_level(m_inter_cluster_input_edges, 
+				inter_cluster_input_distributions, unused_distributions);
+	find_edge_length_distributions_by_delay_level(m_inter_cluster_output_edges, 
+				unused_distributions, inter_cluster_output_distributions);
+}
+
+//
+// Counts each edge by length in the distribution of the delay level of its 
+// sink and in that of its source.  A primary input is at delay level 0.
+//
+// PRE: the delay levels have been created
+// POST: input_distributions and output_distributions have one edge length 
+//       distribution for each delay level
+//
+void SEQUENTIAL_LEVEL::find_edge_length_distributions_by_delay_level
+(
+	const EDGES & edges,
+	DISTRIBUTIONS & input_distributions,
+	DISTRIBUTIONS & output_distributions
+) const
+{
+	assert(! m_frozen_circuit);
+
+	EDGES::const_iterator edge_iter;
 	EDGE * edge = 0;
+	NODE * sink_node = 0;
 	NODE * source_node = 0;
+	DELAY_TYPE edge_length = 0;
+	DELAY_TYPE sink_level = 0;
+	DELAY_TYPE source_level = 0;
+
+	input_distributions.assign(m_delay_levels.size(), DISTRIBUTION(m_delay_levels.size(), 0));
+	output_distributions.assign(m_delay_levels.size(), DISTRIBUTION(m_delay_levels.size(), 0));
 
-	for (edge_iter = m_inter_cluster_output_edges.begin(); edge_iter != m_inter_cluster_output_edges.end();
-			edge_iter++)
+	for (edge_iter = edges.begin(); edge_iter != edges.end(); edge_iter++)
 	{
 		edge = *edge_iter;
 		assert(edge);
+		sink_node = edge->get_sink_node();
+		assert(sink_node);
 		source_node = edge->get_source_node();
 
-		if (source_node)
+		edge_length = edge->get_length();
+		assert(edge_length >= 0 && static_cast<unsigned>(edge_length) < m_delay_levels.size());
+
+		sink_level = sink_node->get_max_comb_delay_level();
+		source_level = source_node ? source_node->get_max_comb_delay_level() : 0;
+
+		if (sink_level >= 0 && static_cast<unsigned>(sink_level) < input_distributions.size())
 		{
-			if (source_node->get_max_comb_delay_level() == delay_level)
-			{
-				output_edges_to_a_delay_level.push_back(edge);
-			}
+			input_distributions[sink_level][edge_length]++;
 		}
-		else
+		if (source_level >= 0 && static_cast<unsigned>(source_level) < output_distributions.size())
 		{
-			// we have a primary input if we are looking for delay level 0 nodes 
-			// add the edge the output edges
-
-			if (delay_level == 0)
-			{
-				output_edges_to_a_delay_level.push_back(edge);
-			}
+			output_distributions[source_level][edge_length]++;
 		}
-
 	}
-
-	return find_edge_length_distribution(output_edges_to_a_delay_level);
 }
 //
 // gets the fanout distribution, which is the number of nodes at each fanout 
@@ -908,6 +996,11 @@ DISTRIBUTION SEQUENTIAL_LEVEL::get_fanout_distribution
 
 	assert(m_max_delay + 1 == static_cast<signed>(m_delay_levels.size()));
 
+	if (m_frozen_circuit)
+	{
+		return get_frozen_fanout_distribution(max_fanout);
+	}
+
 	for (delay_level_index = 0; delay_level_index <= m_max_delay; delay_level_index++)
 	{
 		add_fanout_distribution_for_delay_level(fanout_distribution, m_delay_levels[delay_level_index]);
@@ -1015,6 +1108,8 @@ NUM_ELEMENTS SEQUENTIAL_LEVEL::get_max_width() const
 //
 void SEQUENTIAL_LEVEL::final_sanity_check()
 {
+	// a frozen sequential level does not keep the edge lists
+	assert(! m_frozen_circuit);
 	
 	// make sure that the sum of the input and output shape is equal to the sum of 
 	//
@@ -1047,3 +1142,78 @@ void SEQUENTIAL_LEVEL::final_sanity_check()
 	//if the sequential level is unclustered each delay level should have 
 	//some nodes in the shape
 }
+
+//
+// The shapes and distributions of a frozen sequential level come from the 
+// statistics pass of the frozen circuit.  They count the same edges as the 
+// edge lists of an unclustered sequential level.
+//
+
+//
+// PRE: the statistics of the frozen circuit have been calculated for its levels
+// RETURNS: the statistics
+//
+const FROZEN_STATISTICS & SEQUENTIAL_LEVEL::get_frozen_statistics() const
+{
+	assert(m_frozen_circuit);
+
+	const FROZEN_STATISTICS & statistics = m_frozen_circuit->get_statistics();
+
+	assert(statistics.is_calculated() && statistics.has_shapes());
+	assert(statistics.get_input_shape().size() == m_delay_levels.size());
+
+	return statistics;
+}
+
+//
+// RETURNS: the number of inputs of the combinational nodes at each delay level
+//
+SHAPE SEQUENTIAL_LEVEL::get_frozen_input_shape() const
+{
+	return get_frozen_statistics().get_input_shape();
+}
+
+//
+// RETURNS: the number of outputs to combinational nodes at each delay level
+//          but the last, with the PI at delay level 0
+//
+SHAPE SEQUENTIAL_LEVEL::get_frozen_output_shape() const
+{
+	assert(! m_delay_levels.empty());
+
+	return get_frozen_statistics().get_output_shape();
+}
+
+//
+// RETURNS: the number of edges into dff from each delay level
+//
+SHAPE SEQUENTIAL_LEVEL::get_frozen_latched_shape() const
+{
+	return get_frozen_statistics().get_latched_shape();
+}
+
+//
+// RETURNS: the number of edges into combinational nodes at each edge length
+//
+DISTRIBUTION SEQUENTIAL_LEVEL::get_frozen_edge_length_distribution() const
+{
+	return get_frozen_statistics().get_edge_length_distribution();
+}
+
+//
+// PRE: max_fanout is the maximum fanout for the circuit
+// RETURNS: the number of nodes and PI at each fanout to combinational nodes
+//
+DISTRIBUTION SEQUENTIAL_LEVEL::get_frozen_fanout_distribution
+(
+	const NUM_ELEMENTS & max_fanout
+) const
+{
+	DISTRIBUTION fanout_distribution = get_frozen_statistics().get_fanout_distribution();
+
+	assert(fanout_distribution.size() <= static_cast<unsigned>(max_fanout + 1));
+
+	fanout_distribution.resize(max_fanout + 1, 0);
+
+	return fanout_distribution;
+}
@@ -25,11 +25,14 @@
 #include "circ.h"
 
 class SEQUENTIAL_LEVEL;
+class FROZEN_CIRCUIT;
+class FROZEN_STATISTICS;
 
 typedef NODES 	DELAY_LEVEL;
 typedef vector<DELAY_LEVEL> 	DELAY_LEVELS;
 typedef vector<NUM_ELEMENTS>	SHAPE;
 typedef vector<NUM_ELEMENTS>	DISTRIBUTION;
+typedef vector<DISTRIBUTION>	DISTRIBUTIONS;
 
 typedef vector<SEQUENTIAL_LEVEL *> SEQUENTIAL_LEVELS;
 
@@ -41,6 +44,10 @@ typedef vector<SEQUENTIAL_LEVEL *> SEQUENTIAL_LEVELS;
 // Description
 //
 //		Contains information about the sequential levels of the circuit.
+//
+//		The sequential level of a frozen circuit is filled from the 
+//		FROZEN_CIRCUIT and takes its shapes and distributions from the 
+//		FROZEN_STATISTICS pass, so it does not keep the lists of edges.
 
 
 class SEQUENTIAL_LEVEL
@@ -53,6 +60,7 @@ public:
 	void set_max_combinational_delay(const DELAY_TYPE & max_delay);
 	void add_node(NODE * node);
 	void add_primary_input(PORT * primary_input);
+	void add_frozen_circuit(const FROZEN_CIRCUIT * frozen_circuit, DELAY_LEVELS & delay_levels);
 
 	void set_is_clustered(const bool & is_clustered) { m_is_clustered = is_clustered;}
 
@@ -90,6 +98,11 @@ public:
 	DISTRIBUTION		get_intra_cluster_output_edge_length_distribution(const DELAY_TYPE& delay_level);
 	DISTRIBUTION		get_inter_cluster_input_edge_length_distribution(const DELAY_TYPE& delay_level);
 	DISTRIBUTION		get_inter_cluster_output_edge_length_distribution(const DELAY_TYPE& delay_level);
+	void				get_edge_length_distributions_by_delay_level(
+							DISTRIBUTIONS & intra_cluster_input_distributions,
+							DISTRIBUTIONS & intra_cluster_output_distributions,
+							DISTRIBUTIONS & inter_cluster_input_distributions,
+							DISTRIBUTIONS & inter_cluster_output_distributions) const;
 private:
 	SEQUENTIAL_LEVEL(const SEQUENTIAL_LEVEL & another_sequential_level);
 	SEQUENTIAL_LEVEL & operator=(const SEQUENTIAL_LEVEL & another_sequential_level);
@@ -99,6 +112,7 @@ private:
 	PORTS				m_dff_output_ports;
 	PORTS				m_PO;
 	PORT * 				m_clock_port;
+	const FROZEN_CIRCUIT *	m_frozen_circuit;	// set if filled from a frozen circuit
 
 	DELAY_TYPE			m_max_delay;
 	LEVEL_TYPE			m_sequential_level_number;
@@ -131,7 +145,18 @@ private:
 	void add_fanout_distribution_for_primary_inputs(DISTRIBUTION & fanout_distribution) const;
 
 	DISTRIBUTION find_edge_length_distribution(const EDGES& edges) const;
+	void find_edge_length_distributions_by_delay_level(const EDGES & edges, 
+								DISTRIBUTIONS & input_distributions,
+								DISTRIBUTIONS & output_distributions) const;
+
+	const FROZEN_STATISTICS &	get_frozen_statistics() const;
+
 
+	SHAPE		get_frozen_input_shape() const;
+	SHAPE		get_frozen_output_shape() const;
+	SHAPE		get_frozen_latched_shape() const;
+	DISTRIBUTION get_frozen_edge_length_distribution() const;
+	DISTRIBUTION get_frozen_fanout_distribution(const NUM_ELEMENTS & max_fanout) const;
 
 	NUM_ELEMENTS get_number_of_non_clock_inputs(const NODES & nodes_at_a_delay_level) const;
 	NUM_ELEMENTS get_number_of_outputs(const NODES & nodes_at_a_delay_level) const;
@@ -0,0 +1,133 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+
+
+#ifndef small_vector_H
+#define small_vector_H
+
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+//
+// Class_name SMALL_VECTOR
+//
+// Description
+//
+//	A vector of pointers (or other plain values) that keeps its first 
+//	INLINE_SIZE elements inside the object and only goes to the heap when
+//	it grows past them.  Used for the fanin of a node and the edges of a 
+//	port, which almost always fit inline, so building a graph does not 
+//	make a small allocation for every node and port.
+//
+//	Only the parts of the std::vector interface the graph uses are here.
+//	The iterators are plain pointers and are invalidated by push_back.
+//
+
+template <class VALUE_TYPE, int INLINE_SIZE>
+class SMALL_VECTOR
+{
+public:
+	typedef VALUE_TYPE *		iterator;
+	typedef const VALUE_TYPE *	const_iterator;
+
+	SMALL_VECTOR() 
+		: m_data(m_inline), m_size(0), m_capacity(INLINE_SIZE) {}
+	SMALL_VECTOR(const SMALL_VECTOR & another_vector) 
+		: m_data(m_inline), m_size(0), m_capacity(INLINE_SIZE) 
+		{ append(another_vector.begin(), another_vector.end()); }
+	SMALL_VECTOR & operator=(const SMALL_VECTOR & another_vector)
+	{
+		if (this != &another_vector)
+		{
+			m_size = 0;
+			append(another_vector.begin(), another_vector.end());
+		}
+		return (*this);
+	}
+	~SMALL_VECTOR() { if (m_data != m_inline) delete [] m_data; }
+
+	iterator		begin() { return m_data; }
+	iterator		end() { return m_data + m_size; }
+	const_iterator	begin() const { return m_data; }
+	const_iterator	end() const { return m_data + m_size; }
+
+	size_t			size() const { return m_size; }
+	bool			empty() const { return m_size == 0; }
+	bool			is_inline() const { return m_data == m_inline; }
+
+	VALUE_TYPE &		operator[](const size_t & index) { assert(index < m_size); return m_data[index]; }
+	const VALUE_TYPE &	operator[](const size_t & index) const { assert(index < m_size); return m_data[index]; }
+	VALUE_TYPE &		front() { assert(m_size > 0); return m_data[0]; }
+	const VALUE_TYPE &	front() const { assert(m_size > 0); return m_data[0]; }
+	VALUE_TYPE &		back() { assert(m_size > 0); return m_data[m_size - 1]; }
+	const VALUE_TYPE &	back() const { assert(m_size > 0); return m_data[m_size - 1]; }
+
+	void push_back(const VALUE_TYPE & value)
+	{
+		if (m_size == m_capacity)
+		{
+			grow();
+		}
+		m_data[m_size++] = value;
+	}
+	iterator erase(iterator position)
+	{
+		assert(position >= begin() && position < end());
+		copy(position + 1, end(), position);
+		m_size--;
+		return position;
+	}
+	void clear() { m_size = 0; }
+
+	// a copy as a std::vector, for the accessors that hand out collections
+	vector<VALUE_TYPE> to_vector() const { return vector<VALUE_TYPE>(begin(), end()); }
+
+private:
+	VALUE_TYPE *	m_data;		// m_inline until the vector outgrows it
+	unsigned		m_size;
+	unsigned		m_capacity;
+	VALUE_TYPE		m_inline[INLINE_SIZE];
+
+	void grow()
+	{
+		VALUE_TYPE * new_data = new VALUE_TYPE[2 * m_capacity];
+		assert(new_data);
+
+		copy(begin(), end(), new_data);
+		if (m_data != m_inline)
+		{
+			delete [] m_data;
+		}
+		m_data = new_data;
+		m_capacity *= 2;
+	}
+	void append(const_iterator first, const_iterator last)
+	{
+		for (; first != last; first++)
+		{
+			push_back(*first);
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,433 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#include "sparse_matrix.h"
+#include <queue>
+#include <functional>
+#include <cmath>
+#include <cassert>
+
+SPARSE_MATRIX::SPARSE_MATRIX()
+{
+	m_nFill = 0;
+	m_work = 0;
+}
+
+SPARSE_MATRIX::SPARSE_MATRIX(const SPARSE_MATRIX & another_matrix)
+{
+	m_rows		= another_matrix.m_rows;
+	m_columns	= another_matrix.m_columns;
+	m_diagonal	= another_matrix.m_diagonal;
+	m_nFill		= another_matrix.m_nFill;
+	m_work		= another_matrix.m_work;
+}
+
+SPARSE_MATRIX & SPARSE_MATRIX::operator=(const SPARSE_MATRIX & another_matrix)
+{
+	m_rows		= another_matrix.m_rows;
+	m_columns	= another_matrix.m_columns;
+	m_diagonal	= another_matrix.m_diagonal;
+	m_nFill		= another_matrix.m_nFill;
+	m_work		= another_matrix.m_work;
+
+	return (*this);
+}
+
+SPARSE_MATRIX::~SPARSE_MATRIX()
+{
+}
+
+//
+// PRE: size >= 0
+// POST: the matrix is size x size and all 0
+//       the storage of the rows is kept for the next matrix
+//
+void SPARSE_MATRIX::resize
+(
+	const INDEX_SIZE & size
+)
+{
+	INDEX_SIZE index = 0;
+
+	assert(size >= 0);
+
+	for (index = 0; index < get_size() && index < size; index++)
+	{
+		m_rows[index].clear();
+		m_columns[index].clear();
+	}
+	m_rows.resize(size);
+	m_columns.resize(size);
+	m_diagonal.assign(size, -1);
+	m_nFill = 0;
+	m_work = 0;
+}
+
+//
+// POST: value has been added to entry (row, column)
+//
+void SPARSE_MATRIX::add
+(
+	const INDEX_SIZE & row,
+	const INDEX_SIZE & column,
+	const double & value
+)
+{
+	INDEX_SIZE position = 0;
+
+	assert(row >= 0 && row < get_size());
+	assert(column >= 0 && column < get_size());
+
+	position = find_entry(row, column);
+	if (position >= 0)
+	{
+		m_rows[row][position].value += value;
+	}
+	else
+	{
+		new_entry(row, column, value);
+	}
+}
+
+//
+// PRE: the matrix can be factored with pivots on the diagonal in any order
+// POST: the matrix has been eliminated (and is no longer valid)
+//       log2_determinant is log2 of the absolute value of the determinant, 
+//       -HUGE_VAL if the matrix is singular
+// RETURNS: false if the elimination takes more than max_work, in which 
+//          case it stops and log2_determinant is not set
+//
+bool SPARSE_MATRIX::get_log2_determinant
+(
+	double & log2_determinant,
+	const long & max_work
+)
+{
+	typedef pair<long, INDEX_SIZE> CANDIDATE;
+
+	priority_queue<CANDIDATE, vector<CANDIDATE>, greater<CANDIDATE> > candidates;
+	vector<char> is_eliminated(get_size(), 0);
+	vector<char> is_pushed(get_size(), 0);
+	vector<INDEX_SIZE> changed;
+	vector<INDEX_SIZE>::const_iterator changed_iter;
+	INDEX_SIZE nEliminated = 0;
+	INDEX_SIZE pivot = 0;
+	long markowitz_count = 0;
+	double pivot_value = 0;
+	double log2_sum = 0;
+
+	m_position.assign(get_size(), -1);
+
+	for (pivot = 0; pivot < get_size(); pivot++)
+	{
+		candidates.push(CANDIDATE(get_markowitz_count(pivot), pivot));
+	}
+
+	// the candidates are not removed when their count changes: the stale 
+	// ones are skipped when they come up
+	while (nEliminated < get_size())
+	{
+		assert(! candidates.empty());
+
+		markowitz_count = candidates.top().first;
+		pivot = candidates.top().second;
+		if (is_eliminated[pivot] || markowitz_count != get_markowitz_count(pivot))
+		{
+			candidates.pop();
+			continue;
+		}
+		candidates.pop();
+
+		// the Markowitz count is the least work the pivot can take
+		if (m_work + markowitz_count > max_work)
+		{
+			return false;
+		}
+
+		pivot_value = m_diagonal[pivot] >= 0 ? m_rows[pivot][m_diagonal[pivot]].value : 0;
+		if (pivot_value == 0)
+		{
+			log2_determinant = -HUGE_VAL;
+			return true;
+		}
+		log2_sum += log2(fabs(pivot_value));
+
+		changed.clear();
+		eliminate(pivot, changed);
+		is_eliminated[pivot] = 1;
+		nEliminated++;
+		if (m_work > max_work)
+		{
+			return false;
+		}
+
+		// an index is listed once for each fill in its column
+		for (changed_iter = changed.begin(); changed_iter != changed.end(); changed_iter++)
+		{
+			if (! is_eliminated[*changed_iter] && ! is_pushed[*changed_iter])
+			{
+				candidates.push(CANDIDATE(get_markowitz_count(*changed_iter), *changed_iter));
+				is_pushed[*changed_iter] = 1;
+			}
+		}
+		for (changed_iter = changed.begin(); changed_iter != changed.end(); changed_iter++)
+		{
+			is_pushed[*changed_iter] = 0;
+		}
+	}
+
+	log2_determinant = log2_sum;
+	return true;
+}
+
+//
+// RETURNS: the Markowitz count of the diagonal entry of index
+//
+long SPARSE_MATRIX::get_markowitz_count
+(
+	const INDEX_SIZE & index
+) const
+{
+	long nRow_entries = static_cast<long>(m_rows[index].size());
+	long nColumn_entries = static_cast<long>(m_columns[index].size());
+
+	return (nRow_entries > 0 ? nRow_entries - 1 : 0) * (nColumn_entries > 0 ? nColumn_entries - 1 : 0);
+}
+
+//
+// RETURNS: the position of entry (row, column) in its row, -1 if there is 
+//          none.  A diagonal entry is found at once, any other by a scan of
+//          the shorter of its row and column
+//
+INDEX_SIZE SPARSE_MATRIX::find_entry
+(
+	const INDEX_SIZE & row,
+	const INDEX_SIZE & column
+) const
+{
+	SPARSE_ROW::const_iterator row_iter;
+	SPARSE_COLUMN::const_iterator column_iter;
+
+	if (row == column)
+	{
+		return m_diagonal[row];
+	}
+
+	if (m_rows[row].size() <= m_columns[column].size())
+	{
+		for (row_iter = m_rows[row].begin(); row_iter != m_rows[row].end(); row_iter++)
+		{
+			if (row_iter->column == column)
+			{
+				return static_cast<INDEX_SIZE>(row_iter - m_rows[row].begin());
+			}
+		}
+	}
+	else
+	{
+		for (column_iter = m_columns[column].begin(); column_iter != m_columns[column].end(); column_iter++)
+		{
+			if (column_iter->row == row)
+			{
+				return column_iter->row_position;
+			}
+		}
+	}
+
+	return -1;
+}
+
+//
+// PRE: there is no entry (row, column)
+// RETURNS: the position of the new entry, at the end of its row 
+//
+INDEX_SIZE SPARSE_MATRIX::new_entry
+(
+	const INDEX_SIZE & row,
+	const INDEX_SIZE & column,
+	const double & value
+)
+{
+	ROW_ENTRY row_entry;
+	COLUMN_ENTRY column_entry;
+
+	row_entry.column = column;
+	row_entry.value = value;
+	row_entry.column_position = static_cast<INDEX_SIZE>(m_columns[column].size());
+	column_entry.row = row;
+	column_entry.row_position = static_cast<INDEX_SIZE>(m_rows[row].size());
+
+	m_rows[row].push_back(row_entry);
+	m_columns[column].push_back(column_entry);
+	if (row == column)
+	{
+		m_diagonal[row] = column_entry.row_position;
+	}
+
+	return column_entry.row_position;
+}
+
+//
+// POST: the entry at position in row is gone from its row and column
+//       the last entry of each takes its place
+//
+void SPARSE_MATRIX::remove_entry
+(
+	const INDEX_SIZE & row,
+	const INDEX_SIZE & position
+)
+{
+	SPARSE_ROW & sparse_row = m_rows[row];
+	INDEX_SIZE column = sparse_row[position].column;
+	INDEX_SIZE column_position = sparse_row[position].column_position;
+	SPARSE_COLUMN & sparse_column = m_columns[column];
+
+	assert(sparse_column[column_position].row == row);
+	assert(sparse_column[column_position].row_position == position);
+
+	if (column_position + 1 < static_cast<INDEX_SIZE>(sparse_column.size()))
+	{
+		sparse_column[column_position] = sparse_column.back();
+		m_rows[sparse_column[column_position].row][sparse_column[column_position].row_position].column_position = column_position;
+	}
+	sparse_column.pop_back();
+
+	if (position + 1 < static_cast<INDEX_SIZE>(sparse_row.size()))
+	{
+		sparse_row[position] = sparse_row.back();
+		m_columns[sparse_row[position].column][sparse_row[position].column_position].row_position = position;
+		if (sparse_row[position].column == row)
+		{
+			m_diagonal[row] = position;
+		}
+	}
+	sparse_row.pop_back();
+
+	if (column == row)
+	{
+		m_diagonal[row] = -1;
+	}
+}
+
+//
+// Subtract the multiple of the pivot row that zeroes the pivot column from
+// every other row with an entry in the pivot column
+//
+// PRE: the diagonal entry of pivot is not 0
+// POST: the pivot row and column are gone from the matrix
+//       changed holds the rows and columns whose counts changed
+//
+void SPARSE_MATRIX::eliminate
+(
+	const INDEX_SIZE & pivot,
+	vector<INDEX_SIZE> & changed
+)
+{
+	// the inner loops run over raw pointers: the rows being updated have 
+	// room reserved for their fill so they do not move
+	const SPARSE_ROW & pivot_row = m_rows[pivot];
+	const ROW_ENTRY * pivot_begin = pivot_row.data();
+	const ROW_ENTRY * pivot_end = pivot_begin + pivot_row.size();
+	const ROW_ENTRY * pivot_entry = 0;
+	SPARSE_COLUMN rows_to_update = m_columns[pivot];
+	SPARSE_COLUMN::const_iterator row_iter;
+	ROW_ENTRY * row_begin = 0;
+	ROW_ENTRY * row_entry = 0;
+	INDEX_SIZE * position = m_position.data();
+	INDEX_SIZE row = 0;
+	INDEX_SIZE column = 0;
+	INDEX_SIZE nRow_entries = 0;
+	INDEX_SIZE entry_index = 0;
+	double pivot_value = pivot_row[m_diagonal[pivot]].value;
+	double factor = 0;
+
+	for (row_iter = rows_to_update.begin(); row_iter != rows_to_update.end(); row_iter++)
+	{
+		row = row_iter->row;
+		if (row == pivot)
+		{
+			continue;
+		}
+
+		// a pivot row of only the diagonal changes nothing but the pivot column
+		if (pivot_row.size() == 1)
+		{
+			remove_entry(row, row_iter->row_position);
+			changed.push_back(row);
+			continue;
+		}
+
+		SPARSE_ROW & sparse_row = m_rows[row];
+
+		sparse_row.reserve(sparse_row.size() + pivot_row.size());
+		row_begin = sparse_row.data();
+		nRow_entries = static_cast<INDEX_SIZE>(sparse_row.size());
+		m_work += nRow_entries;
+		for (entry_index = 0; entry_index < nRow_entries; entry_index++)
+		{
+			position[row_begin[entry_index].column] = entry_index;
+		}
+
+		factor = row_begin[row_iter->row_position].value / pivot_value;
+
+		for (pivot_entry = pivot_begin; pivot_entry != pivot_end; pivot_entry++)
+		{
+			if (pivot_entry->column == pivot)
+			{
+				continue;
+			}
+
+			if (position[pivot_entry->column] >= 0)
+			{
+				row_begin[position[pivot_entry->column]].value -= factor * pivot_entry->value;
+			}
+			else
+			{
+				// fill
+				position[pivot_entry->column] = new_entry(row, pivot_entry->column, -factor * pivot_entry->value);
+				changed.push_back(pivot_entry->column);
+				m_nFill++;
+			}
+			m_work++;
+		}
+
+		nRow_entries = static_cast<INDEX_SIZE>(sparse_row.size());
+		for (row_entry = row_begin; row_entry != row_begin + nRow_entries; row_entry++)
+		{
+			position[row_entry->column] = -1;
+		}
+
+		// take the pivot column out of the row
+		remove_entry(row, row_iter->row_position);
+		changed.push_back(row);
+	}
+
+	// take the pivot row out of the columns
+	while (! m_rows[pivot].empty())
+	{
+		column = m_rows[pivot].back().column;
+		if (column != pivot)
+		{
+			changed.push_back(column);
+		}
+		remove_entry(pivot, static_cast<INDEX_SIZE>(m_rows[pivot].size()) - 1);
+	}
+
+	assert(m_columns[pivot].empty());
+}
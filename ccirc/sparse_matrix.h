@@ -0,0 +1,97 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef sparse_matrix_H
+#define sparse_matrix_H
+
+#include <vector>
+#include <utility>
+using namespace std;
+#include "matrix.h"
+
+//
+// Class_name SPARSE_MATRIX
+//
+// Description
+//
+//	A square matrix of doubles that only keeps its non-zero entries, for 
+//	finding the determinant of matrices too big to hold densely.
+//
+//	The determinant is found by LU elimination without row exchanges, 
+//	choosing each pivot on the diagonal by the Markowitz count 
+//	(row entries - 1) * (column entries - 1) so that little fill is 
+//	created: a row or column with a single entry is eliminated for free, 
+//	so the triangular part of a matrix costs nothing.  Diagonal pivots in
+//	any order are only safe for matrices that need no row exchanges, such
+//	as the diagonally dominant Kirchhoff matrices of graphs.
+//
+//	Each entry knows its place in its row and in its column, so an entry
+//	is found or removed in constant time.  The fill still depends on the
+//	graph and can make the elimination cubic, so it stops once it has 
+//	scanned and updated a given number of entries (its work).
+//
+
+class SPARSE_MATRIX
+{
+public:
+	SPARSE_MATRIX();
+	SPARSE_MATRIX(const SPARSE_MATRIX & another_matrix);
+	SPARSE_MATRIX & operator=(const SPARSE_MATRIX & another_matrix);
+	~SPARSE_MATRIX();
+
+	void		resize(const INDEX_SIZE & size);	// also sets every entry to 0
+	void		add(const INDEX_SIZE & row, const INDEX_SIZE & column, const double & value);
+
+	INDEX_SIZE	get_size() const { return static_cast<INDEX_SIZE>(m_rows.size()); }
+	INDEX_SIZE	get_nFill() const { return m_nFill; }
+	long		get_work() const { return m_work; }
+
+	// destroys the matrix
+	bool		get_log2_determinant(double & log2_determinant, const long & max_work);
+private:
+	struct ROW_ENTRY
+	{
+		INDEX_SIZE	column;
+		double		value;
+		INDEX_SIZE	column_position;	// of the entry in m_columns[column]
+	};
+	struct COLUMN_ENTRY
+	{
+		INDEX_SIZE	row;
+		INDEX_SIZE	row_position;		// of the entry in m_rows[row]
+	};
+	typedef vector<ROW_ENTRY> SPARSE_ROW;
+	typedef vector<COLUMN_ENTRY> SPARSE_COLUMN;
+
+	vector<SPARSE_ROW>		m_rows;
+	vector<SPARSE_COLUMN>	m_columns;
+	vector<INDEX_SIZE>		m_diagonal;			// position of the diagonal in each row, -1 if none
+	INDEX_SIZE				m_nFill;			// entries created by the elimination
+	long					m_work;				// entries scanned and updated by the elimination
+
+	vector<INDEX_SIZE>		m_position;			// of each column in the row being updated
+
+	long		get_markowitz_count(const INDEX_SIZE & index) const;
+	INDEX_SIZE	find_entry(const INDEX_SIZE & row, const INDEX_SIZE & column) const;
+	INDEX_SIZE	new_entry(const INDEX_SIZE & row, const INDEX_SIZE & column, const double & value);
+	void		remove_entry(const INDEX_SIZE & row, const INDEX_SIZE & position);
+	void		eliminate(const INDEX_SIZE & pivot, vector<INDEX_SIZE> & changed);
+};
+
+#endif
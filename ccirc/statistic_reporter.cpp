@@ -23,22 +23,81 @@
 #include <algorithm>
 #include <numeric>
 #include <iterator>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include "degree_info.h"
 #include "rnum.h"
+#include "util.h"
+
+// the schema of the binary stats. append to the end only, so older 
+// readers still find the scalars they know at the same offsets, and bump
+// the version in STATS_BINARY_MAGIC: the array lengths follow the scalars
+// and move with them.  CCIRCST2 added the sampled rnum scalars, CCIRCST3 
+// the full rnum cones counted quick.
+const char * const STATS_SCALAR_NAMES[] = 
+{
+	"Number_of_Nodes", "Number_of_Edges", "Maximum_Delay", "Number_of_PI", "Number_of_PO",
+	"Number_of_Combinational_Nodes", "Number_of_DFF", "kin", "Wirelength_approx",
+	"Avg_fanin_comb", "Avg_fanin_comb_std_dev", "Avg_fanout", "Avg_fanout_std_dev",
+	"Avg_fanout_comb", "Avg_fanout_comb_std_dev", "Avg_fanout_pi", "Avg_fanout_pi_std_dev",
+	"Avg_fanout_dff", "Avg_fanout_dff_std_dev", "Maximum_fanout",
+	"Number_of_high_degree_comb", "Number_of_high_degree_pi", "Number_of_high_degree_dff",
+	"Number_of_10plus_degree_comb", "Number_of_10plus_degree_pi", "Number_of_10plus_degree_dff",
+	"Reconvergence", "Reconvergence_max", "Reconvergence_min",
+	"Reconvergence_full", "Reconvergence_full_max", "Reconvergence_full_min",
+	"Number_of_Clusters",
+	"Reconvergence_error", "Reconvergence_sampled_pi",
+	"Reconvergence_full_error", "Reconvergence_full_sampled_pi",
+	"Reconvergence_full_capped_pi"
+};
+const int STATS_nSCALARS = sizeof(STATS_SCALAR_NAMES) / sizeof(STATS_SCALAR_NAMES[0]);
+
+const char * const STATS_ARRAY_NAMES[] = 
+{
+	"Node_shape", "Input_shape", "Output_shape", "Latched_shape", "POshape",
+	"Edge_length_distribution", "Intra_cluster_edge_length_distribution",
+	"Inter_cluster_input_edge_length_distribution", "Inter_cluster_output_edge_length_distribution",
+	"Fanout_distribution"
+};
+const int STATS_nARRAYS = sizeof(STATS_ARRAY_NAMES) / sizeof(STATS_ARRAY_NAMES[0]);
+
+static const char STATS_BINARY_MAGIC[] = "CCIRCST3";
+
+static void _write_json_string(ostream & output_stream, const string & text);
+static void _write_json_number(ostream & output_stream, const double & value);
+static void _write_uint64(ostream & output_stream, unsigned long long value);
+static void _write_float64(ostream & output_stream, const double & value);
+static DISTRIBUTION _get_distribution(const DISTRIBUTIONS & distributions, const DELAY_TYPE & delay);
 
 STATISTIC_REPORTER::STATISTIC_REPORTER()
+	: m_output_file(0)
 {
 	m_circuit	= 0;
+	m_metrics	= 0;
+	m_stats_plan = 0;
+	m_section	= 0;
 }
 
 STATISTIC_REPORTER::STATISTIC_REPORTER(const STATISTIC_REPORTER & another_statistic_reporter)
+	: m_output_file(0)
 {
 	m_circuit		= another_statistic_reporter.m_circuit;
+	m_metrics		= another_statistic_reporter.m_metrics;
+	m_stats_plan	= another_statistic_reporter.m_stats_plan;
+	m_sections		= another_statistic_reporter.m_sections;
+	m_section		= another_statistic_reporter.m_section;
 }
 
 STATISTIC_REPORTER & STATISTIC_REPORTER::operator=(const STATISTIC_REPORTER & another_statistic_reporter)
 {
 	m_circuit	= another_statistic_reporter.m_circuit;
+	m_metrics	= another_statistic_reporter.m_metrics;
+	m_stats_plan = another_statistic_reporter.m_stats_plan;
+	m_sections	= another_statistic_reporter.m_sections;
+	m_section	= another_statistic_reporter.m_section;
 
 	return (*this);
 }
@@ -47,6 +106,13 @@ STATISTIC_REPORTER::~STATISTIC_REPORTER()
 {
 }
 
+//
+// Report the statistics to the .stats file
+//
+// PRE: circuit has been analyzed
+// POST: the stats have been written to the output file (--out) or
+//       to <circuit name>.stats, .json or .bin by the --format
+//
 void STATISTIC_REPORTER::report_stats
 (
 	CIRCUIT * circuit
@@ -54,11 +120,8 @@ void STATISTIC_REPORTER::report_stats
 {
 	assert(circuit);
 	m_circuit = circuit;
-	DEGREE_INFO * degree_info = m_circuit->get_degree_info();
-	assert(degree_info);
-	SEQUENTIAL_LEVEL * sequential_level = m_circuit->get_sequential_level();
-	assert(sequential_level);
 
+	OPTIONS::OUTPUT_FORMAT format = g_options->get_output_format();
 	string circuit_name;
 	string file_name;
 
@@ -68,35 +131,161 @@ void STATISTIC_REPORTER::report_stats
 	{
 		circuit_name = m_circuit->get_name();
 		assert(! circuit_name.empty());
-		file_name = circuit_name + ".stats";
+		file_name = circuit_name + (format == OPTIONS::JSON_FORMAT ? ".json" : 
+									format == OPTIONS::BINARY_FORMAT ? ".bin" : ".stats");
 	}
 
 	Log("About to open the statistical results file: " << file_name);
 
-	m_output_file.open(file_name.c_str(), ios::out);
+	m_stats_file.open(file_name.c_str(), 
+			(format == OPTIONS::BINARY_FORMAT) ? ios::out | ios::binary : ios::out);
 
-	if (! m_output_file.is_open())
+	if (! m_stats_file.is_open())
 	{
 		Warning("Could not open output file " << file_name << 
 				". Therefore, could not output a .stats file\n");
 		return;
 	}
 
+	if (format == OPTIONS::TEXT_FORMAT)
+	{
+		m_output_file.rdbuf(m_stats_file.rdbuf());
+
+		report_all_stats();
+
+		m_output_file.rdbuf(0);
+	}
+	else
+	{
+		report_formatted_stats(m_stats_file);
+	}
+
+	m_stats_file.close();
+}
+
+//
+// Report the statistics to a stream instead of a file
+//
+// PRE: circuit has been analyzed
+// POST: the stats have been written to output_stream
+//
+void STATISTIC_REPORTER::report_stats
+(
+	CIRCUIT * circuit,
+	ostream & output_stream
+)
+{
+	assert(circuit);
+	m_circuit = circuit;
+
+	if (g_options->get_output_format() != OPTIONS::TEXT_FORMAT)
+	{
+		report_formatted_stats(output_stream);
+		return;
+	}
+
+	m_output_file.rdbuf(output_stream.rdbuf());
+
+	report_all_stats();
+
+	m_output_file.rdbuf(0);
+	output_stream.flush();
+}
+
+//
+// Collect the statistics in memory instead of writing them
+//
+// PRE: circuit has been analyzed
+// POST: metrics holds every number the stats would contain, in the order
+//       they would be written
+//
+void STATISTIC_REPORTER::collect_stats
+(
+	CIRCUIT * circuit,
+	METRICS & metrics
+)
+{
+	assert(circuit);
+	m_circuit = circuit;
+	m_metrics = &metrics;
+
+	// with no buffer bound m_output_file discards the text
+	m_output_file.rdbuf(0);
+
+	report_all_stats();
+
+	m_metrics = 0;
+	m_output_file.clear();
+}
+
+//
+// Write the stats as a json line or a binary record
+//
+// PRE: m_circuit has been analyzed
+// POST: the stats have been written to output_stream in the --format
+//
+void STATISTIC_REPORTER::report_formatted_stats
+(
+	ostream & output_stream
+)
+{
+	// gather the numbers without the text
+	m_output_file.rdbuf(0);
+
+	report_all_stats();
+
+	m_output_file.clear();
+
+	if (g_options->get_output_format() == OPTIONS::JSON_FORMAT)
+	{
+		write_json(output_stream);
+	}
+	else
+	{
+		assert(g_options->get_output_format() == OPTIONS::BINARY_FORMAT);
+		write_binary(output_stream);
+	}
+
+	output_stream.flush();
+}
+
+//
+// PRE: m_output_file is bound to an open stream
+//      m_stats_plan is set and its passes have been run
+// POST: the sections of the stats in the plan have been written
+//
+void STATISTIC_REPORTER::report_all_stats()
+{
+	assert(m_circuit && m_stats_plan);
+	DEGREE_INFO * degree_info = m_circuit->get_degree_info();
+	SEQUENTIAL_LEVEL * sequential_level = m_circuit->get_sequential_level();
+	assert(sequential_level);
+
+	m_sections.clear();
+	begin_section("", -1);
+
 	m_output_file << "######################## BASIC ############################" << endl;
 	m_output_file << "Circuit_Name:  " 	<< m_circuit->get_name()	<< endl;
-    m_output_file << "Number_of_Nodes:  " 	<< m_circuit->get_size()	<< endl;
-    m_output_file << "Number_of_Edges: " << m_circuit->get_nEdges_without_clock_edges() << endl;
-    m_output_file << "Maximum_Delay: " 		<< m_circuit->get_maximum_combinational_delay() << endl;
-    m_output_file << "Number_of_PI: " 	<< m_circuit->get_nPI()		<< endl;
-    m_output_file << "Number_of_PO: " 	<< m_circuit->get_nPO()		<< endl;
-    m_output_file << "Number_of_Combinational_Nodes: " 	<< m_circuit->get_nComb()	<< endl;
-    m_output_file << "Number_of_DFF: " 	<< m_circuit->get_nDFF()	<< endl;
-    m_output_file << "kin: " << g_options->get_k()	<< endl;
+	if (is_reported("Number_of_Nodes"))
+	{
+    	m_output_file << "Number_of_Nodes:  " 	<< m_circuit->get_size()	<< endl;
+		record_metric("Number_of_Nodes", m_circuit->get_size());
+	}
+	output_value("Number_of_Edges", m_circuit->get_nEdges_without_clock_edges());
+	if (m_stats_plan->is_needed(STATS_PLAN::DELAY_PASS))
+	{
+		output_value("Maximum_Delay", m_circuit->get_maximum_combinational_delay());
+	}
+	output_value("Number_of_PI", m_circuit->get_nPI());
+	output_value("Number_of_PO", m_circuit->get_nPO());
+	output_value("Number_of_Combinational_Nodes", m_circuit->get_nComb());
+	output_value("Number_of_DFF", m_circuit->get_nDFF());
+	output_value("kin", g_options->get_k());
 	
 	// if we didn't calculate wirelength approx. don't print 0 but print not_calculated
 	if (g_options->is_determine_wirelength_approx())
 	{
-		m_output_file << "Wirelength_approx: " << m_circuit->get_wirelength_approx()	<< endl;
+		output_value("Wirelength_approx", m_circuit->get_wirelength_approx());
 	}
 
 	if (m_circuit->get_global_clock()) 
@@ -108,13 +297,47 @@ void STATISTIC_REPORTER::report_stats
     //m_output_file << "Num_unreachable: " << m_circuit->num_unreachable()<< endl;
 
 
-	//report_by_cluster_statistics();
+	if (m_circuit->get_nClusters() > 1 && m_stats_plan->is_requested("Cluster_summary"))
+	{
+		report_by_cluster_statistics();
+	}
 
-	report_degree_information(degree_info);
-	report_reconvergence(circuit);
-	report_level_shape(sequential_level, degree_info);
+	if (m_stats_plan->is_needed(STATS_PLAN::DEGREE_PASS))
+	{
+		report_degree_information(degree_info);
+	}
+
+	// the reconvergence and the shapes are worked out as they are reported
+	if (m_stats_plan->is_needed(STATS_PLAN::RNUM_PASS))
+	{
+		PROFILE_STAGE stage("rnum");
+		m_stats_plan->start_pass(STATS_PLAN::RNUM_PASS);
+		report_reconvergence(m_circuit);
+		m_stats_plan->finish_pass(STATS_PLAN::RNUM_PASS);
+	}
 
-	//report_cluster_stastistics();
+	if (m_stats_plan->is_needed(STATS_PLAN::SHAPE_PASS))
+	{
+		PROFILE_STAGE stage("shape_reporting");
+		m_stats_plan->start_pass(STATS_PLAN::SHAPE_PASS);
+		if (m_circuit->is_frozen())
+		{
+			// done already if the degree info was
+			m_circuit->get_frozen_circuit()->calculate_statistics();
+		}
+		report_level_shape(sequential_level, degree_info);
+		m_stats_plan->finish_pass(STATS_PLAN::SHAPE_PASS);
+	}
+
+	if (m_circuit->get_nClusters() > 1)
+	{
+		report_cluster_stastistics();
+	}
+
+	if (g_profiler && g_options->is_profile())
+	{
+		report_profile(g_profiler->get_stages());
+	}
 
 	
 }
@@ -124,33 +347,123 @@ void STATISTIC_REPORTER::report_reconvergence(CIRCUIT * circuit){
 	m_output_file << "======================== Mapping  ============================" << endl;
 
 	//report reconvergence value 
-	double R0,R0min,R0max;
-	rnum (circuit,&R0,&R0max,&R0min);
-	m_output_file << "Reconvergence: " << R0 << endl;
-	m_output_file << "Reconvergence_max: " << R0max	<< endl;
-	m_output_file << "Reconvergence_min: " << R0min	<< endl;
+	double R0,R0min,R0max,R0error;
+	long nSampled, nCapped;
+	OPTIONS::RNUM_MODE mode = g_options->get_rnum_mode();
+	bool is_sampled = g_options->get_rnum_sample() > 0;
+
+	if (mode == OPTIONS::RNUM_QUICK || mode == OPTIONS::RNUM_BOTH)
+	{
+		if (is_sampled)
+		{
+			rnum_sampled (circuit,false,&R0,&R0max,&R0min,&R0error,&nSampled,&nCapped);
+		}
+		else
+		{
+			rnum (circuit,&R0,&R0max,&R0min);
+		}
+		output_value("Reconvergence", R0);
+		output_value("Reconvergence_max", R0max);
+		output_value("Reconvergence_min", R0min);
+		if (is_sampled)
+		{
+			output_value("Reconvergence_error", R0error);
+			output_value("Reconvergence_sampled_pi", nSampled);
+		}
+	}
+	if (mode == OPTIONS::RNUM_FULL || mode == OPTIONS::RNUM_BOTH)
+	{
+		if (is_sampled)
+		{
+			rnum_sampled (circuit,true,&R0,&R0max,&R0min,&R0error,&nSampled,&nCapped);
+		}
+		else
+		{
+			rnum_full (circuit,&R0,&R0max,&R0min,&nCapped);
+		}
+		output_value("Reconvergence_full", R0);
+		output_value("Reconvergence_full_max", R0max);
+		output_value("Reconvergence_full_min", R0min);
+		if (is_sampled)
+		{
+			output_value("Reconvergence_full_error", R0error);
+			output_value("Reconvergence_full_sampled_pi", nSampled);
+		}
+		// the primary inputs whose cones were over the cap or the work budget
+		output_value("Reconvergence_full_capped_pi", nCapped);
+	}
+}
+
+//
+// PRE: stages are the stages of the analysis so far
+// POST: the cost of each stage has been reported in the Profile section,
+//       and the estimated cost of each pass that --stats skipped.  the cpu
+//       time is of the circuit's threads only
+//
+void STATISTIC_REPORTER::report_profile
+(
+	const PROFILE_RECORDS & stages
+)
+{
+	PROFILE_RECORDS::const_iterator stage_iter;
+	vector<string> stage_names;
+	int pass;
+	bool is_measured = false;
+
+	begin_section("Profile", -1);
+
+	m_output_file << "======================== PROFILE ============================" << endl;
+
+	// in the order they began. a stage inside another is named parent.stage
+	for (stage_iter = stages.begin(); stage_iter != stages.end(); stage_iter++)
+	{
+		stage_names.push_back(stage_iter->parent < 0 ? stage_iter->name : 
+							  stage_names[stage_iter->parent] + "." + stage_iter->name);
+
+		output_value(stage_names.back() + "_wall_s", stage_iter->wall_seconds);
+		output_value(stage_names.back() + "_cpu_s", stage_iter->cpu_seconds);
+		output_value(stage_names.back() + "_rss_delta_kb", stage_iter->rss_delta_kb);
+	}
+
+	output_value("peak_rss_kb", util_peak_resident_kb());
+
+	// what --stats saved
+	for (pass = 0; pass < STATS_PLAN::nPASSES; pass++)
+	{
+		if (m_stats_plan->is_skipped(static_cast<STATS_PLAN::PASS>(pass)))
+		{
+			output_value(string(STATS_PLAN::get_pass_name(static_cast<STATS_PLAN::PASS>(pass))) + "_pass_skipped_est_s", 
+						 m_stats_plan->get_estimated_seconds(static_cast<STATS_PLAN::PASS>(pass), 
+															m_circuit->get_nEdges(), is_measured));
+		}
+	}
 
+	begin_section("", -1);
 }
 
 void STATISTIC_REPORTER::report_by_cluster_statistics()
 {
 	DISTRIBUTION size, nPI, nDFF, nIntra_cluster_edges, nInter_cluster_edges, wirelength_approx;
 
+	begin_section("Cluster_summary", -1);
+
 	m_output_file << "======================== Cluster_Summary ==================\n";
 
 	m_circuit->get_cluster_stats(size, nPI, nDFF, nIntra_cluster_edges, nInter_cluster_edges, wirelength_approx);
 
-	m_output_file << "Number_of_nodes: "; output_distribution(size);
-	m_output_file << "Number_of_pi: "; output_distribution(nPI);
-	m_output_file << "Number_of_dff: "; output_distribution(nDFF);
-	m_output_file << "Number_of_intra_cluster_edges: "; output_distribution(nIntra_cluster_edges);
-	m_output_file << "Number_of_inter_cluster_edges: "; output_distribution(nInter_cluster_edges);
+	output_distribution("Number_of_nodes", size);
+	output_distribution("Number_of_pi", nPI);
+	output_distribution("Number_of_dff", nDFF);
+	output_distribution("Number_of_intra_cluster_edges", nIntra_cluster_edges);
+	output_distribution("Number_of_inter_cluster_edges", nInter_cluster_edges);
 	if (g_options->is_determine_wirelength_approx())
 	{
-		m_output_file << "Wirelength_approx: "; output_distribution(wirelength_approx);
+		output_distribution("Wirelength_approx", wirelength_approx);
 	}
 
-	m_output_file << "Partitioned_scaled_cost: " << m_circuit->get_scaled_cost() << endl;
+	output_value("Partitioned_scaled_cost", m_circuit->get_scaled_cost());
+
+	begin_section("", -1);
 }
 
 
@@ -163,30 +476,30 @@ void STATISTIC_REPORTER::report_degree_information
 
 	m_output_file << "======================== DEGREE ============================" << endl;
 
-	m_output_file << "Avg_fanin_comb: " << degree_info->get_avg_fanin_for_comb() 
-		<< " (" << degree_info->get_std_dev_comb_fanin() << ")" << endl;
+	output_average("Avg_fanin_comb", degree_info->get_avg_fanin_for_comb(),
+					degree_info->get_std_dev_comb_fanin());
 
-	m_output_file << "Avg_fanout: " 	<< degree_info->get_avg_fanout()
-		<< " (" << degree_info->get_std_dev_fanout() << ")" 	<< endl;
+	output_average("Avg_fanout", degree_info->get_avg_fanout(),
+					degree_info->get_std_dev_fanout());
 
-	m_output_file << "Avg_fanout_comb: "<< degree_info->get_avg_fanout_for_comb() 	
-		<< " (" << degree_info->get_std_dev_comb_fanout() << ")" << endl;
+	output_average("Avg_fanout_comb", degree_info->get_avg_fanout_for_comb(),
+					degree_info->get_std_dev_comb_fanout());
 
-	m_output_file << "Avg_fanout_pi: " 	<< degree_info->get_avg_fanout_for_pi() 
-		<< " (" << degree_info->get_std_dev_pi_fanout() << ")" 	<< endl;
+	output_average("Avg_fanout_pi", degree_info->get_avg_fanout_for_pi(),
+					degree_info->get_std_dev_pi_fanout());
 
-	m_output_file << "Avg_fanout_dff: " << degree_info->get_avg_fanout_for_dff() 
-		<< " (" << degree_info->get_std_dev_dff_fanout() << ")"	<< endl;
+	output_average("Avg_fanout_dff", degree_info->get_avg_fanout_for_dff(),
+					degree_info->get_std_dev_dff_fanout());
 
-	m_output_file << "Maximum_fanout: " << degree_info->get_maximum_fanout_degree() 	<< endl;
+	output_value("Maximum_fanout", degree_info->get_maximum_fanout_degree());
 
-	m_output_file << "Number_of_high_degree_comb: " 	<< degree_info->get_high_degree_comb()<< endl;
-	m_output_file << "Number_of_high_degree_pi: " 	<< degree_info->get_high_degree_pi() 	<< endl;
-	m_output_file << "Number_of_high_degree_dff: " 	<< degree_info->get_high_degree_dff()	<< endl;
+	output_value("Number_of_high_degree_comb", degree_info->get_high_degree_comb());
+	output_value("Number_of_high_degree_pi", degree_info->get_high_degree_pi());
+	output_value("Number_of_high_degree_dff", degree_info->get_high_degree_dff());
 
-	m_output_file << "Number_of_10plus_degree_comb: " << degree_info->get_10plus_fanout_degree_comb() 	<< endl;
-	m_output_file << "Number_of_10plus_degree_pi: " 	<< degree_info->get_10plus_fanout_degree_pi() 	<< endl;
-	m_output_file << "Number_of_10plus_degree_dff: " 	<< degree_info->get_10plus_fanout_degree_dff() 	<< endl;
+	output_value("Number_of_10plus_degree_comb", degree_info->get_10plus_fanout_degree_comb());
+	output_value("Number_of_10plus_degree_pi", degree_info->get_10plus_fanout_degree_pi());
+	output_value("Number_of_10plus_degree_dff", degree_info->get_10plus_fanout_degree_dff());
 
 }
 
@@ -218,9 +531,8 @@ void STATISTIC_REPORTER::report_level_shape
 {
 	m_output_file << "======================== SHAPE ============================" << endl;
 
-	assert(seq_level && degree_info);
+	assert(seq_level);
 
-	NUM_ELEMENTS max_fanout = degree_info->get_maximum_fanout_degree();
 	SHAPE node_shape = seq_level->get_node_shape();
 	SHAPE input_shape = seq_level->get_input_shape();
 	SHAPE output_shape_by_level = seq_level->get_output_shape();
@@ -232,44 +544,40 @@ void STATISTIC_REPORTER::report_level_shape
 					seq_level->get_inter_cluster_input_edge_length_distribution();
 	DISTRIBUTION inter_cluster_output_edge_length_distribution = 
 					seq_level->get_inter_cluster_output_edge_length_distribution();
-	DISTRIBUTION fanout_distribution = seq_level->get_fanout_distribution(max_fanout);
-
-	m_output_file << "Node_shape: ";
-	output_shape(node_shape);
 
-	m_output_file << "Input_shape: ";
-	output_shape(input_shape);
+	output_shape("Node_shape", node_shape);
 
-	m_output_file << "Output_shape: ";
-	output_shape(output_shape_by_level);
+	output_shape("Input_shape", input_shape);
 
-	m_output_file << "Latched_shape: ";
-	output_shape(latched_shape);
-
-	m_output_file << "POshape: ";
-	output_shape(primary_output_shape);
+	output_shape("Output_shape", output_shape_by_level);
 
+	output_shape("Latched_shape", latched_shape);
 
+	output_shape("POshape", primary_output_shape);
 
 	if (seq_level->is_clustered())
 	{
-		m_output_file << "Intra_cluster_edge_length_distribution: ";
-		output_distribution(intra_cluster_edge_length_distribution);
+		output_distribution("Intra_cluster_edge_length_distribution",
+							intra_cluster_edge_length_distribution);
 
-		m_output_file << "Inter_cluster_input_edge_length_distribution: ";
-		output_distribution(inter_cluster_input_edge_length_distribution);
+		output_distribution("Inter_cluster_input_edge_length_distribution",
+							inter_cluster_input_edge_length_distribution);
 
-		m_output_file << "Inter_cluster_output_edge_length_distribution: ";
-		output_distribution(inter_cluster_output_edge_length_distribution);
+		output_distribution("Inter_cluster_output_edge_length_distribution",
+							inter_cluster_output_edge_length_distribution);
 	}
 	else
 	{
-		m_output_file << "Edge_length_distribution: ";
-		output_distribution(intra_cluster_edge_length_distribution);
+		output_distribution("Edge_length_distribution", intra_cluster_edge_length_distribution);
 	}
 
-	m_output_file << "Fanout_distribution: ";
-	output_distribution(fanout_distribution);
+	// the fanout distribution is the only one that needs the degree info
+	if (is_reported("Fanout_distribution"))
+	{
+		assert(degree_info);
+		output_distribution("Fanout_distribution", 
+							seq_level->get_fanout_distribution(degree_info->get_maximum_fanout_degree()));
+	}
 }
 
 void STATISTIC_REPORTER::report_cluster_stastistics()
@@ -283,9 +591,10 @@ void STATISTIC_REPORTER::report_cluster_stastistics()
 	m_output_file << "#################### Clusters ######################" << endl;
 
 
-	m_output_file << "Number_of_Clusters: " << clusters.size()	<< endl;
+	output_value("Number_of_Clusters", clusters.size());
 
-	for (cluster_iter = clusters.begin(); cluster_iter != clusters.end(); cluster_iter++)
+	for (cluster_iter = clusters.begin(); 
+			cluster_iter != clusters.end() && m_stats_plan->is_requested("Clusters"); cluster_iter++)
 	{
 		cluster = *cluster_iter;
 		assert(cluster);
@@ -293,7 +602,12 @@ void STATISTIC_REPORTER::report_cluster_stastistics()
 		report_cluster(cluster);
 	}
 
-	report_inter_cluster_adjacency_matrix();
+	begin_section("", -1);
+
+	if (m_stats_plan->is_requested("Inter_cluster_adjacency_matrix"))
+	{
+		report_inter_cluster_adjacency_matrix();
+	}
 }
 
 void STATISTIC_REPORTER::report_cluster
@@ -307,24 +621,24 @@ void STATISTIC_REPORTER::report_cluster
 	DEGREE_INFO * degree_info = cluster->get_degree_info();
 	assert(degree_info && sequential_level);
 
+	begin_section("Clusters", cluster_number);
+
 	m_output_file << "#################### Cluster " <<  cluster_number << " ######################" << endl;
 
-	m_output_file << "Number_of_Nodes: " << cluster->get_size()<< endl;
-	m_output_file << "Number_of_Intra_cluster_edges: " << cluster->get_nIntra_cluster_edges()<< endl;
-	m_output_file << "Number_of_Inter_cluster_edges: " << cluster->get_nInter_cluster_edges()<< endl;
-	m_output_file << "Number_of_PI: " 	<< cluster->get_nPI()	<< endl;
-	m_output_file << "Number_of_PO: " 	<< cluster->get_nPO()	<< endl;
-	m_output_file << "Number_of_Comb: " 	<< cluster->get_nComb()	<< endl;
-	m_output_file << "Number_of_DFF: " 	<< cluster->get_nDFF()	<< endl;
-	m_output_file << "Number_of_Latched: " << cluster->get_nLatched() << endl;
-	m_output_file << "Number_of_Inter_cluster_input_edges: " 
-		<< cluster->get_nInter_cluster_input_edges() << endl;
-	m_output_file << "Number_of_Inter_cluster_output_edges: " 
-		<< cluster->get_nInter_cluster_output_edges() << endl;
+	output_value("Number_of_Nodes", cluster->get_size());
+	output_value("Number_of_Intra_cluster_edges", cluster->get_nIntra_cluster_edges());
+	output_value("Number_of_Inter_cluster_edges", cluster->get_nInter_cluster_edges());
+	output_value("Number_of_PI", cluster->get_nPI());
+	output_value("Number_of_PO", cluster->get_nPO());
+	output_value("Number_of_Comb", cluster->get_nComb());
+	output_value("Number_of_DFF", cluster->get_nDFF());
+	output_value("Number_of_Latched", cluster->get_nLatched());
+	output_value("Number_of_Inter_cluster_input_edges", cluster->get_nInter_cluster_input_edges());
+	output_value("Number_of_Inter_cluster_output_edges", cluster->get_nInter_cluster_output_edges());
 
 	if (g_options->is_determine_wirelength_approx())
 	{
-		m_output_file << "Wirelength_approx: " 	<< cluster->get_wirelength_approx()	<< endl;
+		output_value("Wirelength_approx", cluster->get_wirelength_approx());
 	}
 
 	report_delay_defining_stats(cluster);
@@ -337,10 +651,8 @@ void STATISTIC_REPORTER::report_cluster
 
 		DISTRIBUTION pi_fanout_distribution = cluster->get_PI_fanout_values();
 		DISTRIBUTION dff_fanout_distribution = cluster->get_DFF_fanout_values();
-		m_output_file << "pi_fanout: ";
-		output_distribution(pi_fanout_distribution);
-		m_output_file << "dff_fanout: ";
-		output_distribution(dff_fanout_distribution);
+		output_distribution("pi_fanout", pi_fanout_distribution);
+		output_distribution("dff_fanout", dff_fanout_distribution);
 	}
 
 	assert(Dsingle_seq_level);
@@ -348,12 +660,69 @@ void STATISTIC_REPORTER::report_cluster
 	report_level_shape(sequential_level, degree_info);
 }
 
+//
+// Write "name: value" and record the value
+//
+template <class VALUE_TYPE>
+void STATISTIC_REPORTER::output_value
+(
+	const string & name,
+	const VALUE_TYPE & value
+)
+{
+	if (! is_reported(name))
+	{
+		return;
+	}
+
+	m_output_file << name << ": " << value << endl;
+	record_metric(name, static_cast<double>(value));
+}
+
+//
+// Write "name: average (std_dev)" and record both
+//
+void STATISTIC_REPORTER::output_average
+(
+	const string & name,
+	const double & average,
+	const double & std_dev
+)
+{
+	if (! is_reported(name))
+	{
+		return;
+	}
+
+	m_output_file << name << ": " << average << " (" << std_dev << ")" << endl;
+	record_metric(name, average);
+	record_metric(name + "_std_dev", std_dev);
+}
+
 void STATISTIC_REPORTER::output_shape
 (
+	const string & name,
 	const SHAPE & shape
 )
 {
+	SHAPE::size_type index;
 
+	if (! is_reported(name))
+	{
+		return;
+	}
+
+	// the metrics have one element per number, the sections the whole array
+	for (index = 0; m_metrics && index < shape.size(); index++)
+	{
+		ostringstream element_name;
+		element_name << name << "[" << index << "]";
+		m_metrics->push_back(METRIC(element_name.str(), static_cast<double>(shape[index])));
+	}
+
+	m_sections[m_section].arrays.push_back(STATS_ARRAY(name, DOUBLE_VECTOR(shape.begin(), shape.end())));
+
+	m_output_file << name << ": ";
 	m_output_file << "( ";
 	copy(shape.begin(), shape.end(), ostream_iterator<NUM_ELEMENTS>(m_output_file, " "));
 	m_output_file << ")" << endl;
@@ -361,12 +730,107 @@ void STATISTIC_REPORTER::output_shape
 
 void STATISTIC_REPORTER::output_distribution
 (
+	const string & name,
 	const DISTRIBUTION & distribution
 )
 {
-	m_output_file << "( ";
-	copy(distribution.begin(), distribution.end(), ostream_iterator<NUM_ELEMENTS>(m_output_file, " "));
-	m_output_file << ")" << endl;
+	// a distribution is written and recorded just like a shape
+	output_shape(name, distribution);
+}
+
+//
+// PRE: report_all_stats has begun a section
+// POST: name and value have been recorded in the section and, if we are 
+//       collecting metrics, in the metrics
+//
+void STATISTIC_REPORTER::record_metric
+(
+	const string & name,
+	const double & value
+)
+{
+	assert(m_section < m_sections.size());
+
+	m_sections[m_section].scalars.push_back(METRIC(name, value));
+
+	if (m_metrics)
+	{
+		m_metrics->push_back(METRIC(name, value));
+	}
+}
+
+//
+// RETURNS: true if the stat name of the section being reported is in the 
+//          plan. in the cluster sections all the stats are, if the clusters are
+//
+bool STATISTIC_REPORTER::is_reported
+(
+	const string & name
+) const
+{
+	assert(m_stats_plan && m_section < m_sections.size());
+
+	const string & section_name = m_sections[m_section].name;
+
+	// the profile is asked for by --profile, not --stats
+	if (section_name == "Profile")
+	{
+		return true;
+	}
+
+	return m_stats_plan->is_requested(section_name.empty() ? name : section_name);
+}
+
+//
+// PRE: report_all_stats has begun a section
+// POST: the rows of matrix have been recorded in the section
+//
+void STATISTIC_REPORTER::record_matrix
+(
+	const string & name,
+	const MATRIX & matrix
+)
+{
+	assert(m_section < m_sections.size());
+
+	vector<DOUBLE_VECTOR> rows(matrix.get_nRows(), DOUBLE_VECTOR(matrix.get_nColumns()));
+	INDEX_SIZE row, col;
+
+	for (row = 0; row < matrix.get_nRows(); row++)
+	{
+		for (col = 0; col < matrix.get_nColumns(); col++)
+		{
+			rows[row][col] = static_cast<double>(matrix.get_value(row, col));
+		}
+	}
+
+	m_sections[m_section].matrices.push_back(STATS_MATRIX(name, rows));
+}
+
+//
+// Make the numbers reported from now on go to a section, the circuit's 
+// if name is empty
+//
+// PRE: nothing
+// POST: m_section is the section name of cluster_number, added if it is new
+//
+void STATISTIC_REPORTER::begin_section
+(
+	const string & name,
+	const long & cluster_number
+)
+{
+	for (m_section = 0; m_section < m_sections.size(); m_section++)
+	{
+		if (m_sections[m_section].name == name && m_sections[m_section].cluster_number == cluster_number)
+		{
+			return;
+		}
+	}
+
+	m_sections.push_back(STATS_SECTION());
+	m_sections.back().name = name;
+	m_sections.back().cluster_number = cluster_number;
 }
 
 
@@ -387,6 +851,9 @@ void STATISTIC_REPORTER::report_inter_cluster_adjacency_matrix()
 
 	m_output_file << inter_cluster_connections_for_dff << endl;
 
+	record_matrix("Inter_cluster_adjacency_matrix_to_combinational_nodes", inter_cluster_connections);
+	record_matrix("Inter_cluster_adjacency_matrix_to_dffs", inter_cluster_connections_for_dff);
+
 
 	if (g_options->is_display_inter_cluster_matricies_at_each_edge_length())
 	{
@@ -515,27 +982,36 @@ void STATISTIC_REPORTER::report_edge_length_by_delay_level
 	assert(seq_level);
 	assert(m_circuit);
 	DELAY_TYPE delay = 0;
+	DISTRIBUTIONS intra_cluster_input_edge_lengths;
+	DISTRIBUTIONS intra_cluster_output_edge_lengths;
+	DISTRIBUTIONS inter_cluster_input_edge_lengths;
+	DISTRIBUTIONS inter_cluster_output_edge_lengths;
 	DISTRIBUTION edge_lengths;
 	m_output_file << "edge_lengths_by_delay_level: " << "\n\n";
 
+	// all the delay levels at once
+	seq_level->get_edge_length_distributions_by_delay_level(intra_cluster_input_edge_lengths,
+			intra_cluster_output_edge_lengths, inter_cluster_input_edge_lengths, 
+			inter_cluster_output_edge_lengths);
+
 	for (delay = 0; delay <= m_circuit->get_maximum_combinational_delay(); delay++)
 	{
 		m_output_file << "Delay " << delay << "\n\n";
 	
 		m_output_file << "Intra_cluster_input_edge_lengths\n";
-		edge_lengths = seq_level->get_intra_cluster_input_edge_length_distribution(delay);
+		edge_lengths = _get_distribution(intra_cluster_input_edge_lengths, delay);
 		copy(edge_lengths.begin(), edge_lengths.end(), ostream_iterator<NUM_ELEMENTS>(m_output_file, " "));
 
 		m_output_file << "\nIntra_cluster_output_edge_lengths\n";
-		edge_lengths = seq_level->get_intra_cluster_output_edge_length_distribution(delay);
+		edge_lengths = _get_distribution(intra_cluster_output_edge_lengths, delay);
 		copy(edge_lengths.begin(), edge_lengths.end(), ostream_iterator<NUM_ELEMENTS>(m_output_file, " "));
 
 		m_output_file << "\nInter_cluster_input_edge_lengths\n";
-		edge_lengths = seq_level->get_inter_cluster_input_edge_length_distribution(delay);	
+		edge_lengths = _get_distribution(inter_cluster_input_edge_lengths, delay);
 		copy(edge_lengths.begin(), edge_lengths.end(), ostream_iterator<NUM_ELEMENTS>(m_output_file, " "));
 		
 		m_output_file << "\nInter_cluster_output_edge_lengths\n";
-		edge_lengths = seq_level->get_inter_cluster_output_edge_length_distribution(delay);
+		edge_lengths = _get_distribution(inter_cluster_output_edge_lengths, delay);
 		copy(edge_lengths.begin(), edge_lengths.end(), ostream_iterator<NUM_ELEMENTS>(m_output_file, " "));
 
 		m_output_file << endl << endl;
@@ -565,3 +1041,295 @@ void STATISTIC_REPORTER::report_cluster_size_distribution
 
 	debugsep;
 }
+
+//
+// Write the stats as one json object on one line: the circuit's numbers, 
+// its Cluster_summary and its Clusters
+//
+// PRE: report_all_stats has recorded the sections
+// POST: the object and a newline have been written to output_stream
+//
+void STATISTIC_REPORTER::write_json
+(
+	ostream & output_stream
+) const
+{
+	assert(m_circuit && ! m_sections.empty());
+
+	STATS_SECTIONS::const_iterator section_iter;
+	bool is_first = false,
+		 is_first_cluster = true;
+
+	output_stream << "{\"Circuit_Name\":";
+	_write_json_string(output_stream, m_circuit->get_name());
+
+	if (m_circuit->get_global_clock())
+	{
+		output_stream << ",\"clock\":";
+		_write_json_string(output_stream, m_circuit->get_global_clock()->get_name());
+	}
+
+	write_json_section(output_stream, m_sections.front(), is_first);
+
+	for (section_iter = m_sections.begin() + 1; section_iter != m_sections.end(); section_iter++)
+	{
+		if (section_iter->cluster_number < 0)
+		{
+			output_stream << ",";
+			_write_json_string(output_stream, section_iter->name);
+			output_stream << ":{";
+			is_first = true;
+			write_json_section(output_stream, *section_iter, is_first);
+			output_stream << "}";
+		}
+	}
+
+	for (section_iter = m_sections.begin() + 1; section_iter != m_sections.end(); section_iter++)
+	{
+		if (section_iter->cluster_number >= 0)
+		{
+			output_stream << (is_first_cluster ? ",\"Clusters\":[" : ",");
+			output_stream << "{\"Cluster_number\":" << section_iter->cluster_number;
+			is_first = false;
+			write_json_section(output_stream, *section_iter, is_first);
+			output_stream << "}";
+			is_first_cluster = false;
+		}
+	}
+
+	if (! is_first_cluster)
+	{
+		output_stream << "]";
+	}
+
+	output_stream << "}\n";
+}
+
+//
+// PRE: is_first is true if nothing has been written in the object yet
+// POST: the scalars, arrays and matrices of section have been written as 
+//       "name":value members
+//
+void STATISTIC_REPORTER::write_json_section
+(
+	ostream & output_stream,
+	const STATS_SECTION & section,
+	bool & is_first
+) const
+{
+	METRICS::const_iterator scalar_iter;
+	STATS_ARRAYS::const_iterator array_iter;
+	STATS_MATRICES::const_iterator matrix_iter;
+	DOUBLE_VECTOR::size_type index;
+	vector<DOUBLE_VECTOR>::size_type row;
+
+	for (scalar_iter = section.scalars.begin(); scalar_iter != section.scalars.end(); scalar_iter++)
+	{
+		output_stream << (is_first ? "" : ",");
+		_write_json_string(output_stream, scalar_iter->first);
+		output_stream << ":";
+		_write_json_number(output_stream, scalar_iter->second);
+		is_first = false;
+	}
+
+	for (array_iter = section.arrays.begin(); array_iter != section.arrays.end(); array_iter++)
+	{
+		output_stream << (is_first ? "" : ",");
+		_write_json_string(output_stream, array_iter->first);
+		output_stream << ":[";
+		for (index = 0; index < array_iter->second.size(); index++)
+		{
+			output_stream << (index == 0 ? "" : ",");
+			_write_json_number(output_stream, array_iter->second[index]);
+		}
+		output_stream << "]";
+		is_first = false;
+	}
+
+	for (matrix_iter = section.matrices.begin(); matrix_iter != section.matrices.end(); matrix_iter++)
+	{
+		output_stream << (is_first ? "" : ",");
+		_write_json_string(output_stream, matrix_iter->first);
+		output_stream << ":[";
+		for (row = 0; row < matrix_iter->second.size(); row++)
+		{
+			output_stream << (row == 0 ? "[" : ",[");
+			for (index = 0; index < matrix_iter->second[row].size(); index++)
+			{
+				output_stream << (index == 0 ? "" : ",");
+				_write_json_number(output_stream, matrix_iter->second[row][index]);
+			}
+			output_stream << "]";
+		}
+		output_stream << "]";
+		is_first = false;
+	}
+}
+
+//
+// Write the circuit's numbers as a binary record, laid out as described in
+// statistic_reporter.h
+//
+// PRE: report_all_stats has recorded the sections
+// POST: the record has been written to output_stream
+//
+void STATISTIC_REPORTER::write_binary
+(
+	ostream & output_stream
+) const
+{
+	assert(m_circuit && ! m_sections.empty());
+
+	const STATS_SECTION & circuit_section = m_sections.front();
+	DOUBLE_VECTOR values(STATS_nSCALARS + STATS_nARRAYS, numeric_limits<double>::quiet_NaN());
+	METRICS::const_iterator scalar_iter;
+	STATS_ARRAYS::const_iterator array_iter;
+	DOUBLE_VECTOR::const_iterator value_iter;
+	string name = m_circuit->get_name();
+	int index;
+
+	for (index = 0; index < STATS_nSCALARS; index++)
+	{
+		for (scalar_iter = circuit_section.scalars.begin(); scalar_iter != circuit_section.scalars.end(); 
+				scalar_iter++)
+		{
+			if (scalar_iter->first == STATS_SCALAR_NAMES[index])
+			{
+				values[index] = scalar_iter->second;
+				break;
+			}
+		}
+	}
+
+	for (index = 0; index < STATS_nARRAYS; index++)
+	{
+		values[STATS_nSCALARS + index] = 0;
+
+		for (array_iter = circuit_section.arrays.begin(); array_iter != circuit_section.arrays.end(); 
+				array_iter++)
+		{
+			if (array_iter->first == STATS_ARRAY_NAMES[index])
+			{
+				values[STATS_nSCALARS + index] = static_cast<double>(array_iter->second.size());
+				values.insert(values.end(), array_iter->second.begin(), array_iter->second.end());
+				break;
+			}
+		}
+	}
+
+	// keep the body aligned for the readers that map it in place
+	name.resize((name.size() + 7) / 8 * 8, '\0');
+
+	output_stream.write(STATS_BINARY_MAGIC, 8);
+	_write_uint64(output_stream, name.size());
+	_write_uint64(output_stream, values.size());
+	output_stream.write(name.data(), name.size());
+
+	for (value_iter = values.begin(); value_iter != values.end(); value_iter++)
+	{
+		_write_float64(output_stream, *value_iter);
+	}
+}
+
+// POST: text has been written as a quoted json string
+static void _write_json_string
+(
+	ostream & output_stream,
+	const string & text
+)
+{
+	string::const_iterator char_iter;
+	char escape[8];
+
+	output_stream << '"';
+	for (char_iter = text.begin(); char_iter != text.end(); char_iter++)
+	{
+		if (*char_iter == '"' || *char_iter == '\\')
+		{
+			output_stream << '\\' << *char_iter;
+		}
+		else if (static_cast<unsigned char>(*char_iter) < 0x20)
+		{
+			sprintf(escape, "\\u%04x", static_cast<unsigned char>(*char_iter));
+			output_stream << escape;
+		}
+		else
+		{
+			output_stream << *char_iter;
+		}
+	}
+	output_stream << '"';
+}
+
+// POST: value has been written with the fewest digits that read back the 
+//       same double. null if it is not finite
+static void _write_json_number
+(
+	ostream & output_stream,
+	const double & value
+)
+{
+	char number[32];
+
+	if (! std::isfinite(value))
+	{
+		output_stream << "null";
+		return;
+	}
+
+	sprintf(number, "%.15g", value);
+	if (strtod(number, 0) != value)
+	{
+		sprintf(number, "%.17g", value);
+	}
+
+	output_stream << number;
+}
+
+// POST: value has been written as 8 little-endian bytes
+static void _write_uint64
+(
+	ostream & output_stream,
+	unsigned long long value
+)
+{
+	char bytes[8];
+	int index;
+
+	for (index = 0; index < 8; index++)
+	{
+		bytes[index] = static_cast<char>((value >> (8 * index)) & 0xff);
+	}
+
+	output_stream.write(bytes, 8);
+}
+
+// POST: value has been written as a little-endian IEEE double
+static void _write_float64
+(
+	ostream & output_stream,
+	const double & value
+)
+{
+	unsigned long long bits;
+
+	assert(sizeof(bits) == sizeof(value));
+	memcpy(&bits, &value, sizeof(bits));
+
+	_write_uint64(output_stream, bits);
+}
+
+// RETURNS: the distribution of the delay level, all 0 if the sequential 
+//          level does not reach it
+static DISTRIBUTION _get_distribution
+(
+	const DISTRIBUTIONS & distributions,
+	const DELAY_TYPE & delay
+)
+{
+	if (static_cast<unsigned>(delay) < distributions.size())
+	{
+		return distributions[delay];
+	}
+	return DISTRIBUTION(distributions.size(), 0);
+}
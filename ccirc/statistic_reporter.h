@@ -25,7 +25,53 @@
 #include "circ.h"
 #include "circuit.h"
 #include "degree_info.h"
+#include "stats_plan.h"
+#include "profiler.h"
 #include <fstream>
+#include <utility>
+
+// every number in the stats by name. shapes and distributions give one 
+// metric per element named <name>[<index>], averages give <name> and
+// <name>_std_dev
+typedef pair<string, double> METRIC;
+typedef vector<METRIC> METRICS;
+
+// a shape or distribution of the stats, and a matrix as its rows
+typedef pair<string, DOUBLE_VECTOR> STATS_ARRAY;
+typedef vector<STATS_ARRAY> STATS_ARRAYS;
+typedef pair<string, vector<DOUBLE_VECTOR> > STATS_MATRIX;
+typedef vector<STATS_MATRIX> STATS_MATRICES;
+
+// the numbers of one part of the stats: the circuit, the cluster summary 
+// or one cluster
+struct STATS_SECTION
+{
+	string					name;
+	long					cluster_number;		// -1 if not a cluster
+	METRICS					scalars;
+	STATS_ARRAYS			arrays;
+	STATS_MATRICES			matrices;
+};
+typedef vector<STATS_SECTION> STATS_SECTIONS;
+
+//
+// The binary stats (--format bin), one record per circuit, little-endian:
+//
+//	char[8]		"CCIRCST3"
+//	uint64		name_size		bytes of the name, padded with '\0' to a multiple of 8
+//	uint64		nValues			float64s in the body
+//	char[name_size]	the circuit name
+//	float64[STATS_nSCALARS]	the scalars of STATS_SCALAR_NAMES, NaN if not measured
+//	float64[STATS_nARRAYS]	the length of each array of STATS_ARRAY_NAMES, 0 if not measured
+//	float64[...]	the elements of the arrays, one after the other
+//
+// so the body is numpy.frombuffer(record, '<f8', nValues, 24 + name_size).
+// only the circuit's own numbers are in it; the clusters are in the json.
+//
+extern const char * const STATS_SCALAR_NAMES[];
+extern const char * const STATS_ARRAY_NAMES[];
+extern const int STATS_nSCALARS;
+extern const int STATS_nARRAYS;
 
 //
 // Class_name STATISTIC_REPORTER
@@ -44,14 +90,33 @@ public:
 	~STATISTIC_REPORTER();
 
 	void report_stats(CIRCUIT * circuit);
+	void report_stats(CIRCUIT * circuit, ostream & output_stream);
+	void collect_stats(CIRCUIT * circuit, METRICS & metrics);
+
+	// the stats reported and the passes that ran. must be set before reporting
+	void set_stats_plan(STATS_PLAN * stats_plan) { m_stats_plan = stats_plan; }
 private:
 	CIRCUIT * 		m_circuit;
 	DEGREE_INFO * 	m_degree_info;
 
-	fstream m_output_file;
+	fstream m_stats_file;
+	ostream m_output_file;		// writes to m_stats_file or to the caller's stream
+	METRICS * m_metrics;		// if set, every number reported is also recorded here
+	STATS_PLAN * m_stats_plan;
+	STATS_SECTIONS m_sections;	// every number reported, by the section it is in
+	unsigned int m_section;		// the section being reported
+
+	void report_all_stats();
+	void report_formatted_stats(ostream & output_stream);
+	void begin_section(const string & name, const long & cluster_number);
+
+	void write_json(ostream & output_stream) const;
+	void write_json_section(ostream & output_stream, const STATS_SECTION & section, bool & is_first) const;
+	void write_binary(ostream & output_stream) const;
 
 	void report_global_stats();
 	void report_by_cluster_statistics();
+	void report_profile(const PROFILE_RECORDS & stages);
 	void report_degree_information(DEGREE_INFO * degree_info);
 	void report_shape_information(SEQUENTIAL_LEVELS & sequential_levels, DEGREE_INFO * degree_info);
 	void report_level_shape(SEQUENTIAL_LEVEL * seq_level, DEGREE_INFO * degree_info);
@@ -59,8 +124,14 @@ private:
 	void report_cluster(CLUSTER * cluster);
 	void report_cluster_size_distribution(CLUSTER * cluster);
 
-	void output_shape(const SHAPE & shape);
-	void output_distribution(const DISTRIBUTION & distribution);
+	template <class VALUE_TYPE> 
+	void output_value(const string & name, const VALUE_TYPE & value);
+	void output_average(const string & name, const double & average, const double & std_dev);
+	void output_shape(const string & name, const SHAPE & shape);
+	void output_distribution(const string & name, const DISTRIBUTION & distribution);
+	void record_metric(const string & name, const double & value);
+	bool is_reported(const string & name) const;
+	void record_matrix(const string & name, const MATRIX & matrix);
 
 	void report_inter_cluster_adjacency_matrix();
 
@@ -0,0 +1,419 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+#include "stats_plan.h"
+#include <algorithm>
+#include <mutex>
+
+// the passes each statistic needs. a statistic with nPASSES needs none 
+// beyond reading and freezing the circuit
+struct STATS_DEPENDENCY
+{
+	const char *		stat_name;
+	STATS_PLAN::PASS	pass;
+};
+
+static const STATS_DEPENDENCY STATS_DEPENDENCIES[] = 
+{
+	{"Number_of_Nodes",						STATS_PLAN::nPASSES},
+	{"Number_of_Edges",						STATS_PLAN::nPASSES},
+	{"Number_of_PI",						STATS_PLAN::nPASSES},
+	{"Number_of_PO",						STATS_PLAN::nPASSES},
+	{"Number_of_Combinational_Nodes",		STATS_PLAN::nPASSES},
+	{"Number_of_DFF",						STATS_PLAN::nPASSES},
+	{"kin",									STATS_PLAN::nPASSES},
+	{"Maximum_Delay",						STATS_PLAN::DELAY_PASS},
+	{"Wirelength_approx",					STATS_PLAN::WIRELENGTH_PASS},
+	{"Avg_fanin_comb",						STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanin_comb_std_dev",				STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanout",							STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanout_std_dev",					STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanout_comb",						STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanout_comb_std_dev",				STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanout_pi",						STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanout_pi_std_dev",				STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanout_dff",						STATS_PLAN::DEGREE_PASS},
+	{"Avg_fanout_dff_std_dev",				STATS_PLAN::DEGREE_PASS},
+	{"Maximum_fanout",						STATS_PLAN::DEGREE_PASS},
+	{"Number_of_high_degree_comb",			STATS_PLAN::DEGREE_PASS},
+	{"Number_of_high_degree_pi",			STATS_PLAN::DEGREE_PASS},
+	{"Number_of_high_degree_dff",			STATS_PLAN::DEGREE_PASS},
+	{"Number_of_10plus_degree_comb",		STATS_PLAN::DEGREE_PASS},
+	{"Number_of_10plus_degree_pi",			STATS_PLAN::DEGREE_PASS},
+	{"Number_of_10plus_degree_dff",			STATS_PLAN::DEGREE_PASS},
+	{"Reconvergence",						STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_max",					STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_min",					STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_error",					STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_sampled_pi",			STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_full",					STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_full_max",				STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_full_min",				STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_full_error",			STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_full_sampled_pi",		STATS_PLAN::RNUM_PASS},
+	{"Reconvergence_full_capped_pi",		STATS_PLAN::RNUM_PASS},
+	{"Node_shape",							STATS_PLAN::SHAPE_PASS},
+	{"Input_shape",							STATS_PLAN::SHAPE_PASS},
+	{"Output_shape",						STATS_PLAN::SHAPE_PASS},
+	{"Latched_shape",						STATS_PLAN::SHAPE_PASS},
+	{"POshape",								STATS_PLAN::SHAPE_PASS},
+	{"Edge_length_distribution",			STATS_PLAN::SHAPE_PASS},
+	{"Intra_cluster_edge_length_distribution",			STATS_PLAN::SHAPE_PASS},
+	{"Inter_cluster_input_edge_length_distribution",	STATS_PLAN::SHAPE_PASS},
+	{"Inter_cluster_output_edge_length_distribution",	STATS_PLAN::SHAPE_PASS},
+	{"Fanout_distribution",					STATS_PLAN::SHAPE_PASS},
+	{"Fanout_distribution",					STATS_PLAN::DEGREE_PASS},
+	{"Number_of_Clusters",					STATS_PLAN::PARTITION_PASS},
+	{"Inter_cluster_adjacency_matrix",		STATS_PLAN::PARTITION_PASS},
+	{"Cluster_summary",						STATS_PLAN::PARTITION_PASS},
+	{"Clusters",							STATS_PLAN::PARTITION_PASS},
+	{"Clusters",							STATS_PLAN::DEGREE_PASS},
+	{"Clusters",							STATS_PLAN::SHAPE_PASS}
+};
+static const int nSTATS_DEPENDENCIES = sizeof(STATS_DEPENDENCIES) / sizeof(STATS_DEPENDENCIES[0]);
+
+static const char * const PASS_NAMES[STATS_PLAN::nPASSES] = 
+{
+	"sanity", "delay", "partition", "degree", "wirelength", "rnum", "shape"
+};
+
+// seconds per edge of each pass on one thread, measured on a 100K node 
+// netlist_gen circuit with 2 partitions and the default options.  only
+// a guess for other circuits, the rnum above all, so the rates measured
+// in this process replace them
+static const double BUILT_IN_SECONDS_PER_EDGE[STATS_PLAN::nPASSES] = 
+{
+	8.5e-7, 2.1e-7, 3.5e-5, 1.8e-7, 2.2e-4, 3.2e-7, 1e-9
+};
+
+// the seconds per edge of each pass on the last circuit it ran on. 
+// < 0 until then.  shared by the circuits of a batch
+static mutex g_rates_mutex;
+static double g_measured_seconds_per_edge[STATS_PLAN::nPASSES] = {-1, -1, -1, -1, -1, -1, -1};
+
+//
+// PRE: g_options holds the options of the circuit to analyze
+// POST: the passes needed for the --stats, or all of them, are marked
+//
+STATS_PLAN::STATS_PLAN()
+{
+	assert(g_options);
+
+	vector<string>::const_iterator stat_iter;
+	int pass, 
+		index;
+	bool is_known;
+
+	for (pass = 0; pass < nPASSES; pass++)
+	{
+		m_is_needed[pass] = false;
+		m_is_skipped[pass] = false;
+		m_seconds[pass] = -1;
+	}
+
+	read_requested_stats(g_options->get_stats_list());
+
+	if (is_full())
+	{
+		for (pass = 0; pass < nPASSES; pass++)
+		{
+			add_pass(static_cast<PASS>(pass));
+		}
+	}
+
+	for (stat_iter = m_requested_stats.begin(); stat_iter != m_requested_stats.end(); stat_iter++)
+	{
+		is_known = false;
+		for (index = 0; index < nSTATS_DEPENDENCIES; index++)
+		{
+			if (*stat_iter == STATS_DEPENDENCIES[index].stat_name)
+			{
+				is_known = true;
+				if (STATS_DEPENDENCIES[index].pass != nPASSES)
+				{
+					add_pass(STATS_DEPENDENCIES[index].pass);
+				}
+			}
+		}
+
+		if (! is_known)
+		{
+			Warning("Unknown statistic '" << *stat_iter << "' in --stats.  Ignoring.");
+		}
+	}
+
+	// the incremental analysis reuses the levels and the reconvergence of 
+	// the previous circuit, so they are kept for every circuit
+	if (g_options->is_incremental() || g_options->is_verify_incremental())
+	{
+		add_pass(DELAY_PASS);
+		add_pass(RNUM_PASS);
+	}
+
+	// the drawing is laid out by delay level
+	if (g_options->is_draw_circuit())
+	{
+		add_pass(DELAY_PASS);
+	}
+
+	// the wirelength is measured cluster by cluster so it needs the one cluster at least
+	m_is_needed[WIRELENGTH_PASS] = m_is_needed[WIRELENGTH_PASS] && g_options->is_determine_wirelength_approx();
+	m_is_needed[PARTITION_PASS] = m_is_needed[PARTITION_PASS] && 
+									(g_options->get_nPartitions() > 1 || m_is_needed[WIRELENGTH_PASS]);
+
+	// what all the stats would have run with these options
+	for (pass = 0; pass < nPASSES; pass++)
+	{
+		m_is_skipped[pass] = ! m_is_needed[pass];
+	}
+	m_is_skipped[WIRELENGTH_PASS] = m_is_skipped[WIRELENGTH_PASS] && g_options->is_determine_wirelength_approx();
+	m_is_skipped[PARTITION_PASS] = m_is_skipped[PARTITION_PASS] && 
+									(g_options->get_nPartitions() > 1 || g_options->is_determine_wirelength_approx());
+}
+
+STATS_PLAN::STATS_PLAN(const STATS_PLAN & another_stats_plan)
+{
+	int pass;
+
+	m_requested_stats	= another_stats_plan.m_requested_stats;
+	m_pass_start		= another_stats_plan.m_pass_start;
+	for (pass = 0; pass < nPASSES; pass++)
+	{
+		m_is_needed[pass]	= another_stats_plan.m_is_needed[pass];
+		m_is_skipped[pass]	= another_stats_plan.m_is_skipped[pass];
+		m_seconds[pass]		= another_stats_plan.m_seconds[pass];
+	}
+}
+
+STATS_PLAN & STATS_PLAN::operator=(const STATS_PLAN & another_stats_plan)
+{
+	int pass;
+
+	m_requested_stats	= another_stats_plan.m_requested_stats;
+	m_pass_start		= another_stats_plan.m_pass_start;
+	for (pass = 0; pass < nPASSES; pass++)
+	{
+		m_is_needed[pass]	= another_stats_plan.m_is_needed[pass];
+		m_is_skipped[pass]	= another_stats_plan.m_is_skipped[pass];
+		m_seconds[pass]		= another_stats_plan.m_seconds[pass];
+	}
+
+	return (*this);
+}
+
+STATS_PLAN::~STATS_PLAN()
+{
+}
+
+//
+// RETURNS: true if stat_name, or the group of that name, is to be reported
+//
+bool STATS_PLAN::is_requested
+(
+	const string & stat_name
+) const
+{
+	return (is_full() || 
+			find(m_requested_stats.begin(), m_requested_stats.end(), stat_name) != m_requested_stats.end());
+}
+
+//
+// PRE: pass is needed
+// POST: the pass is being timed
+//
+void STATS_PLAN::start_pass
+(
+	const PASS & pass
+)
+{
+	assert(pass >= 0 && pass < nPASSES);
+	assert(m_is_needed[pass]);
+
+	m_pass_start = PASS_CLOCK::now();
+}
+
+//
+// PRE: start_pass(pass) was the last pass started
+// POST: the time since then has been added to the time of the pass
+//
+void STATS_PLAN::finish_pass
+(
+	const PASS & pass
+)
+{
+	assert(pass >= 0 && pass < nPASSES);
+
+	m_seconds[pass] = MAX(m_seconds[pass], 0.0) + 
+						chrono::duration<double>(PASS_CLOCK::now() - m_pass_start).count();
+}
+
+//
+// RETURNS: the name of pass
+//
+const char * STATS_PLAN::get_pass_name
+(
+	const PASS & pass
+)
+{
+	assert(pass >= 0 && pass < nPASSES);
+
+	return PASS_NAMES[pass];
+}
+
+//
+// RETURNS: about how long pass would take on a circuit of nEdges edges.
+//          is_measured is false if the rate is the built-in one
+//
+double STATS_PLAN::get_estimated_seconds
+(
+	const PASS & pass,
+	const NUM_ELEMENTS & nEdges,
+	bool & is_measured
+) const
+{
+	unique_lock<mutex> lock(g_rates_mutex);
+
+	assert(pass >= 0 && pass < nPASSES);
+
+	is_measured = g_measured_seconds_per_edge[pass] >= 0;
+
+	return (is_measured ? g_measured_seconds_per_edge[pass] : BUILT_IN_SECONDS_PER_EDGE[pass]) * nEdges;
+}
+
+//
+// POST: the seconds per edge of each pass that ran have been kept for the
+//       estimates of the next circuits.  if --stats was given, the time 
+//       of each pass that ran has been logged, and the estimated time of
+//       those that were skipped
+//
+void STATS_PLAN::report_pass_times
+(
+	const NUM_ELEMENTS & nEdges
+) const
+{
+	int pass;
+	double total_seconds = 0,
+		   saved_seconds = 0,
+		   estimated_seconds = 0;
+	bool is_measured = false;
+
+	if (nEdges > 0)
+	{
+		unique_lock<mutex> lock(g_rates_mutex);
+
+		for (pass = 0; pass < nPASSES; pass++)
+		{
+			if (m_seconds[pass] >= 0)
+			{
+				g_measured_seconds_per_edge[pass] = m_seconds[pass] / nEdges;
+			}
+		}
+	}
+
+	if (g_options->get_stats_list().empty())
+	{
+		return;
+	}
+
+	for (pass = 0; pass < nPASSES; pass++)
+	{
+		if (m_seconds[pass] >= 0)
+		{
+			Log("stats: the " << PASS_NAMES[pass] << " pass took " << m_seconds[pass] << " s");
+			total_seconds += m_seconds[pass];
+		}
+		else if (m_is_skipped[pass])
+		{
+			estimated_seconds = get_estimated_seconds(static_cast<PASS>(pass), nEdges, is_measured);
+			Log("stats: the " << PASS_NAMES[pass] << " pass was skipped, saving about " << estimated_seconds << 
+				" s (" << (is_measured ? "as measured on an earlier circuit" : "a built-in guess") << ")");
+			saved_seconds += estimated_seconds;
+		}
+		else
+		{
+			Log("stats: the " << PASS_NAMES[pass] << " pass was not asked for");
+		}
+	}
+
+	Log("stats: the passes took " << total_seconds << " s, skipping saved about " << saved_seconds << " s");
+}
+
+//
+// PRE: stats_list is a comma separated list of statistics, "all" or empty
+// POST: m_requested_stats holds the statistics of the list. empty for all
+//
+void STATS_PLAN::read_requested_stats
+(
+	const string & stats_list
+)
+{
+	string::size_type start = 0,
+					  end = 0;
+	string stat_name;
+
+	m_requested_stats.clear();
+
+	while (start < stats_list.size())
+	{
+		end = stats_list.find(',', start);
+		if (end == string::npos)
+		{
+			end = stats_list.size();
+		}
+
+		stat_name = stats_list.substr(start, end - start);
+		stat_name.erase(0, stat_name.find_first_not_of(" \t"));
+		stat_name.erase(stat_name.find_last_not_of(" \t") + 1);
+
+		if (stat_name == "all")
+		{
+			m_requested_stats.clear();
+			return;
+		}
+		if (! stat_name.empty())
+		{
+			m_requested_stats.push_back(stat_name);
+		}
+
+		start = end + 1;
+	}
+}
+
+//
+// POST: pass and the passes it needs are marked as needed
+//
+void STATS_PLAN::add_pass
+(
+	const PASS & pass
+)
+{
+	assert(pass >= 0 && pass < nPASSES);
+
+	m_is_needed[pass] = true;
+
+	switch (pass)
+	{
+	case SHAPE_PASS:
+	case PARTITION_PASS:
+		add_pass(DELAY_PASS);
+		break;
+	case WIRELENGTH_PASS:
+		add_pass(PARTITION_PASS);
+		break;
+	default:
+		break;
+	}
+}
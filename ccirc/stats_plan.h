@@ -0,0 +1,79 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+#ifndef stats_plan_H
+#define stats_plan_H
+
+#include "circ.h"
+#include <chrono>
+
+//
+// Class_name STATS_PLAN
+//
+// Description
+//
+//	Decides which passes of the analysis to run for the statistics asked 
+//	for with --stats, and times the passes.
+//
+//	Each statistic depends on some passes and each pass on the passes 
+//	before it (STATS_DEPENDENCIES in stats_plan.cpp), so a short list of
+//	cheap statistics skips the shapes, the reconvergence and the wirelength.
+//	Without --stats every pass runs and every statistic is reported.
+//
+//	Besides the statistics reported there are three groups: 
+//	Cluster_summary, Clusters and Inter_cluster_adjacency_matrix.
+//
+//	A pass that --stats skips is given an estimated cost, so the saving 
+//	shows at run time: its seconds per edge as last measured on a circuit
+//	of this process, or a built-in rate before it has been measured.
+//
+
+class STATS_PLAN
+{
+public:
+	enum PASS {SANITY_PASS, DELAY_PASS, PARTITION_PASS, DEGREE_PASS, WIRELENGTH_PASS, 
+				RNUM_PASS, SHAPE_PASS, nPASSES};
+
+	STATS_PLAN();
+	STATS_PLAN(const STATS_PLAN & another_stats_plan);
+	STATS_PLAN & operator=(const STATS_PLAN & another_stats_plan);
+	~STATS_PLAN();
+
+	bool	is_full() const { return m_requested_stats.empty(); }
+	bool	is_needed(const PASS & pass) const { return m_is_needed[pass]; }
+	bool	is_skipped(const PASS & pass) const { return m_is_skipped[pass]; }
+	bool	is_requested(const string & stat_name) const;
+
+	static const char * get_pass_name(const PASS & pass);
+	double	get_estimated_seconds(const PASS & pass, const NUM_ELEMENTS & nEdges, bool & is_measured) const;
+
+	void	start_pass(const PASS & pass);
+	void	finish_pass(const PASS & pass);
+	void	report_pass_times(const NUM_ELEMENTS & nEdges) const;
+private:
+	typedef chrono::steady_clock PASS_CLOCK;
+
+	vector<string>			m_requested_stats;	// empty for all of them
+	bool					m_is_needed[nPASSES];
+	bool					m_is_skipped[nPASSES];	// would run for all the stats, but not for --stats
+	double					m_seconds[nPASSES];	// how long each pass took. < 0 if it did not run
+	PASS_CLOCK::time_point	m_pass_start;
+
+	void read_requested_stats(const string & stats_list);
+	void add_pass(const PASS & pass);
+};
+
+#endif
@@ -19,9 +19,14 @@
 
 
 #include "symbol_table.h"
+#include <algorithm>
 
 SYMBOL_TABLE::SYMBOL_TABLE()
 {
+	m_nPorts		= 0;
+	m_nNodes		= 0;
+	m_front_port	= 0;
+	m_front_node	= 0;
 }
 
 SYMBOL_TABLE::SYMBOL_TABLE(const SYMBOL_TABLE & another_symbol_table)
@@ -41,120 +46,178 @@ SYMBOL_TABLE::~SYMBOL_TABLE()
 
 void SYMBOL_TABLE::insert_port
 (
-	const string & port_name,
+	const NAME_ID & port_name,
 	PORT * port
 )
 {	
-	debugif(DSYMBOL_TABLE,"Symbol Table: Inserting port name = '" << port_name << "'");
+	debugif(DSYMBOL_TABLE,"Symbol Table: Inserting port id = " << port_name);
+	assert(port_name >= 0 && port);
+
+	if (port_name >= static_cast<NAME_ID>(m_port_symbol_table.size()))
+	{
+		m_port_symbol_table.resize(port_name + 1, 0);
+	}
+	if (! m_port_symbol_table[port_name])
+	{
+		m_nPorts++;
+	}
 	m_port_symbol_table[port_name] = port;
+	m_front_port = min(m_front_port, port_name);
 }
 
 void SYMBOL_TABLE::insert_edge
 (
-	const string & edge_name,
+	const NAME_ID & output_port_name,
+	const NAME_ID & input_node_name,
 	EDGE * edge
 )
 {
-	debugif(DSYMBOL_TABLE,"Symbol Table: Inserting edge name = '" << edge_name << "'");
-	m_edge_symbol_table[edge_name] = edge;
+	debugif(DSYMBOL_TABLE,"Symbol Table: Inserting edge ids = " << output_port_name 
+			<< ", " << input_node_name);
+	m_edge_symbol_table[get_edge_key(output_port_name, input_node_name)] = edge;
 }
 
 void SYMBOL_TABLE::insert_node
 (
-	const string & node_name,
+	const NAME_ID & node_name,
 	NODE * node
 )
 {
-	debugif(DSYMBOL_TABLE,"Symbol Table: Inserting node name = '" << node_name << "'");
+	debugif(DSYMBOL_TABLE,"Symbol Table: Inserting node id = " << node_name);
+	assert(node_name >= 0 && node);
+
+	if (node_name >= static_cast<NAME_ID>(m_node_symbol_table.size()))
+	{
+		m_node_symbol_table.resize(node_name + 1, 0);
+	}
+	if (! m_node_symbol_table[node_name])
+	{
+		m_nNodes++;
+	}
 	m_node_symbol_table[node_name] = node;
+	m_front_node = min(m_front_node, node_name);
 }
 
 PORT *	 SYMBOL_TABLE::query_for_port
 (
-	const string & port_name
-)
+	const NAME_ID & port_name
+) const
 {
-	debugif(DSYMBOL_TABLE,"Symbol Table: Query for port name = '" << port_name << "'");
-	return m_port_symbol_table[port_name];
+	debugif(DSYMBOL_TABLE,"Symbol Table: Query for port id = " << port_name);
+	assert(port_name >= 0);
+
+	if (port_name < static_cast<NAME_ID>(m_port_symbol_table.size()))
+	{
+		return m_port_symbol_table[port_name];
+	}
+	return 0;
 }
 
 EDGE *	 SYMBOL_TABLE::query_for_edge
 (
-	const string & edge_name
-)
+	const NAME_ID & output_port_name,
+	const NAME_ID & input_node_name
+) const
 {
-	debugif(DSYMBOL_TABLE,"Symbol Table: Query for edge name = '" << edge_name << "'");
-	return m_edge_symbol_table[edge_name];
+	EDGE_HASH_TABLE::const_iterator edge_iter;
+
+	debugif(DSYMBOL_TABLE,"Symbol Table: Query for edge ids = " << output_port_name 
+			<< ", " << input_node_name);
+	edge_iter = m_edge_symbol_table.find(get_edge_key(output_port_name, input_node_name));
+
+	return (edge_iter == m_edge_symbol_table.end() ? 0 : edge_iter->second);
 }
 
 NODE *	 SYMBOL_TABLE::query_for_node
 (
-	const string & node_name
-)
+	const NAME_ID & node_name
+) const
 {
-	debugif(DSYMBOL_TABLE,"Symbol Table: Query for node name = '" << node_name << "'");
-	return m_node_symbol_table[node_name];
+	debugif(DSYMBOL_TABLE,"Symbol Table: Query for node id = " << node_name);
+	assert(node_name >= 0);
+
+	if (node_name < static_cast<NAME_ID>(m_node_symbol_table.size()))
+	{
+		return m_node_symbol_table[node_name];
+	}
+	return 0;
 }
 
 void SYMBOL_TABLE::remove_port
 (
-	const string & port_name
+	const NAME_ID & port_name
 )
 {	
-	PORT_HASH_TABLE_ITER port_to_remove;
-	
-	debugif(DSYMBOL_TABLE,"Symbol Table::Removing port name = '" << port_name << "'");
-	debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_port == DEBUG");
-	port_to_remove = m_port_symbol_table.find(port_name);
-	if (port_to_remove == m_port_symbol_table.end()){
+	debugif(DSYMBOL_TABLE,"Symbol Table::Removing port id = " << port_name);
+
+	if (query_for_port(port_name))
+	{
+		m_port_symbol_table[port_name] = 0;
+		m_nPorts--;
+	}
+	else
+	{
 		debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::port not found");
-	}else{
-		debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_port Table size == "<< m_port_symbol_table.size());
-		if (m_port_symbol_table.size()) m_port_symbol_table.erase(port_to_remove); //risky, 2021/5/6, don't understand why segmentation error
-		debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_port == DEBUG");
 	}
-	
 }
  
 void SYMBOL_TABLE::remove_edge
 (
-	const string & edge_name
+	const NAME_ID & output_port_name,
+	const NAME_ID & input_node_name
 )
 {
-	EDGE_HASH_TABLE_ITER edge_to_remove;
-
-	debugif(DSYMBOL_TABLE,"Symbol Table::Removing edge name = '" << edge_name << "'");
-	debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_edge == DEBUG");
-	edge_to_remove = m_edge_symbol_table.find(edge_name);
-	debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_edge Table size == "<< m_edge_symbol_table.size());
-	if (m_edge_symbol_table.size()) m_edge_symbol_table.erase(edge_to_remove);
-	debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_edge == DEBUG");
+	debugif(DSYMBOL_TABLE,"Symbol Table::Removing edge ids = " << output_port_name 
+			<< ", " << input_node_name);
+	m_edge_symbol_table.erase(get_edge_key(output_port_name, input_node_name));
 }
 
 void SYMBOL_TABLE::remove_node
 (
-	const string & node_name
+	const NAME_ID & node_name
 )
 {
-	NODE_HASH_TABLE_ITER node_to_remove;
+	debugif(DSYMBOL_TABLE,"Symbol Table::Removing node id = " << node_name);
 
-	debugif(DSYMBOL_TABLE,"Symbol Table::Removing node name = '" << node_name << "'");
-	debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_node == DEBUG");
-	node_to_remove = m_node_symbol_table.find(node_name);
-	debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_node Table size == "<< m_node_symbol_table.size());
-	if (m_node_symbol_table.size()) m_node_symbol_table.erase(node_to_remove);
-	debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::remove_node == DEBUG");
+	if (query_for_node(node_name))
+	{
+		m_node_symbol_table[node_name] = 0;
+		m_nNodes--;
+	}
+	else
+	{
+		debugif(DSYMBOL_TABLE,"SYMBOL_TABLE::node not found");
+	}
 }
 
+//
+// PRE: the table is not empty
+// RETURNS: the node with the lowest name id
+//
 NODE *	SYMBOL_TABLE::front_node()
 {
-	return (*m_node_symbol_table.begin()).second;
+	assert(! empty_of_nodes());
+
+	while (! m_node_symbol_table[m_front_node])
+	{
+		m_front_node++;
+	}
+	return m_node_symbol_table[m_front_node];
 }
 
+//
+// PRE: the table is not empty
+// RETURNS: the port with the lowest name id
+//
 PORT * 	SYMBOL_TABLE::front_port()
 {
+	assert(! empty_of_ports());
 
-	return (*m_port_symbol_table.begin()).second;
+	while (! m_port_symbol_table[m_front_port])
+	{
+		m_front_port++;
+	}
+	return m_port_symbol_table[m_front_port];
 }
 
 EDGE * 	SYMBOL_TABLE::front_edge()
@@ -164,12 +227,14 @@ EDGE * 	SYMBOL_TABLE::front_edge()
 
 void	SYMBOL_TABLE::pop_front_node()
 {
-	m_node_symbol_table.erase(m_node_symbol_table.begin());
+	front_node();
+	remove_node(m_front_node);
 }
 
 void	SYMBOL_TABLE::pop_front_port()
 {
-	m_port_symbol_table.erase(m_port_symbol_table.begin());
+	front_port();
+	remove_port(m_front_port);
 }
 
 void	SYMBOL_TABLE::pop_front_edge()
@@ -177,16 +242,17 @@ void	SYMBOL_TABLE::pop_front_edge()
 	m_edge_symbol_table.erase(m_edge_symbol_table.begin());
 }
 
-bool	SYMBOL_TABLE::empty_of_nodes()
-{
-	return m_node_symbol_table.empty();
-}
-bool	SYMBOL_TABLE::empty_of_ports()
+//
+// RETURNS: the key of the edge from the output port to the input node
+//
+EDGE_KEY SYMBOL_TABLE::get_edge_key
+(
+	const NAME_ID & output_port_name,
+	const NAME_ID & input_node_name
+) const
 {
-	return m_port_symbol_table.empty();
-}
+	assert(output_port_name >= 0 && input_node_name >= 0);
 
-bool	SYMBOL_TABLE::empty_of_edges()
-{
-	return m_edge_symbol_table.empty();
+	return (static_cast<EDGE_KEY>(output_port_name) << 32) | 
+			static_cast<EDGE_KEY>(input_node_name);
 }
@@ -23,7 +23,6 @@
 #define symbol_H
 
 #include "circ.h"
-//#include <hash_map>
 #include <functional>
 #include <unordered_map>
 
@@ -33,42 +32,18 @@
 // Description
 //
 //	Contains information during graph construction.
-//	Based on hash_map from the stl library.
 //
-//	If you are trying to compile this for VC++ and do not have 
-//	access to the hash_map class please download and use STLport.
+//	Ports and nodes are found by the id of their name in the circuit's
+//	name pool, so the port and node tables are vectors indexed by id.
+//	Edges are found by the pair (source port name id, sink node name id).
 //	
 
+typedef unsigned long long EDGE_KEY;
 
-//#ifndef VISUAL_C
-# if 0
-template <>
-class std::hash<string>
-{
-	public:
-		size_t operator()(const string &str) const
-		{
-			hash<char const *> h;
-
-			return (h(str.c_str()));
-		}
-};
-#endif
-
-struct eqstr
-{
-	bool operator()(const string& s1, const string& s2) const
-	{
-		return (s1 == s2);
-	}
-};
-
-typedef unordered_map<string, PORT *, hash<string>, eqstr> PORT_HASH_TABLE;
-typedef unordered_map<string, EDGE *, hash<string>, eqstr> EDGE_HASH_TABLE;
-typedef unordered_map<string, NODE *, hash<string>, eqstr> NODE_HASH_TABLE;
+typedef vector<PORT *> PORT_ID_TABLE;
+typedef vector<NODE *> NODE_ID_TABLE;
+typedef unordered_map<EDGE_KEY, EDGE *, hash<EDGE_KEY> > EDGE_HASH_TABLE;
 
-typedef PORT_HASH_TABLE::iterator PORT_HASH_TABLE_ITER;
-typedef NODE_HASH_TABLE::iterator NODE_HASH_TABLE_ITER;
 typedef EDGE_HASH_TABLE::iterator EDGE_HASH_TABLE_ITER;
 
 class SYMBOL_TABLE
@@ -77,17 +52,19 @@ public:
 	SYMBOL_TABLE();
 	~SYMBOL_TABLE();
 
-	void	insert_port(const string & port_name, PORT * port);
-	void	insert_edge(const string & edge_name, EDGE * edge);
-	void	insert_node(const string & node_name, NODE * node);
+	void	insert_port(const NAME_ID & port_name, PORT * port);
+	void	insert_edge(const NAME_ID & output_port_name, const NAME_ID & input_node_name, 
+						EDGE * edge);
+	void	insert_node(const NAME_ID & node_name, NODE * node);
 
-	PORT *	query_for_port(const string & port_name);
-	EDGE *	query_for_edge(const string & edge_name);
-	NODE *	query_for_node(const string & node_name);
+	PORT *	query_for_port(const NAME_ID & port_name) const;
+	EDGE *	query_for_edge(const NAME_ID & output_port_name, 
+						const NAME_ID & input_node_name) const;
+	NODE *	query_for_node(const NAME_ID & node_name) const;
 
-	void	remove_port(const string & port_name);
-	void	remove_edge(const string & edge_name);
-	void	remove_node(const string & node_name);
+	void	remove_port(const NAME_ID & port_name);
+	void	remove_edge(const NAME_ID & output_port_name, const NAME_ID & input_node_name);
+	void	remove_node(const NAME_ID & node_name);
 
 	// Returns the first element in the symbol table
 	NODE *	front_node();
@@ -99,13 +76,21 @@ public:
 	void	pop_front_port();
 	void	pop_front_edge();
 
-	bool	empty_of_nodes();
-	bool	empty_of_ports();
-	bool	empty_of_edges();
+	bool	empty_of_nodes() const { return m_nNodes == 0; }
+	bool	empty_of_ports() const { return m_nPorts == 0; }
+	bool	empty_of_edges() const { return m_edge_symbol_table.empty(); }
 private:
-	PORT_HASH_TABLE		m_port_symbol_table;
+	PORT_ID_TABLE		m_port_symbol_table;
 	EDGE_HASH_TABLE		m_edge_symbol_table;
-	NODE_HASH_TABLE		m_node_symbol_table;
+	NODE_ID_TABLE		m_node_symbol_table;
+
+	NUM_ELEMENTS		m_nPorts;		// the number of non-null entries
+	NUM_ELEMENTS		m_nNodes;
+	NAME_ID				m_front_port;	// no entry is before these
+	NAME_ID				m_front_node;
+
+	EDGE_KEY	get_edge_key(const NAME_ID & output_port_name, 
+							const NAME_ID & input_node_name) const;
 
 	SYMBOL_TABLE(const SYMBOL_TABLE & another_symbol);
 	SYMBOL_TABLE & operator=(const SYMBOL_TABLE & another_symbol);
@@ -0,0 +1,234 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#include "thread_pool.h"
+#include "circ.h"
+#include "profiler.h"
+#include "util.h"
+#include <cassert>
+
+//
+// PRE: nThreads is the number of threads to use, < 1 for the default
+// POST: the threads besides the caller are waiting for work
+//
+THREAD_POOL::THREAD_POOL
+(
+	int nThreads
+)
+{
+	int thread_index = 0;
+
+	m_generation = 0;
+	m_nBusy_threads = 0;
+	m_is_stopping = false;
+	m_task = 0;
+	m_options = 0;
+	m_profiler = 0;
+	m_nTasks = 0;
+	m_next_task = 0;
+
+	if (nThreads < 1)
+	{
+		nThreads = get_default_nThreads();
+	}
+
+	for (thread_index = 1; thread_index < nThreads; thread_index++)
+	{
+		m_threads.push_back(thread(&THREAD_POOL::wait_for_work, this, thread_index));
+	}
+}
+
+THREAD_POOL::THREAD_POOL(const THREAD_POOL & another_thread_pool)
+{
+	// the threads can't be copied
+	assert(false);
+
+	m_generation = 0;
+	m_nBusy_threads = 0;
+	m_is_stopping = false;
+	m_task = 0;
+	m_options = 0;
+	m_profiler = 0;
+	m_nTasks = 0;
+	m_next_task = 0;
+}
+
+THREAD_POOL & THREAD_POOL::operator=(const THREAD_POOL & another_thread_pool)
+{
+	assert(false);
+
+	return (*this);
+}
+
+THREAD_POOL::~THREAD_POOL()
+{
+	vector<thread>::iterator thread_iter;
+
+	{
+		unique_lock<mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_work_ready.notify_all();
+
+	for (thread_iter = m_threads.begin(); thread_iter != m_threads.end(); thread_iter++)
+	{
+		thread_iter->join();
+	}
+}
+
+//
+// RETURNS: the number of hardware threads, at least 1
+//
+int THREAD_POOL::get_default_nThreads()
+{
+	unsigned int nHardware_threads = thread::hardware_concurrency();
+
+	return (nHardware_threads > 0 ? static_cast<int>(nHardware_threads) : 1);
+}
+
+//
+// Run task(task_index, thread_index) for every task_index in [0, nTasks)
+//
+// PRE: task is safe to call from several threads at once
+// POST: every task has been run 
+//       or the first exception thrown by a task has been rethrown
+//
+void THREAD_POOL::run
+(
+	const NUM_ELEMENTS & nTasks,
+	const TASK & task
+)
+{
+	exception_ptr failure;
+
+	if (nTasks <= 0)
+	{
+		return;
+	}
+
+	{
+		unique_lock<mutex> lock(m_mutex);
+
+		m_task = &task;
+		m_options = g_options;
+		m_profiler = g_profiler;
+		m_nTasks = nTasks;
+		m_next_task = 0;
+		m_failure = exception_ptr();
+		m_nBusy_threads = static_cast<int>(m_threads.size());
+		m_generation++;
+	}
+	m_work_ready.notify_all();
+
+	do_tasks(0);
+
+	{
+		unique_lock<mutex> lock(m_mutex);
+
+		while (m_nBusy_threads > 0)
+		{
+			m_work_done.wait(lock);
+		}
+
+		m_task = 0;
+		failure = m_failure;
+	}
+
+	if (failure)
+	{
+		rethrow_exception(failure);
+	}
+}
+
+//
+// The loop of each thread besides the caller
+//
+void THREAD_POOL::wait_for_work
+(
+	int thread_index
+)
+{
+	unsigned int generation_done = 0;
+	double start_cpu_seconds = 0;
+
+	for (;;)
+	{
+		{
+			unique_lock<mutex> lock(m_mutex);
+
+			while (! m_is_stopping && m_generation == generation_done)
+			{
+				m_work_ready.wait(lock);
+			}
+
+			if (m_is_stopping)
+			{
+				return;
+			}
+			generation_done = m_generation;
+			g_options = m_options;
+			g_profiler = m_profiler;
+		}
+
+		// the caller's stages count the cpu time of the pool too
+		start_cpu_seconds = g_profiler ? util_thread_cputime() : 0;
+		do_tasks(thread_index);
+		if (g_profiler)
+		{
+			g_profiler->add_pool_cpu(util_thread_cputime() - start_cpu_seconds);
+		}
+
+		{
+			unique_lock<mutex> lock(m_mutex);
+
+			m_nBusy_threads--;
+		}
+		m_work_done.notify_one();
+	}
+}
+
+//
+// Take tasks until there are none left
+//
+void THREAD_POOL::do_tasks
+(
+	int thread_index
+)
+{
+	NUM_ELEMENTS task_index = 0;
+
+	for (task_index = m_next_task++; task_index < m_nTasks; task_index = m_next_task++)
+	{
+		try
+		{
+			(*m_task)(task_index, thread_index);
+		}
+		catch (...)
+		{
+			unique_lock<mutex> lock(m_mutex);
+
+			if (! m_failure)
+			{
+				m_failure = current_exception();
+			}
+			// skip whatever is left
+			m_next_task = m_nTasks;
+		}
+	}
+}
@@ -0,0 +1,95 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef thread_pool_H
+#define thread_pool_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+using namespace std;
+#include "types.h"
+
+class OPTIONS;
+class PROFILER;
+
+//
+// Class_name THREAD_POOL
+//
+// Description
+//
+//	Runs a number of independent tasks on a fixed set of threads.  
+//
+//	The calling thread is thread 0 and works on the tasks too, so a pool 
+//	of one thread runs everything in the caller.  Each task is handed its 
+//	index and the index of the thread running it so that tasks can use 
+//	per-thread scratch space without locking.  Tasks are taken in index 
+//	order but finish in any order: a task must only write what belongs 
+//	to its own index if the result is to be the same for any number of 
+//	threads.
+//
+//	If a task throws, the remaining tasks are skipped and the first 
+//	exception is rethrown by run().
+//
+//	g_options is per thread, so that each circuit of a batch can have its
+//	own.  The threads of the pool take the caller's for the tasks of each run(),
+//	and the caller's g_profiler.
+//
+
+class THREAD_POOL
+{
+public:
+	typedef function<void(NUM_ELEMENTS task_index, int thread_index)> TASK;
+
+	THREAD_POOL(int nThreads);
+	THREAD_POOL(const THREAD_POOL & another_thread_pool);
+	THREAD_POOL & operator=(const THREAD_POOL & another_thread_pool);
+	~THREAD_POOL();
+
+	int		get_nThreads() const { return static_cast<int>(m_threads.size()) + 1; }
+	void	run(const NUM_ELEMENTS & nTasks, const TASK & task);
+
+	// the number of threads to use when none was asked for
+	static int	get_default_nThreads();
+private:
+	vector<thread>			m_threads;			// the threads besides the caller
+
+	mutex					m_mutex;
+	condition_variable		m_work_ready;
+	condition_variable		m_work_done;
+	unsigned int			m_generation;		// counts the calls to run()
+	int						m_nBusy_threads;
+	bool					m_is_stopping;
+
+	const TASK *			m_task;
+	OPTIONS *				m_options;			// the caller's g_options
+	PROFILER *				m_profiler;			// and g_profiler
+	NUM_ELEMENTS			m_nTasks;
+	atomic<NUM_ELEMENTS>	m_next_task;
+	exception_ptr			m_failure;
+
+	void	wait_for_work(int thread_index);
+	void	do_tasks(int thread_index);
+};
+
+#endif
@@ -0,0 +1,220 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#include "traversal.h"
+#include <algorithm>
+#include <cassert>
+
+atomic<VISIT_EPOCH> NODE_VISITS::s_last_epoch(0);
+
+//
+// PRE: default_colour is the colour of a node this traversal hasn't coloured
+// POST: no node has been coloured by this traversal
+//
+NODE_VISITS::NODE_VISITS
+(
+	const NODE::COLOUR_TYPE & default_colour
+)
+{
+	m_default_colour = default_colour;
+	restart();
+}
+
+NODE_VISITS::NODE_VISITS(const NODE_VISITS & another_node_visits)
+{
+	// two traversals can't share an epoch
+	assert(false);
+
+	m_default_colour = another_node_visits.m_default_colour;
+	restart();
+}
+
+NODE_VISITS & NODE_VISITS::operator=(const NODE_VISITS & another_node_visits)
+{
+	assert(false);
+
+	m_default_colour = another_node_visits.m_default_colour;
+	restart();
+
+	return (*this);
+}
+
+NODE_VISITS::~NODE_VISITS()
+{
+}
+
+//
+// POST: every node has the default colour
+//
+void NODE_VISITS::restart()
+{
+	m_epoch = ++s_last_epoch;
+}
+
+//
+// Colour this node and the nodes up from it, stopping at nodes that
+// already have the colour
+//
+// PRE: node is valid
+// POST: all nodes up from this node have the colour
+// RETURNS: the number of nodes coloured
+//
+NUM_ELEMENTS NODE_VISITS::colour_up_from_node
+(
+	NODE * node,
+	const NODE::COLOUR_TYPE & colour
+)
+{
+	NUM_ELEMENTS number_nodes = 0;
+	NUM_ELEMENTS port_index;
+	NODE * output_node;
+
+	assert(node);
+	if (get_colour(node) == colour)
+	{
+		return 0;
+	}
+
+	set_colour(node, colour);
+	m_stack.clear();
+	m_stack.push_back(node);
+
+	while (! m_stack.empty())
+	{
+		node = m_stack.back();
+		m_stack.pop_back();
+		number_nodes++;
+
+		for (port_index = 0; port_index < node->get_fanin_degree(); port_index++)
+		{
+			assert(node->get_input_port(port_index));
+			output_node = node->get_input_port(port_index)->get_node_that_fanout_to_me();
+
+			if (output_node && get_colour(output_node) != colour)
+			{
+				set_colour(output_node, colour);
+				m_stack.push_back(output_node);
+			}
+		}
+	}
+
+	return number_nodes;
+}
+
+//
+// Colour the nodes down from this output port, stopping at nodes that 
+// already have the colour
+//
+// PRE: output_port is valid
+// POST: all nodes down from this output port have the colour
+// RETURNS: the number of nodes coloured
+//
+NUM_ELEMENTS NODE_VISITS::colour_down_from_port
+(
+	PORT * output_port,
+	const NODE::COLOUR_TYPE & colour
+)
+{
+	NUM_ELEMENTS number_nodes = 0;
+	NUM_ELEMENTS edge_index;
+	NODE * node;
+
+	assert(output_port);
+	m_stack.clear();
+
+	while (output_port)
+	{
+		for (edge_index = 0; edge_index < output_port->get_nEdges(); edge_index++)
+		{
+			assert(output_port->get_edge(edge_index));
+			node = output_port->get_edge(edge_index)->get_sink_node();
+			assert(node);
+
+			if (get_colour(node) != colour)
+			{
+				set_colour(node, colour);
+				m_stack.push_back(node);
+			}
+		}
+
+		output_port = 0;
+		if (! m_stack.empty())
+		{
+			node = m_stack.back();
+			m_stack.pop_back();
+			number_nodes++;
+
+			output_port = node->get_output_port();
+			assert(output_port);
+		}
+	}
+
+	return number_nodes;
+}
+
+
+INDEX_VISITS::INDEX_VISITS()
+{
+	m_epoch = 0;
+}
+
+INDEX_VISITS::INDEX_VISITS(const INDEX_VISITS & another_index_visits)
+{
+	m_epochs = another_index_visits.m_epochs;
+	m_epoch = another_index_visits.m_epoch;
+}
+
+INDEX_VISITS & INDEX_VISITS::operator=(const INDEX_VISITS & another_index_visits)
+{
+	m_epochs = another_index_visits.m_epochs;
+	m_epoch = another_index_visits.m_epoch;
+
+	return (*this);
+}
+
+INDEX_VISITS::~INDEX_VISITS()
+{
+}
+
+//
+// PRE: nNodes is the number of nodes in the frozen circuit
+// POST: no node is visited
+//
+void INDEX_VISITS::resize
+(
+	const NODE_INDEX & nNodes
+)
+{
+	m_epochs.assign(nNodes, 0);
+	m_epoch = 1;
+}
+
+//
+// POST: no node is visited
+//
+void INDEX_VISITS::restart()
+{
+	m_epoch++;
+
+	if (m_epoch == 0)
+	{
+		fill(m_epochs.begin(), m_epochs.end(), 0);
+		m_epoch = 1;
+	}
+}
@@ -0,0 +1,111 @@
+/*--------------------------------------------------------------------------*
+ * Copyright 2002 by Paul D. Kundarewich, Michael Hutton, Jonathan Rose     *
+ * and the University of Toronto. 											*
+ * Use is permitted, provided that this attribution is retained  			*
+ * and no part of the code is re-distributed or included in any commercial	*
+ * product except by written agreement with the above parties.              *
+ *                                                                          *
+ * For more information, contact us directly:                               *
+ *	  Paul D. Kundarewich (paul.kundarewich@utoronto.ca)					*
+ *    Jonathan Rose  (jayar@eecg.toronto.edu)                               *
+ *    Mike Hutton  (mdhutton@cs.toronto.edu, mdhutton@eecg.toronto.edu)     *
+ *    Department of Electrical and Computer Engineering                     *
+ *    University of Toronto, 10 King's College Rd.,                         *
+ *    Toronto, Ontario, CANADA M5S 1A4                                      *
+ *    Phone: (416) 978-6992  Fax: (416) 971-2286                            *
+ *--------------------------------------------------------------------------*/
+
+
+
+#ifndef traversal_H
+#define traversal_H
+
+#include <vector>
+#include <atomic>
+#include <utility>
+using namespace std;
+#include "types.h"
+#include "edges_and_nodes.h"
+
+// 
+// A depth-first walk down the fanout keeps the output port of each node 
+// on its path with the index of the next edge to follow from it.
+//
+typedef pair<PORT *, NUM_ELEMENTS> FANOUT_FRAME;
+typedef vector<FANOUT_FRAME> FANOUT_STACK;
+
+//
+// Class_name NODE_VISITS
+//
+// Description
+//
+//	The colours of the nodes for one traversal of the graph, so that a 
+//	pass doesn't have to colour the whole graph back before it starts.
+//
+//	Each traversal takes a new epoch and stamps the nodes it colours with 
+//	it.  A node stamped by any other traversal has the default colour, so
+//	starting over costs nothing however big the graph is.  Only one 
+//	traversal at a time can colour a node.
+//
+//	The graph is walked with explicit stacks rather than recursion so 
+//	that the depth of the logic is not limited by the depth of the stack.
+//
+
+class NODE_VISITS
+{
+public:
+	NODE_VISITS(const NODE::COLOUR_TYPE & default_colour);
+	NODE_VISITS(const NODE_VISITS & another_node_visits);
+	NODE_VISITS & operator=(const NODE_VISITS & another_node_visits);
+	~NODE_VISITS();
+
+	void				restart();		// every node has the default colour again
+
+	NODE::COLOUR_TYPE	get_colour(const NODE * node) const
+							{ return node->get_visit_epoch() == m_epoch ? node->get_colour() : m_default_colour; }
+	void				set_colour(NODE * node, const NODE::COLOUR_TYPE & colour) 
+							{ node->set_visit(m_epoch, colour); }
+
+	NUM_ELEMENTS		colour_up_from_node(NODE * node, const NODE::COLOUR_TYPE & colour);
+	NUM_ELEMENTS		colour_down_from_port(PORT * output_port, const NODE::COLOUR_TYPE & colour);
+
+private:
+	VISIT_EPOCH			m_epoch;
+	NODE::COLOUR_TYPE	m_default_colour;
+	NODES				m_stack;		// nodes still to explore
+
+	static atomic<VISIT_EPOCH>	s_last_epoch;
+};
+
+
+//
+// Class_name INDEX_VISITS
+//
+// Description
+//
+//	The visited marks of the nodes of a frozen circuit, which are 
+//	numbered, for one traversal at a time.  The marks are only cleared 
+//	when the epoch wraps around.
+//
+
+class INDEX_VISITS
+{
+public:
+	INDEX_VISITS();
+	INDEX_VISITS(const INDEX_VISITS & another_index_visits);
+	INDEX_VISITS & operator=(const INDEX_VISITS & another_index_visits);
+	~INDEX_VISITS();
+
+	void		resize(const NODE_INDEX & nNodes);	// also restarts
+	void		restart();							// no node is visited
+
+	NODE_INDEX	get_size() const { return static_cast<NODE_INDEX>(m_epochs.size()); }
+	bool		is_visited(const NODE_INDEX & node) const { return m_epochs[node] == m_epoch; }
+	void		visit(const NODE_INDEX & node) { m_epochs[node] = m_epoch; }
+
+private:
+	vector<unsigned>	m_epochs;
+	unsigned			m_epoch;
+};
+
+#endif
@@ -32,15 +32,19 @@
 using namespace std;
 
 typedef long NUM_ELEMENTS;
-typedef short DELAY_TYPE;
-typedef short LEVEL_TYPE;
+typedef int DELAY_TYPE;			// a combinational chain can be longer than a short
+typedef int LEVEL_TYPE;
 typedef short LUT_TYPE;
-typedef short LENGTH_TYPE;
+typedef int LENGTH_TYPE;			// the difference of two delays
 typedef short DEPTH_TYPE;
 typedef long CLUSTER_NUMBER_TYPE;
 typedef long ID_TYPE;
 typedef long LOCALITY;
 typedef double COST_TYPE;
+typedef int NODE_INDEX;			// the position of a node in a frozen circuit
+
+const NODE_INDEX NO_NODE_INDEX = -1;
+typedef unsigned long long VISIT_EPOCH;	// which traversal last coloured a node
 
 
 typedef vector<NUM_ELEMENTS> NUM_ELEMENTS_VECTOR;
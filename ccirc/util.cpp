@@ -26,6 +26,9 @@ using namespace std;
 #ifndef VISUAL_C
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <time.h>
 #else
 #include <time.h>
 #endif
@@ -155,6 +158,85 @@ int util_cputime(void)
     return cputime;
 }
 
+//
+//  Returns: the cpu time of the calling thread alone, in seconds.
+//           0 where we can't tell
+//
+double util_thread_cputime(void)
+{
+	double cputime = 0;
+
+#ifndef VISUAL_C
+	struct timespec thread_time;
+
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &thread_time) == 0)
+	{
+		cputime = thread_time.tv_sec + thread_time.tv_nsec / 1e9;
+	}
+#endif
+
+	return cputime;
+}
+
+//
+//  Returns: the memory the process has resident, in kB. 0 where we can't tell
+//
+long util_resident_kb(void)
+{
+	long resident_kb = 0;
+
+#ifndef VISUAL_C
+	FILE * statm_file = fopen("/proc/self/statm", "r");
+	long size_pages = 0,
+		 resident_pages = 0;
+
+	if (statm_file)
+	{
+		if (fscanf(statm_file, "%ld %ld", &size_pages, &resident_pages) == 2)
+		{
+			resident_kb = resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+		}
+		fclose(statm_file);
+	}
+#endif
+
+	return resident_kb;
+}
+
+//
+//  Returns: the most memory the process has had resident, in kB.  VmHWM
+//  is of this program only; ru_maxrss, taken when there's no /proc, 
+//  keeps the high-water mark of the parent that exec'd it.
+//
+long util_peak_resident_kb(void)
+{
+	long peak_kb = 0;
+
+#ifndef VISUAL_C
+	FILE * status_file = fopen("/proc/self/status", "r");
+	char line[256];
+	bool is_found = false;
+
+	if (status_file)
+	{
+		while (! is_found && fgets(line, sizeof(line), status_file))
+		{
+			is_found = (sscanf(line, "VmHWM: %ld", &peak_kb) == 1);
+		}
+		fclose(status_file);
+	}
+
+	if (! is_found)
+	{
+		struct rusage rusage;
+		(void) getrusage(RUSAGE_SELF, &rusage);
+		peak_kb = rusage.ru_maxrss;
+	}
+#endif
+
+	return peak_kb;
+}
+
 // RETURNS: the long number converted toa string
 string  util_long_to_string(const long & number)
 {
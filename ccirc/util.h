@@ -27,5 +27,8 @@ string	util_strip_file_extension(const string & file_name);
 string	util_time_string();
 long	util_ticks();
 int		util_cputime();
+double	util_thread_cputime();
+long	util_resident_kb();
+long	util_peak_resident_kb();
 string  util_long_to_string(const long & number);
 #endif
@@ -21,29 +21,77 @@
 
 #include "wirelength_character.h"
 #include <math.h>
+#include <map>
+#include <algorithm>
 #include "rand.h"
-
+#include "util.h"
+#include "thread_pool.h"
+#include "profiler.h"
+
+// the annealing schedule of each chain
+const NUM_ELEMENTS WL_TEMPERATURE_STEPS = 1000;	// each of as many moves as there are nodes
+const NUM_ELEMENTS WL_SHARING_STEPS = 20;		// steps between sharing the best chain
+const double WL_INITIAL_TEMPERATURE = 0.01;
+const double WL_MIN_TEMPERATURE = 1e-32;
+
+// the adaptive schedule, shaped after Lam and Delosme's.  their 0.44 counts
+// every move; counting only the moves that change the wirelength, 0.2 
+// anneals these netlists better
+const double WL_TARGET_ACCEPTANCE = 0.2;		// the rate held through the middle of the annealing
+const double WL_HEATING_END = 0.15;				// the fraction of the annealing spent falling to it
+const double WL_COOLING_START = 0.65;			// and when it starts to fall to nothing
+const double WL_TEMPERATURE_GAIN = 4.0;			// how hard the temperature chases the target
+const double WL_MAX_START_ACCEPTANCE = 0.95;	// of the uphill moves sampled for the initial temperature
+const double WL_MIN_RANGE = 1e-6;				// the fraction of a group a move may span
+
+// the analytic placement
+const NUM_ELEMENTS WL_ANALYTIC_ITERATIONS = 100;	// solves and legalizations at most
+const NUM_ELEMENTS WL_ANALYTIC_PATIENCE = 10;		// stop after as many without a better wirelength
+const double WL_ANCHOR_WEIGHT = 0.05;				// the pull to the last place, per iteration
 
 WIRELENGTH_CHARACTER::WIRELENGTH_CHARACTER()
 {
-	long seed = 0;
-	m_rand_number_gen = new RANDOM_NUMBER(seed);
+	m_circuit = 0;
+	m_width = 0;
+	m_cost_scale = 1.0;
+	m_is_adaptive = true;
+	m_start_progress = 0.0;
+	m_has_deadline = false;
+	m_nMoves = 0;
+	m_seconds = 0.0;
 }
 WIRELENGTH_CHARACTER::WIRELENGTH_CHARACTER(const WIRELENGTH_CHARACTER & another_wirelength_character)
 {
 	m_circuit	= another_wirelength_character.m_circuit;
+	m_width		= another_wirelength_character.m_width;
+	m_cost_scale = another_wirelength_character.m_cost_scale;
+	m_is_adaptive = another_wirelength_character.m_is_adaptive;
+	m_start_progress = another_wirelength_character.m_start_progress;
+	m_has_deadline = another_wirelength_character.m_has_deadline;
+	m_start		= another_wirelength_character.m_start;
+	m_deadline	= another_wirelength_character.m_deadline;
+	m_nMoves	= another_wirelength_character.m_nMoves;
+	m_seconds	= another_wirelength_character.m_seconds;
 }
 
 WIRELENGTH_CHARACTER & WIRELENGTH_CHARACTER::operator=(const WIRELENGTH_CHARACTER & another_wirelength_character)
 {
 	m_circuit	= another_wirelength_character.m_circuit;
+	m_width		= another_wirelength_character.m_width;
+	m_cost_scale = another_wirelength_character.m_cost_scale;
+	m_is_adaptive = another_wirelength_character.m_is_adaptive;
+	m_start_progress = another_wirelength_character.m_start_progress;
+	m_has_deadline = another_wirelength_character.m_has_deadline;
+	m_start		= another_wirelength_character.m_start;
+	m_deadline	= another_wirelength_character.m_deadline;
+	m_nMoves	= another_wirelength_character.m_nMoves;
+	m_seconds	= another_wirelength_character.m_seconds;
 
 	return (*this);
 }
 
 WIRELENGTH_CHARACTER::~WIRELENGTH_CHARACTER()
 {
-	delete m_rand_number_gen;
 }
 
 // Calculate the Wirelength-approx for the circuit
@@ -66,7 +114,16 @@ COST_TYPE  WIRELENGTH_CHARACTER::get_circuit_wirelength_approx
 
 	wirelength = get_wirelength_measurement();
 
-	iterate();
+	index_circuit();
+
+	if (g_options->get_wirelength_mode() != OPTIONS::WL_ANNEAL)
+	{
+		place_analytically();
+	}
+	if (g_options->get_wirelength_mode() != OPTIONS::WL_ANALYTIC)
+	{
+		iterate();
+	}
 
 	wirelength = get_wirelength_measurement();
 
@@ -231,514 +288,698 @@ COST_TYPE WIRELENGTH_CHARACTER::get_wirelength_measurement() const
 
 	return total_wirelength;
 }
-// performs a simulated anneal to try and lower the wirelengthapprox measured
+// Copy the circuit into the arrays the chains anneal
 //
 // PRE: nodes and primary inputs have their horizontal position defined
-// POST: the wirelengthapprox is hopefully lower
+// POST: every node and primary input is an item with its group and its wires
+//       m_cost_scale turns a wirelength into the normalized cost
 //
-void WIRELENGTH_CHARACTER::iterate()
+void WIRELENGTH_CHARACTER::index_circuit()
 {
+	map<NODE *, NUM_ELEMENTS> node_items;
+	map<PORT *, NUM_ELEMENTS> PI_items;
+	map<PORT *, NUM_ELEMENTS>::const_iterator PI_item_iter;
+	CLUSTERS& clusters = m_circuit->get_clusters();
+	CLUSTERS::iterator cluster_iter;
+	CLUSTER * cluster = 0;
+	DELAY_TYPE delay = 0;
+	NODES::const_iterator node_iter;
+	PORTS::const_iterator port_iter;
+	EDGES input_edges;
+	EDGES::const_iterator edge_iter;
+	EDGE * edge = 0;
+	NUM_ELEMENTS_VECTOR wire_sinks,
+						wire_sources,
+						next_wire;
+	NUM_ELEMENTS nNodes = 0,
+				 nItems = 0,
+				 nGroups = 0,
+				 item = 0,
+				 source = 0,
+				 index = 0;
+
 	m_nodes = m_circuit->get_nodes();
 	m_PI = m_circuit->get_PI();
-	m_clusters = m_circuit->get_clusters();
-
-	//print_wirelength_results();
-
-	double cost = get_cost(),
-				 lowest_cost = cost,
-				 changed_cost = 0;
-
-	NUM_ELEMENTS loops_without_display_of_lowest_cost = 0,
-				 inner_loops = 1,
-				 loops = 1;
-	const NUM_ELEMENTS final_iteratation_limit = static_cast<NUM_ELEMENTS>(m_nodes.size())*1000;
-	const NUM_ELEMENTS inner_loop_limit = static_cast<NUM_ELEMENTS>(m_nodes.size());
-
-	double random_number = 0.0;
-	double temperature = 0.01;
-	double success_rate = 0.0;
-	NUM_ELEMENTS number_success = 0;
-
 
-	debug("Initial cost is " << cost << endl);
+	nNodes = static_cast<NUM_ELEMENTS>(m_nodes.size());
+	for (item = 0; item < nNodes; item++)
+	{
+		node_items[m_nodes[item]] = item;
+	}
+	for (index = 0; index < static_cast<NUM_ELEMENTS>(m_PI.size()); index++)
+	{
+		PI_items[m_PI[index]] = nNodes + index;
+	}
 
-	while (cost > 0 && loops < final_iteratation_limit)
+	// the wires are the edges the measurement counts: into the nodes,
+	// except to the clock
+	for (item = 0; item < nNodes; item++)
 	{
-		while (inner_loops < inner_loop_limit)
+		input_edges = m_nodes[item]->get_input_edges_without_clock_edges();
+
+		for (edge_iter = input_edges.begin(); edge_iter != input_edges.end(); edge_iter++)
 		{
-			generate_move();
+			edge = *edge_iter;
+			assert(edge);
 
-			if (m_move.is_valid())
+			if (edge->get_source_node())
 			{
-				changed_cost = get_changed_cost(cost);
-
-				//debug("Changed cost is " << changed_cost);
-
-				random_number = m_rand_number_gen->random_double_number(1);
-
-				if (changed_cost <= 0.0 || random_number < exp(- changed_cost/temperature))
+				assert(node_items.find(edge->get_source_node()) != node_items.end());
+				source = node_items[edge->get_source_node()];
+			}
+			else
+			{
+				// a port outside the primary inputs keeps its place
+				PI_item_iter = PI_items.find(edge->get_source());
+				if (PI_item_iter == PI_items.end())
+				{
+					m_PI.push_back(edge->get_source());
+					source = nNodes + static_cast<NUM_ELEMENTS>(m_PI.size()) - 1;
+					PI_items[edge->get_source()] = source;
+				}
+				else
 				{
-					//debug("Making the move. Changed cost " << changed_cost);
-					number_success++;
+					source = PI_item_iter->second;
+				}
+			}
 
-					cost += changed_cost;
+			wire_sinks.push_back(item);
+			wire_sources.push_back(source);
+		}
+	}
+	nItems = nNodes + static_cast<NUM_ELEMENTS>(m_PI.size());
 
-					m_move.make_and_commit_move();
+	m_wire_offsets.assign(nItems + 1, 0);
+	for (index = 0; index < static_cast<NUM_ELEMENTS>(wire_sinks.size()); index++)
+	{
+		m_wire_offsets[wire_sinks[index] + 1]++;
+		m_wire_offsets[wire_sources[index] + 1]++;
+	}
+	for (item = 0; item < nItems; item++)
+	{
+		m_wire_offsets[item + 1] += m_wire_offsets[item];
+	}
+	next_wire.assign(m_wire_offsets.begin(), m_wire_offsets.end() - 1);
+	m_wires.resize(m_wire_offsets[nItems]);
+	for (index = 0; index < static_cast<NUM_ELEMENTS>(wire_sinks.size()); index++)
+	{
+		m_wires[next_wire[wire_sinks[index]]++] = wire_sources[index];
+		m_wires[next_wire[wire_sources[index]]++] = wire_sinks[index];
+	}
 
-					//debug("New cost is " << cost);
+	// the groups are the delay levels of each cluster.  the primary inputs
+	// share the 0th delay level with the flip-flops
+	m_item_groups.assign(nItems, -1);
+	for (cluster_iter = clusters.begin(); cluster_iter != clusters.end(); cluster_iter++)
+	{
+		cluster = *cluster_iter;
+		assert(cluster && cluster->get_sequential_level());
 
-					if (cost < lowest_cost)
-					{
+		const DELAY_LEVELS & delay_levels = cluster->get_sequential_level()->get_delay_levels();
+		const PORTS PI = cluster->get_PI();
 
-						lowest_cost = cost;
-						
-						loops_without_display_of_lowest_cost++;
-						if (loops_without_display_of_lowest_cost == 500)
-						{
-							cost = get_cost();
+		for (port_iter = PI.begin(); port_iter != PI.end(); port_iter++)
+		{
+			assert(PI_items.find(*port_iter) != PI_items.end());
+			m_item_groups[PI_items[*port_iter]] = nGroups;
+		}
 
-							assert(m_move.get_port_a() == 0 && m_move.get_port_b() == 0 && 
-									m_move.get_node_a() == 0 && m_move.get_node_b() == 0);
-							lowest_cost = cost;
-							loops_without_display_of_lowest_cost = 0;
-							debug("************************************* Lowest cost " << lowest_cost << " **********");
-							debug("*************************************************** Wirelengthapprox " << get_wirelength_measurement() << " **********");
-						}
-					}
-				}
+		for (delay = 0; delay < static_cast<DELAY_TYPE>(delay_levels.size()); delay++)
+		{
+			for (node_iter = delay_levels[delay].begin(); node_iter != delay_levels[delay].end(); node_iter++)
+			{
+				assert(node_items.find(*node_iter) != node_items.end());
+				m_item_groups[node_items[*node_iter]] = nGroups;
 			}
-				
-			inner_loops++;
-			loops++;
+			nGroups++;
 		}
+	}
 
-
-		success_rate = static_cast<double>(number_success)/static_cast<double>(inner_loop_limit);	
-
-		if (temperature > 1e-32)
+	// anything left over can't move
+	for (item = 0; item < nItems; item++)
+	{
+		if (m_item_groups[item] < 0)
 		{
-			update_temperature(temperature, success_rate, loops);
+			m_item_groups[item] = nGroups;
+			nGroups++;
 		}
-		number_success = 0;
-		inner_loops = 0;
 	}
 
-	debug("********************** Final lowest cost " << lowest_cost << " **********");
-	debug("********************** Final Wirelengthapprox " << get_wirelength_measurement() << " **********");
-}
+	m_group_offsets.assign(nGroups + 1, 0);
+	for (item = 0; item < nItems; item++)
+	{
+		m_group_offsets[m_item_groups[item] + 1]++;
+	}
+	for (index = 0; index < nGroups; index++)
+	{
+		m_group_offsets[index + 1] += m_group_offsets[index];
+	}
+	next_wire.assign(m_group_offsets.begin(), m_group_offsets.end() - 1);
+	m_group_items.resize(nItems);
+	for (item = 0; item < nItems; item++)
+	{
+		m_group_items[next_wire[m_item_groups[item]]++] = item;
+	}
 
+	m_cost_scale = static_cast<double>(m_width) * m_circuit->get_nEdges_without_clock_edges() * 16;
+}
 
-// generate a move 
-// 
-// PRE: nothing
-// POST: m_move contains a valid move
 //
-void WIRELENGTH_CHARACTER::generate_move()
+// POST: positions has the horizontal position of each item
+//
+void WIRELENGTH_CHARACTER::get_item_positions
+(
+	NUM_ELEMENTS_VECTOR & positions
+) const
 {
-	m_move.clear();
-
-	NUM_ELEMENTS choice = 0,
-				 size = 0;
-	PORT * pi_a = 0,
-		 * pi_b = 0;
-	NODE * node_a = 0,
-		 * node_b = 0;
-	NUM_ELEMENTS nNodes = static_cast<NUM_ELEMENTS>(m_nodes.size());
-	NUM_ELEMENTS nPI = static_cast<NUM_ELEMENTS>(m_PI.size());
-	PORTS PIs;
-
-	CLUSTER_NUMBER_TYPE cluster_number = 0;
-	DELAY_TYPE delay = 0;
-	CLUSTER * cluster = 0;
-	SEQUENTIAL_LEVEL * seq_level = 0;
-	DELAY_LEVELS delay_levels;
-	DELAY_LEVEL delay_level;
+	NUM_ELEMENTS nNodes = static_cast<NUM_ELEMENTS>(m_nodes.size()),
+				 item = 0;
 
-	size = nNodes + nPI;
-
-	choice = m_rand_number_gen->random_number(size-1);
-
-	assert(m_move.get_port_a() == 0 && m_move.get_port_b() == 0 && m_move.get_node_a() == 0 && 
-			m_move.get_node_b() == 0);
-
-	if (choice >= nNodes)
+	positions.resize(m_item_groups.size());
+	for (item = 0; item < static_cast<NUM_ELEMENTS>(positions.size()); item++)
 	{
-		// we have a primary input
-
-		choice -= nNodes;
-		assert(choice >= 0 && static_cast<unsigned>(choice) < m_PI.size());
-		pi_a = m_PI[choice];
-		assert(pi_a);
-		cluster_number = pi_a->get_cluster_number();
-		delay = 0;
-
-		m_move.set_port_a(pi_a);
+		positions[item] = (item < nNodes) ? m_nodes[item]->get_horizontal_position() :
+											m_PI[item - nNodes]->get_horizontal_position();
 	}
-	else
-	{
-		// we have only nodes at our delay level
-		assert(choice < nNodes);
-
-		node_a = m_nodes[choice];
-		assert(node_a);
+}
 
-		cluster_number = node_a->get_cluster_number();
-		delay = node_a->get_max_comb_delay_level();
+//
+// POST: the nodes and primary inputs are at the positions of their items
+//
+void WIRELENGTH_CHARACTER::set_item_positions
+(
+	const NUM_ELEMENTS_VECTOR & positions
+)
+{
+	NUM_ELEMENTS nNodes = static_cast<NUM_ELEMENTS>(m_nodes.size()),
+				 item = 0;
 
-		m_move.set_node_a(node_a);
+	assert(positions.size() == m_item_groups.size());
+	for (item = 0; item < static_cast<NUM_ELEMENTS>(positions.size()); item++)
+	{
+		if (item < nNodes)
+		{
+			m_nodes[item]->set_horizontal_position(positions[item]);
+		}
+		else
+		{
+			m_PI[item - nNodes]->set_horizontal_position(positions[item]);
+		}
 	}
+}
 
+// The slots of a group are its places from left to right, so nearby
+// slots are nearby places
+//
+// POST: slot_items has the items of each group in order of position
+//
+void WIRELENGTH_CHARACTER::get_slot_items
+(
+	const NUM_ELEMENTS_VECTOR & positions,
+	NUM_ELEMENTS_VECTOR & slot_items
+) const
+{
+	NUM_ELEMENTS group = 0;
 
+	slot_items = m_group_items;
+	for (group = 0; group + 1 < static_cast<NUM_ELEMENTS>(m_group_offsets.size()); group++)
+	{
+		sort(slot_items.begin() + m_group_offsets[group], slot_items.begin() + m_group_offsets[group + 1],
+			[&](const NUM_ELEMENTS & item_a, const NUM_ELEMENTS & item_b)
+			{
+				return positions[item_a] < positions[item_b] || 
+						(positions[item_a] == positions[item_b] && item_a < item_b);
+			});
+	}
+}
 
-	assert(cluster_number >= 0 && static_cast<unsigned>(cluster_number) < m_clusters.size());
-
-	cluster = m_clusters[cluster_number];
-	assert(cluster);
-
-	seq_level = cluster->get_sequential_level();
-	assert(seq_level);
-
-	delay_levels = seq_level->get_delay_levels();
-	assert(delay >= 0 && static_cast<unsigned>(delay) < delay_levels.size());
-	delay_level = delay_levels[delay];
-	nNodes = static_cast<unsigned>(delay_level.size());
+// Places the items without annealing.  Each iteration solves for the 
+// place of each item that is the least squared distance from the items 
+// it is wired to, and from its own last place by a weight that grows each
+// iteration so that the placement settles.  Each group is then sorted by 
+// those places into its slots, which spreads the items out again.
+//
+// PRE: the circuit is indexed. nodes and primary inputs have their horizontal position defined
+// POST: the nodes and primary inputs are at the places of the lowest wirelength
+//       found, a reordering of the places of each group
+//
+void WIRELENGTH_CHARACTER::place_analytically()
+{
+	THREAD_POOL thread_pool(MAX(1, g_options->get_nThreads()));
+	WIRELENGTH_CLOCK::time_point start = WIRELENGTH_CLOCK::now();
+	const NUM_ELEMENTS nItems = static_cast<NUM_ELEMENTS>(m_item_groups.size()),
+					   nGroups = static_cast<NUM_ELEMENTS>(m_group_offsets.size()) - 1,
+					   nBlocks = MIN(nItems, static_cast<NUM_ELEMENTS>(16 * thread_pool.get_nThreads()));
+	NUM_ELEMENTS_VECTOR positions,
+						best_positions,
+						slot_items,
+						slot_positions;
+	vector<double> targets(nItems, 0.0);
+	NUM_ELEMENTS iteration = 0,
+				 nIterations_without_gain = 0,
+				 slot = 0,
+				 wirelength = 0,
+				 best_wirelength = 0;
+	double anchor_weight = 0.0;
+
+	get_item_positions(positions);
+	get_slot_items(positions, slot_items);
+
+	slot_positions.resize(slot_items.size());
+	for (slot = 0; slot < static_cast<NUM_ELEMENTS>(slot_items.size()); slot++)
+	{
+		slot_positions[slot] = positions[slot_items[slot]];
+	}
 
+	best_positions = positions;
+	best_wirelength = get_wirelength(positions);
 
-	if (delay > 0)
+	for (iteration = 0; iteration < WL_ANALYTIC_ITERATIONS && nIterations_without_gain < WL_ANALYTIC_PATIENCE &&
+						best_wirelength > 0; iteration++)
 	{
-		choice = m_rand_number_gen->random_number(nNodes-1);
-		node_b = delay_level[choice];
-		assert(node_b);
+		PROFILE_SPAN span("analytic iteration");
+		anchor_weight = WL_ANCHOR_WEIGHT * iteration;
 
-		m_move.set_node_b(node_b);
-	}
-	else
-	{
-		assert(delay == 0);
+		// every target is found from the same positions
+		thread_pool.run(nBlocks, [&](NUM_ELEMENTS block, int)
+		{
+			NUM_ELEMENTS item = 0,
+						 index = 0;
+			double weight = 0.0,
+				   weighted_sum = 0.0;
 
-		size = nNodes + cluster->get_nPI();
-		choice = m_rand_number_gen->random_number(size-1);
+			for (item = block * nItems / nBlocks; item < (block + 1) * nItems / nBlocks; item++)
+			{
+				weight = anchor_weight;
+				weighted_sum = anchor_weight * positions[item];
+				for (index = m_wire_offsets[item]; index < m_wire_offsets[item + 1]; index++)
+				{
+					weight += 1.0;
+					weighted_sum += positions[m_wires[index]];
+				}
+				targets[item] = (weight > 0.0) ? weighted_sum / weight : positions[item];
+			}
+		});
 
-			
-		// a choice greater than the number of nodes indicates a PI
-		if (choice >= nNodes)
+		// each group touches only its own items and slots
+		thread_pool.run(nGroups, [&](NUM_ELEMENTS group, int)
 		{
-			// we have a primary input
-				
-			choice -= nNodes;
-			
-			PIs = cluster->get_PI();
+			NUM_ELEMENTS group_slot = 0;
 
+			sort(slot_items.begin() + m_group_offsets[group], slot_items.begin() + m_group_offsets[group + 1],
+				[&](const NUM_ELEMENTS & item_a, const NUM_ELEMENTS & item_b)
+				{
+					return targets[item_a] < targets[item_b] || 
+							(targets[item_a] == targets[item_b] && item_a < item_b);
+				});
 
-			assert(choice >= 0 && static_cast<unsigned>(choice) < PIs.size());
-			pi_b = PIs[choice];
-			assert(pi_b);
+			for (group_slot = m_group_offsets[group]; group_slot < m_group_offsets[group + 1]; group_slot++)
+			{
+				positions[slot_items[group_slot]] = slot_positions[group_slot];
+			}
+		});
 
-			m_move.set_port_b(pi_b);
+		wirelength = get_wirelength(positions);
+		if (wirelength < best_wirelength)
+		{
+			best_wirelength = wirelength;
+			best_positions = positions;
+			nIterations_without_gain = 0;
 		}
 		else
 		{
-			// we have a node
-	
-			node_b = delay_level[choice];
-			assert(node_b);
-
-			m_move.set_node_b(node_b);
+			nIterations_without_gain++;
 		}
 	}
-}
 
-// 
-// get the cost for the iterative improvement algorithm
-//
-// PRE: horizontal position of nodes has been defined
-// RETURNS: the normalized cost
-//
-COST_TYPE WIRELENGTH_CHARACTER::get_cost() const
-{
-	NUM_ELEMENTS nEdges = m_circuit->get_nEdges_without_clock_edges();
-	COST_TYPE wirelength = get_wirelength_measurement()/(static_cast<double>(m_width) * nEdges * 16);
-	return wirelength;
-}
+	set_item_positions(best_positions);
 
-// get the changed cost for the move being considered
-//
-// PRE: m_move contains a valid move
-// RETURNS: the normalized changed cost of the move
-//
-COST_TYPE WIRELENGTH_CHARACTER::get_changed_cost(const double& old_cost)
-{
-	NUM_ELEMENTS nEdges = m_circuit->get_nEdges_without_clock_edges();
-
-	COST_TYPE changed_cost = m_move.get_wirelength_change_of_nodes_involved();
-	changed_cost = changed_cost/(static_cast<double>(m_width) * nEdges * 16);
-	
-	return changed_cost;
-
-	/* if you want to get the exact cost
-	m_move.make_temporary_move();
-	COST_TYPE changed_cost = get_cost();
-	m_move.unmake_temporary_move();
-	changed_cost -= old_cost;
-	*/
-}
-WIRELENGTH_MOVE::WIRELENGTH_MOVE()
-{
-	m_node_a 	= 0;
-	m_node_b 	= 0;
-	m_port_a 	= 0;
-	m_port_b 	= 0;
-}
+	m_nMoves = 0;
+	m_seconds = chrono::duration<double>(WIRELENGTH_CLOCK::now() - start).count();
 
-WIRELENGTH_MOVE::~WIRELENGTH_MOVE()
-{
+	Log("wirelength: analytic placement took " << iteration << " iterations in " << m_seconds << " s");
+	debug("********************** Analytic Wirelengthapprox " << best_wirelength << " **********");
 }
 
+// performs a simulated anneal to try and lower the wirelengthapprox measured
 //
-// RETURNS: whether or not we have a valid move
+// PRE: the circuit is indexed. nodes and primary inputs have their horizontal position defined
+// POST: the wirelengthapprox is hopefully lower.  the nodes and primary
+//       inputs have the positions of the best chain
 //
-bool WIRELENGTH_MOVE::is_valid() const
+void WIRELENGTH_CHARACTER::iterate()
 {
-	bool valid = (m_node_a != m_node_b || m_port_a != m_port_b);
+	THREAD_POOL thread_pool(MAX(1, g_options->get_nThreads()));
+	bool is_out_of_time = false;
+	unsigned long long seed = static_cast<unsigned long long>(g_options->get_seed());
+	NUM_ELEMENTS_VECTOR positions,
+						slot_items;
+	NUM_ELEMENTS chain_index = 0,
+				 best_chain = 0,
+				 last_step = 0;
+
+	m_start = WIRELENGTH_CLOCK::now();
+	m_deadline = m_start;
+	m_has_deadline = (g_options->get_wirelength_time_budget() > 0);
+	m_is_adaptive = (g_options->get_wirelength_schedule() == OPTIONS::WL_ADAPTIVE_SCHEDULE);
+
+	// a placement to start from only needs the cooling
+	m_start_progress = (g_options->get_wirelength_mode() == OPTIONS::WL_ANALYTIC_ANNEAL) ? WL_COOLING_START : 0.0;
+
+	get_item_positions(positions);
+	get_slot_items(positions, slot_items);
+
+	if (seed == 0)
+	{
+		seed = static_cast<unsigned long long>(util_ticks());
+		debug("Seeding the wirelength chains with clock-ticks (" << seed << ")");
+	}
 
-	return valid;
-}
+	if (m_has_deadline)
+	{
+		m_deadline = m_start + chrono::duration_cast<WIRELENGTH_CLOCK::duration>(
+								chrono::duration<double>(g_options->get_wirelength_time_budget()));
+	}
 
-void WIRELENGTH_MOVE::make_temporary_move()
-{
-	make_move();
-}
-void WIRELENGTH_MOVE::unmake_temporary_move()
-{
-	make_move();
-}
+	m_chains.resize(thread_pool.get_nThreads());
+	for (chain_index = 0; chain_index < static_cast<NUM_ELEMENTS>(m_chains.size()); chain_index++)
+	{
+		m_chains[chain_index].random_stream = RANDOM_STREAM(seed, chain_index);
+		start_chain(m_chains[chain_index], positions, slot_items);
+	}
+	assert(m_chains[0].wirelength == static_cast<NUM_ELEMENTS>(get_wirelength_measurement()));
 
-void WIRELENGTH_MOVE::make_and_commit_move()
-{
-	make_move();
+	debug("Initial cost is " << m_chains[0].wirelength / m_cost_scale << endl);
 
-	clear();
+	while (m_chains[0].nSteps < WL_TEMPERATURE_STEPS && m_chains[0].wirelength > 0 && ! is_out_of_time)
+	{
+		last_step = MIN(WL_TEMPERATURE_STEPS, m_chains[0].nSteps + WL_SHARING_STEPS);
+
+		thread_pool.run(static_cast<NUM_ELEMENTS>(m_chains.size()), [&](NUM_ELEMENTS task_index, int)
+		{
+			PROFILE_SPAN span("anneal chain");
+			anneal_chain(m_chains[task_index], last_step);
+		});
+
+		is_out_of_time = (m_has_deadline && WIRELENGTH_CLOCK::now() >= m_deadline);
+		share_best_chain();
+	}
+
+	best_chain = get_best_chain();
+	set_item_positions(m_chains[best_chain].positions);
+
+	m_nMoves = 0;
+	for (chain_index = 0; chain_index < static_cast<NUM_ELEMENTS>(m_chains.size()); chain_index++)
+	{
+		m_nMoves += m_chains[chain_index].nMoves;
+	}
+	m_seconds = chrono::duration<double>(WIRELENGTH_CLOCK::now() - m_start).count();
+
+	Log("wirelength: " << m_chains.size() << " chains annealed for " << m_chains[best_chain].nSteps <<
+		" temperature steps in " << m_seconds << " s" << (is_out_of_time ? " (the time budget ran out)" : ""));
+	debug("********************** Final lowest cost " << m_chains[best_chain].wirelength / m_cost_scale << " **********");
+	debug("********************** Final Wirelengthapprox " << get_wirelength_measurement() << " **********");
 }
 
+// Start a chain at the positions, with the items in the slots given
 //
-// clear the move
+// PRE: the chain has its random stream. slot_items orders each group by position
+// POST: the chain is ready to anneal
 //
-void WIRELENGTH_MOVE::clear()
+void WIRELENGTH_CHARACTER::start_chain
+(
+	WIRELENGTH_CHAIN & chain,
+	const NUM_ELEMENTS_VECTOR & positions,
+	const NUM_ELEMENTS_VECTOR & slot_items
+) const
 {
-	m_node_a 	= 0;
-	m_node_b 	= 0;
-	m_port_a 	= 0;
-	m_port_b 	= 0;
+	NUM_ELEMENTS slot = 0;
+
+	chain.positions = positions;
+	chain.wirelength = get_wirelength(positions);
+	chain.nSteps = 0;
+	chain.nMoves = 0;
+	chain.range = 1.0;
+	chain.slot_items = slot_items;
+	chain.item_slots.resize(slot_items.size());
+	for (slot = 0; slot < static_cast<NUM_ELEMENTS>(slot_items.size()); slot++)
+	{
+		chain.item_slots[slot_items[slot]] = slot;
+	}
+	chain.temperature = get_initial_temperature(chain);
 }
 
-
+// Anneal one chain up to a temperature step, or until the deadline
 //
-// Swap the horizontal position of items selected for movement
+// PRE: the chain's positions and wirelength agree
+// POST: the chain has taken its steps up to last_step
 //
-void WIRELENGTH_MOVE::make_move()
+void WIRELENGTH_CHARACTER::anneal_chain
+(
+	WIRELENGTH_CHAIN & chain,
+	const NUM_ELEMENTS & last_step
+) const
 {
-	NUM_ELEMENTS horizontal_position_a = 0,
-				 horizontal_position_b = 0;
-
-	if (m_node_a && m_node_b)
+	const NUM_ELEMENTS inner_loop_limit = static_cast<NUM_ELEMENTS>(m_nodes.size());
+	NUM_ELEMENTS inner_loops = 0,
+				 number_success = 0,
+				 number_changing = 0,
+				 number_changing_success = 0,
+				 item_a = 0,
+				 item_b = 0,
+				 changed_wirelength = 0;
+	double changed_cost = 0.0,
+		   success_rate = 0.0;
+
+	while (chain.nSteps < last_step && chain.wirelength > 0)
 	{
-		horizontal_position_a = m_node_a->get_horizontal_position();
-		horizontal_position_b = m_node_b->get_horizontal_position();
+		if (m_has_deadline && WIRELENGTH_CLOCK::now() >= m_deadline)
+		{
+			break;
+		}
 
-		m_node_a->set_horizontal_position(horizontal_position_b);
-		m_node_b->set_horizontal_position(horizontal_position_a);
-	}
-	else if (m_node_a && m_port_b)
-	{
-		horizontal_position_a = m_node_a->get_horizontal_position();
-		horizontal_position_b = m_port_b->get_horizontal_position();
+		number_success = 0;
+		number_changing = 0;
+		number_changing_success = 0;
+		for (inner_loops = 0; inner_loops < inner_loop_limit; inner_loops++)
+		{
+			chain.nMoves++;
+			if (! generate_move(chain, item_a, item_b))
+			{
+				continue;
+			}
 
-		m_node_a->set_horizontal_position(horizontal_position_b);
-		m_port_b->set_horizontal_position(horizontal_position_a);
-	}
-	else if (m_port_a && m_node_b)
-	{
-		horizontal_position_a = m_port_a->get_horizontal_position();
-		horizontal_position_b = m_node_b->get_horizontal_position();
+			changed_wirelength = get_wirelength_change(chain.positions, item_a, item_b);
+			changed_cost = changed_wirelength / m_cost_scale;
+			number_changing += (changed_wirelength != 0);
 
-		m_port_a->set_horizontal_position(horizontal_position_b);
-		m_node_b->set_horizontal_position(horizontal_position_a);
-	}
-	else if (m_port_a && m_port_b)
-	{
-		horizontal_position_a = m_port_a->get_horizontal_position();
-		horizontal_position_b = m_port_b->get_horizontal_position();
+			if (changed_cost <= 0.0 || chain.random_stream.random_fraction() < exp(- changed_cost/chain.temperature))
+			{
+				number_success++;
+				number_changing_success += (changed_wirelength != 0);
+				make_move(chain, item_a, item_b, changed_wirelength);
+			}
+		}
+		chain.nSteps++;
 
-		m_port_a->set_horizontal_position(horizontal_position_b);
-		m_port_b->set_horizontal_position(horizontal_position_a);
-	}
-	else
-	{
-		Fail("Something is weird with a wirelength move");
-	}
+		success_rate = static_cast<double>(number_success)/static_cast<double>(inner_loop_limit);
 
-	assert(horizontal_position_a != horizontal_position_b);
+		if (m_is_adaptive)
+		{
+			// swaps that leave the wirelength alone are always taken, whatever
+			// the temperature, so they can't tell how hot the chain is
+			update_adaptive_schedule(chain, (number_changing > 0) ? 
+						static_cast<double>(number_changing_success)/static_cast<double>(number_changing) : 0.0);
+		}
+		else if (chain.temperature > WL_MIN_TEMPERATURE)
+		{
+			update_temperature(chain.temperature, success_rate, chain.nSteps * inner_loop_limit);
+		}
+	}
 }
 
 
+// generate a move: an item and another in its group.  the adaptive 
+// schedule keeps the other within the chain's range of slots
+//
+// POST: item_a and item_b are the items to swap
+// RETURNS: whether the move swaps two different items
 //
-// PRE: the move is valid
-// RETURN: the unnormalized cost all the nodes and/or primary inputs affected by the move
-//         
-COST_TYPE WIRELENGTH_MOVE::get_wirelength_cost_of_nodes_involved()
+bool WIRELENGTH_CHARACTER::generate_move
+(
+	WIRELENGTH_CHAIN & chain,
+	NUM_ELEMENTS & item_a,
+	NUM_ELEMENTS & item_b
+) const
 {
-	COST_TYPE wirelength_cost = 0;
+	NUM_ELEMENTS group = 0,
+				 group_size = 0,
+				 reach = 0,
+				 slot_a = 0,
+				 first_slot = 0,
+				 last_slot = 0,
+				 slot_b = 0;
 
-	if (m_node_a && m_node_b)
-	{
-		wirelength_cost = get_wirelength_cost_of_node_and_fanout(m_node_a) + 
-						get_wirelength_cost_of_node_and_fanout(m_node_b);
-	}
-	else if (m_node_a && m_port_b)
-	{
-		wirelength_cost = get_wirelength_cost_of_node_and_fanout(m_node_a) + 
-						get_wirelength_cost_of_fanout_of_PI(m_port_b);
-	}
-	else if (m_port_a && m_node_b)
+	item_a = chain.random_stream.random_number(static_cast<NUM_ELEMENTS>(m_item_groups.size()) - 1);
+
+	group = m_item_groups[item_a];
+	group_size = m_group_offsets[group + 1] - m_group_offsets[group];
+
+	if (! m_is_adaptive)
 	{
-		wirelength_cost = get_wirelength_cost_of_node_and_fanout(m_node_b) + 
-						get_wirelength_cost_of_fanout_of_PI(m_port_a);
+		item_b = m_group_items[m_group_offsets[group] + chain.random_stream.random_number(group_size - 1)];
+		return (item_a != item_b);
 	}
-	else if (m_port_a && m_port_b)
+
+	if (group_size < 2)
 	{
-		wirelength_cost = get_wirelength_cost_of_fanout_of_PI(m_port_a) + 
-						get_wirelength_cost_of_fanout_of_PI(m_port_b);
+		return false;
 	}
-	else
+
+	reach = MAX(1, static_cast<NUM_ELEMENTS>(chain.range * group_size));
+	slot_a = chain.item_slots[item_a];
+	first_slot = MAX(m_group_offsets[group], slot_a - reach);
+	last_slot = MIN(m_group_offsets[group + 1] - 1, slot_a + reach);
+
+	// any slot in reach but item_a's own
+	slot_b = first_slot + chain.random_stream.random_number(last_slot - first_slot - 1);
+	if (slot_b >= slot_a)
 	{
-		Fail("Something is weird with a wirelength move");
+		slot_b++;
 	}
+	item_b = chain.slot_items[slot_b];
 
-	return wirelength_cost;
+	assert(item_a != item_b && m_item_groups[item_b] == group);
+	return true;
 }
+
 //
-// PRE: the node is valid
-// RETURNS: the wirelength cost of the node and its fanout
+// POST: item_a and item_b have swapped places and slots
 //
-COST_TYPE WIRELENGTH_MOVE::get_wirelength_cost_of_node_and_fanout
+void WIRELENGTH_CHARACTER::make_move
 (
-	NODE * node
-) 
+	WIRELENGTH_CHAIN & chain,
+	const NUM_ELEMENTS & item_a,
+	const NUM_ELEMENTS & item_b,
+	const NUM_ELEMENTS & changed_wirelength
+) const
 {
-	assert(node);
+	NUM_ELEMENTS position_a = chain.positions[item_a],
+				 slot_a = chain.item_slots[item_a];
 
-	PORT * port = 0;
-	NODE * sink_node = 0;
-	EDGES output_edges;
-	EDGES::const_iterator edge_iter;
-	EDGE * edge = 0;
+	chain.positions[item_a] = chain.positions[item_b];
+	chain.positions[item_b] = position_a;
+	chain.wirelength += changed_wirelength;
 
-	// 1st get the wirelength cost of the node
-	COST_TYPE wirelength = node->get_wirelength_approx_cost();
+	chain.item_slots[item_a] = chain.item_slots[item_b];
+	chain.item_slots[item_b] = slot_a;
+	chain.slot_items[chain.item_slots[item_a]] = item_a;
+	chain.slot_items[slot_a] = item_b;
+}
 
-	// 2nd get the wirelength cost of the fanout of the node 
-	// because those sink node's will also have had their wirelength change
-	// by the movement of this node
-	port = node->get_output_port();
-	output_edges = port->get_edges();
+//
+// RETURNS: the unnormalized Wirelength-approx of the positions
+//
+NUM_ELEMENTS WIRELENGTH_CHARACTER::get_wirelength
+(
+	const NUM_ELEMENTS_VECTOR & positions
+) const
+{
+	NUM_ELEMENTS item = 0,
+				 index = 0,
+				 wirelength = 0;
 
-	for (edge_iter = output_edges.begin(); edge_iter != output_edges.end(); edge_iter++)
+	// each wire is seen from both of its ends
+	for (item = 0; item < static_cast<NUM_ELEMENTS>(positions.size()); item++)
 	{
-		edge = *edge_iter;
-		assert(edge);
-
-		sink_node = edge->get_sink_node();
-		assert(node);
-
-		wirelength += sink_node->get_wirelength_approx_cost();
+		for (index = m_wire_offsets[item]; index < m_wire_offsets[item + 1]; index++)
+		{
+			wirelength += ABS(positions[item] - positions[m_wires[index]]);
+		}
 	}
 
-	return wirelength;
+	return wirelength / 2;
 }
 
 //
-// PRE: the port is valid
-// RETURNS: the wirelength cost of the primary output and its fanout
+//  PRE: item_a and item_b are in the same group
+//  RETURNS: the change in the unnormalized Wirelength-approx if the items swap places
 //
-COST_TYPE WIRELENGTH_MOVE::get_wirelength_cost_of_fanout_of_PI
+NUM_ELEMENTS WIRELENGTH_CHARACTER::get_wirelength_change
 (
-	const PORT * port
+	const NUM_ELEMENTS_VECTOR & positions,
+	const NUM_ELEMENTS & item_a,
+	const NUM_ELEMENTS & item_b
 ) const
 {
-	assert(port);
-
-	COST_TYPE wirelength = 0.0;
-
-	NODE * sink_node = 0;
-	EDGES output_edges;
-	EDGES::const_iterator edge_iter;
-	EDGE * edge = 0;
-
-	output_edges = port->get_edges();
-
-	for (edge_iter = output_edges.begin(); edge_iter != output_edges.end(); edge_iter++)
+	NUM_ELEMENTS position_a = positions[item_a],
+				 position_b = positions[item_b],
+				 other_position = 0,
+				 index = 0,
+				 changed_wirelength = 0;
+
+	// the wires between the two keep their length
+	for (index = m_wire_offsets[item_a]; index < m_wire_offsets[item_a + 1]; index++)
 	{
-		edge = *edge_iter;
-		assert(edge);
-
-		sink_node = edge->get_sink_node();
-		assert(sink_node);
-
-		wirelength += sink_node->get_wirelength_approx_cost();
+		if (m_wires[index] != item_b)
+		{
+			other_position = positions[m_wires[index]];
+			changed_wirelength += ABS(position_b - other_position) - ABS(position_a - other_position);
+		}
+	}
+	for (index = m_wire_offsets[item_b]; index < m_wire_offsets[item_b + 1]; index++)
+	{
+		if (m_wires[index] != item_a)
+		{
+			other_position = positions[m_wires[index]];
+			changed_wirelength += ABS(position_a - other_position) - ABS(position_b - other_position);
+		}
 	}
 
-	return wirelength;
+	return changed_wirelength;
 }
 
 //
-//  Find the change in wirelength cost for the nodes involved in
-//  the move
+// RETURNS: the chain with the lowest wirelength, the first of any tie
 //
-//  PRE: a wirelength move has been defined
-//  RETURNS: the change in wirelength cost
-//
-COST_TYPE WIRELENGTH_MOVE::get_wirelength_change_of_nodes_involved()
+NUM_ELEMENTS WIRELENGTH_CHARACTER::get_best_chain() const
 {
-	make_temporary_move();
-
-	COST_TYPE changed_cost = get_wirelength_cost_of_nodes_involved();
-
-	unmake_temporary_move();
+	NUM_ELEMENTS chain_index = 0,
+				 best_chain = 0;
 
-	changed_cost -= get_wirelength_cost_of_nodes_involved();
+	for (chain_index = 1; chain_index < static_cast<NUM_ELEMENTS>(m_chains.size()); chain_index++)
+	{
+		if (m_chains[chain_index].wirelength < m_chains[best_chain].wirelength)
+		{
+			best_chain = chain_index;
+		}
+	}
 
-	return changed_cost;
+	return best_chain;
 }
 
-
-
-
 //
-//  Find the change in wirelength cost normalized by the 
-//  number of edges and the max_index
+// POST: every chain carries on from the positions and temperature of the
+//       best chain, each with its own random stream
 //
-//  PRE: a wirelength move has been defined
-//  RETURNS: the normalized changed in wirelength cost
-//
-COST_TYPE WIRELENGTH_MOVE::get_changed_wirelength_cost
-(
-	const double& wirelength_cost, 
-	const double& max_index,
-	const double& nEdges
-)
+void WIRELENGTH_CHARACTER::share_best_chain()
 {
+	NUM_ELEMENTS chain_index = 0,
+				 best_chain = get_best_chain();
 
-	double changed_wirelength = 0.0,
-			  changed_wirelength_of_sink_nodes = 0.0,
-			  changed_cost = 0.0;
-
-	changed_wirelength_of_sink_nodes = get_wirelength_change_of_nodes_involved();
-		
-	changed_cost = changed_wirelength/(max_index*nEdges);
-
-	//debug("wirelength Changed cost " << changed_cost);
-	
-	return changed_cost;
+	for (chain_index = 0; chain_index < static_cast<NUM_ELEMENTS>(m_chains.size()); chain_index++)
+	{
+		if (chain_index != best_chain)
+		{
+			m_chains[chain_index].positions = m_chains[best_chain].positions;
+			m_chains[chain_index].wirelength = m_chains[best_chain].wirelength;
+			m_chains[chain_index].temperature = m_chains[best_chain].temperature;
+			m_chains[chain_index].nSteps = m_chains[best_chain].nSteps;
+			m_chains[chain_index].item_slots = m_chains[best_chain].item_slots;
+			m_chains[chain_index].slot_items = m_chains[best_chain].slot_items;
+			m_chains[chain_index].range = m_chains[best_chain].range;
+		}
+	}
 }
 
 //
@@ -749,7 +990,7 @@ void WIRELENGTH_CHARACTER::update_temperature
 	double & temperature,
 	const double& success_rate,
 	const NUM_ELEMENTS& loops
-)
+) const
 {
 	if (success_rate > 0.96) 
 	{
@@ -780,6 +1021,118 @@ void WIRELENGTH_CHARACTER::update_temperature
 	}
 }
 
+//
+// RETURNS: the temperature the chain starts at.  the adaptive schedule
+//          accepts the uphill moves it samples at the rate it starts by
+//
+double WIRELENGTH_CHARACTER::get_initial_temperature
+(
+	WIRELENGTH_CHAIN & chain
+) const
+{
+	NUM_ELEMENTS nSamples = static_cast<NUM_ELEMENTS>(m_nodes.size()),
+				 sample = 0,
+				 nUphill = 0,
+				 item_a = 0,
+				 item_b = 0,
+				 changed_wirelength = 0;
+	double uphill_cost = 0.0;
+
+	if (! m_is_adaptive)
+	{
+		return WL_INITIAL_TEMPERATURE;
+	}
+
+	for (sample = 0; sample < nSamples; sample++)
+	{
+		chain.nMoves++;
+		if (generate_move(chain, item_a, item_b))
+		{
+			changed_wirelength = get_wirelength_change(chain.positions, item_a, item_b);
+			if (changed_wirelength > 0)
+			{
+				uphill_cost += changed_wirelength / m_cost_scale;
+				nUphill++;
+			}
+		}
+	}
+
+	if (nUphill == 0)
+	{
+		return WL_INITIAL_TEMPERATURE;
+	}
+	return uphill_cost / nUphill / - log(MIN(get_target_rate(m_start_progress), WL_MAX_START_ACCEPTANCE));
+}
+
+//
+// RETURNS: how far through the annealing the chain is, from where it 
+//          started to 1, by its steps or the time budget, whichever is further
+//
+double WIRELENGTH_CHARACTER::get_progress
+(
+	const WIRELENGTH_CHAIN & chain
+) const
+{
+	double progress = static_cast<double>(chain.nSteps) / WL_TEMPERATURE_STEPS;
+
+	if (m_has_deadline)
+	{
+		progress = MAX(progress, chrono::duration<double>(WIRELENGTH_CLOCK::now() - m_start).count() /
+								 chrono::duration<double>(m_deadline - m_start).count());
+	}
+
+	return m_start_progress + (1.0 - m_start_progress) * MIN(1.0, progress);
+}
+
+//
+// RETURNS: the acceptance rate the adaptive schedule aims for at the 
+//          progress.  it falls from 1 to WL_TARGET_ACCEPTANCE, holds, and
+//          then falls toward 0
+//
+double WIRELENGTH_CHARACTER::get_target_rate
+(
+	const double & progress
+) const
+{
+	if (progress < WL_HEATING_END)
+	{
+		return WL_TARGET_ACCEPTANCE + 
+				(1.0 - WL_TARGET_ACCEPTANCE) * pow(560.0, - progress / WL_HEATING_END);
+	}
+	else if (progress >= WL_COOLING_START)
+	{
+		return WL_TARGET_ACCEPTANCE * 
+				pow(440.0, - (progress - WL_COOLING_START) / (1.0 - WL_COOLING_START));
+	}
+	return WL_TARGET_ACCEPTANCE;
+}
+
+//
+// steers the temperature to the target acceptance rate for the chain's 
+// progress, and widens or narrows the range of its moves to keep the 
+// rate near WL_TARGET_ACCEPTANCE
+// 
+void WIRELENGTH_CHARACTER::update_adaptive_schedule
+(
+	WIRELENGTH_CHAIN & chain,
+	const double& success_rate
+) const
+{
+	double target_rate = get_target_rate(get_progress(chain));
+
+	chain.temperature *= exp(WL_TEMPERATURE_GAIN * (target_rate - success_rate));
+	chain.temperature = MAX(chain.temperature, WL_MIN_TEMPERATURE);
+
+	chain.range *= 1.0 - WL_TARGET_ACCEPTANCE + success_rate;
+	chain.range = MAX(WL_MIN_RANGE, MIN(1.0, chain.range));
+
+	if (chain.nSteps % 100 == 0)
+	{
+		debug("success_rate " << success_rate << "\ttarget " << target_rate << 
+			  "\tNew temperature " << chain.temperature << "\trange " << chain.range);
+	}
+}
+
 //
 // Prints out the list of horizontal positions of all nodes and primary inputs
 //
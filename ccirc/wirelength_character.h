@@ -26,48 +26,55 @@
 //
 // Description
 //
+//	Finds a low Wirelength-approx by annealing the horizontal positions of
+//	the nodes and primary inputs.  A move swaps two items in the same delay
+//	level of the same cluster.
+//
+//	The circuit is first copied into arrays: the items are the nodes 
+//	followed by the primary inputs, each with the group of items it may 
+//	swap with and the items it is wired to.  Each thread then anneals a 
+//	chain of its own, drawing its moves from its own counter based random 
+//	stream.  Every few temperature steps the chains stop and carry on from
+//	the best of them, so the result depends only on the seed and the 
+//	number of threads -- unless the time budget runs out first.
+//
+//	The fixed schedule cools by a table of the acceptance rate.  The 
+//	adaptive schedule steers the temperature to an acceptance rate that
+//	falls as the annealing goes on (Lam and Delosme), measured by the steps 
+//	or the time budget, whichever runs out first.  It also limits how far 
+//	apart in its delay level an item may be swapped, which keeps the rate 
+//	up as the chain cools.
+//
+//	The analytic mode places instead of annealing: each item moves to the 
+//	average place of the items it is wired to (a step of the quadratic 
+//	placement), held back by a pull toward its last place, and then each 
+//	delay level is sorted by those places back into its slots.  It is much 
+//	faster than annealing and can start the annealing off.
+//
 
 
 #include "circ.h"
 #include "circuit.h"
 #include "rand.h"
+#include <chrono>
+
+typedef chrono::steady_clock WIRELENGTH_CLOCK;
 
-class WIRELENGTH_MOVE
+// one annealing chain
+struct WIRELENGTH_CHAIN
 {
-public:
-	WIRELENGTH_MOVE();
-	~WIRELENGTH_MOVE();
-
-	void set_node_a(NODE * node_a) { m_node_a = node_a; }
-	void set_port_a(PORT * port_a) { m_port_a = port_a; }
-	void set_node_b(NODE * node_b) { m_node_b = node_b; }
-	void set_port_b(PORT * port_b) { m_port_b = port_b; }
-
-	NODE * get_node_a() const { return m_node_a; }
-	PORT * get_port_a() const { return m_port_a; }
-	NODE * get_node_b() const { return m_node_b; } 
-	PORT * get_port_b() const { return m_port_b; } 
-
-	bool is_valid() const;
-	void clear();
-
-	void make_and_commit_move();
-	void make_move();
-	void make_temporary_move();
-	void unmake_temporary_move();
-
-	COST_TYPE get_changed_wirelength_cost(const COST_TYPE& wirelength_cost,
-										const COST_TYPE& max_index, const COST_TYPE& nEdges);
-	COST_TYPE get_wirelength_change_of_nodes_involved(); 
-	COST_TYPE get_wirelength_cost_of_nodes_involved();
-	COST_TYPE get_wirelength_cost_of_node_and_fanout(NODE * node);
-	COST_TYPE get_wirelength_cost_of_fanout_of_PI(const PORT * port) const;
-private:
-	NODE * 	m_node_a;
-	PORT * 	m_port_a;
-	NODE *  m_node_b;		
-	PORT *  m_port_b;
+	NUM_ELEMENTS_VECTOR	positions;		// the horizontal position of each item
+	NUM_ELEMENTS		wirelength;		// unnormalized Wirelength-approx of the positions
+	double				temperature;
+	NUM_ELEMENTS		nSteps;			// temperature steps taken
+	NUM_ELEMENTS_VECTOR	item_slots;		// the slots of its group, in order of position, 
+	NUM_ELEMENTS_VECTOR	slot_items;		//   that each item is in and the item in each slot
+	double				range;			// the fraction of its group an item may move across
+	NUM_ELEMENTS		nMoves;			// the moves tried by this chain, never shared
+	RANDOM_STREAM		random_stream;	// the chain keeps its own when the best is shared
 };
+typedef vector<WIRELENGTH_CHAIN> WIRELENGTH_CHAINS;
+
 class WIRELENGTH_CHARACTER
 {
 public:
@@ -77,23 +84,59 @@ public:
 	~WIRELENGTH_CHARACTER();
 
 	double get_circuit_wirelength_approx(CIRCUIT * circuit);
+
+	// of the last annealing
+	NUM_ELEMENTS get_nMoves() const { return m_nMoves; }
+	double get_seconds() const { return m_seconds; }
 private:
 	CIRCUIT * m_circuit;
 	NUM_ELEMENTS m_width;
-	RANDOM_NUMBER * m_rand_number_gen;
-	WIRELENGTH_MOVE m_move;
 
 	NODES m_nodes;
 	PORTS m_PI;
-	CLUSTERS m_clusters;
+
+	// the circuit as arrays of items.  item i < m_nodes.size() is node i, 
+	// the rest are the primary inputs
+	NUM_ELEMENTS_VECTOR	m_item_groups;		// the group of items each item can swap with
+	NUM_ELEMENTS_VECTOR	m_group_offsets;	// group g is m_group_items[m_group_offsets[g]..[g+1])
+	NUM_ELEMENTS_VECTOR	m_group_items;
+	NUM_ELEMENTS_VECTOR	m_wire_offsets;		// item i is wired to m_wires[m_wire_offsets[i]..[i+1]),
+	NUM_ELEMENTS_VECTOR	m_wires;			//   once for each edge between them
+	double				m_cost_scale;		// turns a wirelength into the annealing cost
+
+	WIRELENGTH_CHAINS	m_chains;
+	bool				m_is_adaptive;
+	double				m_start_progress;	// of the adaptive schedule, at cooling for a placement
+	bool				m_has_deadline;
+	WIRELENGTH_CLOCK::time_point	m_start;
+	WIRELENGTH_CLOCK::time_point	m_deadline;
+	NUM_ELEMENTS		m_nMoves;
+	double				m_seconds;
 
 	void set_horizontal_position_of_nodes();
 	double get_wirelength_measurement() const;
+	void index_circuit();
+	void get_item_positions(NUM_ELEMENTS_VECTOR & positions) const;
+	void set_item_positions(const NUM_ELEMENTS_VECTOR & positions);
+	void get_slot_items(const NUM_ELEMENTS_VECTOR & positions, NUM_ELEMENTS_VECTOR & slot_items) const;
+	void place_analytically();
 	void iterate();
-	void generate_move();
-	COST_TYPE get_cost() const;
-	COST_TYPE get_changed_cost(const COST_TYPE& old_cost);
-	void update_temperature(double& temperature, const double& success_rate, const NUM_ELEMENTS& loops);
+	void start_chain(WIRELENGTH_CHAIN & chain, const NUM_ELEMENTS_VECTOR & positions,
+					const NUM_ELEMENTS_VECTOR & slot_items) const;
+	void anneal_chain(WIRELENGTH_CHAIN & chain, const NUM_ELEMENTS & last_step) const;
+	bool generate_move(WIRELENGTH_CHAIN & chain, NUM_ELEMENTS & item_a, NUM_ELEMENTS & item_b) const;
+	void make_move(WIRELENGTH_CHAIN & chain, const NUM_ELEMENTS & item_a, const NUM_ELEMENTS & item_b,
+					const NUM_ELEMENTS & changed_wirelength) const;
+	NUM_ELEMENTS get_wirelength(const NUM_ELEMENTS_VECTOR & positions) const;
+	NUM_ELEMENTS get_wirelength_change(const NUM_ELEMENTS_VECTOR & positions, 
+									const NUM_ELEMENTS & item_a, const NUM_ELEMENTS & item_b) const;
+	NUM_ELEMENTS get_best_chain() const;
+	void share_best_chain();
+	double get_initial_temperature(WIRELENGTH_CHAIN & chain) const;
+	double get_progress(const WIRELENGTH_CHAIN & chain) const;
+	double get_target_rate(const double & progress) const;
+	void update_temperature(double& temperature, const double& success_rate, const NUM_ELEMENTS& loops) const;
+	void update_adaptive_schedule(WIRELENGTH_CHAIN & chain, const double& success_rate) const;
 	void print_wirelength_results() const;
 };
 